@@ -0,0 +1,884 @@
+/******************************************************************************
+ * Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+// examples/mdl_sdk_benchmarks.cpp
+//
+// Runs fixed CPU workloads over the materials in examples/mdl/nvidia and reports the timings
+// as comma-separated values. The workloads cover module loading, material instantiation,
+// instance and class compilation, native and PTX code generation, argument block creation,
+// per-sample execution of the native BSDFs, overload resolution, and uniform and importance
+// sampling of light profiles.
+//
+// Each workload is repeated and the minimum, median, and maximum time of a repetition is
+// reported. No GPU is needed; PTX code is generated, but not executed.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <mi/mdl_sdk.h>
+
+#include "example_shared.h"
+
+// The modules whose materials are used by the workloads.
+const char* const g_modules[] = {
+    "::nvidia::core_definitions",
+    "::nvidia::sdk_examples::tutorials",
+    "::nvidia::sdk_examples::carbon_composite",
+    "::nvidia::sdk_examples::carpaint_measured",
+    "::nvidia::sdk_examples::gun_metal",
+    "::nvidia::sdk_examples::measured_metal",
+    "::nvidia::sdk_examples::metal_single_diamond_plate",
+    "::nvidia::sdk_examples::procedural_noise"
+};
+
+// The standard modules whose functions are used by the overload resolution workload.
+const char* const g_overload_modules[] = {
+    "::math",
+    "::df",
+    "::base"
+};
+
+// Command line options.
+struct Options
+{
+    Options()
+    : repetitions(5)
+    , samples(1 << 16)
+    , arg_blocks(1000)
+    {
+    }
+
+    mi::Uint32 repetitions;         // number of repetitions of each workload
+    mi::Uint32 samples;             // number of samples of the sampling workloads
+    mi::Uint32 arg_blocks;          // number of argument blocks created per material
+    std::string filter;             // only report workloads whose name starts with this prefix
+    std::string material_filter;    // only use materials whose DB name contains this string
+    std::string output_file;        // write the results to this file instead of stdout
+};
+
+// The timings of one workload.
+struct Result
+{
+    std::string name;               // name of the workload
+    mi::Size items;                 // number of items processed per repetition
+    std::vector<double> times;      // time of each repetition in milliseconds
+};
+
+// Measures the wall clock time since its construction.
+class Timer
+{
+public:
+    Timer() : m_start(std::chrono::steady_clock::now()) {}
+
+    // Returns the elapsed time in milliseconds.
+    double elapsed_ms() const
+    {
+        return std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - m_start).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// A small xorshift random number generator. Every workload uses the same seed, so all runs
+// process the same samples.
+class Random
+{
+public:
+    Random() : m_state(0x2545f491u) {}
+
+    // Returns a random number in [0, 1).
+    float next()
+    {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 17;
+        m_state ^= m_state << 5;
+        return float(m_state >> 8) * (1.0f / 16777216.0f);
+    }
+
+private:
+    mi::Uint32 m_state;
+};
+
+// Returns true if the results of the given workload are reported.
+//
+// Workloads that are not reported, but whose results are needed by later workloads, are run
+// exactly once.
+bool is_enabled(const Options& options, const char* name)
+{
+    return options.filter.empty()
+        || strncmp(name, options.filter.c_str(), options.filter.size()) == 0;
+}
+
+// Returns the number of repetitions of the given workload.
+mi::Uint32 get_repetitions(const Options& options, const char* name)
+{
+    return is_enabled(options, name) ? options.repetitions : 1;
+}
+
+// Adds the timings of a workload to the results if it is enabled.
+void add_result(
+    std::vector<Result>& results,
+    const Options& options,
+    const std::string& name,
+    mi::Size items,
+    const std::vector<double>& times)
+{
+    if (!is_enabled(options, name.c_str()))
+        return;
+
+    Result result;
+    result.name = name;
+    result.items = items;
+    result.times = times;
+    results.push_back(result);
+}
+
+// Prints the results as comma-separated values, one line per workload.
+void print_results(std::ostream& s, const std::vector<Result>& results)
+{
+    s << "workload,items,repetitions,min_ms,median_ms,max_ms,median_us_per_item" << std::endl;
+    s << std::fixed << std::setprecision(4);
+    for (size_t i = 0, n = results.size(); i < n; ++i) {
+        std::vector<double> times(results[i].times);
+        if (times.empty())
+            continue;
+        std::sort(times.begin(), times.end());
+
+        size_t count = times.size();
+        double median = (count & 1) != 0
+            ? times[count / 2]
+            : 0.5 * (times[count / 2 - 1] + times[count / 2]);
+        double per_item = results[i].items > 0 ? median * 1000.0 / results[i].items : 0.0;
+
+        s << results[i].name << ','
+          << results[i].items << ','
+          << count << ','
+          << times.front() << ','
+          << median << ','
+          << times.back() << ','
+          << per_item << std::endl;
+    }
+}
+
+// Loads all modules into a fresh scope for every repetition, so that each repetition compiles
+// the modules and the standard modules imported by them from scratch.
+void benchmark_module_loading(
+    mi::neuraylib::IDatabase* database,
+    mi::neuraylib::IMdl_compiler* mdl_compiler,
+    const Options& options,
+    std::vector<Result>& results)
+{
+    if (!is_enabled(options, "module_load"))
+        return;
+
+    mi::base::Handle<mi::neuraylib::IScope> global_scope(database->get_global_scope());
+    const mi::Size module_count = sizeof(g_modules) / sizeof(g_modules[0]);
+
+    std::vector<double> times;
+    for (mi::Uint32 r = 0; r < options.repetitions; ++r) {
+        mi::base::Handle<mi::neuraylib::IScope> scope(
+            database->create_scope(global_scope.get(), 1));
+        mi::base::Handle<mi::neuraylib::ITransaction> transaction(scope->create_transaction());
+
+        Timer timer;
+        for (mi::Size i = 0; i < module_count; ++i)
+            check_success(mdl_compiler->load_module(transaction.get(), g_modules[i]) >= 0);
+        times.push_back(timer.elapsed_ms());
+
+        transaction->abort();
+        transaction = 0;
+
+        std::string scope_id = scope->get_id();
+        scope = 0;
+        check_success(database->remove_scope(scope_id.c_str()) == 0);
+    }
+    add_result(results, options, "module_load", module_count, times);
+}
+
+// Loads all modules and returns the DB names of their materials.
+void collect_materials(
+    mi::neuraylib::ITransaction* transaction,
+    mi::neuraylib::IMdl_compiler* mdl_compiler,
+    const Options& options,
+    std::vector<std::string>& materials)
+{
+    const mi::Size module_count = sizeof(g_modules) / sizeof(g_modules[0]);
+    for (mi::Size i = 0; i < module_count; ++i) {
+        check_success(mdl_compiler->load_module(transaction, g_modules[i]) >= 0);
+
+        std::string module_db_name = std::string("mdl") + g_modules[i];
+        mi::base::Handle<const mi::neuraylib::IModule> module(
+            transaction->access<mi::neuraylib::IModule>(module_db_name.c_str()));
+        check_success(module.is_valid_interface());
+
+        for (mi::Size j = 0, n = module->get_material_count(); j < n; ++j) {
+            std::string name = module->get_material(j);
+            if (name.find(options.material_filter) != std::string::npos)
+                materials.push_back(name);
+        }
+    }
+}
+
+// Creates an instance with the default arguments of each material. Materials with parameters
+// without default arguments are skipped.
+void benchmark_instantiation(
+    mi::neuraylib::ITransaction* transaction,
+    const std::vector<std::string>& materials,
+    const Options& options,
+    std::vector<Result>& results,
+    std::vector<std::string>& instances)
+{
+    std::vector<double> times;
+    for (mi::Uint32 r = 0, n_r = get_repetitions(options, "instantiate"); r < n_r; ++r) {
+        instances.clear();
+
+        double time = 0.0;
+        for (size_t i = 0, n = materials.size(); i < n; ++i) {
+            mi::base::Handle<const mi::neuraylib::IMaterial_definition> material_definition(
+                transaction->access<mi::neuraylib::IMaterial_definition>(materials[i].c_str()));
+
+            Timer timer;
+            mi::Sint32 result = -1;
+            mi::base::Handle<mi::neuraylib::IMaterial_instance> material_instance(
+                material_definition->create_material_instance(0, &result));
+            time += timer.elapsed_ms();
+
+            if (result != 0 || !material_instance.is_valid_interface())
+                continue;
+
+            std::string instance_name = "benchmark instance of " + materials[i];
+            transaction->store(material_instance.get(), instance_name.c_str());
+            instances.push_back(instance_name);
+        }
+        times.push_back(time);
+    }
+    add_result(results, options, "instantiate", instances.size(), times);
+}
+
+// Compiles all material instances in instance or class compilation mode.
+void benchmark_compilation(
+    mi::neuraylib::ITransaction* transaction,
+    const std::vector<std::string>& instances,
+    bool class_compilation,
+    const Options& options,
+    std::vector<Result>& results,
+    std::vector<std::string>& compiled_materials)
+{
+    const char* workload = class_compilation ? "class_compile" : "instance_compile";
+    mi::Uint32 flags = class_compilation
+        ? mi::neuraylib::IMaterial_instance::CLASS_COMPILATION
+        : mi::neuraylib::IMaterial_instance::DEFAULT_OPTIONS;
+
+    std::vector<double> times;
+    for (mi::Uint32 r = 0, n_r = get_repetitions(options, workload); r < n_r; ++r) {
+        compiled_materials.clear();
+
+        double time = 0.0;
+        for (size_t i = 0, n = instances.size(); i < n; ++i) {
+            mi::base::Handle<const mi::neuraylib::IMaterial_instance> material_instance(
+                transaction->access<mi::neuraylib::IMaterial_instance>(instances[i].c_str()));
+
+            Timer timer;
+            mi::Sint32 result = -1;
+            mi::base::Handle<mi::neuraylib::ICompiled_material> compiled_material(
+                material_instance->create_compiled_material(
+                    flags, 1.0f, 380.0f, 780.0f, &result));
+            time += timer.elapsed_ms();
+
+            if (result != 0 || !compiled_material.is_valid_interface())
+                continue;
+
+            std::string compiled_name = std::string(workload) + " of " + instances[i];
+            transaction->store(compiled_material.get(), compiled_name.c_str());
+            compiled_materials.push_back(compiled_name);
+        }
+        times.push_back(time);
+    }
+    add_result(results, options, workload, compiled_materials.size(), times);
+}
+
+// Generates code for the "surface.scattering" BSDF of all compiled materials with the given
+// backend. Besides the total time, the compile phases recorded in the target codes are reported.
+void benchmark_code_generation(
+    mi::neuraylib::ITransaction* transaction,
+    mi::neuraylib::IMdl_compiler* mdl_compiler,
+    mi::neuraylib::IMdl_compiler::Mdl_backend_kind kind,
+    const std::vector<std::string>& compiled_materials,
+    const Options& options,
+    std::vector<Result>& results,
+    std::vector<mi::base::Handle<const mi::neuraylib::ITarget_code> >& target_codes,
+    std::vector<std::string>& target_code_materials)
+{
+    const bool native = kind == mi::neuraylib::IMdl_compiler::MB_NATIVE;
+    const char* workload = native ? "native_codegen" : "ptx_codegen";
+
+    mi::base::Handle<mi::neuraylib::IMdl_backend> backend(mdl_compiler->get_backend(kind));
+    check_success(backend->set_option("num_texture_spaces", "1") == 0);
+    if (!native)
+        check_success(backend->set_option("sm_version", "50") == 0);
+
+    std::vector<double> times;
+    std::vector<std::vector<double> > phase_times;
+    for (mi::Uint32 r = 0, n_r = get_repetitions(options, workload); r < n_r; ++r) {
+        target_codes.clear();
+        target_code_materials.clear();
+
+        double time = 0.0;
+        std::vector<double> phases;
+        for (size_t i = 0, n = compiled_materials.size(); i < n; ++i) {
+            mi::base::Handle<const mi::neuraylib::ICompiled_material> compiled_material(
+                transaction->access<mi::neuraylib::ICompiled_material>(
+                    compiled_materials[i].c_str()));
+
+            Timer timer;
+            mi::Sint32 result = -1;
+            mi::base::Handle<const mi::neuraylib::ITarget_code> target_code(
+                backend->translate_material_df(
+                    transaction, compiled_material.get(), "surface.scattering", "bsdf",
+                    /*include_geometry_normal=*/true, &result));
+            time += timer.elapsed_ms();
+
+            if (result != 0 || !target_code.is_valid_interface())
+                continue;
+
+            phases.resize(target_code->get_compile_phase_count(), 0.0);
+            for (mi::Size p = 0, n_p = phases.size(); p < n_p; ++p)
+                phases[p] += target_code->get_compile_phase_time(p) * 1000.0;
+
+            target_codes.push_back(target_code);
+            target_code_materials.push_back(compiled_materials[i]);
+        }
+        times.push_back(time);
+        phase_times.push_back(phases);
+    }
+    add_result(results, options, workload, target_codes.size(), times);
+
+    // report the phases which were recorded for the generated code
+    if (target_codes.empty())
+        return;
+    for (mi::Size p = 0, n_p = target_codes[0]->get_compile_phase_count(); p < n_p; ++p) {
+        std::vector<double> times_of_phase;
+        bool recorded = false;
+        for (size_t r = 0, n_r = phase_times.size(); r < n_r; ++r) {
+            double t = p < phase_times[r].size() ? phase_times[r][p] : 0.0;
+            recorded |= t > 0.0;
+            times_of_phase.push_back(t);
+        }
+        if (!recorded)
+            continue;
+
+        std::string name = std::string(workload) + "." +
+            target_codes[0]->get_compile_phase_name(p);
+        std::replace(name.begin(), name.end(), ' ', '_');
+        add_result(results, options, name, target_codes.size(), times_of_phase);
+    }
+}
+
+// Creates argument blocks for the class-compiled materials from their arguments.
+void benchmark_argument_blocks(
+    mi::neuraylib::ITransaction* transaction,
+    const std::vector<mi::base::Handle<const mi::neuraylib::ITarget_code> >& target_codes,
+    const std::vector<std::string>& target_code_materials,
+    const Options& options,
+    std::vector<Result>& results)
+{
+    if (!is_enabled(options, "argument_blocks"))
+        return;
+
+    std::vector<mi::base::Handle<const mi::neuraylib::ICompiled_material> > compiled_materials;
+    for (size_t i = 0, n = target_codes.size(); i < n; ++i)
+        compiled_materials.push_back(mi::base::make_handle(
+            transaction->access<mi::neuraylib::ICompiled_material>(
+                target_code_materials[i].c_str())));
+
+    std::vector<double> times;
+    mi::Size items = 0;
+    for (mi::Uint32 r = 0; r < options.repetitions; ++r) {
+        items = 0;
+
+        Timer timer;
+        for (size_t i = 0, n = target_codes.size(); i < n; ++i) {
+            if (target_codes[i]->get_argument_block_count() == 0)
+                continue;
+
+            for (mi::Uint32 k = 0; k < options.arg_blocks; ++k) {
+                mi::base::Handle<mi::neuraylib::ITarget_argument_block> arg_block(
+                    target_codes[i]->create_argument_block(
+                        0, compiled_materials[i].get(), /*resource_callback=*/NULL));
+                check_success(arg_block.is_valid_interface());
+                ++items;
+            }
+        }
+        times.push_back(timer.elapsed_ms());
+    }
+    add_result(results, options, "argument_blocks", items, times);
+}
+
+// Recompiles the material instances of the given target codes in class compilation mode, passing
+// the compiled materials the target codes were generated for, and updates their target code.
+// Target code is only regenerated if the recompiled material cannot reuse it, otherwise just a
+// new argument block is created.
+void benchmark_class_recompilation(
+    mi::neuraylib::ITransaction* transaction,
+    mi::neuraylib::IMdl_compiler* mdl_compiler,
+    const std::vector<mi::base::Handle<const mi::neuraylib::ITarget_code> >& target_codes,
+    const std::vector<std::string>& target_code_materials,
+    const Options& options,
+    std::vector<Result>& results)
+{
+    if (!is_enabled(options, "class_recompile"))
+        return;
+
+    mi::base::Handle<mi::neuraylib::IMdl_backend> backend(
+        mdl_compiler->get_backend(mi::neuraylib::IMdl_compiler::MB_NATIVE));
+    check_success(backend->set_option("num_texture_spaces", "1") == 0);
+
+    // the target code materials are named "class_compile of <instance>"
+    const std::string prefix = "class_compile of ";
+
+    std::vector<double> times;
+    mi::Size items = 0;
+    for (mi::Uint32 r = 0; r < options.repetitions; ++r) {
+        items = 0;
+
+        Timer timer;
+        for (size_t i = 0, n = target_codes.size(); i < n; ++i) {
+            const std::string& name = target_code_materials[i];
+            if (name.compare(0, prefix.size(), prefix) != 0)
+                continue;
+
+            mi::base::Handle<const mi::neuraylib::IMaterial_instance> material_instance(
+                transaction->access<mi::neuraylib::IMaterial_instance>(
+                    name.c_str() + prefix.size()));
+            if (!material_instance.is_valid_interface())
+                continue;
+
+            // the compiled material the target code was generated for
+            mi::base::Handle<const mi::neuraylib::ICompiled_material> previous(
+                transaction->access<mi::neuraylib::ICompiled_material>(name.c_str()));
+
+            mi::Sint32 result = -1;
+            bool target_code_reusable = false;
+            mi::base::Handle<mi::neuraylib::ICompiled_material> compiled_material(
+                material_instance->create_compiled_material(
+                    mi::neuraylib::IMaterial_instance::CLASS_COMPILATION, 1.0f, 380.0f, 780.0f,
+                    &result, previous.get(), &target_code_reusable));
+            if (result != 0 || !compiled_material.is_valid_interface())
+                continue;
+
+            if (target_code_reusable) {
+                if (target_codes[i]->get_argument_block_count() > 0) {
+                    mi::base::Handle<mi::neuraylib::ITarget_argument_block> arg_block(
+                        target_codes[i]->create_argument_block(
+                            0, compiled_material.get(), /*resource_callback=*/NULL));
+                    check_success(arg_block.is_valid_interface());
+                }
+            } else {
+                mi::base::Handle<const mi::neuraylib::ITarget_code> target_code(
+                    backend->translate_material_df(
+                        transaction, compiled_material.get(), "surface.scattering", "bsdf",
+                        /*include_geometry_normal=*/true, &result));
+                check_success(result == 0 && target_code.is_valid_interface());
+            }
+            ++items;
+        }
+        times.push_back(timer.elapsed_ms());
+    }
+    add_result(results, options, "class_recompile", items, times);
+}
+
+// Runs the init, sample, and evaluate functions of the native BSDFs at random surface points,
+// one shading point per sample.
+void benchmark_native_execution(
+    const std::vector<mi::base::Handle<const mi::neuraylib::ITarget_code> >& target_codes,
+    const Options& options,
+    std::vector<Result>& results)
+{
+    if (!is_enabled(options, "native_execution"))
+        return;
+
+    mi::Float32_3_struct texture_coords[1]    = { { 0.0f, 0.0f, 0.0f } };
+    mi::Float32_3_struct texture_tangent_u[1] = { { 1.0f, 0.0f, 0.0f } };
+    mi::Float32_3_struct texture_tangent_v[1] = { { 0.0f, 1.0f, 0.0f } };
+    mi::Float32_4_4 identity(
+        1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, 1.0f, 0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f
+    );
+    mi::neuraylib::Shading_state_material mdl_state = {
+        /*normal=*/           { 0.0f, 0.0f, 1.0f },
+        /*geom_normal=*/      { 0.0f, 0.0f, 1.0f },
+        /*position=*/         { 0.0f, 0.0f, 0.0f },
+        /*animation_time=*/   0.0f,
+        /*texture_coords=*/   texture_coords,
+        /*tangent_u=*/        texture_tangent_u,
+        /*tangent_v=*/        texture_tangent_v,
+        /*text_results=*/     NULL,
+        /*ro_data_segment=*/  NULL,
+        /*world_to_object=*/  &identity[0],
+        /*object_to_world=*/  &identity[0],
+        /*object_id=*/        0
+    };
+
+    // the outgoing direction, 30 degrees off the normal
+    const mi::Float32_3_struct k1 = { 0.5f, 0.0f, 0.8660254f };
+    const mi::Float32_3_struct ior1 = { 1.0f, 1.0f, 1.0f };
+    const mi::Float32_3_struct ior2 = {
+        MI_NEURAYLIB_BSDF_USE_MATERIAL_IOR,
+        MI_NEURAYLIB_BSDF_USE_MATERIAL_IOR,
+        MI_NEURAYLIB_BSDF_USE_MATERIAL_IOR };
+
+    std::vector<double> times;
+    mi::Size items = 0;
+    for (mi::Uint32 r = 0; r < options.repetitions; ++r) {
+        items = 0;
+
+        Timer timer;
+        for (size_t i = 0, n = target_codes.size(); i < n; ++i) {
+            const mi::neuraylib::ITarget_code* target_code = target_codes[i].get();
+
+            Random rng;
+            for (mi::Uint32 s = 0; s < options.samples; ++s) {
+                float u = rng.next();
+                float v = rng.next();
+
+                mdl_state.normal.x = 0.0f;
+                mdl_state.normal.y = 0.0f;
+                mdl_state.normal.z = 1.0f;
+                mdl_state.position.x = 2.0f * u - 1.0f;
+                mdl_state.position.y = 2.0f * v - 1.0f;
+                texture_coords[0].x = u;
+                texture_coords[0].y = v;
+
+                // the functions are generated in the order init, sample, evaluate, pdf
+                if (target_code->execute_bsdf_init(0, mdl_state, NULL) != 0)
+                    break;
+
+                mi::neuraylib::Bsdf_sample_data sample_data;
+                sample_data.ior1 = ior1;
+                sample_data.ior2 = ior2;
+                sample_data.k1 = k1;
+                sample_data.xi.x = rng.next();
+                sample_data.xi.y = rng.next();
+                sample_data.xi.z = rng.next();
+                if (target_code->execute_bsdf_sample(1, &sample_data, mdl_state, NULL) != 0)
+                    break;
+
+                mi::neuraylib::Bsdf_evaluate_data eval_data;
+                eval_data.ior1 = ior1;
+                eval_data.ior2 = ior2;
+                eval_data.k1 = k1;
+                eval_data.k2 = sample_data.event_type != mi::neuraylib::BSDF_EVENT_ABSORB
+                    ? sample_data.k2 : mdl_state.normal;
+                if (target_code->execute_bsdf_evaluate(2, &eval_data, mdl_state, NULL) != 0)
+                    break;
+
+                ++items;
+            }
+        }
+        times.push_back(timer.elapsed_ms());
+    }
+    add_result(results, options, "native_execution", items, times);
+}
+
+// Resolves the overloads of all functions of the standard modules for argument lists built
+// from the parameter types of each overload.
+void benchmark_overload_resolution(
+    mi::neuraylib::ITransaction* transaction,
+    mi::neuraylib::IMdl_compiler* mdl_compiler,
+    mi::neuraylib::IMdl_factory* mdl_factory,
+    const Options& options,
+    std::vector<Result>& results)
+{
+    if (!is_enabled(options, "overload_resolution"))
+        return;
+
+    mi::base::Handle<mi::neuraylib::IValue_factory> value_factory(
+        mdl_factory->create_value_factory(transaction));
+    mi::base::Handle<mi::neuraylib::IExpression_factory> expression_factory(
+        mdl_factory->create_expression_factory(transaction));
+
+    // prepare the queries outside of the measurement
+    std::vector<mi::base::Handle<const mi::neuraylib::IModule> > modules;
+    std::vector<std::string> names;
+    std::vector<mi::base::Handle<const mi::neuraylib::IExpression_list> > arguments;
+
+    const mi::Size module_count = sizeof(g_overload_modules) / sizeof(g_overload_modules[0]);
+    for (mi::Size i = 0; i < module_count; ++i) {
+        check_success(mdl_compiler->load_module(transaction, g_overload_modules[i]) >= 0);
+
+        std::string module_db_name = std::string("mdl") + g_overload_modules[i];
+        mi::base::Handle<const mi::neuraylib::IModule> module(
+            transaction->access<mi::neuraylib::IModule>(module_db_name.c_str()));
+        check_success(module.is_valid_interface());
+
+        for (mi::Size j = 0, n = module->get_function_count(); j < n; ++j) {
+            const char* function_name = module->get_function(j);
+            mi::base::Handle<const mi::neuraylib::IFunction_definition> function_definition(
+                transaction->access<mi::neuraylib::IFunction_definition>(function_name));
+            mi::base::Handle<const mi::neuraylib::IType_list> types(
+                function_definition->get_parameter_types());
+
+            mi::base::Handle<mi::neuraylib::IExpression_list> args(
+                expression_factory->create_expression_list());
+            bool valid = true;
+            for (mi::Size p = 0, n_p = function_definition->get_parameter_count(); p < n_p; ++p) {
+                mi::base::Handle<const mi::neuraylib::IType> type(types->get_type(p));
+                mi::base::Handle<mi::neuraylib::IValue> value(value_factory->create(type.get()));
+                if (!value.is_valid_interface()) {
+                    valid = false;
+                    break;
+                }
+                mi::base::Handle<mi::neuraylib::IExpression> expr(
+                    expression_factory->create_constant(value.get()));
+                args->add_expression(function_definition->get_parameter_name(p), expr.get());
+            }
+            if (!valid)
+                continue;
+
+            std::string name = function_name;
+            name = name.substr(0, name.find('('));
+
+            modules.push_back(module);
+            names.push_back(name);
+            arguments.push_back(mi::base::make_handle_dup<const mi::neuraylib::IExpression_list>(
+                args.get()));
+        }
+    }
+
+    std::vector<double> times;
+    for (mi::Uint32 r = 0; r < options.repetitions; ++r) {
+        Timer timer;
+        for (size_t i = 0, n = names.size(); i < n; ++i) {
+            mi::base::Handle<const mi::IArray> overloads(
+                modules[i]->get_function_overloads(names[i].c_str(), arguments[i].get()));
+            check_success(overloads.is_valid_interface());
+        }
+        times.push_back(timer.elapsed_ms());
+    }
+    add_result(results, options, "overload_resolution", names.size(), times);
+}
+
+// Estimates the integral of a light profile over the sphere by uniform sphere sampling and by
+// importance sampling with ILightprofile::sample_direction(). The latter uses the sampling tables
+// that are shared with the native runtime (lp_sample()), built once per light profile.
+void benchmark_light_profile(
+    mi::neuraylib::ITransaction* transaction,
+    const Options& options,
+    std::vector<Result>& results)
+{
+    bool uniform = is_enabled(options, "lightprofile_uniform_sphere");
+    bool importance = is_enabled(options, "lightprofile_importance_sample");
+    if (!uniform && !importance)
+        return;
+
+    mi::base::Handle<mi::neuraylib::ILightprofile> light_profile(
+        transaction->create<mi::neuraylib::ILightprofile>("Lightprofile"));
+    std::string filename =
+        get_samples_mdl_root() + "/nvidia/sdk_examples/resources/example_modules.ies";
+    check_success(light_profile->reset_file(filename.c_str()) == 0);
+
+    const float pi = 3.14159265358979f;
+
+    if (uniform) {
+        std::vector<double> times;
+        for (mi::Uint32 r = 0; r < options.repetitions; ++r) {
+            Random rng;
+            double sum = 0.0;
+
+            Timer timer;
+            for (mi::Uint32 s = 0; s < options.samples; ++s) {
+                float phi = 2.0f * pi * rng.next();
+                float theta = acosf(1.0f - 2.0f * rng.next());
+                sum += light_profile->sample(phi, theta, /*candela=*/false) * (4.0f * pi);
+            }
+            times.push_back(timer.elapsed_ms());
+
+            check_success(sum >= 0.0);
+        }
+        add_result(results, options, "lightprofile_uniform_sphere", options.samples, times);
+    }
+
+    if (importance) {
+        // the sampling tables have been built by reset_file(), check that they are not empty
+        float phi, theta;
+        check_success(light_profile->sample_direction(0.5f, 0.5f, &phi, &theta) > 0.0f);
+
+        std::vector<double> times;
+        for (mi::Uint32 r = 0; r < options.repetitions; ++r) {
+            Random rng;
+            double sum = 0.0;
+
+            Timer timer;
+            for (mi::Uint32 s = 0; s < options.samples; ++s) {
+                float xi_phi = rng.next();
+                float xi_theta = rng.next();
+                float p = light_profile->sample_direction(xi_phi, xi_theta, &phi, &theta);
+                if (p > 0.0f)
+                    sum += light_profile->sample(phi, theta, /*candela=*/false) / p;
+            }
+            times.push_back(timer.elapsed_ms());
+
+            check_success(sum >= 0.0);
+        }
+        add_result(results, options, "lightprofile_importance_sample", options.samples, times);
+    }
+}
+
+static void usage(const char *name)
+{
+    std::cout
+        << "usage: " << name << " [options]\n"
+        << "-h                 print this text\n"
+        << "-r <num>           number of repetitions of each workload (default: 5)\n"
+        << "-n <num>           number of samples of the sampling workloads (default: 65536)\n"
+        << "-a <num>           number of argument blocks created per material (default: 1000)\n"
+        << "-w <prefix>        only report workloads whose name starts with <prefix>\n"
+        << "-m <substring>     only use materials whose DB name contains <substring>\n"
+        << "-o <outputfile>    file to write the results to (default: stdout)\n";
+
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char* argv[])
+{
+    // Parse commandline options
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const char *opt = argv[i];
+        if (strcmp(opt, "-r") == 0 && i < argc - 1) {
+            options.repetitions = mi::Uint32(std::max(atoi(argv[++i]), 1));
+        } else if (strcmp(opt, "-n") == 0 && i < argc - 1) {
+            options.samples = mi::Uint32(std::max(atoi(argv[++i]), 1));
+        } else if (strcmp(opt, "-a") == 0 && i < argc - 1) {
+            options.arg_blocks = mi::Uint32(std::max(atoi(argv[++i]), 1));
+        } else if (strcmp(opt, "-w") == 0 && i < argc - 1) {
+            options.filter = argv[++i];
+        } else if (strcmp(opt, "-m") == 0 && i < argc - 1) {
+            options.material_filter = argv[++i];
+        } else if (strcmp(opt, "-o") == 0 && i < argc - 1) {
+            options.output_file = argv[++i];
+        } else
+            usage(argv[0]);
+    }
+
+    // Access the MDL SDK
+    mi::base::Handle<mi::neuraylib::INeuray> neuray(load_and_get_ineuray());
+    check_success(neuray.is_valid_interface());
+
+    // Configure the MDL SDK
+    configure(neuray.get());
+
+    // Start the MDL SDK
+    mi::Sint32 result = neuray->start();
+    check_start_success(result);
+
+    std::vector<Result> results;
+    {
+        mi::base::Handle<mi::neuraylib::IMdl_compiler> mdl_compiler(
+            neuray->get_api_component<mi::neuraylib::IMdl_compiler>());
+        mi::base::Handle<mi::neuraylib::IMdl_factory> mdl_factory(
+            neuray->get_api_component<mi::neuraylib::IMdl_factory>());
+        mi::base::Handle<mi::neuraylib::IDatabase> database(
+            neuray->get_api_component<mi::neuraylib::IDatabase>());
+
+        // Module loading uses its own scopes and must run before the modules are loaded into
+        // the global scope
+        benchmark_module_loading(database.get(), mdl_compiler.get(), options, results);
+
+        mi::base::Handle<mi::neuraylib::IScope> scope(database->get_global_scope());
+        mi::base::Handle<mi::neuraylib::ITransaction> transaction(scope->create_transaction());
+
+        {
+            std::vector<std::string> materials;
+            collect_materials(transaction.get(), mdl_compiler.get(), options, materials);
+
+            std::vector<std::string> instances;
+            benchmark_instantiation(transaction.get(), materials, options, results, instances);
+
+            std::vector<std::string> instance_compiled, class_compiled;
+            benchmark_compilation(
+                transaction.get(), instances, false, options, results, instance_compiled);
+            benchmark_compilation(
+                transaction.get(), instances, true, options, results, class_compiled);
+
+            std::vector<mi::base::Handle<const mi::neuraylib::ITarget_code> > native_codes;
+            std::vector<std::string> native_code_materials;
+            benchmark_code_generation(
+                transaction.get(), mdl_compiler.get(), mi::neuraylib::IMdl_compiler::MB_NATIVE,
+                class_compiled, options, results, native_codes, native_code_materials);
+
+            std::vector<mi::base::Handle<const mi::neuraylib::ITarget_code> > ptx_codes;
+            std::vector<std::string> ptx_code_materials;
+            benchmark_code_generation(
+                transaction.get(), mdl_compiler.get(), mi::neuraylib::IMdl_compiler::MB_CUDA_PTX,
+                class_compiled, options, results, ptx_codes, ptx_code_materials);
+
+            benchmark_argument_blocks(
+                transaction.get(), native_codes, native_code_materials, options, results);
+            benchmark_class_recompilation(
+                transaction.get(), mdl_compiler.get(), native_codes, native_code_materials,
+                options, results);
+            benchmark_native_execution(native_codes, options, results);
+
+            benchmark_overload_resolution(
+                transaction.get(), mdl_compiler.get(), mdl_factory.get(), options, results);
+            benchmark_light_profile(transaction.get(), options, results);
+        }
+
+        transaction->commit();
+    }
+
+    // Shut down the MDL SDK
+    check_success(neuray->shutdown() == 0);
+    neuray = 0;
+
+    // Unload the MDL SDK
+    check_success(unload());
+
+    // Print the results
+    if (options.output_file.empty()) {
+        print_results(std::cout, results);
+    } else {
+        std::ofstream file(options.output_file.c_str());
+        check_success(file.is_open());
+        print_results(file, results);
+    }
+
+    return EXIT_SUCCESS;
+}
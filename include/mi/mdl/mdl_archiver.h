@@ -268,6 +268,10 @@ public:
     /// The name of the option to specify resource suffixes that should be compressed.
     #define MDL_ARC_OPTION_COMPRESS_SUFFIXES "compress_suffixes"
 
+    /// The name of the option to set the number of threads used to compile the modules and
+    /// to compress the entries of a new archive. The archive does not depend on this number.
+    #define MDL_ARC_OPTION_THREADS "threads"
+
     /// An entry into the manifest.
     struct Key_value_entry {
         char const *key;
@@ -381,5 +385,10 @@ public:
  *   - <b>compress_suffixes:</b> This option allows to specify a comma separated list of
  *     file extentions that should be stored uncompressed inside an MDL archive.
  *     Default: ".ies,.mbsdf,.txt,.html"
+ *
+ *   \anchor mdl_archive_tool_option_threads
+ *   - <b>threads:</b> The number of threads used to compile the modules and to compress the
+ *     entries of a new archive. If set to "0", one thread per hardware thread is used.
+ *     Default: "0"
  */
 #endif // MDL_MDL_ARCHIEVER_H
@@ -735,6 +735,12 @@ public:
     /// The name of the option to forbid local functions inside material bodies.
     #define MDL_CG_DAG_OPTION_NO_LOCAL_FUNC_CALLS "no_local_func_calls"
 
+    /// The name of the option to set the number of threads used to compile the materials
+    /// of a module. The result does not depend on this number. The threads besides the calling
+    /// thread are taken from a budget of hardware threads shared by all concurrent compilations
+    /// of the process, so fewer threads might be used.
+    #define MDL_CG_DAG_OPTION_COMPILE_THREADS "compile_threads"
+
     /// Compile a module.
     /// \param      module  The module to compile.
     /// \returns            The generated code.
@@ -788,15 +794,27 @@ class ICode_generator_jit : public
     /// The name of the option to include the uniform state in the MDL state.
     #define MDL_JIT_OPTION_INCLUDE_UNIFORM_STATE "jit_include_uniform_state"
 
+    /// The name of the option to compile native code lazily on the first call of a function.
+    #define MDL_JIT_OPTION_LAZY_COMPILATION "jit_lazy_compilation"
+
     /// The name of the option to steer linking of libdevice.
     #define MDL_JIT_OPTION_LINK_LIBDEVICE "jit_link_libdevice"
 
     /// The name of the option to map strings to IDs.
     #define MDL_JIT_OPTION_MAP_STRINGS_TO_IDS "jit_map_strings_to_ids"
 
+    /// The name of the option to set the directory of the persistent native object code cache.
+    #define MDL_JIT_OPTION_OBJECT_CACHE_DIR "jit_object_cache_dir"
+
     /// The name of the option to set the optimization level of the JIT code generator.
     #define MDL_JIT_OPTION_OPT_LEVEL "jit_opt_level"
 
+    /// The name of the option to set the CPU native code is generated for.
+    #define MDL_JIT_OPTION_TARGET_CPU "jit_target_cpu"
+
+    /// The name of the option to set additional target features for native code.
+    #define MDL_JIT_OPTION_TARGET_FEATURES "jit_target_features"
+
     /// The name of the option that steers the call mode for the GPU texture lookup.
     #define MDL_JIT_OPTION_TEX_LOOKUP_CALL_MODE "jit_tex_lookup_call_mode"
 
@@ -1078,10 +1096,14 @@ These options are specific to the MDL JIT code generator:
 - \ref mdl_option_jit_enable_ro_segment      "jit_enable_ro_segment"
 - \ref mdl_option_jit_fast_math              "jit_fast_math"
 - \ref mdl_option_jit_include_uniform_state  "jit_include_uniform_state"
+- \ref mdl_option_jit_lazy_compilation       "jit_lazy_compilation"
 - \ref mdl_option_jit_link_libdevice         "jit_link_libdevice"
 - \ref mdl_option_jit_llvm_state_module      "jit_llvm_state_module"
 - \ref mdl_option_jit_map_strings_to_ids     "jit_map_strings_to_ids"
+- \ref mdl_option_jit_object_cache_dir       "jit_object_cache_dir"
 - \ref mdl_option_jit_opt_level              "jit_opt_level"
+- \ref mdl_option_jit_target_cpu             "jit_target_cpu"
+- \ref mdl_option_jit_target_features        "jit_target_features"
 - \ref mdl_option_jit_tex_lookup_call_mode   "jit_tex_lookup_call_mode"
 - \ref mdl_option_jit_use_bitangent          "jit_use_bitangent"
 - \ref mdl_option_jit_write_bitcode          "jit_write_bitcode"
@@ -1149,6 +1171,13 @@ These options are specific to the MDL JIT code generator:
   so setting this option does not have any effect in most cases.
   Default: \c "false"
 
+\anchor mdl_option_jit_lazy_compilation
+- <b>jit_lazy_compilation</b>: If set to \c "true", native code is not compiled ahead of time.
+  Instead, the entry points are stubs that compile a function on its first call. This reduces
+  the compile time for materials of which only a few functions are ever executed. Ignored for
+  PTX and LLVM IR output.
+  Default: \c "false"
+
 \anchor mdl_option_jit_link_libdevice
 - <b>jit_link_libdevice</b>: If set to \c "true", a built-in version of CUDA's libdevice will be
   linked before generating PTX code.
@@ -1162,10 +1191,31 @@ These options are specific to the MDL JIT code generator:
 - <b>jit_map_strings_to_ids</b>: If set to \c "true", strings become mapped to 32-bit IDs.
   Default: \c "false"
 
+\anchor mdl_option_jit_object_cache_dir
+- <b>jit_object_cache_dir</b>: If set to a non-empty directory name, the native object code of
+  every compiled module is stored in this directory and reused by later compilations (also in
+  other processes) of identical LLVM modules for the same host CPU and SDK build, skipping LLVM
+  code generation. Ignored for PTX and LLVM IR output and if lazy compilation is enabled.
+  Default: \c ""
+
 \anchor mdl_option_jit_opt_level
 - <b>jit_opt_level</b>: The optimization level for the JIT code generator.
   Default: \c "2"
 
+\anchor mdl_option_jit_target_cpu
+- <b>jit_target_cpu</b>: The CPU native code is tuned for. Either \c "host" for the CPU of the
+  running machine or an LLVM CPU name like \c "haswell" or \c "skylake-avx512". If set, the loop
+  and SLP vectorizers run with the cost model of this CPU, fast-math enables fused multiply-adds
+  and every module gets its own execution engine. An unknown CPU name results in a warning and
+  generic code. Ignored for PTX and LLVM IR output and if lazy compilation is enabled.
+  Default: \c "" (generic code of the built-in JIT)
+
+\anchor mdl_option_jit_target_features
+- <b>jit_target_features</b>: A comma separated list of LLVM target features enabled (\c "+")
+  or disabled (\c "-") in addition to the ones of <b>jit_target_cpu</b>, for example
+  \c "+avx2,+fma" or \c "-avx512f". Only used, if <b>jit_target_cpu</b> is set.
+  Default: \c ""
+
 \anchor mdl_option_jit_tex_lookup_call_mode
 - <b>jit_tex_lookup_call_mode</b>: Specifies the call mode for texture lookup functions on GPU.
   Possible values:
@@ -34,6 +34,7 @@
 #include <mi/base/interface_declare.h>
 
 #include <mi/mdl/mdl_definitions.h>
+#include <mi/mdl/mdl_statistics.h>
 
 namespace mi {
 namespace mdl {
@@ -43,7 +44,7 @@ class Messages;
 
 /// Generic interface for generated code of a MDL Core backend.
 class IGenerated_code : public
-    mi::base::Interface_declare<0x73d763a2,0x8038,0x45c2,0xbb,0x71,0x3e,0xc4,0x68,0x7e,0x7e,0x0c,
+    mi::base::Interface_declare<0x73d763a2,0x8038,0x45c2,0xbb,0x71,0x3e,0xc4,0x68,0x7e,0x7e,0x0d,
     mi::base::IInterface>
 {
 public:
@@ -71,6 +72,11 @@ public:
 
     /// Access messages.
     virtual Messages const &access_messages() const = 0;
+
+    /// Access the per-phase statistics of the phases that produced this code.
+    ///
+    /// For DAG code, this includes the front-end phases of the module.
+    virtual Compile_statistics const &access_statistics() const = 0;
 };
 
 /// Cast to subtype or return NULL if types do not match.
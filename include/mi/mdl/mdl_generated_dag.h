@@ -359,7 +359,7 @@ public:
 /// This object can be generated via ICode_generator_dag::compile() from a module
 /// loaded via IMDL::load_module().
 class IGenerated_code_dag : public
-    mi::base::Interface_declare<0x9dbfd12e,0x8207,0x4a47,0x8c,0x1f,0x5f,0x9a,0xc4,0x9b,0x00,0xf6,
+    mi::base::Interface_declare<0x9dbfd12e,0x8207,0x4a47,0x8c,0x1f,0x5f,0x9a,0xc4,0x9b,0x00,0xf7,
     IGenerated_code>
 {
 public:
@@ -451,7 +451,7 @@ public:
     ///  - Call IGenerated_code_dag::IMaterial_instance::initialize().
     class IMaterial_instance : public
         mi::base::Interface_declare
-        <0x29c36255,0x7558,0x4865,0xa7,0x7e,0xaa,0x3a,0x50,0x4f,0x70,0xbc,
+        <0x29c36255,0x7558,0x4865,0xa7,0x7e,0xaa,0x3a,0x50,0x4f,0x70,0xbd,
         IDag_builder>
     {
     public:
@@ -658,6 +658,12 @@ public:
         /// Access messages.
         virtual Messages const &access_messages() const = 0;
 
+        /// Access the statistics of this instance.
+        ///
+        /// Contains only the initialization of the instance. The phases that produced the DAG
+        /// of its module are reported by IGenerated_code_dag::access_statistics().
+        virtual Compile_statistics const &access_statistics() const = 0;
+
         /// Get the instance properties.
         virtual Properties get_properties() const = 0;
     };
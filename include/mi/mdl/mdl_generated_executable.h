@@ -139,7 +139,7 @@ public:
 
 /// The base executable code interface.
 class IGenerated_code_executable : public
-    mi::base::Interface_declare<0x11c439a5,0x3eaf,0x4e48,0x8b,0xd3,0xb2,0x23,0x3e,0x6a,0x79,0x68,
+    mi::base::Interface_declare<0x11c439a5,0x3eaf,0x4e48,0x8b,0xd3,0xb2,0x23,0x3e,0x6a,0x79,0x69,
     IGenerated_code>
 {
 public:
@@ -871,6 +871,86 @@ public:
     /// \return True if bm_data represents a valid bsdf measurement, false otherwise.
     virtual bool bm_isvalid(
         void const *bm_data) const = 0;
+
+    /// Evaluate a measured BSDF.
+    ///
+    /// \param result         the RGB value of the BSDF
+    /// \param bm_data        the read-only shared bsdf measurement data pointer
+    /// \param thread_data    extra per-thread data that was passed to the lambda function
+    /// \param theta_phi_in   the incoming direction, theta in [0, pi/2]
+    /// \param theta_phi_out  the outgoing direction, theta in [0, pi/2]
+    /// \param part           0 for the reflection and 1 for the transmission part
+    ///
+    /// The default implementation returns black.
+    virtual void bm_evaluate(
+        float       result[3],
+        void const  *bm_data,
+        void        *thread_data,
+        float const theta_phi_in[2],
+        float const theta_phi_out[2],
+        unsigned    part) const
+    {
+        result[0] = result[1] = result[2] = 0.0f;
+    }
+
+    /// Importance sample an outgoing direction of a measured BSDF.
+    ///
+    /// \param result        the sampled theta and phi and the pdf with respect to solid angle
+    /// \param bm_data       the read-only shared bsdf measurement data pointer
+    /// \param thread_data   extra per-thread data that was passed to the lambda function
+    /// \param theta_phi_in  the incoming direction, theta in [0, pi/2]
+    /// \param xi            three uniformly distributed random numbers in [0, 1)
+    /// \param part          0 for the reflection and 1 for the transmission part
+    ///
+    /// The default implementation returns a pdf of zero, so no direction is sampled.
+    virtual void bm_sample(
+        float       result[3],
+        void const  *bm_data,
+        void        *thread_data,
+        float const theta_phi_in[2],
+        float const xi[3],
+        unsigned    part) const
+    {
+        result[0] = result[1] = result[2] = 0.0f;
+    }
+
+    /// Get the pdf with respect to solid angle of bm_sample() for the given directions.
+    ///
+    /// \param bm_data        the read-only shared bsdf measurement data pointer
+    /// \param thread_data    extra per-thread data that was passed to the lambda function
+    /// \param theta_phi_in   the incoming direction, theta in [0, pi/2]
+    /// \param theta_phi_out  the outgoing direction, theta in [0, pi/2]
+    /// \param part           0 for the reflection and 1 for the transmission part
+    ///
+    /// \return The pdf of bm_sample() for the directions, the default implementation
+    ///         returns zero.
+    virtual float bm_pdf(
+        void const  *bm_data,
+        void        *thread_data,
+        float const theta_phi_in[2],
+        float const theta_phi_out[2],
+        unsigned    part) const
+    {
+        return 0.0f;
+    }
+
+    /// Get the directional albedos of a measured BSDF.
+    ///
+    /// \param result        the reflection albedo for theta_phi_in and its maximum, followed
+    ///                      by the same values of the transmission part
+    /// \param bm_data       the read-only shared bsdf measurement data pointer
+    /// \param thread_data   extra per-thread data that was passed to the lambda function
+    /// \param theta_phi_in  the incoming direction, theta in [0, pi/2]
+    ///
+    /// The default implementation returns zero albedos.
+    virtual void bm_albedos(
+        float       result[4],
+        void const  *bm_data,
+        void        *thread_data,
+        float const theta_phi_in[2]) const
+    {
+        result[0] = result[1] = result[2] = result[3] = 0.0f;
+    }
 };
 
 /// Executable code of a compiled lambda function.
@@ -881,7 +961,7 @@ public:
 /// code.
 /// If compiled for GPU execution only PTX code is provided.
 class IGenerated_code_lambda_function : public
-    mi::base::Interface_declare<0x7e100527,0x0ae6,0x46e3,0x83,0x7a,0x45,0x84,0x99,0x4f,0xe4,0x22,
+    mi::base::Interface_declare<0x7e100527,0x0ae6,0x46e3,0x83,0x7a,0x45,0x84,0x99,0x4f,0xe4,0x23,
     IGenerated_code_executable>
 {
 public:
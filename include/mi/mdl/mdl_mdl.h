@@ -106,7 +106,7 @@ public:
 ///
 /// An IMDL interface can be obtained by calling the mi_mdl_factory() function.
 class IMDL : public
-    mi::base::Interface_declare<0x6af90e47,0xb232,0x4567,0xa7,0x54,0x5d,0xce,0x7b,0x3e,0x0a,0x76,
+    mi::base::Interface_declare<0x6af90e47,0xb232,0x4567,0xa7,0x54,0x5d,0xce,0x7b,0x3e,0x0a,0x77,
     mi::base::IInterface>
 {
 public:
@@ -152,6 +152,9 @@ public:
     /// The value of \c state::WAVELENGTH_BASE_MAX.
     #define MDL_OPTION_STATE_WAVELENGTH_BASE_MAX "state::WAVELENGTH_BASE_MAX"
 
+    /// The maximum age of cached file resolution results in seconds.
+    #define MDL_OPTION_FILE_RESOLUTION_CACHE_TTL "file_resolution_cache_ttl"
+
 
 public:
     /// Get the type factory of the compiler.
@@ -461,6 +464,16 @@ public:
     ///
     /// The archive tool is used to create and unpack MDL archives.
     virtual IArchive_tool *create_archive_tool() = 0;
+
+    /// Drop all cached file resolution results.
+    ///
+    /// The compiler remembers the results of search path lookups, including lookups that did
+    /// not find anything, and the central directories of MDL archives. The cache is dropped
+    /// automatically if the search paths change, and lookups older than the time given by the
+    /// \ref mdl_option_file_resolution_cache_ttl "file_resolution_cache_ttl" option are
+    /// repeated. Call this method if files were added to or removed from the search paths and
+    /// the change must be seen immediately.
+    virtual void clear_file_resolution_cache() = 0;
 };
 
 
@@ -474,6 +487,7 @@ These options are specific to the MDL compiler:
 
 - \ref mdl_option_dump_call_graph "dump_call_graph"
 - \ref mdl_option_dump_dependence_graph "dump_dependence_graph"
+- \ref mdl_option_file_resolution_cache_ttl "file_resolution_cache_ttl"
 - \ref mdl_option_opt_level "opt_level"
 - \ref mdl_option_warn "warning"
 
@@ -497,6 +511,12 @@ These options set render specific constants in the standard library:
 - <b>dump_dependence_graph:</b> If set to "true", the compiler will dump the dependence graph for
   every analyzed function. Default: "false"
 
+\anchor mdl_option_file_resolution_cache_ttl
+- <b>file_resolution_cache_ttl:</b> The maximum age in seconds of cached search path lookups.
+  Older results are searched again, so files added to or removed from the search paths are
+  noticed. If set to "0", results are kept until the search paths change or
+  #mi::mdl::IMDL::clear_file_resolution_cache() is called. Default: "2"
+
 \anchor mdl_option_opt_level
 - <b>opt_level:</b> Specifies the optimization level.
   Possible values are:
@@ -65,6 +65,24 @@ public:
     ///
     /// \note  The module must be returned with increased reference count.
     virtual IModule const *lookup(char const *absname) const = 0;
+
+    /// Announce that the compiler is going to compile a module not found by lookup().
+    ///
+    /// Caches shared by several threads can use this to let other threads wait for the
+    /// module instead of compiling it a second time. Every call that returns NULL is followed
+    /// by a call to loaded() for the same module.
+    ///
+    /// \param absname  the absolute name of the MDL module
+    ///
+    /// \return  NULL if the caller should compile the module, otherwise the module compiled
+    ///          by another thread in the meantime, with increased reference count.
+    virtual IModule const *begin_loading(char const *absname) { return NULL; }
+
+    /// Report the result of a compilation announced by begin_loading().
+    ///
+    /// \param absname  the absolute name of the MDL module
+    /// \param module   the compiled module or NULL if the compilation failed
+    virtual void loaded(char const *absname, IModule const *module) {}
 };
 
 /// Helper interface to represent an overload resolution result set returned by
@@ -0,0 +1,153 @@
+/******************************************************************************
+ * Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+/// \file mi/mdl/mdl_statistics.h
+/// \brief Per-phase compilation statistics of the MDL Core compiler and its backends
+#ifndef MDL_STATISTICS_H
+#define MDL_STATISTICS_H 1
+
+#include <cstddef>
+
+namespace mi {
+namespace mdl {
+
+/// The phases of the material pipeline for which statistics are recorded.
+///
+/// Phases may nest: the AT analysis runs inside the NT analysis, and modules imported
+/// during the NT analysis are parsed and analyzed inside it.
+enum Compile_phase {
+    CP_PARSER,                  ///< Scanning and parsing of a module.
+    CP_NT_ANALYSIS,             ///< Name and type analysis.
+    CP_SEMA_ANALYSIS,           ///< Semantic analysis.
+    CP_AT_ANALYSIS,             ///< Auto-type analysis.
+    CP_OPTIMIZER,               ///< The AST optimizer.
+    CP_DAG_GENERATION,          ///< Conversion of a module into the DAG representation.
+    CP_INSTANCE_INITIALIZE,     ///< Initialization of a material instance.
+    CP_LAMBDA_CONVERSION,       ///< Conversion of a compiled material into lambda functions.
+    CP_LLVM_OPTIMIZATION,       ///< Optimization of the generated LLVM IR.
+    CP_CODE_EMISSION,           ///< Emission of native, PTX or LLVM IR code.
+    CP_LAST = CP_CODE_EMISSION
+};
+
+/// The statistics of one compilation phase.
+struct Phase_statistics {
+    /// Constructor.
+    Phase_statistics()
+    : wall_time(0.0)
+    , allocated_bytes(0)
+    , node_count(0)
+    , invocations(0)
+    {
+    }
+
+    double wall_time;        ///< Accumulated wall clock time in seconds.
+    size_t allocated_bytes;  ///< Accumulated size of the memory arena chunks allocated.
+    size_t node_count;       ///< Accumulated number of AST, DAG or LLVM nodes produced.
+    size_t invocations;      ///< Number of times the phase was run.
+};
+
+/// Accumulated statistics of all compilation phases.
+///
+/// Recording is not synchronized, every object is owned by one thread context or one
+/// compilation result.
+class Compile_statistics {
+public:
+    /// Get the statistics of a phase.
+    Phase_statistics const &get(Compile_phase phase) const { return m_phases[phase]; }
+
+    /// Record one run of a phase.
+    ///
+    /// \param phase            the phase
+    /// \param wall_time        the wall clock time in seconds
+    /// \param allocated_bytes  the arena memory allocated by this run
+    /// \param node_count       the number of nodes produced by this run
+    void record(
+        Compile_phase phase,
+        double        wall_time,
+        size_t        allocated_bytes,
+        size_t        node_count)
+    {
+        Phase_statistics &s = m_phases[phase];
+        s.wall_time       += wall_time;
+        s.allocated_bytes += allocated_bytes;
+        s.node_count      += node_count;
+        s.invocations     += 1;
+    }
+
+    /// Replace the statistics of a phase, used when restoring serialized statistics.
+    ///
+    /// \param phase  the phase
+    /// \param stats  the new statistics of the phase
+    void set(Compile_phase phase, Phase_statistics const &stats) { m_phases[phase] = stats; }
+
+    /// Add the statistics of another object.
+    void merge(Compile_statistics const &other)
+    {
+        for (size_t i = 0; i <= CP_LAST; ++i) {
+            Phase_statistics const &o = other.m_phases[i];
+            Phase_statistics       &s = m_phases[i];
+            s.wall_time       += o.wall_time;
+            s.allocated_bytes += o.allocated_bytes;
+            s.node_count      += o.node_count;
+            s.invocations     += o.invocations;
+        }
+    }
+
+    /// Reset all statistics.
+    void clear()
+    {
+        for (size_t i = 0; i <= CP_LAST; ++i)
+            m_phases[i] = Phase_statistics();
+    }
+
+    /// Get the name of a phase.
+    static char const *get_phase_name(Compile_phase phase)
+    {
+        switch (phase) {
+        case CP_PARSER:              return "parser";
+        case CP_NT_ANALYSIS:         return "NT_analysis";
+        case CP_SEMA_ANALYSIS:       return "Sema_analysis";
+        case CP_AT_ANALYSIS:         return "AT_analysis";
+        case CP_OPTIMIZER:           return "optimizer";
+        case CP_DAG_GENERATION:      return "DAG generation";
+        case CP_INSTANCE_INITIALIZE: return "material instance initialization";
+        case CP_LAMBDA_CONVERSION:   return "lambda conversion";
+        case CP_LLVM_OPTIMIZATION:   return "LLVM optimization";
+        case CP_CODE_EMISSION:       return "code emission";
+        }
+        return "";
+    }
+
+private:
+    /// The statistics per phase.
+    Phase_statistics m_phases[CP_LAST + 1];
+};
+
+}  // mdl
+}  // mi
+
+#endif
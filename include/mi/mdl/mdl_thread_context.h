@@ -33,6 +33,8 @@
 #include <mi/base/iinterface.h>
 #include <mi/base/interface_declare.h>
 
+#include <mi/mdl/mdl_statistics.h>
+
 namespace mi {
 namespace mdl {
 
@@ -44,7 +46,7 @@ class Options;
 /// When the compiler is used from different threads, every thread should have its own
 /// context. If no context is provided, the compiler automatically creates one.
 class IThread_context : public
-    mi::base::Interface_declare<0x98779789,0x92bc,0x4530,0x8b,0xfd,0xc3,0xb2,0xfc,0x1e,0xb7,0x8d,
+    mi::base::Interface_declare<0x98779789,0x92bc,0x4530,0x8b,0xfd,0xc3,0xb2,0xfc,0x1e,0xb7,0x8e,
     mi::base::IInterface>
 {
 public:
@@ -73,6 +75,15 @@ public:
     ///       context is in use.
     ///
     virtual Options &access_options() = 0;
+
+    /// Access the per-phase statistics of all front-end operations that used this context.
+    ///
+    /// Records the parser, NT_analysis, Sema_analysis, AT_analysis and optimizer phases.
+    /// The statistics accumulate until they are cleared by the user.
+    virtual Compile_statistics const &access_statistics() const = 0;
+
+    /// Access the per-phase statistics of all front-end operations that used this context.
+    virtual Compile_statistics &access_statistics() = 0;
 };
 
 }  // mdl
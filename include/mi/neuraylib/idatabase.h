@@ -52,8 +52,8 @@ class IScope;
 /// This interface is used to interact with the distributed database.
 ///
 /// \if MDL_SDK_API
-/// \note The MDL SDK currently supports only \em one scope, the global scope. It also supports only
-///       one transaction at time.
+/// \note The MDL SDK supports a tree of scopes and any number of concurrent transactions, see
+///       #mi::neuraylib::IScope for the visibility rules. The database is local to the process.
 /// \endif
 class IDatabase : public
     mi::base::Interface_declare<0x814ae637,0xde35,0x4870,0x8e,0x5b,0x7e,0x28,0x9d,0x30,0xfb,0x82>
@@ -65,7 +65,6 @@ public:
     ///          system.
     virtual IScope* get_global_scope() const = 0;
 
-    /// \ifnot MDL_SDK_API
     /// Creates a new optionally temporary scope at the given privacy level with the
     /// given parent scope ID.
     ///
@@ -85,10 +84,10 @@ public:
     ///                       will be removed. If the scope is not temporary, the default,
     ///                       then when the creating host is removed from the cluster the
     ///                       scope and all contained data will remain in the database.
-    /// \return               The created scope or \c NULL if something went wrong.
-    /// \else
-    /// This operation is not supported.
-    /// \endif
+    ///                       \if MDL_SDK_API Ignored by the MDL SDK, there is only one host.
+    ///                       \endif
+    /// \return               The created scope or \c NULL if something went wrong, e.g., if
+    ///                       \p parent has been removed.
     virtual IScope* create_scope( IScope* parent, Uint8 privacy_level = 0, bool temp = false) = 0;
 
     /// Looks up and returns a scope with a given ID.
@@ -97,20 +96,23 @@ public:
     /// \return               The found scope or \c NULL if no such scope exists.
     virtual IScope* get_scope( const char* id) const = 0;
 
-    /// \ifnot MDL_SDK_API
     /// Removes a scope with the specified ID.
     ///
+    /// \ifnot MDL_SDK_API
     /// Note that scopes are reference counted. The actual removal will not happen before all
     /// elements referencing the scope have been released, e.g., child scopes, transactions,
     /// database elements, including handles to the scope itself.
+    /// \else
+    /// The scope and all its descendants are removed immediately, together with all versions of
+    /// database elements and all names stored in them. Removal fails if a transaction is open in
+    /// any of these scopes. Handles to removed scopes stay valid, but no transactions or child
+    /// scopes can be created from them anymore.
+    /// \endif
     ///
     /// It is not possible to remove the global scope.
     ///
     /// \param id             The ID of the scope as returned by #mi::neuraylib::IScope::get_id().
     /// \return               0, in case of success, -1 in case of failure.
-    /// \else
-    /// This operation is not supported.
-    /// \endif
     virtual Sint32 remove_scope( const char* id) const = 0;
 
     /// \ifnot MDL_SDK_API
@@ -150,7 +152,6 @@ public:
     /// \endif
     virtual Sint32 unlock( Uint32 lock_id) = 0;
 
-    /// \ifnot MDL_SDK_API
     /// Creates or retrieves a new named scope at the given privacy level with the given parent
     /// scope ID.
     ///
@@ -166,20 +167,13 @@ public:
     ///                       0). The default value of 0 indicates the privacy level of the parent
     ///                       scope plus 1.
     /// \return               The created scope or \c NULL if something went wrong.
-    /// \else
-    /// This operation is not supported.
-    /// \endif
     virtual IScope* create_or_get_named_scope(
         const char* name, IScope* parent = 0,  Uint8 privacy_level = 0) = 0;
 
-    /// \ifnot MDL_SDK_API
     /// Looks up and returns a scope with a given name.
     ///
     /// \param name           The name of the scope
     /// \return               The found scope or \c NULL if no such scope exists.
-    /// \else
-    /// This operation is not supported.
-    /// \endif
     virtual IScope* get_named_scope( const char* name) const = 0;
 
     /// Triggers a synchronous garbage collection run.
@@ -92,7 +92,7 @@ mi_static_assert( sizeof( Lightprofile_degree) == sizeof( Uint32));
 /// #mi::neuraylib::IFunction_definition). The type of such an argument is
 /// #mi::neuraylib::IType_light_profile or an alias of it.
 class ILightprofile :
-    public base::Interface_declare<0xa4ac11fd,0x705d,0x4a0a,0x80,0x0b,0x38,0xe5,0x3d,0x46,0x96,0x47,
+    public base::Interface_declare<0xa4ac11fd,0x705d,0x4a0a,0x80,0x0b,0x38,0xe5,0x3d,0x46,0x96,0x48,
                                    neuraylib::IScene_element>
 {
 public:
@@ -268,6 +268,32 @@ public:
     ///
     /// \see #get_data()
     virtual Float32 sample( Float32 phi, Float32 theta, bool candela) const = 0;
+
+    /// Samples a direction proportionally to the light profile.
+    ///
+    /// The grid cells are selected proportionally to their average value times their solid angle.
+    /// Inside a cell, the direction is uniformly distributed in phi and in cos(theta). The
+    /// necessary tables are computed once per light profile.
+    ///
+    /// \param xi_phi    A uniformly distributed random number in [0,1) that selects phi.
+    /// \param xi_theta  A uniformly distributed random number in [0,1) that selects theta.
+    /// \param phi       The sampled azimuthal angle.
+    /// \param theta     The sampled polar angle.
+    /// \return          The probability density of the sampled direction with respect to solid
+    ///                  angle, or 0 if the light profile is zero everywhere, in case of errors, or
+    ///                  after default construction.
+    ///
+    /// \see #get_pdf()
+    virtual Float32 sample_direction(
+        Float32 xi_phi, Float32 xi_theta, Float32* phi, Float32* theta) const = 0;
+
+    /// Returns the probability density of #sample_direction() with respect to solid angle.
+    ///
+    /// \param phi       First dimension of the direction.
+    /// \param theta     Second dimension of the direction.
+    /// \return          The probability density, or 0 outside of the grid, in case of errors, or
+    ///                  after default construction.
+    virtual Float32 get_pdf( Float32 phi, Float32 theta) const = 0;
 };
 
 /*@}*/ // end group mi_neuray_misc
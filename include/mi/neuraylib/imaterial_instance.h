@@ -53,7 +53,7 @@ class ICompiled_material;
 ///
 /// \see #mi::neuraylib::IMaterial_definition, #mi::neuraylib::Argument_editor
 class IMaterial_instance : public
-    mi::base::Interface_declare<0x037ec156,0x281d,0x466a,0xa1,0x56,0x3e,0xd6,0x83,0xe9,0x5a,0x00,
+    mi::base::Interface_declare<0x037ec156,0x281d,0x466a,0xa1,0x56,0x3e,0xd6,0x83,0xe9,0x5a,0x01,
                                 neuraylib::IScene_element>
 {
 public:
@@ -192,6 +192,22 @@ public:
     ///                                    - -3: An argument type of the graph of this material
     ///                                          instance is varying but the corresponding parameter
     ///                                          type is uniform.
+    /// \param previous                    An optional compiled material created earlier, typically
+    ///                                    from this material instance before its latest edits. It
+    ///                                    is used to avoid work for parts of the graph of this
+    ///                                    material instance which did not change: if nothing
+    ///                                    changed, a copy of \p previous is returned; with class
+    ///                                    compilation, if only constant arguments changed, only the
+    ///                                    arguments of \p previous are replaced.
+    /// \param[out] target_code_reusable   An optional pointer to a bool which is set to \c true if
+    ///                                    the result differs from \p previous at most in its
+    ///                                    arguments. Target code generated for \p previous can
+    ///                                    then be kept, and only its argument block needs to be
+    ///                                    recreated with
+    ///                                    #mi::neuraylib::ITarget_code::create_argument_block().
+    ///                                    This is only possible for class compilation, or if
+    ///                                    nothing changed at all. Always \c false if \p previous
+    ///                                    is \c NULL.
     /// \return                            The corresponding compiled material, or \c NULL in case
     ///                                    of failure.
     virtual ICompiled_material* create_compiled_material(
@@ -199,7 +215,9 @@ public:
         Float32 mdl_meters_per_scene_unit,
         Float32 mdl_wavelength_min,
         Float32 mdl_wavelength_max,
-        Sint32* errors = 0) const = 0;
+        Sint32* errors = 0,
+        const ICompiled_material* previous = 0,
+        bool* target_code_reusable = 0) const = 0;
 };
 
 /*@}*/ // end group mi_neuray_mdl_elements
@@ -83,7 +83,7 @@ class ITransaction;
 ///
 /// It also allows to load plugins to add support for loading and exporting images and videos.
 class IMdl_compiler : public
-    mi::base::Interface_declare<0x8fff0a2d,0x7df7,0x4552,0x92,0xf7,0x36,0x1d,0x31,0xc6,0x30,0x08>
+    mi::base::Interface_declare<0x8fff0a2d,0x7df7,0x4552,0x92,0xf7,0x36,0x1d,0x31,0xc6,0x30,0x09>
 {
 public:
     /// \name General configuration
@@ -215,6 +215,14 @@ public:
     /// \return                    The \p index -th path, or \c NULL if \p index is out of bounds.
     virtual const IString* get_resource_path( Size index) const = 0;
 
+    /// Drops all cached file resolution results.
+    ///
+    /// The MDL compiler remembers the results of search path lookups and the contents of MDL
+    /// archives. The cache is dropped automatically if the search paths change, and lookups
+    /// older than a few seconds are repeated. Call this method if files were added to or removed
+    /// from the search paths and the change must be seen immediately.
+    virtual void clear_file_resolution_cache() = 0;
+
     //@}
     /// \name General configuration
     //@{
@@ -521,6 +529,21 @@ public:
     ///   functions, if the size is non-zero.
     ///   Default: "0".
     ///
+    /// The following options are supported by the native backend only:
+    /// - \c "lazy_compilation": Enables/disables lazy compilation. If enabled, functions are
+    ///   compiled to native code on their first call instead of ahead of time.
+    ///   Possible values: \c "on", \c "off". Default: \c "off".
+    /// - \c "object_cache_dir": Sets the directory of a persistent object code cache. The
+    ///   generated machine code is stored there and reused across process runs for identical
+    ///   code on the same CPU. An empty value disables the cache. Ignored if lazy compilation
+    ///   is enabled. Default: \c "".
+    /// - \c "target_cpu": Sets the CPU the native code is tuned for, either \c "host" or an LLVM
+    ///   CPU name like \c "haswell". Enables vectorization with the cost model of this CPU and
+    ///   fused multiply-adds if \c "fast_math" is on. An unknown CPU name results in a warning
+    ///   and generic code. Ignored if lazy compilation is enabled. Default: \c "" (generic code).
+    /// - \c "target_features": Sets a comma separated list of additional target features, for
+    ///   example \c "+avx2,+fma". Only used if \c "target_cpu" is set. Default: \c "".
+    ///
     /// The following options are supported by the PTX backend only:
     /// - \c "sm_version": Specifies the SM target version. Possible values:
     ///   \c "20", \c "30", \c "35", \c "37", \c "50", \c "52", \c "60", \c "61", \c "62" and
@@ -967,7 +990,7 @@ public:
 
 /// Represents target code of an MDL backend.
 class ITarget_code : public
-    mi::base::Interface_declare<0xefca46ae,0xd530,0x4b97,0x9d,0xab,0x3a,0xdb,0x0c,0x58,0xc3,0xac>
+    mi::base::Interface_declare<0xefca46ae,0xd530,0x4b97,0x9d,0xab,0x3a,0xdb,0x0c,0x58,0xc3,0xad>
 {
 public:
     /// The potential state usage properties.
@@ -1333,6 +1356,47 @@ public:
         Bsdf_pdf_data *data,
         const Shading_state_material& state,
         const ITarget_argument_block *cap_args) const = 0;
+
+    /// Returns the number of compilation phases for which statistics were recorded.
+    ///
+    /// The phases cover the steps from the compilation of the module of the material to the
+    /// emission of the target code: the front-end phases (parser, NT, Sema and AT analysis,
+    /// optimizer), DAG generation, material instance initialization, lambda conversion, LLVM
+    /// optimization and code emission. The front-end phases are only reported for the module
+    /// defining the material and only if it was compiled from source, not if it was loaded
+    /// from a binary or an archive. Statistics of each compiled material are counted once per
+    /// target code, even if several of its expressions were added to a link unit. Likewise,
+    /// the front-end and DAG generation statistics of a module are counted once per target
+    /// code, even if several of its materials were added to a link unit.
+    virtual Size get_compile_phase_count() const = 0;
+
+    /// Returns the name of a compilation phase.
+    ///
+    /// \param index      The index of the phase.
+    /// \return           The name of the phase, or \c NULL if \p index is out of range.
+    virtual const char* get_compile_phase_name(Size index) const = 0;
+
+    /// Returns the accumulated wall clock time spent in a compilation phase.
+    ///
+    /// \param index      The index of the phase.
+    /// \return           The time in seconds, or 0 if \p index is out of range.
+    virtual Float64 get_compile_phase_time(Size index) const = 0;
+
+    /// Returns the amount of memory allocated by the compiler in a compilation phase.
+    ///
+    /// Only allocations of arena-based phases are accounted for.
+    ///
+    /// \param index      The index of the phase.
+    /// \return           The number of bytes, or 0 if \p index is out of range.
+    virtual Size get_compile_phase_allocated_bytes(Size index) const = 0;
+
+    /// Returns the number of nodes produced in a compilation phase.
+    ///
+    /// Depending on the phase, these are DAG nodes or LLVM instructions.
+    ///
+    /// \param index      The index of the phase.
+    /// \return           The number of nodes, or 0 if \p index is out of range.
+    virtual Size get_compile_phase_node_count(Size index) const = 0;
 };
 
 /// Represents a link-unit of an MDL backend.
@@ -49,7 +49,7 @@ class IValue_factory;
 
 /// Provides access to various functions for the evaluation of MDL expressions.
 class IMdl_evaluator_api : public
-    mi::base::Interface_declare<0x1dc8e8c2,0xa19e,0x4dc9,0xa3,0x0f,0xeb,0xb4,0x0a,0xf1,0x08,0x58>
+    mi::base::Interface_declare<0x5c1d2b5e,0x8f4a,0x4d27,0x9b,0x61,0x0c,0x3e,0xd4,0x72,0xa1,0x96>
 {
 public:
     /// Evaluates if a material instance parameter is enabled (i.e. the enable_if condition
@@ -99,6 +99,52 @@ public:
         IFunction_call const     *call,
         Size                     index,
         Sint32                   *error) const = 0;
+
+    /// Evaluates the enable_if conditions of all parameters of a material instance.
+    ///
+    /// This is equivalent to calling #is_material_parameter_enabled() for each parameter, but all
+    /// conditions are evaluated in a single evaluation context, and subexpressions shared by
+    /// several conditions are evaluated only once. For material instances stored in the database,
+    /// the results are cached, and subsequent calls only re-evaluate those conditions whose
+    /// arguments (or referenced database elements) changed in the meantime.
+    ///
+    /// \param[in]  trans   the transaction
+    /// \param[in]  inst    the material instance
+    /// \param[out] states  an array with \c inst->get_parameter_count() elements. For each
+    ///                     parameter, the corresponding element is set to 1 if the parameter is
+    ///                     enabled, to 0 if it is disabled, or to one of the error codes -3, -4,
+    ///                     or -5 of #is_material_parameter_enabled() if the condition could not be
+    ///                     evaluated.
+    /// \return
+    ///                    -  0: Success.
+    ///                    - -1: An input parameter is NULL.
+    virtual Sint32 are_material_parameters_enabled(
+        ITransaction             *trans,
+        IMaterial_instance const *inst,
+        Sint32                   *states) const = 0;
+
+    /// Evaluates the enable_if conditions of all parameters of a function call.
+    ///
+    /// This is equivalent to calling #is_function_parameter_enabled() for each parameter, but all
+    /// conditions are evaluated in a single evaluation context, and subexpressions shared by
+    /// several conditions are evaluated only once. For function calls stored in the database,
+    /// the results are cached, and subsequent calls only re-evaluate those conditions whose
+    /// arguments (or referenced database elements) changed in the meantime.
+    ///
+    /// \param[in]  trans   the transaction
+    /// \param[in]  call    the function call
+    /// \param[out] states  an array with \c call->get_parameter_count() elements. For each
+    ///                     parameter, the corresponding element is set to 1 if the parameter is
+    ///                     enabled, to 0 if it is disabled, or to one of the error codes -3, -4,
+    ///                     or -5 of #is_function_parameter_enabled() if the condition could not be
+    ///                     evaluated.
+    /// \return
+    ///                    -  0: Success.
+    ///                    - -1: An input parameter is NULL.
+    virtual Sint32 are_function_parameters_enabled(
+        ITransaction             *trans,
+        IFunction_call const     *call,
+        Sint32                   *states) const = 0;
 };
 
 /*@}*/ // end group mi_neuray_mdl_types
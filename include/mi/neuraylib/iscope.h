@@ -62,12 +62,23 @@ namespace neuraylib {
 /// from the parent scope, etc., until the global scope is reached. Again, this is similar to
 /// shadowing of variables with the same name in programming languages.
 ///
-/// For scope management see the methods on #mi::neuraylib::IDatabase.
+/// Names of database elements follow the same rules: the name passed to a store operation is bound
+/// in the scope of the stored version and visible in that scope and all child scopes. A binding in
+/// a scope shadows bindings of the same name in its ancestor scopes.
+///
+/// \par Concurrent transactions
+/// Any number of transactions can be open at the same time, in the same scope or in different
+/// scopes. Each transaction sees a snapshot of the database taken when the transaction was created:
+/// the versions and name bindings created by transactions which were committed before, plus its
+/// own changes. Changes by transactions which are still open when the transaction is created, or
+/// which are created later, are not visible to it, not even after they are committed. Changes by
+/// aborted transactions are never visible to other transactions.
+/// \par
+/// If the same database element is changed in multiple overlapping transactions, the changes from
+/// the transaction created last survive, independent of the order in which the transactions are
+/// committed.
 ///
-/// \if MDL_SDK_API
-/// \note The MDL SDK currently supports only \em one scope, the global scope. It also supports only
-///       one transaction at a time.
-/// \endif
+/// For scope management see the methods on #mi::neuraylib::IDatabase.
 class IScope : public
     mi::base::Interface_declare<0x578df0c5,0xab97,0x460a,0xb5,0x0a,0x2c,0xf8,0x54,0x22,0x31,0xb9>
 {
@@ -79,9 +90,10 @@ public:
     /// create such a DiCE transaction call the templated variant
     /// #mi::neuraylib::IScope::create_transaction<mi::neuraylib::IDice_transaction>(). \endif
     ///
-    /// \if MDL_SDK_API \note The MDL SDK currently supports only one transaction at a time. \endif
+    /// The transaction sees the database as of its creation, see the concurrency rules above.
     ///
-    /// \return   A transaction associated with this scope.
+    /// \return   A transaction associated with this scope, or \c NULL if the scope has been
+    ///           removed.
     virtual ITransaction* create_transaction() = 0;
 
     /// Creates a new transaction associated with this scope.
@@ -92,8 +104,6 @@ public:
     /// on the returned pointer, since the return type already is a pointer to the type \p T
     /// specified as template parameter.
     ///
-    /// \if MDL_SDK_API \note The MDL SDK currently supports only one transaction at a time. \endif
-    ///
     /// \tparam T   The interface type of the transaction to create.
     /// \return     A transaction associated with this scope.
     template<class T>
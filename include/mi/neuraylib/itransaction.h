@@ -87,15 +87,12 @@ class IScope;
 /// to other API methods that access other database elements, e.g., #mi::IRef::get_reference(),
 /// which internally calls #access().
 ///
-/// \ifnot MDL_SDK_API
 /// \par Concurrent transactions
 /// If the same database element is edited in multiple overlapping transactions, the changes from
 /// the transaction created last survive, independent of the order in which the transactions are
-/// committed. If needed, the lifetime of transactions can be serialized across hosts (see
-/// #mi::neuraylib::IDatabase::lock() for details).
-/// \else
-/// \note The MDL SDK currently supports only one transaction at a time.
-/// \endif
+/// committed. \ifnot MDL_SDK_API If needed, the lifetime of transactions can be serialized across
+/// hosts (see #mi::neuraylib::IDatabase::lock() for details). \endif See
+/// #mi::neuraylib::IScope for the visibility of changes by concurrent transactions.
 class ITransaction : public
     mi::base::Interface_declare<0x6ca1f0c2,0xb262,0x4f09,0xa6,0xa5,0x05,0xae,0x14,0x45,0xed,0xfa>
 {
@@ -111,14 +108,12 @@ public:
     ///                     - -3: The transaction is not open.
     virtual Sint32 commit() = 0;
 
-    /// \ifnot MDL_SDK_API
     /// Aborts the transaction.
     ///
+    /// All changes done in this transaction are discarded.
+    ///
     /// Note that an abort() implicitly closes the transaction.
     /// A closed transaction does not allow any future operations and needs to be released.
-    /// \else
-    /// This operation is not supported.
-    /// \endif
     virtual void abort() = 0;
 
     /// Indicates whether the transaction is open.
@@ -165,6 +165,12 @@ const mi::IString* Mdl_compiler_impl::get_resource_path( mi::Size index) const
     return istring;
 }
 
+void Mdl_compiler_impl::clear_file_resolution_cache()
+{
+    mi::base::Handle<mi::mdl::IMDL> mdl( m_mdlc_module->get_mdl());
+    mdl->clear_file_resolution_cache();
+}
+
 mi::Sint32 Mdl_compiler_impl::load_module(
     mi::neuraylib::ITransaction* transaction,
     const char* module_name,
@@ -102,6 +102,8 @@ public:
 
     const mi::IString* get_resource_path( mi::Size index) const;
 
+    void clear_file_resolution_cache();
+
 
     mi::Sint32 load_module(
         mi::neuraylib::ITransaction* transaction,
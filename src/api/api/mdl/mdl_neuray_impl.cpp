@@ -238,6 +238,16 @@ mi::Sint32 Neuray_impl::shutdown( bool blocking)
     NEURAY::Attribute_set_impl_helper::unregister_mdl_callback();
     NEURAY::Class_registration::unregister_structure_declarations( m_class_factory);
 
+    // drop the cached MDL modules before the database and the MDL compiler go away
+    MDL::invalidate_call_resolution_cache();
+
+    mi::Uint64 hits = 0, misses = 0, invalidations = 0;
+    MDL::get_call_resolution_cache_statistics( hits, misses, invalidations);
+    LOG::mod_log->debug( M_NEURAY_API, LOG::Mod_log::C_DATABASE,
+        "MDL call resolution cache: %llu hits, %llu misses, %llu invalidations.",
+        static_cast<unsigned long long>( hits), static_cast<unsigned long long>( misses),
+        static_cast<unsigned long long>( invalidations));
+
     unregister_api_component<mi::neuraylib::IMdl_evaluator_api>();
     unregister_api_component<mi::neuraylib::IMdl_archive_api>();
     unregister_api_component<mi::neuraylib::IMdl_discovery_api>();
@@ -170,6 +170,20 @@ mi::Float32 Lightprofile_impl::sample( mi::Float32 phi, mi::Float32 theta, bool
     return get_db_element()->sample( phi, theta, candela);
 }
 
+mi::Float32 Lightprofile_impl::sample_direction(
+    mi::Float32 xi_phi, mi::Float32 xi_theta, mi::Float32* phi, mi::Float32* theta) const
+{
+    if( !phi || !theta)
+        return 0.0f;
+
+    return get_db_element()->sample_direction( xi_phi, xi_theta, phi, theta);
+}
+
+mi::Float32 Lightprofile_impl::get_pdf( mi::Float32 phi, mi::Float32 theta) const
+{
+    return get_db_element()->get_pdf( phi, theta);
+}
+
 } // namespace NEURAY
 
 } // namespace MI
@@ -102,6 +102,11 @@ public:
 
     mi::Float32 sample( mi::Float32 phi, mi::Float32 theta, bool candela) const;
 
+    mi::Float32 sample_direction(
+        mi::Float32 xi_phi, mi::Float32 xi_theta, mi::Float32* phi, mi::Float32* theta) const;
+
+    mi::Float32 get_pdf( mi::Float32 phi, mi::Float32 theta) const;
+
     // internal methods
 
 };
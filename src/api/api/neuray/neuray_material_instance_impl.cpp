@@ -181,13 +181,18 @@ mi::neuraylib::ICompiled_material* Material_instance_impl::create_compiled_mater
     mi::Float32 mdl_meters_per_scene_unit,
     mi::Float32 mdl_wavelength_min,
     mi::Float32 mdl_wavelength_max,
-    mi::Sint32* errors) const
+    mi::Sint32* errors,
+    const mi::neuraylib::ICompiled_material* previous,
+    bool* target_code_reusable) const
 {
     bool class_compilation = flags & CLASS_COMPILATION;
+    const MDL::Mdl_compiled_material* db_previous = previous
+        ? static_cast<const Compiled_material_impl*>( previous)->get_db_element() : 0;
     boost::shared_ptr<MDL::Mdl_compiled_material> db_instance(
         get_db_element()->create_compiled_material(
             get_db_transaction(), class_compilation, mdl_meters_per_scene_unit,
-            mdl_wavelength_min, mdl_wavelength_max, errors));
+            mdl_wavelength_min, mdl_wavelength_max, errors, db_previous,
+            target_code_reusable));
     if( !db_instance)
         return 0;
     mi::neuraylib::ICompiled_material* api_instance
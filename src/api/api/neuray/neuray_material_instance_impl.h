@@ -98,7 +98,9 @@ public:
         mi::Float32 mdl_meters_per_scene_unit,
         mi::Float32 mdl_wavelength_min,
         mi::Float32 mdl_wavelength_max,
-        mi::Sint32* errors) const NEURAY_FINAL;
+        mi::Sint32* errors,
+        const mi::neuraylib::ICompiled_material* previous,
+        bool* target_code_reusable) const NEURAY_FINAL;
 
     // methods of IInterface
 
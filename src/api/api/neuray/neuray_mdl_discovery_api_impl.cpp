@@ -47,9 +47,16 @@
 #include <io/scene/mdl_elements/i_mdl_elements_module.h>
 
 #include <algorithm>
+#include <cstdlib>
+#include <set>
 #include <string>
+#include <thread>
 #include <boost/algorithm/string/replace.hpp>
 
+#ifdef MI_PLATFORM_WINDOWS
+#include <windows.h>
+#endif
+
 
 // helper function
 std::string add_slash(std::string val)
@@ -62,6 +69,29 @@ std::string add_slash(std::string val)
     return val;
 }
 
+// Returns the path with all symbolic links resolved, or the path itself if that fails.
+std::string get_real_path(const std::string& path)
+{
+#ifdef MI_PLATFORM_WINDOWS
+    HANDLE handle = CreateFileA(path.c_str(), 0,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS, NULL);
+    if (handle == INVALID_HANDLE_VALUE)
+        return path;
+    char buffer[MAX_PATH];
+    DWORD length = GetFinalPathNameByHandleA(handle, buffer, MAX_PATH, FILE_NAME_NORMALIZED);
+    CloseHandle(handle);
+    return length > 0 && length < MAX_PATH ? std::string(buffer, length) : path;
+#else
+    char* real_path = realpath(path.c_str(), nullptr);
+    if (!real_path)
+        return path;
+    std::string result(real_path);
+    free(real_path);
+    return result;
+#endif
+}
+
 std::string dot_to_slash(std::string val)
 {
 #ifdef MI_PLATFORM_WINDOWS
@@ -424,29 +454,33 @@ bool Mdl_discovery_api_impl::check_ident_validity(const char* identifier) const
 
 bool Mdl_discovery_api_impl::discover_recursive(mi::base::Handle<Mdl_package_info_impl> parent,
     const char* search_path, mi::Size s_idx, const char* path, 
-    const std::vector<std::string>& invalid_dirs) const
+    const std::vector<std::string>& invalid_dirs,
+    const Directory_cache& directories) const
 {
-    DISK::Directory dir;
-    if (!dir.open(path))
+    const Directory_listing* listing = get_listing(directories, path);
+    if (!listing)
         return false;
 
     std::string current_path(path);
     std::string package_path = slash_to_colon(current_path.substr(strlen(search_path))) + "::";
 
-    std::string entry = dir.read();
-    while (!entry.empty())
+    for (mi::Size e = 0, n = listing->m_entries.size(); e < n; ++e)
     {
+        std::string entry = listing->m_entries[e];
         std::string resolved_path = HAL::Ospath::join(current_path, entry);
-        if (DISK::is_directory(resolved_path.c_str()))
+        if (listing->m_is_dir[e])
         {
             if (std::find(invalid_dirs.begin(), invalid_dirs.end(), 
                 resolved_path) != invalid_dirs.end())
             {
                 // todo: add error message
-                entry = dir.read();
                 continue;
             }
 
+            // Skip directories that were not visited, e.g., second paths to the same directory
+            if (!get_listing(directories, resolved_path))
+                continue;
+
             mi::base::Handle< Mdl_package_info_impl>
                 child_package(new Mdl_package_info_impl(entry.c_str(),
                     search_path,
@@ -466,14 +500,14 @@ bool Mdl_discovery_api_impl::discover_recursive(mi::base::Handle<Mdl_package_inf
 
                 // Continue recursion with merged node
                 discover_recursive(merge_package,
-                    search_path, s_idx, resolved_path.c_str(), invalid_dirs);
+                    search_path, s_idx, resolved_path.c_str(), invalid_dirs, directories);
                 parent->reset_package(merge_package.get(), idx);
             }
             else
             {
                 // No merge has happened -> continue with new node
                 discover_recursive(child_package,
-                    search_path, s_idx, resolved_path.c_str(), invalid_dirs);
+                    search_path, s_idx, resolved_path.c_str(), invalid_dirs, directories);
                 parent->add_package(child_package.get());
             }
         }
@@ -481,17 +515,13 @@ bool Mdl_discovery_api_impl::discover_recursive(mi::base::Handle<Mdl_package_inf
         {
             std::size_t found_mdl = resolved_path.rfind(".mdl");
             // Filter sym-links and non-mdl files
-            if (!DISK::is_file(resolved_path.c_str()) || (found_mdl != resolved_path.length() - 4))
-            {
-                entry = dir.read();
+            if (!listing->m_is_file[e] || (found_mdl != resolved_path.length() - 4))
                 continue;
-            }
 
             if (std::find(invalid_dirs.begin(), invalid_dirs.end(), 
                 resolved_path.substr(0, resolved_path.length() - 4)) != invalid_dirs.end())
             {
                 // todo: add error message
-                entry = dir.read();
                 continue;
             }
 
@@ -502,10 +532,7 @@ bool Mdl_discovery_api_impl::discover_recursive(mi::base::Handle<Mdl_package_inf
 
                 // Check if file name is valid for MDL
                 if (!check_ident_validity(entry.c_str()))
-                {
-                    entry = dir.read();
                     continue; //ToDo: Add error message 
-                }
                 mi::base::Handle< Mdl_module_info_impl>
                     module(new Mdl_module_info_impl(entry.c_str(),
                         (package_path + entry).c_str(),
@@ -518,9 +545,7 @@ bool Mdl_discovery_api_impl::discover_recursive(mi::base::Handle<Mdl_package_inf
                     parent->add_module(module.get());
             }
         }
-        entry = dir.read();
     }
-    dir.close();
 
     return true;
 }
@@ -593,29 +618,37 @@ const mi::neuraylib::IMdl_discovery_result* Mdl_discovery_api_impl::discover() c
     mi::base::Handle<Mdl_package_info_impl> root_package(
         new Mdl_package_info_impl("", "", "", -1, ""));
 
-    for (mi::Size i = 0; i < search_paths.size(); ++i) 
-    {
-        std::string path = HAL::Ospath::normpath_v2(search_paths[i]);
+    std::vector<std::string> normalized_paths;
+    for (mi::Size i = 0; i < search_paths.size(); ++i)
+        normalized_paths.push_back(HAL::Ospath::normpath_v2(search_paths[i]));
 
-        if (!DISK::access(path.c_str(), false))
-            continue;
+    // Only the directories and archives that changed since the last call are read again,
+    // the graph itself is rebuilt from a snapshot of the cached data.
+    std::shared_ptr<const Directory_cache> directories =
+        refresh_directory_cache(normalized_paths);
+
+    // the archives found in this call
+    std::set<std::string> archive_paths;
+
+    for (mi::Size i = 0; i < normalized_paths.size(); ++i) 
+    {
+        const std::string& path = normalized_paths[i];
 
         // Collect all archives
-        DISK::Directory dir;
-        if (!dir.open(path.c_str()))
+        const Directory_listing* listing = get_listing(*directories, path);
+        if (!listing)
             continue;
 
-        std::string entry = dir.read();
         std::map<std::string, bool> archives;
-        while (!entry.empty())
+        for (mi::Size e = 0, n = listing->m_entries.size(); e < n; ++e)
         {
-            if(DISK::is_file(HAL::Ospath::join(path, entry).c_str()))
+            const std::string& entry = listing->m_entries[e];
+            if (listing->m_is_file[e])
             {
                 std::size_t found_mdr = entry.rfind(".mdr");
                 if (found_mdr != std::string::npos && found_mdr == entry.size() - 4)
                     archives.insert(std::make_pair(entry.substr(0, found_mdr), true));  
             }
-            entry = dir.read();
         }
 
         // Process archives
@@ -628,12 +661,27 @@ const mi::neuraylib::IMdl_discovery_result* Mdl_discovery_api_impl::discover() c
                 std::string resolved_path = HAL::Ospath::join(path, archive.first);
                 resolved_path += ".mdr";
                 discover_archive(root_package, path.c_str(), i, resolved_path.c_str());
+                archive_paths.insert(resolved_path);
             }
         }
 
         // Discover file system
-        discover_recursive(root_package, path.c_str(), i, path.c_str(), invalid_directies);
+        discover_recursive(
+            root_package, path.c_str(), i, path.c_str(), invalid_directies, *directories);
+    }
+
+    // Drop the cached module lists of archives that disappeared
+    {
+        mi::base::Lock::Block block(&m_cache_lock);
+        for (Archive_cache::iterator it = m_archive_cache.begin(); it != m_archive_cache.end();)
+        {
+            if (archive_paths.find(it->first) == archive_paths.end())
+                it = m_archive_cache.erase(it);
+            else
+                ++it;
+        }
     }
+
     // Sort graph nodes alphabetically
     root_package->sort_children();
     
@@ -643,6 +691,232 @@ const mi::neuraylib::IMdl_discovery_result* Mdl_discovery_api_impl::discover() c
     return disc_res.get();
 }
 
+void Mdl_discovery_api_impl::scan_directories(
+    const Directory_cache* cache,
+    const std::vector<std::string>* dirs,
+    const std::vector<mi::Size>* roots,
+    mi::Size begin,
+    mi::Size end,
+    TIME::Time scan_time,
+    std::vector<Directory_scan>* results)
+{
+    for (mi::Size d = begin; d < end; ++d)
+    {
+        Directory_scan scan;
+        scan.m_path   = (*dirs)[d];
+        scan.m_root   = (*roots)[d];
+        scan.m_exists = false;
+
+        DISK::Stat stat;
+        if (!DISK::stat(scan.m_path.c_str(), &stat) || !stat.m_is_dir)
+        {
+            results->push_back(scan);
+            continue;
+        }
+        scan.m_exists = true;
+
+        Directory_cache::const_iterator it = cache->find(scan.m_path);
+        if (it != cache->end()
+            && it->second->m_stable
+            && it->second->m_mtime == stat.m_modification_time)
+        {
+            scan.m_listing = it->second;
+            results->push_back(scan);
+            continue;
+        }
+
+        DISK::Directory dir;
+        if (!dir.open(scan.m_path.c_str()))
+        {
+            scan.m_exists = false;
+            results->push_back(scan);
+            continue;
+        }
+
+        std::shared_ptr<Directory_listing> listing(new Directory_listing);
+        listing->m_real_path = get_real_path(scan.m_path);
+        listing->m_mtime     = stat.m_modification_time;
+        listing->m_stable    = stat.m_modification_time < scan_time - TIME::Time(1.0);
+        std::string entry = dir.read();
+        while (!entry.empty())
+        {
+            std::string resolved_path = HAL::Ospath::join(scan.m_path, entry);
+            bool is_dir = DISK::is_directory(resolved_path.c_str());
+            listing->m_entries.push_back(entry);
+            listing->m_is_dir.push_back(is_dir);
+            listing->m_is_file.push_back(!is_dir && DISK::is_file(resolved_path.c_str()));
+            entry = dir.read();
+        }
+        dir.close();
+
+        scan.m_listing = listing;
+        results->push_back(scan);
+    }
+}
+
+std::shared_ptr<const Mdl_discovery_api_impl::Directory_cache>
+Mdl_discovery_api_impl::refresh_directory_cache(const std::vector<std::string>& roots) const
+{
+    // take the time before any stat() call, changes after this point are detected next time
+    TIME::Time scan_time = TIME::get_wallclock_time();
+
+    std::shared_ptr<const Directory_cache> old_cache;
+    {
+        mi::base::Lock::Block block(&m_cache_lock);
+        old_cache = m_directory_cache;
+    }
+    if (!old_cache)
+        old_cache.reset(new Directory_cache);
+    std::shared_ptr<Directory_cache> new_cache(new Directory_cache);
+
+    mi::Size n_threads = std::thread::hardware_concurrency();
+    if (n_threads == 0)
+        n_threads = 1;
+
+    // the real paths visited below each root
+    std::set<std::pair<mi::Size, std::string> > visited;
+
+    std::vector<std::string> level(roots);
+    std::vector<mi::Size> level_roots;
+    for (mi::Size i = 0; i < roots.size(); ++i)
+        level_roots.push_back(i);
+
+    while (!level.empty())
+    {
+        // Scan the current level, the workers only read the old cache
+        mi::Size n_workers = std::min(n_threads, mi::Size((level.size() + 15) / 16));
+        std::vector<std::vector<Directory_scan>> results(n_workers > 0 ? n_workers : 1);
+        if (n_workers <= 1)
+        {
+            scan_directories(
+                old_cache.get(), &level, &level_roots, 0, level.size(), scan_time, &results[0]);
+        }
+        else
+        {
+            std::vector<std::thread> workers;
+            mi::Size chunk = (level.size() + n_workers - 1) / n_workers;
+            for (mi::Size w = 0; w < n_workers; ++w)
+            {
+                mi::Size begin = std::min(w * chunk, mi::Size(level.size()));
+                mi::Size end   = std::min(begin + chunk, mi::Size(level.size()));
+                workers.push_back(std::thread(
+                    &Mdl_discovery_api_impl::scan_directories,
+                    old_cache.get(), &level, &level_roots, begin, end, scan_time, &results[w]));
+            }
+            for (mi::Size w = 0; w < n_workers; ++w)
+                workers[w].join();
+        }
+
+        // Merge the results and collect the next level
+        std::vector<std::string> next_level;
+        std::vector<mi::Size> next_level_roots;
+        for (mi::Size w = 0; w < results.size(); ++w)
+        {
+            for (mi::Size r = 0; r < results[w].size(); ++r)
+            {
+                const Directory_scan& scan = results[w][r];
+                if (!scan.m_exists)
+                    continue;
+
+                // Skip directories that were reached twice, e.g., via symbolic links
+                const std::string& real_path = scan.m_listing->m_real_path;
+                if (!visited.insert(std::make_pair(scan.m_root, real_path)).second)
+                    continue;
+
+                (*new_cache)[scan.m_path] = scan.m_listing;
+
+                const Directory_listing& listing = *scan.m_listing;
+                for (mi::Size e = 0, n = listing.m_entries.size(); e < n; ++e)
+                {
+                    if (listing.m_is_dir[e])
+                    {
+                        next_level.push_back(
+                            HAL::Ospath::join(scan.m_path, listing.m_entries[e]));
+                        next_level_roots.push_back(scan.m_root);
+                    }
+                }
+            }
+        }
+        level.swap(next_level);
+        level_roots.swap(next_level_roots);
+    }
+
+    // Directories that are no longer reachable are not part of the new snapshot
+    {
+        mi::base::Lock::Block block(&m_cache_lock);
+        m_directory_cache = new_cache;
+    }
+    return new_cache;
+}
+
+const Mdl_discovery_api_impl::Directory_listing* Mdl_discovery_api_impl::get_listing(
+    const Directory_cache& directories, const std::string& path)
+{
+    Directory_cache::const_iterator it = directories.find(path);
+    if (it == directories.end())
+        return nullptr;
+    return it->second.get();
+}
+
+std::shared_ptr<const Mdl_discovery_api_impl::Archive_modules>
+Mdl_discovery_api_impl::get_archive_modules(const char* res_path) const
+{
+    TIME::Time scan_time = TIME::get_wallclock_time();
+
+    DISK::Stat stat;
+    if (!DISK::stat(res_path, &stat))
+    {
+        mi::base::Lock::Block block(&m_cache_lock);
+        m_archive_cache.erase(res_path);
+        return nullptr;
+    }
+
+    {
+        mi::base::Lock::Block block(&m_cache_lock);
+        Archive_cache::const_iterator it = m_archive_cache.find(res_path);
+        if (it != m_archive_cache.end()
+            && it->second->m_stable
+            && it->second->m_size == stat.m_size
+            && it->second->m_mtime == stat.m_modification_time)
+            return it->second;
+    }
+
+    mi::base::Handle<mi::neuraylib::IMdl_archive_api>archive_api(
+        m_neuray->get_api_component<mi::neuraylib::IMdl_archive_api>());
+    mi::base::Handle<const mi::neuraylib::IManifest>
+        manifest(archive_api->get_manifest(res_path));
+    if (!manifest)
+    {
+        mi::base::Lock::Block block(&m_cache_lock);
+        m_archive_cache.erase(res_path);
+        return nullptr;
+    }
+
+    // Read modules from archive
+    std::shared_ptr<Archive_modules> entry(new Archive_modules);
+    entry->m_size   = stat.m_size;
+    entry->m_mtime  = stat.m_modification_time;
+    entry->m_stable = stat.m_modification_time < scan_time - TIME::Time(1.0);
+    for (mi::Size i = 0; i < manifest->get_number_of_fields(); i++)
+    {
+        const char* manifest_value = manifest->get_value(i);
+        if (manifest_value)
+        {
+            const char* manifest_key = manifest->get_key(i);
+            if (strcmp(manifest_key, "module") == 0)
+            {
+               std::string manifest_val(manifest_value);
+               if (manifest_val.size() > 0)
+                   entry->m_modules.push_back(manifest_val);
+            }
+        }
+    }
+
+    mi::base::Lock::Block block(&m_cache_lock);
+    m_archive_cache[res_path] = entry;
+    return entry;
+}
+
 bool Mdl_discovery_api_impl::create_archive_graph_recursive(
     mi::base::Handle<Mdl_package_info_impl> parent, 
     const char* previous_module,
@@ -772,34 +1046,12 @@ bool Mdl_discovery_api_impl::create_archive_graph_recursive(
 }
 
 bool Mdl_discovery_api_impl::create_archive_graph(
-    mi::base::Handle<const mi::neuraylib::IManifest> m,
+    const std::vector<std::string>& module_list,
     mi::base::Handle<Mdl_package_info_impl> parent,
     const char* search_path, 
     mi::Size s_idx,
     const char* res_path) const
 {
-    mi::base::Handle<Mdl_package_info_impl> archive_package(
-        new Mdl_package_info_impl("", "", "", -1, ""));
-
-    // Read modules from archive
-    std::vector<std::string> module_list;
-    mi::Size i;
-    for (i = 0; i < m->get_number_of_fields(); i++)
-    {
-        std::string package_name;
-        const char* manifest_value = m->get_value(i);
-        if (manifest_value)
-        {
-            const char* manifest_key = m->get_key(i);
-            if (strcmp(manifest_key, "module") == 0)
-            {
-               std::string manifest_val(m->get_value(i));
-               if (manifest_val.size() > 0)
-                   module_list.push_back(manifest_val);
-            }
-        }
-    }
-
     for (size_t x=0; x < module_list.size(); ++x)
     {
         size_t p = 0;
@@ -841,13 +1093,10 @@ bool Mdl_discovery_api_impl::create_archive_graph(
 bool Mdl_discovery_api_impl::discover_archive(mi::base::Handle<Mdl_package_info_impl> parent,
     const char* search_path, mi::Size s_idx, const char* res_path) const
 {
-    mi::base::Handle<mi::neuraylib::IMdl_archive_api>archive_api(
-        m_neuray->get_api_component<mi::neuraylib::IMdl_archive_api>());
-    mi::base::Handle<const mi::neuraylib::IManifest>
-        manifest(archive_api->get_manifest(res_path));
-    if (!manifest)
+    std::shared_ptr<const Archive_modules> modules = get_archive_modules(res_path);
+    if (!modules)
         return false;
-    create_archive_graph(manifest, parent, search_path, s_idx, res_path);
+    create_archive_graph(modules->m_modules, parent, search_path, s_idx, res_path);
     return true;
 }
 
@@ -860,6 +1109,11 @@ mi::Sint32 Mdl_discovery_api_impl::start()
 
 mi::Sint32 Mdl_discovery_api_impl::shutdown()
 {
+    {
+        mi::base::Lock::Block block(&m_cache_lock);
+        m_directory_cache.reset();
+        m_archive_cache.clear();
+    }
     m_path_module.reset();
     m_mdlc_module.reset();
     return 0;
@@ -39,8 +39,11 @@
 #include <mi/neuraylib/istring.h>
 #include <mi/base/handle.h>
 #include <mi/base/interface_implement.h>
+#include <mi/base/lock.h>
 #include <base/system/main/access_module.h>
+#include <base/hal/time/i_time.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -261,10 +264,88 @@ class Mdl_discovery_api_impl
 
     private:
 
+        /// A cached directory listing. It stays valid as long as the modification time of the
+        /// directory does not change, i.e., no entries have been added, removed, or renamed.
+        ///
+        /// Modification times have a resolution of one second. A listing read in the same
+        /// second as the last change of the directory is marked unstable and read again by the
+        /// next refresh, since further changes in that second would not change the time.
+        struct Directory_listing
+        {
+            Directory_listing() : m_stable(false) {}
+
+            std::string              m_real_path;   ///< the path with symbolic links resolved
+            TIME::Time               m_mtime;       ///< modification time of the directory
+            bool                     m_stable;      ///< false if m_mtime cannot be trusted
+            std::vector<std::string> m_entries;     ///< the directory entries
+            std::vector<bool>        m_is_dir;      ///< per entry: is it a directory?
+            std::vector<bool>        m_is_file;     ///< per entry: is it a regular file?
+        };
+
+        /// The result of scanning one directory during a refresh of the directory cache.
+        struct Directory_scan
+        {
+            std::string       m_path;       ///< the scanned directory
+            mi::Size          m_root;       ///< index of the root the directory was reached from
+            bool              m_exists;     ///< false if the directory is gone
+            std::shared_ptr<const Directory_listing> m_listing;  ///< the current listing
+        };
+
+        /// The cached module list of an archive. It stays valid as long as size and
+        /// modification time of the archive do not change. Like directory listings, a module
+        /// list read in the same second as the last change of the archive is unstable.
+        struct Archive_modules
+        {
+            Archive_modules() : m_size(0), m_stable(false) {}
+
+            mi::Sint64               m_size;      ///< size of the archive
+            TIME::Time               m_mtime;     ///< modification time of the archive
+            bool                     m_stable;    ///< false if m_mtime cannot be trusted
+            std::vector<std::string> m_modules;   ///< the "module" entries of the manifest
+        };
+
+        /// The cached entries are never changed once they are published, a refresh replaces
+        /// them instead. Thus a discover() call can use a snapshot of the caches without
+        /// holding m_cache_lock.
+        typedef std::unordered_map<std::string, std::shared_ptr<const Directory_listing> >
+            Directory_cache;
+        typedef std::unordered_map<std::string, std::shared_ptr<const Archive_modules> >
+            Archive_cache;
+
+        /// Brings the directory cache up-to-date for all directories below the given roots and
+        /// returns the new snapshot.
+        ///
+        /// Only directories whose modification time changed are read again, and only then
+        /// their symbolic links are resolved. The directory tree is traversed level by level,
+        /// each level is distributed over several threads. Below each root, a directory reached
+        /// a second time, e.g. via a symbolic link, is skipped.
+        /// m_cache_lock is only held to fetch and to publish the snapshot.
+        std::shared_ptr<const Directory_cache> refresh_directory_cache(
+            const std::vector<std::string>& roots) const;
+
+        /// Scans the directories [begin, end) of \p dirs against the (read-only) cache.
+        static void scan_directories(
+            const Directory_cache* cache,
+            const std::vector<std::string>* dirs,
+            const std::vector<mi::Size>* roots,
+            mi::Size begin,
+            mi::Size end,
+            TIME::Time scan_time,
+            std::vector<Directory_scan>* results);
+
+        /// Returns the listing of a directory in a snapshot, or \c NULL if it does not exist.
+        static const Directory_listing* get_listing(
+            const Directory_cache& directories, const std::string& path);
+
+        /// Returns the module list of an archive, reading its manifest only if the archive
+        /// changed since the last call. Returns \c NULL if the manifest cannot be read.
+        /// The manifest is read without holding m_cache_lock.
+        std::shared_ptr<const Archive_modules> get_archive_modules(const char* res_path) const;
+
         /// Checks if a graph item name is a valid MDL identifier.
         bool check_ident_validity(const char* identifier) const;
 
-        bool create_archive_graph(mi::base::Handle<const mi::neuraylib::IManifest> m,
+        bool create_archive_graph(const std::vector<std::string>& module_list,
             mi::base::Handle<Mdl_package_info_impl> parent,
             const char* search_path,
             mi::Size s_idx,
@@ -287,11 +368,22 @@ class Mdl_discovery_api_impl
             const char* search_path,
             mi::Size search_idx,
             const char* dir,
-            const std::vector<std::string>& invalid_dirs) const;
+            const std::vector<std::string>& invalid_dirs,
+            const Directory_cache& directories) const;
 
         mi::neuraylib::INeuray*                          m_neuray;
         MI::SYSTEM::Access_module<MI::MDLC::Mdlc_module> m_mdlc_module;
         MI::SYSTEM::Access_module<MI::PATH::Path_module> m_path_module;
+
+        /// Protects the snapshot pointers below, discover() may be called concurrently.
+        mutable mi::base::Lock                           m_cache_lock;
+
+        /// The cached listings of all directories below the search paths.
+        mutable std::shared_ptr<const Directory_cache>   m_directory_cache;
+
+        /// The cached module lists of all archives in the search paths. Archives that were
+        /// not found by the last discover() call are dropped.
+        mutable Archive_cache                            m_archive_cache;
 };
 
 /// This class implements the discover result.  
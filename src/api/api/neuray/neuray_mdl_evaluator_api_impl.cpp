@@ -34,6 +34,7 @@
 
 #include <string>
 #include <map>
+#include <vector>
 
 #include <mi/neuraylib/iexpression.h>
 #include <mi/neuraylib/itype.h>
@@ -43,6 +44,7 @@
 #include <api/api/neuray/neuray_expression_impl.h>
 
 #include <mi/base/handle.h>
+#include <mi/base/lock.h>
 
 #include <base/lib/log/i_log_assert.h>
 
@@ -132,8 +134,13 @@ public:
     , m_value_fact(m_arena, m_type_fact)
     , m_user_types()
     , m_max_size(8*1024*1024)
-    , m_max_cycles(1024)
+    , m_max_cycles(MAX_CYCLES)
+    , m_arena_base(0)
     , m_error(EC_OK)
+    , m_memoize(false)
+    , m_memo()
+    , m_used_params()
+    , m_used_tags()
     {
         Transaction_impl *transaction_impl = static_cast<Transaction_impl*>(trans);
         m_trans = transaction_impl->get_db_transaction();
@@ -444,6 +451,31 @@ public:
         return m_value_fact.create_bad();
     }
 
+    /// Enable or disable memoization of evaluated parameters and calls.
+    ///
+    /// If enabled, parameters and calls occurring in several expressions evaluated by this
+    /// evaluator are evaluated only once.
+    void set_memoize(bool flag) { m_memoize = flag; }
+
+    /// Prepares the evaluation of the next expression of a batch.
+    ///
+    /// Resets the error code, the evaluation limits, and the recorded dependencies, but keeps
+    /// the factories and all memoized results.
+    void start_expression()
+    {
+        m_max_cycles = MAX_CYCLES;
+        m_arena_base = m_arena.get_chunks_size();
+        m_error      = EC_OK;
+        m_used_params.clear();
+        m_used_tags.clear();
+    }
+
+    /// Get the indices of the parameters used since the last call of #start_expression().
+    std::vector<size_t> const &get_used_parameters() const { return m_used_params; }
+
+    /// Get the tags of the DB elements accessed since the last call of #start_expression().
+    std::vector<DB::Tag> const &get_used_tags() const { return m_used_tags; }
+
     /// Get a parameter argument expression.
     MI::MDL::IExpression const *get_parameter_argument(size_t index)
     {
@@ -457,7 +489,85 @@ public:
     /// Evaluate an internal neuray expression.
     mi::mdl::IValue const *evaluate(MI::MDL::IExpression const *expr)
     {
-        if (m_arena.get_chunks_size() > m_max_size) {
+        Memo_key key;
+        if (!m_memoize || !get_memo_key(expr, key))
+            return evaluate_expression(expr);
+
+        Memo_map::const_iterator it = m_memo.find(key);
+        if (it != m_memo.end()) {
+            // reuse the earlier result including its error and its dependencies
+            Memo_entry const &entry = it->second;
+            if (entry.m_error != EC_OK)
+                set_error(entry.m_error);
+            m_used_params.insert(
+                m_used_params.end(), entry.m_params.begin(), entry.m_params.end());
+            m_used_tags.insert(
+                m_used_tags.end(), entry.m_tags.begin(), entry.m_tags.end());
+            return entry.m_value;
+        }
+
+        Err_codes old_error   = m_error;
+        size_t    first_param = m_used_params.size();
+        size_t    first_tag   = m_used_tags.size();
+
+        mi::mdl::IValue const *res = evaluate_expression(expr);
+
+        // results depending on the evaluation limits cannot be reused, and if an error occurred
+        // before, it is unknown whether it was caused by this expression
+        if (old_error == EC_OK &&
+            m_error != EC_MEMORY_EXHAUSTED &&
+            m_error != EC_CYCLES_EXHAUSTED)
+        {
+            Memo_entry &entry = m_memo[key];
+            entry.m_value = res;
+            entry.m_error = m_error;
+            entry.m_params.assign(m_used_params.begin() + first_param, m_used_params.end());
+            entry.m_tags.assign(m_used_tags.begin() + first_tag, m_used_tags.end());
+        }
+        return res;
+    }
+
+private:
+    /// Key for memoized results: parameter index or tag of a function call.
+    typedef std::pair<bool, size_t> Memo_key;
+
+    /// A memoized result.
+    struct Memo_entry {
+        mi::mdl::IValue const *m_value;   ///< the value
+        Err_codes             m_error;    ///< the error produced by the evaluation
+        std::vector<size_t>   m_params;   ///< the parameters used by the evaluation
+        std::vector<DB::Tag>  m_tags;     ///< the DB elements accessed by the evaluation
+    };
+
+    typedef std::map<Memo_key, Memo_entry> Memo_map;
+
+    /// Computes the memoization key of an expression, returns false if it is not memoized.
+    static bool get_memo_key(MI::MDL::IExpression const *expr, Memo_key &key)
+    {
+        switch (expr->get_kind()) {
+        case MI::MDL::IExpression::EK_CALL:
+            {
+                mi::base::Handle<MI::MDL::IExpression_call const> call(
+                    expr->get_interface<MI::MDL::IExpression_call>());
+                key = Memo_key(false, call->get_call().get_uint());
+                return true;
+            }
+        case MI::MDL::IExpression::EK_PARAMETER:
+            {
+                mi::base::Handle<MI::MDL::IExpression_parameter const> param(
+                    expr->get_interface<MI::MDL::IExpression_parameter>());
+                key = Memo_key(true, param->get_index());
+                return true;
+            }
+        default:
+            return false;
+        }
+    }
+
+    /// Evaluate an internal neuray expression without memoization.
+    mi::mdl::IValue const *evaluate_expression(MI::MDL::IExpression const *expr)
+    {
+        if (m_arena.get_chunks_size() - m_arena_base > m_max_size) {
             set_error(EC_MEMORY_EXHAUSTED);
             return m_value_fact.create_bad();
         }
@@ -476,6 +586,7 @@ public:
                 mi::base::Handle<MI::MDL::IExpression_call const> call(
                     expr->get_interface<MI::MDL::IExpression_call>());
                 DB::Tag tag = call->get_call();
+                m_used_tags.push_back(tag);
                 SERIAL::Class_id class_id = m_trans->get_class_id(tag);
 
                 if (class_id != MI::MDL::Mdl_function_call::id) {
@@ -484,6 +595,7 @@ public:
                 }
                 DB::Access<MI::MDL::Mdl_function_call> fcall(tag, m_trans);
                 DB::Tag def_tag = fcall->get_function_definition();
+                m_used_tags.push_back(def_tag);
                 DB::Access<MI::MDL::Mdl_function_definition> def(def_tag, m_trans);
 
                 mi::base::Handle<MI::MDL::IExpression_list const> args(
@@ -496,6 +608,7 @@ public:
                 mi::base::Handle<MI::MDL::IExpression_parameter const> param(
                     expr->get_interface<MI::MDL::IExpression_parameter>());
                 size_t index = param->get_index();
+                m_used_params.push_back(index);
 
                 mi::base::Handle<MI::MDL::IExpression const> expr(
                     get_parameter_argument(index));
@@ -511,6 +624,7 @@ public:
                 mi::base::Handle<MI::MDL::IExpression_direct_call const> dcall(
                     expr->get_interface<MI::MDL::IExpression_direct_call>());
                 DB::Tag tag = dcall->get_definition();
+                m_used_tags.push_back(tag);
                 SERIAL::Class_id class_id = m_trans->get_class_id(tag);
 
                 if (class_id != MI::MDL::Mdl_function_definition::id) {
@@ -535,6 +649,7 @@ public:
         return m_value_fact.create_bad();
     }
 
+public:
     /// Evaluate a neuray value.
     mi::mdl::IValue const *evaluate(MI::MDL::IValue const *value)
     {
@@ -1052,6 +1167,9 @@ private:
     }
 
 private:
+    /// Maximum evaluation cycles allowed per expression.
+    static size_t const MAX_CYCLES = 1024;
+
     /// The compiler
     mi::mdl::MDL *m_compiler;
 
@@ -1084,10 +1202,244 @@ private:
     /// Maximum evaluation cycles allowed.
     size_t m_max_cycles;
 
+    /// The arena size at the start of the current expression.
+    size_t m_arena_base;
+
     /// The error code if any.
     Err_codes m_error;
+
+    /// If true, evaluated parameters and calls are memoized.
+    bool m_memoize;
+
+    /// The memoized results.
+    Memo_map m_memo;
+
+    /// The indices of the parameters used since the last call of #start_expression().
+    std::vector<size_t> m_used_params;
+
+    /// The tags of the DB elements accessed since the last call of #start_expression().
+    std::vector<DB::Tag> m_used_tags;
+};
+
+/// Maps evaluator errors to the error codes of the API.
+mi::Sint32 get_api_error(Evaluator::Err_codes code)
+{
+    switch (code) {
+    case Evaluator::EC_OK:
+        return 0;
+    case Evaluator::EC_TEMPORARY:
+        return -3;
+    case Evaluator::EC_NOT_CONSTANT:
+    case Evaluator::EC_UNSUPPORTED:
+    case Evaluator::EC_NON_FUNCTION_CALL:
+    case Evaluator::EC_PARAMETER:
+        return -4;
+    case Evaluator::EC_MEMORY_EXHAUSTED:
+    case Evaluator::EC_CYCLES_EXHAUSTED:
+        return -5;
+    }
+    return -4;
+}
+
+}  // anonymous
+
+/// Caches the results of batch evaluations of enable_if conditions.
+///
+/// For each DB element the cache stores the state of all parameters together with the inputs
+/// each condition depends on: the arguments of the element itself, and the versions of all other
+/// DB elements accessed during the evaluation.
+class Enable_if_cache
+{
+public:
+    /// The cached result of a single condition.
+    struct Condition {
+        mi::Sint32                   m_state;     ///< 1, 0, or a negative error code
+        std::vector<size_t>          m_params;    ///< the parameters used by the condition
+        std::vector<DB::Tag_version> m_versions;  ///< the DB elements accessed by the condition
+    };
+
+    /// The cached results of all conditions of a DB element.
+    struct Entry {
+        /// The version of the DB element.
+        DB::Tag_version m_version;
+        /// A copy of the arguments of the DB element.
+        mi::base::Handle<MI::MDL::IExpression_list const> m_arguments;
+        /// The results per parameter.
+        std::vector<Condition> m_conditions;
+    };
+
+    /// Returns a copy of the entry for \p tag, or \c false if there is none.
+    bool get(DB::Tag tag, Entry &entry) const
+    {
+        mi::base::Lock::Block block(&m_lock);
+        Entry_map::const_iterator it = m_entries.find(tag);
+        if (it == m_entries.end())
+            return false;
+        entry = it->second;
+        return true;
+    }
+
+    /// Stores the entry for \p tag.
+    void set(DB::Tag tag, Entry const &entry)
+    {
+        mi::base::Lock::Block block(&m_lock);
+        // keep the cache bounded, entries for removed DB elements are never looked up again
+        if (m_entries.size() >= MAX_ENTRIES && m_entries.find(tag) == m_entries.end())
+            m_entries.clear();
+        m_entries[tag] = entry;
+    }
+
+    /// Drops all entries.
+    ///
+    /// Tags and tag versions start again from scratch with a new database, so entries from a
+    /// previous run would answer queries for unrelated DB elements.
+    void clear()
+    {
+        mi::base::Lock::Block block(&m_lock);
+        m_entries.clear();
+    }
+
+private:
+    /// The maximum number of cached DB elements.
+    static size_t const MAX_ENTRIES = 4096;
+
+    typedef std::map<DB::Tag, Entry> Entry_map;
+
+    /// The cached entries.
+    Entry_map m_entries;
+
+    /// The lock for #m_entries.
+    mutable mi::base::Lock m_lock;
 };
 
+namespace {
+
+/// Checks whether a cached condition result is still valid.
+///
+/// \param trans          the DB transaction
+/// \param ef             the expression factory
+/// \param cond           the cached condition result
+/// \param old_args       the arguments at the time the result was computed
+/// \param args           the current arguments
+/// \param args_unchanged true, if the DB element was not changed since then
+bool is_up_to_date(
+    DB::Transaction                         *trans,
+    MI::MDL::IExpression_factory            *ef,
+    Enable_if_cache::Condition const        &cond,
+    MI::MDL::IExpression_list const         *old_args,
+    MI::MDL::IExpression_list const         *args,
+    bool                                    args_unchanged)
+{
+    if (!args_unchanged) {
+        for (size_t i = 0, n = cond.m_params.size(); i < n; ++i) {
+            mi::base::Handle<MI::MDL::IExpression const> old_arg(
+                old_args->get_expression(cond.m_params[i]));
+            mi::base::Handle<MI::MDL::IExpression const> arg(
+                args->get_expression(cond.m_params[i]));
+            if (!old_arg || !arg || ef->compare(old_arg.get(), arg.get()) != 0)
+                return false;
+        }
+    }
+    for (size_t i = 0, n = cond.m_versions.size(); i < n; ++i) {
+        DB::Tag_version const &version = cond.m_versions[i];
+        if (trans->get_tag_version(version.m_tag) != version)
+            return false;
+    }
+    return true;
+}
+
+/// Evaluates the enable_if conditions of all parameters of a material instance or function call.
+///
+/// \param compiler  the MDL compiler
+/// \param trans     the transaction
+/// \param cache     the cache for the results
+/// \param db_entity the material instance or function call
+/// \param tag       the tag of \p db_entity, or an invalid tag if the results should not be cached
+/// \param states    receives the state of each parameter
+template<typename T>
+void evaluate_enable_if_conditions(
+    mi::mdl::IMDL               *compiler,
+    mi::neuraylib::ITransaction *trans,
+    Enable_if_cache             &cache,
+    T const                     *db_entity,
+    DB::Tag                     tag,
+    mi::Sint32                  *states)
+{
+    DB::Transaction *db_trans = static_cast<Transaction_impl*>(trans)->get_db_transaction();
+    mi::base::Handle<MI::MDL::IExpression_factory> ef(MI::MDL::get_expression_factory());
+
+    mi::base::Handle<MI::MDL::IExpression_list const> conds(db_entity->get_enable_if_conditions());
+    mi::base::Handle<MI::MDL::IExpression_list const> args(db_entity->get_arguments());
+    size_t n = db_entity->get_parameter_count();
+
+    Enable_if_cache::Entry old_entry;
+    bool has_old_entry = tag.is_valid() && cache.get(tag, old_entry)
+        && old_entry.m_conditions.size() == n;
+
+    Enable_if_cache::Entry new_entry;
+    if (tag.is_valid()) {
+        new_entry.m_version = db_trans->get_tag_version(tag);
+        new_entry.m_conditions.resize(n);
+    }
+    bool args_unchanged = has_old_entry && old_entry.m_version == new_entry.m_version;
+
+    Parameter_helper helper(db_entity);
+    Evaluator eval(compiler, trans, &helper);
+    eval.set_memoize(true);
+
+    for (size_t i = 0; i < n; ++i) {
+        char const *name = db_entity->get_parameter_name(i);
+        mi::base::Handle<MI::MDL::IExpression const> cond(conds->get_expression(name));
+
+        if (!cond) {
+            // the parameter has no condition, always enabled
+            states[i] = 1;
+            if (tag.is_valid())
+                new_entry.m_conditions[i].m_state = 1;
+            continue;
+        }
+
+        if (has_old_entry && is_up_to_date(
+            db_trans,
+            ef.get(),
+            old_entry.m_conditions[i],
+            old_entry.m_arguments.get(),
+            args.get(),
+            args_unchanged))
+        {
+            states[i] = old_entry.m_conditions[i].m_state;
+            new_entry.m_conditions[i] = old_entry.m_conditions[i];
+            continue;
+        }
+
+        eval.start_expression();
+        mi::mdl::IValue const *res = eval.evaluate(cond.get());
+
+        if (mi::mdl::IValue_bool const *b = mi::mdl::as<mi::mdl::IValue_bool>(res))
+            states[i] = b->get_value() ? 1 : 0;
+        else
+            states[i] = eval.get_error() == Evaluator::EC_OK ? -4 : get_api_error(eval.get_error());
+
+        if (!tag.is_valid())
+            continue;
+
+        Enable_if_cache::Condition &new_cond = new_entry.m_conditions[i];
+        new_cond.m_state  = states[i];
+        new_cond.m_params = eval.get_used_parameters();
+        std::vector<DB::Tag> const &used_tags = eval.get_used_tags();
+        new_cond.m_versions.reserve(used_tags.size());
+        for (size_t j = 0, m = used_tags.size(); j < m; ++j)
+            new_cond.m_versions.push_back(db_trans->get_tag_version(used_tags[j]));
+    }
+
+    if (tag.is_valid()) {
+        if (args_unchanged)
+            new_entry.m_arguments = old_entry.m_arguments;
+        else
+            new_entry.m_arguments = ef->clone(args.get());
+        cache.set(tag, new_entry);
+    }
+}
 
 }  // anonymous
 
@@ -1095,11 +1447,14 @@ private:
 Mdl_evaluator_api_impl::Mdl_evaluator_api_impl(mi::neuraylib::INeuray *neuray)
 : m_neuray(neuray)
 , m_mdlc_module( false)
+, m_enable_if_cache(new Enable_if_cache())
 {
 }
 
 Mdl_evaluator_api_impl::~Mdl_evaluator_api_impl()
 {
+    delete m_enable_if_cache;
+    m_enable_if_cache = NULL;
     m_neuray = NULL;
 }
 
@@ -1151,24 +1506,7 @@ mi::neuraylib::IValue_bool const *Mdl_evaluator_api_impl::is_material_parameter_
 
     if (!mi::mdl::is<mi::mdl::IValue_bool>(res)) {
         // could not be evaluated
-        switch (eval.get_error()) {
-        case Evaluator::EC_OK:
-            *error = 0;
-            break;
-        case Evaluator::EC_TEMPORARY:
-            *error = -3;
-            break;
-        case Evaluator::EC_NOT_CONSTANT:
-        case Evaluator::EC_UNSUPPORTED:
-        case Evaluator::EC_NON_FUNCTION_CALL:
-        case Evaluator::EC_PARAMETER:
-            *error = -4;
-            break;
-        case Evaluator::EC_MEMORY_EXHAUSTED:
-        case Evaluator::EC_CYCLES_EXHAUSTED:
-            *error = -5;
-            break;
-        }
+        *error = get_api_error(eval.get_error());
         return NULL;
     }
 
@@ -1223,24 +1561,7 @@ mi::neuraylib::IValue_bool const *Mdl_evaluator_api_impl::is_function_parameter_
 
     if (!mi::mdl::is<mi::mdl::IValue_bool>(res)) {
         // could not be evaluated
-        switch (eval.get_error()) {
-        case Evaluator::EC_OK:
-            *error = 0;
-            break;
-        case Evaluator::EC_TEMPORARY:
-            *error = -3;
-            break;
-        case Evaluator::EC_NOT_CONSTANT:
-        case Evaluator::EC_UNSUPPORTED:
-        case Evaluator::EC_NON_FUNCTION_CALL:
-        case Evaluator::EC_PARAMETER:
-            *error = -4;
-            break;
-        case Evaluator::EC_MEMORY_EXHAUSTED:
-        case Evaluator::EC_CYCLES_EXHAUSTED:
-            *error = -5;
-            break;
-        }
+        *error = get_api_error(eval.get_error());
         return NULL;
     }
 
@@ -1248,14 +1569,58 @@ mi::neuraylib::IValue_bool const *Mdl_evaluator_api_impl::is_function_parameter_
     return fact->create_bool(mi::mdl::cast<mi::mdl::IValue_bool>(res)->get_value());
 }
 
+// Evaluates the enable_if conditions of all parameters of a material instance.
+mi::Sint32 Mdl_evaluator_api_impl::are_material_parameters_enabled(
+    mi::neuraylib::ITransaction             *trans,
+    mi::neuraylib::IMaterial_instance const *inst,
+    mi::Sint32                              *states) const
+{
+    if (trans == NULL || inst == NULL || states == NULL)
+        return -1;
+
+    Material_instance_impl const *inst_impl = static_cast<Material_instance_impl const *>(inst);
+    MI::MDL::Mdl_material_instance const *db_inst(inst_impl->get_db_element());
+
+    // elements being edited might change without a new version, do not cache their results
+    DB::Tag tag = inst_impl->get_state() == STATE_ACCESS ? inst_impl->get_tag() : DB::Tag();
+
+    mi::base::Handle<mi::mdl::IMDL> compiler(m_mdlc_module->get_mdl());
+    evaluate_enable_if_conditions(
+        compiler.get(), trans, *m_enable_if_cache, db_inst, tag, states);
+    return 0;
+}
+
+// Evaluates the enable_if conditions of all parameters of a function call.
+mi::Sint32 Mdl_evaluator_api_impl::are_function_parameters_enabled(
+    mi::neuraylib::ITransaction             *trans,
+    mi::neuraylib::IFunction_call const     *call,
+    mi::Sint32                              *states) const
+{
+    if (trans == NULL || call == NULL || states == NULL)
+        return -1;
+
+    Function_call_impl const *call_impl = static_cast<Function_call_impl const *>(call);
+    MI::MDL::Mdl_function_call const *db_call(call_impl->get_db_element());
+
+    // elements being edited might change without a new version, do not cache their results
+    DB::Tag tag = call_impl->get_state() == STATE_ACCESS ? call_impl->get_tag() : DB::Tag();
+
+    mi::base::Handle<mi::mdl::IMDL> compiler(m_mdlc_module->get_mdl());
+    evaluate_enable_if_conditions(
+        compiler.get(), trans, *m_enable_if_cache, db_call, tag, states);
+    return 0;
+}
+
 mi::Sint32 Mdl_evaluator_api_impl::start()
 {
     m_mdlc_module.set();
+    m_enable_if_cache->clear();
     return 0;
 }
 
 mi::Sint32 Mdl_evaluator_api_impl::shutdown()
 {
+    m_enable_if_cache->clear();
     m_mdlc_module.reset();
     return 0;
 }
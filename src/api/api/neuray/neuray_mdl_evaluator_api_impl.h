@@ -57,6 +57,8 @@ namespace MDLC { class Mdlc_module; }
 
 namespace NEURAY {
 
+class Enable_if_cache;
+
 class Mdl_evaluator_api_impl NEURAY_FINAL
   : public mi::base::Interface_implement<mi::neuraylib::IMdl_evaluator_api>
 {
@@ -106,6 +108,30 @@ public:
         mi::Size                                index,
         mi::Sint32                              *error) const NEURAY_FINAL;
 
+    /// Evaluates the enable_if conditions of all parameters of a material instance.
+    ///
+    /// \param[in]  trans   the transaction
+    /// \param[in]  inst    the material instance
+    /// \param[out] states  receives the state of each parameter
+    ///
+    /// \return 0 on success, -1 if an input parameter is NULL
+    mi::Sint32 are_material_parameters_enabled(
+        mi::neuraylib::ITransaction             *trans,
+        mi::neuraylib::IMaterial_instance const *inst,
+        mi::Sint32                              *states) const NEURAY_FINAL;
+
+    /// Evaluates the enable_if conditions of all parameters of a function call.
+    ///
+    /// \param[in]  trans   the transaction
+    /// \param[in]  call    the function call
+    /// \param[out] states  receives the state of each parameter
+    ///
+    /// \return 0 on success, -1 if an input parameter is NULL
+    mi::Sint32 are_function_parameters_enabled(
+        mi::neuraylib::ITransaction             *trans,
+        mi::neuraylib::IFunction_call const     *call,
+        mi::Sint32                              *states) const NEURAY_FINAL;
+
     // internal methods
 
     /// Starts this API component.
@@ -133,6 +159,9 @@ private:
     mi::neuraylib::INeuray *m_neuray;
 
     SYSTEM::Access_module<MDLC::Mdlc_module> m_mdlc_module;
+
+    /// The results of previous batch evaluations of enable_if conditions, per DB element.
+    Enable_if_cache *m_enable_if_cache;
 };
 
 } // namespace NEURAY
@@ -75,8 +75,6 @@ Scope_impl::Scope_impl( DB::Scope* scope, const Class_factory* class_factory)
             ".",
             id_as_uint);
     }
-
-    ASSERT( M_NEURAY_API, id == 0);
 }
 
 Scope_impl::~Scope_impl()
@@ -57,6 +57,7 @@
 #include <io/scene/mdl_elements/i_mdl_elements_function_definition.h>
 #include <io/scene/mdl_elements/i_mdl_elements_material_definition.h>
 #include <io/scene/mdl_elements/i_mdl_elements_module.h>
+#include <io/scene/mdl_elements/i_mdl_elements_utilities.h>
 
 
 namespace MI {
@@ -86,9 +87,10 @@ Transaction_impl::~Transaction_impl()
 {
     if( m_commit_or_abort_warning) {
         // Abort/commit the transaction here if it was not aborted or committed yet. Since this is
-        // not a proper usage, emit a warning/error. The MDL SDK does not support abort(), therefore
-        // we have to call commit(). This is unfortunate since it advantages users to omit the
-        // commit() call. Hence, it is treated as an error and not just as a warning.
+        // not a proper usage, emit a warning/error. For compatibility with earlier versions of the
+        // MDL SDK, which did not support abort(), we call commit(). This is unfortunate since it
+        // advantages users to omit the commit() call. Hence, it is treated as an error and not
+        // just as a warning.
         LOG::mod_log->error( SYSTEM::M_NEURAY_API, LOG::Mod_log::C_DATABASE,
             "Transaction is released without being committed or aborted. Automatically "
             "committing.");
@@ -128,9 +130,24 @@ mi::Sint32 Transaction_impl::commit()
 
 void Transaction_impl::abort()
 {
-    LOG::mod_log->error( SYSTEM::M_NEURAY_API, LOG::Mod_log::C_DATABASE,
-        "ITransaction::abort() is not supported.");
-    return;
+    if( !is_open())
+        return;
+
+    check_no_referenced_elements( "aborted");
+
+    m_commit_or_abort_warning = false;
+
+#ifdef VERBOSE_TX
+    LOG::mod_log->info( SYSTEM::M_NEURAY_API, LOG::Mod_log::C_DATABASE,
+        "TX %u aborting ...", m_id_as_uint);
+#endif
+
+    m_db_transaction->abort();
+
+#ifdef VERBOSE_TX
+    LOG::mod_log->info( SYSTEM::M_NEURAY_API, LOG::Mod_log::C_DATABASE,
+        "TX %u aborting done.", m_id_as_uint);
+#endif
 }
 
 bool Transaction_impl::is_open() const
@@ -303,6 +320,13 @@ mi::Sint32 Transaction_impl::remove(
     if( !tag)
         return -1;
 
+    // removing MDL modules or definitions might change the result of name lookups
+    SERIAL::Class_id class_id = m_db_transaction->get_class_id( tag);
+    if(    (class_id == MDL::ID_MDL_MODULE)
+        || (class_id == MDL::ID_MDL_MATERIAL_DEFINITION)
+        || (class_id == MDL::ID_MDL_FUNCTION_DEFINITION))
+        MDL::invalidate_call_resolution_cache();
+
 #ifdef VERBOSE_TX
     LOG::mod_log->info( SYSTEM::M_NEURAY_API, LOG::Mod_log::C_DATABASE,
         "TX %u removing \"%s\" ...", m_id_as_uint, name);
@@ -0,0 +1,182 @@
+/***************************************************************************************************
+ * Copyright (c) 2014-2018, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************************************/
+/// \file
+/// \brief The cache for cacheables, i.e., objects with data that can be regenerated on demand.
+
+#ifndef BASE_DATA_DB_I_DB_CACHE_H
+#define BASE_DATA_DB_I_DB_CACHE_H
+
+#include "i_db_cacheable.h"
+
+#include <cstddef>
+#include <mi/base/lock.h>
+#include <base/lib/cont/i_cont_dlist.h>
+
+namespace MI {
+
+namespace DBNR {
+
+/// Manages the memory usage of cacheables.
+///
+/// Cacheables are reference-counted. A cacheable whose reference count drops to 0 is appended
+/// to a list of flushable cacheables (in LRU order). If the total memory usage of all registered
+/// cacheables exceeds the high water mark, flushable cacheables are offloaded, starting with the
+/// least recently used one, until the memory usage drops below the low water mark or the list is
+/// exhausted.
+///
+/// All methods accept cacheables that were constructed without a cache (i.e., with \c NULL as
+/// cache). In that case the methods do nothing.
+///
+/// \note Owners of cacheables must not call methods of this class while holding locks that are
+///       also acquired by DB::Cacheable::offload() since that method is invoked with the lock of
+///       the cache being held.
+class Cache
+{
+public:
+    /// Statistics about the cache.
+    struct Statistics
+    {
+        /// The total memory usage of all registered cacheables (in bytes).
+        size_t m_memory_usage;
+        /// The low water mark (in bytes).
+        size_t m_low_water;
+        /// The high water mark (in bytes), or 0 for no limit.
+        size_t m_high_water;
+        /// The number of cacheables in the list of flushable cacheables.
+        size_t m_flushable_cacheables;
+        /// The number of offloaded cacheables since the creation of the cache.
+        size_t m_offloaded_cacheables;
+        /// The number of bytes freed by offloading since the creation of the cache.
+        size_t m_offloaded_memory;
+    };
+
+    /// Constructor.
+    ///
+    /// Initially, there is no memory limit.
+    Cache();
+
+    /// Destructor.
+    ~Cache();
+
+    /// Increments the reference count of a cacheable.
+    ///
+    /// Removes the cacheable from the list of flushable cacheables if the reference count is
+    /// incremented from 0 to 1.
+    void pin( DB::Cacheable* cacheable);
+
+    /// Decrements the reference count of a cacheable.
+    ///
+    /// Appends the cacheable to the list of flushable cacheables if the reference count is
+    /// decremented from 1 to 0. Cacheables are never destroyed by the cache.
+    void unpin( DB::Cacheable* cacheable);
+
+    /// Marks a cacheable as recently used.
+    ///
+    /// Moves the cacheable to the end of the list of flushable cacheables. Cacheables that have
+    /// been offloaded before are re-inserted into the list if their reference count is 0, i.e.,
+    /// owners are expected to call this method after regenerating the data of a cacheable.
+    void touch( DB::Cacheable* cacheable);
+
+    /// Reports a change of the memory usage of a cacheable (in bytes).
+    ///
+    /// Offloads flushable cacheables if the high water mark is exceeded afterwards.
+    void update_memory_usage( DB::Cacheable* cacheable, ptrdiff_t delta);
+
+    /// Unregisters a cacheable from the cache.
+    ///
+    /// Removes the cacheable from the list of flushable cacheables and subtracts its memory usage
+    /// from the total. Needs to be called at the beginning of the destructor of classes derived
+    /// from DB::Cacheable. Calling this method more than once is harmless.
+    void unregister_cacheable( DB::Cacheable* cacheable);
+
+    /// Offloads flushable cacheables in LRU order until the memory usage is at most \p target.
+    ///
+    /// \return   The memory usage after offloading (in bytes).
+    size_t offload( size_t target);
+
+    /// Sets the limits for the memory usage of all cacheables (in bytes).
+    ///
+    /// Offloads flushable cacheables if the new high water mark is already exceeded.
+    ///
+    /// \param low_water    The memory usage targeted by offloading.
+    /// \param high_water   The memory usage that triggers offloading, or 0 for no limit.
+    /// \return             0 in case of success, -1 if \p low_water exceeds \p high_water.
+    Sint32 set_memory_limits( size_t low_water, size_t high_water);
+
+    /// Returns the limits for the memory usage of all cacheables (in bytes).
+    void get_memory_limits( size_t& low_water, size_t& high_water) const;
+
+    /// Returns statistics about the cache.
+    void get_statistics( Statistics& statistics) const;
+
+private:
+    /// Offloads flushable cacheables until the memory usage is at most \p target.
+    ///
+    /// Needs to be called with #m_lock being held.
+    void offload_locked( size_t target);
+
+    /// Offloads flushable cacheables if the high water mark is exceeded.
+    ///
+    /// Needs to be called with #m_lock being held.
+    void check_memory_limits();
+
+    /// Applies a change of the memory usage of \p cacheable.
+    ///
+    /// Needs to be called with #m_lock being held.
+    void apply_memory_delta( DB::Cacheable* cacheable, ptrdiff_t delta);
+
+    /// The type of the list of flushable cacheables.
+    typedef CONT::Dlist_intr<DB::Cacheable, &DB::Cacheable::m_list_link> Cacheable_list;
+
+    /// The lock that protects all members below and the list-related members of the cacheables.
+    mutable mi::base::Lock m_lock;
+
+    /// The list of flushable cacheables, least recently used first.
+    Cacheable_list m_list;
+
+    /// The total memory usage of all registered cacheables (in bytes).
+    size_t m_memory_usage;
+
+    /// The low water mark (in bytes).
+    size_t m_low_water;
+
+    /// The high water mark (in bytes), or 0 for no limit.
+    size_t m_high_water;
+
+    /// The number of offloaded cacheables since the creation of the cache.
+    size_t m_offloaded_cacheables;
+
+    /// The number of bytes freed by offloading since the creation of the cache.
+    size_t m_offloaded_memory;
+};
+
+} // namespace DBNR
+
+} // namespace MI
+
+#endif // BASE_DATA_DB_I_DB_CACHE_H
@@ -42,6 +42,12 @@ namespace DBNR { class Cache; }
 namespace DB {
 
 /// The base class of objects managed by the #Cache class.
+///
+/// Cacheables hold data that can be regenerated on demand. The cache offloads the data of
+/// unreferenced cacheables in LRU order if the memory usage exceeds the configured limit.
+///
+/// \note Derived classes need to call DBNR::Cache::unregister_cacheable() at the beginning of their
+///       destructor. Otherwise, #offload() might be invoked on a partially destroyed object.
 class Cacheable : public STLEXT::Non_copyable
 {
 public:
@@ -49,7 +55,8 @@ public:
     ///
     /// The initial reference count is 1.
     ///
-    /// \param cache   The #Cache instance this cacheable belongs to.
+    /// \param cache   The #Cache instance this cacheable belongs to, or \c NULL if the cacheable
+    ///                is not managed by any cache.
     Cacheable( DBNR::Cache* cache);
 
     /// Destructor.
@@ -61,8 +68,9 @@ public:
     /// Offloads the cacheable and returns the difference in memory usages (in bytes, typically
     /// negative).
     ///
-    /// This method is invoked via #Cache_module::offload() for cacheables that are selected
-    /// based on an LRU strategy among all flushable cacheables.
+    /// This method is invoked via DBNR::Cache::offload() for cacheables that are selected
+    /// based on an LRU strategy among all flushable cacheables. It is called with the lock of the
+    /// cache being held, i.e., implementations must not call any methods of the cache.
     virtual ptrdiff_t offload() = 0;
 
     /// The #Cache class may access the private members, but no-one else.
@@ -97,6 +105,11 @@ private:
     ///
     /// Protected by #m_cache->m_lock.
     mi::Uint32 m_list_reference_count;
+
+    /// The memory usage of the cacheable as reported via DBNR::Cache::update_memory_usage().
+    ///
+    /// Protected by #m_cache->m_lock.
+    size_t m_memory_usage;
 };
 
 } // namespace DB
@@ -37,10 +37,22 @@
 #include <base/data/db/i_db_transaction.h>
 #include <base/data/db/i_db_access.h>
 
+#include "dblight_transaction.h"
+
 namespace MI {
 
 namespace DB {
 
+namespace {
+
+/// Unpins \p info under the database lock since the last unpin updates the reference counts.
+void unpin_info(Transaction* transaction, Info* info)
+{
+    static_cast<DBLIGHT::Transaction_impl*>(transaction->get_real_transaction())->unpin_info(info);
+}
+
+} // namespace
+
 Access_base::Access_base()
   : m_pointer(NULL),
     m_transaction(NULL),
@@ -205,14 +217,14 @@ void Access_base::cleanup()
             // cleanup after an edit was finished. This includes updating references,
             // sending data over the network etc.
             m_transaction->finish_edit(m_info, m_journal_type);
-            m_info->unpin();
+            unpin_info(m_transaction, m_info);
             m_info = NULL;
         }
         m_is_edit = false;
     } else {
         // unpin old info, if any
         if (m_info) {
-            m_info->unpin();
+            unpin_info(m_transaction, m_info);
         } else {
             // This is not valid. We might have returned a dummy element, though,
             // which we have to delete, now.
@@ -0,0 +1,243 @@
+/***************************************************************************************************
+ * Copyright (c) 2012-2018, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************************************/
+/** \file
+ ** \brief This file implements the cache for cacheables.
+ **/
+
+#include "pch.h"
+
+#include <base/data/db/i_db_cache.h>
+#include <base/system/main/i_assert.h>
+
+namespace MI {
+
+namespace DB {
+
+Cacheable::Cacheable(DBNR::Cache* cache)
+  : m_reference_count(1),
+    m_cache(cache),
+    m_in_list(false),
+    m_list_reference_count(1),
+    m_memory_usage(0)
+{
+}
+
+Cacheable::~Cacheable()
+{
+    // Derived classes are supposed to unregister themselves, but do it here again in case they
+    // do not hold any memory.
+    if (m_cache)
+        m_cache->unregister_cacheable(this);
+    MI_ASSERT(!m_in_list);
+}
+
+} // namespace DB
+
+namespace DBNR {
+
+Cache::Cache()
+  : m_memory_usage(0),
+    m_low_water(0),
+    m_high_water(0),
+    m_offloaded_cacheables(0),
+    m_offloaded_memory(0)
+{
+}
+
+Cache::~Cache()
+{
+    mi::base::Lock::Block block(&m_lock);
+    while (DB::Cacheable* cacheable = m_list.remove_first())
+        cacheable->m_in_list = false;
+}
+
+void Cache::pin(DB::Cacheable* cacheable)
+{
+    if (!cacheable->m_cache) {
+        ++cacheable->m_reference_count;
+        return;
+    }
+
+    MI_ASSERT(cacheable->m_cache == this);
+    mi::base::Lock::Block block(&m_lock);
+    ++cacheable->m_reference_count;
+    if (cacheable->m_list_reference_count++ == 0 && cacheable->m_in_list) {
+        m_list.remove(cacheable);
+        cacheable->m_in_list = false;
+    }
+}
+
+void Cache::unpin(DB::Cacheable* cacheable)
+{
+    if (!cacheable->m_cache) {
+        --cacheable->m_reference_count;
+        return;
+    }
+
+    MI_ASSERT(cacheable->m_cache == this);
+    mi::base::Lock::Block block(&m_lock);
+    MI_ASSERT(cacheable->m_list_reference_count > 0);
+    --cacheable->m_reference_count;
+    if (--cacheable->m_list_reference_count == 0 && !cacheable->m_in_list) {
+        m_list.append(cacheable);
+        cacheable->m_in_list = true;
+        check_memory_limits();
+    }
+}
+
+void Cache::touch(DB::Cacheable* cacheable)
+{
+    if (!cacheable->m_cache)
+        return;
+
+    MI_ASSERT(cacheable->m_cache == this);
+    mi::base::Lock::Block block(&m_lock);
+    if (cacheable->m_in_list)
+        m_list.remove(cacheable);
+    else if (cacheable->m_list_reference_count != 0)
+        return;
+    m_list.append(cacheable);
+    cacheable->m_in_list = true;
+}
+
+void Cache::update_memory_usage(DB::Cacheable* cacheable, ptrdiff_t delta)
+{
+    if (!cacheable->m_cache || delta == 0)
+        return;
+
+    MI_ASSERT(cacheable->m_cache == this);
+    mi::base::Lock::Block block(&m_lock);
+    apply_memory_delta(cacheable, delta);
+    if (delta > 0)
+        check_memory_limits();
+}
+
+void Cache::unregister_cacheable(DB::Cacheable* cacheable)
+{
+    if (!cacheable->m_cache)
+        return;
+
+    MI_ASSERT(cacheable->m_cache == this);
+    mi::base::Lock::Block block(&m_lock);
+    if (cacheable->m_in_list) {
+        m_list.remove(cacheable);
+        cacheable->m_in_list = false;
+    }
+    MI_ASSERT(m_memory_usage >= cacheable->m_memory_usage);
+    m_memory_usage -= cacheable->m_memory_usage;
+    cacheable->m_memory_usage = 0;
+    // Prevent any further re-insertion into the list.
+    cacheable->m_list_reference_count = ~0u / 2;
+}
+
+size_t Cache::offload(size_t target)
+{
+    mi::base::Lock::Block block(&m_lock);
+    offload_locked(target);
+    return m_memory_usage;
+}
+
+Sint32 Cache::set_memory_limits(size_t low_water, size_t high_water)
+{
+    if (high_water > 0 && low_water > high_water)
+        return -1;
+
+    mi::base::Lock::Block block(&m_lock);
+    m_low_water = low_water;
+    m_high_water = high_water;
+    check_memory_limits();
+    return 0;
+}
+
+void Cache::get_memory_limits(size_t& low_water, size_t& high_water) const
+{
+    mi::base::Lock::Block block(&m_lock);
+    low_water = m_low_water;
+    high_water = m_high_water;
+}
+
+void Cache::get_statistics(Statistics& statistics) const
+{
+    mi::base::Lock::Block block(&m_lock);
+    statistics.m_memory_usage = m_memory_usage;
+    statistics.m_low_water = m_low_water;
+    statistics.m_high_water = m_high_water;
+    statistics.m_flushable_cacheables = m_list.count();
+    statistics.m_offloaded_cacheables = m_offloaded_cacheables;
+    statistics.m_offloaded_memory = m_offloaded_memory;
+}
+
+void Cache::offload_locked(size_t target)
+{
+    // Cacheables that cannot be offloaded right now (offload() returns 0) are moved to the end of
+    // the list. Visit each cacheable at most once to guarantee termination.
+    size_t remaining = m_list.count();
+    while (m_memory_usage > target && remaining > 0) {
+        --remaining;
+        DB::Cacheable* cacheable = m_list.remove_first();
+        MI_ASSERT(cacheable && cacheable->m_list_reference_count == 0);
+
+        ptrdiff_t delta = cacheable->offload();
+        if (delta == 0) {
+            m_list.append(cacheable);
+            continue;
+        }
+
+        cacheable->m_in_list = false;
+        apply_memory_delta(cacheable, delta);
+        if (delta < 0) {
+            ++m_offloaded_cacheables;
+            m_offloaded_memory += static_cast<size_t>(-delta);
+        }
+    }
+}
+
+void Cache::check_memory_limits()
+{
+    if (m_high_water > 0 && m_memory_usage > m_high_water)
+        offload_locked(m_low_water);
+}
+
+void Cache::apply_memory_delta(DB::Cacheable* cacheable, ptrdiff_t delta)
+{
+    if (delta < 0) {
+        size_t decrease = static_cast<size_t>(-delta);
+        MI_ASSERT(cacheable->m_memory_usage >= decrease);
+        if (decrease > cacheable->m_memory_usage)
+            decrease = cacheable->m_memory_usage;
+        cacheable->m_memory_usage -= decrease;
+        m_memory_usage -= decrease;
+    } else {
+        cacheable->m_memory_usage += static_cast<size_t>(delta);
+        m_memory_usage += static_cast<size_t>(delta);
+    }
+}
+
+} // namespace DBNR
+
+} // namespace MI
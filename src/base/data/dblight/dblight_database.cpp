@@ -29,7 +29,8 @@
 /** \file
  ** \brief Implementation of the lightweight database.
  **
- ** This is an implementation of the database. It does only very little things.
+ ** This is an implementation of the database. It does only very little things. Concurrent
+ ** transactions are supported by keeping multiple versions per tag.
  **/
 
 #include "pch.h"
@@ -48,20 +49,62 @@ namespace MI {
 
 namespace DBLIGHT {
 
+namespace {
+
+/// Indicates whether \p first is sorted before \p second in a #Name_binding_list.
+bool is_older(const Name_binding& first, const Name_binding& second)
+{
+    if (first.m_scope_id != second.m_scope_id)
+        return first.m_scope_id < second.m_scope_id;
+    if (first.m_transaction_id != second.m_transaction_id)
+        return first.m_transaction_id < second.m_transaction_id;
+    return first.m_version < second.m_version;
+}
+
+/// Inserts \p binding into \p bindings and returns the new number of bindings.
+size_t insert_binding(Name_binding_list& bindings, const Name_binding& binding)
+{
+    // Bindings are usually created in ascending order. Only concurrent transactions with smaller
+    // IDs need to insert before the end.
+    Name_binding_list::iterator it = bindings.end();
+    while (it != bindings.begin() && is_older(binding, *(it-1)))
+        --it;
+    bindings.insert(it, binding);
+    return bindings.size();
+}
+
+} // namespace
+
 Database_impl::Database_impl()
-  : m_global_scope(new Scope_impl(this))
+  : m_next_scope_id(0)
+  , m_journal_size(0)
+  , m_commits_since_collection(0)
+  , m_global_scope(new Scope_impl(this, 0, DB::Scope_id(0), 0, ""))
 {
+    m_scopes[m_global_scope->get_id()] = m_global_scope;
 }
 
 Database_impl::~Database_impl()
 {
     for (Tag_map::iterator it = m_tags.begin(); it != m_tags.end(); ++it) {
-        DB::Info* info = it->second;
-        MI_ASSERT(info->get_pin_count() == 1);
-        info->unpin();
+        Info_list& versions = it->second;
+        for (size_t i = 0; i < versions.size(); ++i) {
+            DB::Info* info = versions[i];
+            MI_ASSERT(info->get_pin_count() == 1);
+            info->unpin();
+        }
     }
 
-    m_global_scope->unpin();
+    Open_transaction_map::iterator it_transaction     = m_open_transactions.begin();
+    Open_transaction_map::iterator it_transaction_end = m_open_transactions.end();
+    for ( ; it_transaction != it_transaction_end; ++it_transaction)
+        it_transaction->second->unpin();
+
+    // also releases the global scope
+    Scope_map::iterator it_scope     = m_scopes.begin();
+    Scope_map::iterator it_scope_end = m_scopes.end();
+    for ( ; it_scope != it_scope_end; ++it_scope)
+        it_scope->second->unpin();
 }
 
 void Database_impl::prepare_close() { }
@@ -73,29 +116,112 @@ void Database_impl::close()
 
 void Database_impl::garbage_collection()
 {
-    Uint32 counter = m_global_scope->increment_transaction_count();
-    if (counter > 1) {
-        m_global_scope->decrement_transaction_count();
-        return;
-    }
-
-    garbage_collection_internal();
-    m_global_scope->decrement_transaction_count();
+    mi::base::Lock::Block block(&m_transaction_lock);
+    collect();
 }
 
 DB::Scope* Database_impl::get_global_scope() { return m_global_scope; }
 
 DB::Scope* Database_impl::lookup_scope(DB::Scope_id id)
 {
-    return id == 0 ? m_global_scope : 0;
+    mi::base::Lock::Block block(&m_scope_lock);
+
+    Scope_map::const_iterator it = m_scopes.find(id);
+    return it != m_scopes.end() ? it->second : 0;
 }
 
 DB::Scope* Database_impl::lookup_scope(const std::string& name)
 {
-    return 0;
+    mi::base::Lock::Block block(&m_scope_lock);
+
+    Named_scope_map::const_iterator it = m_named_scopes.find(name);
+    if (it == m_named_scopes.end())
+        return 0;
+
+    Scope_map::const_iterator it_scope = m_scopes.find(it->second);
+    MI_ASSERT(it_scope != m_scopes.end());
+    return it_scope->second;
 }
 
-bool Database_impl::remove(DB::Scope_id id) { return false; }
+bool Database_impl::remove(DB::Scope_id id)
+{
+    if (id == 0)
+        return false;
+
+    mi::base::Lock::Block scope_block(&m_scope_lock);
+
+    Scope_map::iterator it = m_scopes.find(id);
+    if (it == m_scopes.end())
+        return false;
+
+    // Collect the scope and all its descendants.
+    Scope_impl* scope = it->second;
+    std::set<DB::Scope_id> removed_ids;
+    for (Scope_map::const_iterator it_scope = m_scopes.begin(); it_scope != m_scopes.end();
+        ++it_scope)
+        if (it_scope->second->is_self_or_ancestor(scope))
+            removed_ids.insert(it_scope->first);
+
+    mi::base::Lock::Block transaction_block(&m_transaction_lock);
+
+    // Removing scopes with open transactions is not supported.
+    Open_transaction_map::const_iterator it_transaction     = m_open_transactions.begin();
+    Open_transaction_map::const_iterator it_transaction_end = m_open_transactions.end();
+    for ( ; it_transaction != it_transaction_end; ++it_transaction) {
+        DB::Scope_id scope_id = it_transaction->second->get_scope()->get_id();
+        if (removed_ids.find(scope_id) != removed_ids.end())
+            return false;
+    }
+
+    {
+        mi::base::Lock::Block block(&m_lock);
+
+        // Names bound in the removed scopes become unbound (or fall back to the bindings in the
+        // remaining ancestor scopes).
+        erase_bindings(removed_ids);
+
+        // Release all versions in the removed scopes. Tags that were created in these scopes do
+        // not have any version left and are removed completely. They are erased only after all
+        // versions were released, since releasing a version drops its references to other tags.
+        std::vector<Tag_map::iterator> emptied_tags;
+        Tag_map::iterator it_tag = m_tags.begin();
+        while (it_tag != m_tags.end()) {
+            Info_list& versions = it_tag->second;
+            size_t n = 0;
+            for (size_t i = 0; i < versions.size(); ++i) {
+                DB::Info* info = versions[i];
+                if (removed_ids.find(info->get_scope_id()) != removed_ids.end())
+                    info->unpin();
+                else
+                    versions[n++] = info;
+            }
+            versions.resize(n);
+
+            if (n == 0)
+                emptied_tags.push_back(it_tag);
+            else if (n == 1)
+                m_tags_with_multiple_versions.erase(it_tag->first);
+            ++it_tag;
+        }
+
+        for (size_t i = 0; i < emptied_tags.size(); ++i)
+            erase_tag(emptied_tags[i]);
+    }
+
+    std::set<DB::Scope_id>::const_iterator it_id     = removed_ids.begin();
+    std::set<DB::Scope_id>::const_iterator it_id_end = removed_ids.end();
+    for ( ; it_id != it_id_end; ++it_id) {
+        Scope_map::iterator it_scope = m_scopes.find(*it_id);
+        Scope_impl* removed_scope = it_scope->second;
+        removed_scope->set_removed();
+        if (!removed_scope->get_name().empty())
+            m_named_scopes.erase(removed_scope->get_name());
+        m_scopes.erase(it_scope);
+        removed_scope->unpin();
+    }
+
+    return true;
+}
 
 Sint32 Database_impl::set_memory_limits(size_t low_water, size_t high_water)
 {
@@ -156,6 +282,210 @@ void Database_impl::unregister_transaction_listener(DB::ITransaction_listener* l
     { MI_ASSERT(false); }
 void Database_impl::register_scope_listener(DB::IScope_listener* listener) { MI_ASSERT(false); }
 void Database_impl::unregister_scope_listener(DB::IScope_listener* listener) { MI_ASSERT(false); }
+
+void Database_impl::lowest_open_transaction_id_changed(DB::Transaction_id transaction_id)
+{
+    mi::base::Lock::Block block(&m_lock);
+
+    DB::Tag_set::iterator it = m_tags_with_multiple_versions.begin();
+    while (it != m_tags_with_multiple_versions.end()) {
+
+        // A version is not visible to any transaction anymore if the next version in the same
+        // scope has been created by a transaction visible to all transactions.
+        Info_list& versions = m_tags[*it];
+        size_t n = 0;
+        for (size_t i = 0; i < versions.size(); ++i) {
+            DB::Info* info = versions[i];
+            if (i+1 < versions.size()
+                && versions[i+1]->get_scope_id() == info->get_scope_id()
+                && versions[i+1]->get_transaction_id() < transaction_id)
+                info->unpin();
+            else
+                versions[n++] = info;
+        }
+        versions.resize(n);
+
+        if (n <= 1)
+            m_tags_with_multiple_versions.erase(it++);
+        else
+            ++it;
+    }
+
+    // Same for the bindings of names and tags.
+    std::set<std::string>::iterator it_name = m_names_with_multiple_bindings.begin();
+    while (it_name != m_names_with_multiple_bindings.end()) {
+        if (release_old_bindings(m_named_tags[*it_name], transaction_id) <= 1)
+            m_names_with_multiple_bindings.erase(it_name++);
+        else
+            ++it_name;
+    }
+
+    it = m_tags_with_multiple_bindings.begin();
+    while (it != m_tags_with_multiple_bindings.end()) {
+        if (release_old_bindings(m_reverse_named_tags[*it], transaction_id) <= 1)
+            m_tags_with_multiple_bindings.erase(it++);
+        else
+            ++it;
+    }
+}
+
+size_t Database_impl::release_old_bindings(
+    Name_binding_list& bindings, DB::Transaction_id transaction_id)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < bindings.size(); ++i)
+        if (i+1 >= bindings.size()
+            || bindings[i+1].m_scope_id != bindings[i].m_scope_id
+            || !(bindings[i+1].m_transaction_id < transaction_id))
+            bindings[n++] = bindings[i];
+    bindings.resize(n);
+    return n;
+}
+
+void Database_impl::erase_bindings(const std::set<DB::Scope_id>& scope_ids)
+{
+    Named_tag_map::iterator it_name = m_named_tags.begin();
+    while (it_name != m_named_tags.end()) {
+        Name_binding_list& bindings = it_name->second;
+        size_t n = 0;
+        for (size_t i = 0; i < bindings.size(); ++i)
+            if (scope_ids.find(bindings[i].m_scope_id) == scope_ids.end())
+                bindings[n++] = bindings[i];
+        bindings.resize(n);
+
+        if (n <= 1)
+            m_names_with_multiple_bindings.erase(it_name->first);
+        if (n == 0)
+            m_named_tags.erase(it_name++);
+        else
+            ++it_name;
+    }
+
+    Reverse_named_tag_map::iterator it_tag = m_reverse_named_tags.begin();
+    while (it_tag != m_reverse_named_tags.end()) {
+        Name_binding_list& bindings = it_tag->second;
+        size_t n = 0;
+        for (size_t i = 0; i < bindings.size(); ++i)
+            if (scope_ids.find(bindings[i].m_scope_id) == scope_ids.end())
+                bindings[n++] = bindings[i];
+        bindings.resize(n);
+
+        if (n <= 1)
+            m_tags_with_multiple_bindings.erase(it_tag->first);
+        if (n == 0)
+            m_reverse_named_tags.erase(it_tag++);
+        else
+            ++it_tag;
+    }
+}
+
+void Database_impl::erase_bindings(
+    Name_binding_list& bindings, const std::string& name, DB::Tag tag)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < bindings.size(); ++i)
+        if (bindings[i].m_tag != tag || *bindings[i].m_name != name)
+            bindings[n++] = bindings[i];
+    bindings.resize(n);
+}
+
+Scope_impl* Database_impl::create_scope(
+    Scope_impl* parent, DB::Privacy_level level, const std::string& name)
+{
+    if (level <= parent->get_level())
+        return 0;
+
+    mi::base::Lock::Block block(&m_scope_lock);
+
+    // checked under the lock that remove() holds while flagging the scope
+    if (parent->is_removed())
+        return 0;
+
+    if (!name.empty()) {
+        Named_scope_map::const_iterator it = m_named_scopes.find(name);
+        if (it != m_named_scopes.end()) {
+            Scope_impl* scope = m_scopes[it->second];
+            if (scope->get_parent_scope() != parent || scope->get_level() != level)
+                return 0;
+            return scope;
+        }
+    }
+
+    DB::Scope_id id = ++m_next_scope_id;
+    Scope_impl* scope = new Scope_impl(this, parent, id, level, name);
+    m_scopes[id] = scope;
+    if (!name.empty())
+        m_named_scopes[name] = id;
+    return scope;
+}
+
+Transaction_impl* Database_impl::start_transaction(Scope_impl* scope)
+{
+    mi::base::Lock::Block block(&m_transaction_lock);
+
+    // Checking the flag and registering the transaction under the lock that remove() holds while
+    // checking for open transactions and flagging the scope ensures that no transaction is started
+    // in a removed scope.
+    if (scope->is_removed())
+        return 0;
+
+    // Allocating the ID and taking the snapshot of open transactions under the same lock ensures
+    // that all transactions with smaller IDs are either in the snapshot or already committed.
+    DB::Transaction_id transaction_id = allocate_transaction_id();
+    Transaction_impl* transaction
+        = new Transaction_impl(this, scope, transaction_id, m_open_transactions);
+    m_open_transactions[transaction_id] = transaction;
+    return transaction;
+}
+
+void Database_impl::end_transaction(Transaction_impl* transaction)
+{
+    {
+        mi::base::Lock::Block block(&m_transaction_lock);
+
+        Open_transaction_map::iterator it = m_open_transactions.find(transaction->get_id());
+        MI_ASSERT(it != m_open_transactions.end());
+        m_open_transactions.erase(it);
+
+        // Releasing old versions and collecting garbage is deferred until enough commits or
+        // garbage candidates have accumulated (or until garbage_collection() is called). Keep
+        // holding the lock such that no transaction can be started meanwhile.
+        size_t candidates;
+        {
+            mi::base::Lock::Block block(&m_lock);
+            candidates = m_reference_count_zero.size();
+        }
+        if (++m_commits_since_collection >= GC_COMMIT_INTERVAL
+            || candidates >= GC_CANDIDATE_THRESHOLD)
+            collect();
+    }
+
+    transaction->unpin();
+}
+
+void Database_impl::collect()
+{
+    DB::Transaction_id transaction_id = get_lowest_open_transaction_id();
+    lowest_open_transaction_id_changed(transaction_id);
+    garbage_collection_internal(transaction_id);
+    m_commits_since_collection = 0;
+}
+
+DB::Transaction_id Database_impl::get_lowest_open_transaction_id() const
+{
+    if (m_open_transactions.empty())
+        return DB::Transaction_id(m_next_transaction_id + 1);
+
+    DB::Transaction_id result = m_open_transactions.begin()->first;
+    Open_transaction_map::const_iterator it     = m_open_transactions.begin();
+    Open_transaction_map::const_iterator it_end = m_open_transactions.end();
+    for ( ; it != it_end; ++it) {
+        DB::Transaction_id visibility_bound = it->second->get_visibility_bound();
+        if (visibility_bound < result)
+            result = visibility_bound;
+    }
+    return result;
+}
 void Database_impl::set_ready_event(EVENT::Event0_base* event) { MI_ASSERT(false); }
 
 DB::Transaction* Database_impl::get_transaction(DB::Transaction_id id)
@@ -192,8 +522,13 @@ void Database_impl::increment_reference_count(DB::Tag tag)
 
 void Database_impl::decrement_reference_count(DB::Tag tag)
 {
-    Uint32 value = --m_reference_counts[tag];
-    if (value == 0)
+    // Infos pinned elsewhere might be destroyed after the referenced tag was erased.
+    Reference_count_map::iterator it = m_reference_counts.find(tag);
+    if (it == m_reference_counts.end())
+        return;
+
+    MI_ASSERT(it->second > 0);
+    if (--it->second == 0)
         m_reference_count_zero.insert(tag);
 }
 
@@ -221,36 +556,212 @@ Uint32 Database_impl::get_tag_reference_count(DB::Tag tag)
     return m_reference_counts[tag];
 }
 
-void Database_impl::garbage_collection_internal()
+void Database_impl::garbage_collection_internal(DB::Transaction_id transaction_id)
 {
     mi::base::Lock::Block block(&m_lock);
 
-    while (true) {
+    // Erasing a tag releases its references, which might turn further tags into garbage.
+    bool erased = true;
+    while (erased) {
 
+        erased = false;
         DB::Tag_set candidates = m_reference_count_zero;
-        if (candidates.empty())
-            return;
 
         DB::Tag_set::const_iterator it     = candidates.begin();
         DB::Tag_set::const_iterator it_end = candidates.end();
         for ( ;  it != it_end; ++it) {
 
-            DB::Tag tag = *it;
+            Tag_map::iterator it_info = m_tags.find(*it);
+            if (it_info == m_tags.end()) {
+                // tag was already removed together with its scope or by an aborted transaction
+                m_reference_counts.erase(*it);
+                m_reference_count_zero.erase(*it);
+                continue;
+            }
+
+            // The removing transaction might still be open (and abort), or its removal might be
+            // invisible to some open transaction.
+            Flagged_for_removal_map::const_iterator it_flag = m_tags_flagged_for_removal.find(*it);
+            if (it_flag != m_tags_flagged_for_removal.end() && !(it_flag->second < transaction_id))
+                continue;
+
+            erase_tag(it_info);
+            erased = true;
+        }
+    }
+}
 
-            Tag_map::iterator it_info = m_tags.find(tag);
-            it_info->second->unpin();
-            m_tags.erase(it_info);
+void Database_impl::erase_tag(Tag_map::iterator it)
+{
+    DB::Tag tag = it->first;
+
+    Info_list& versions = it->second;
+    for (size_t i = 0; i < versions.size(); ++i)
+        versions[i]->unpin();
+    m_tags.erase(it);
+
+    Reverse_named_tag_map::iterator it_names = m_reverse_named_tags.find(tag);
+    if (it_names != m_reverse_named_tags.end()) {
+        const Name_binding_list& bindings = it_names->second;
+        for (size_t i = 0; i < bindings.size(); ++i) {
+            const std::string& name = *bindings[i].m_name;
+            Named_tag_map::iterator it_tags = m_named_tags.find(name);
+            if (it_tags == m_named_tags.end())
+                continue;
+            erase_bindings(it_tags->second, name, tag);
+            if (it_tags->second.size() <= 1)
+                m_names_with_multiple_bindings.erase(name);
+            if (it_tags->second.empty())
+                m_named_tags.erase(it_tags);
+        }
+        m_reverse_named_tags.erase(it_names);
+    }
 
-            Reverse_named_tag_map::iterator it_name = m_reverse_named_tags.find(tag);
-            m_named_tags.erase(it_name->second);
-            m_reverse_named_tags.erase(it_name);
+    m_tags_flagged_for_removal.erase(tag);
+    m_reference_counts.erase(tag);
+    m_reference_count_zero.erase(tag);
+    m_tags_with_multiple_versions.erase(tag);
+    m_tags_with_multiple_bindings.erase(tag);
+}
 
-            m_tags_flagged_for_removal.erase(tag); m_reference_counts.erase(tag);
-            m_reference_count_zero.erase(tag);
+void Database_impl::discard_transaction(
+    DB::Transaction_id id, const DB::Tag_set& changed_tags, const DB::Tag_set& removed_tags)
+{
+    DB::Tag_set::const_iterator it     = removed_tags.begin();
+    DB::Tag_set::const_iterator it_end = removed_tags.end();
+    for ( ; it != it_end; ++it) {
+        Flagged_for_removal_map::iterator it_flag = m_tags_flagged_for_removal.find(*it);
+        if (it_flag != m_tags_flagged_for_removal.end() && it_flag->second == id) {
+            m_tags_flagged_for_removal.erase(it_flag);
+            increment_reference_count(*it);
         }
     }
+
+    // Tags created by the transaction are erased only after all its versions were released, since
+    // releasing a version drops its references to other tags.
+    std::vector<Tag_map::iterator> emptied_tags;
+
+    it     = changed_tags.begin();
+    it_end = changed_tags.end();
+    for ( ; it != it_end; ++it) {
+
+        // Drop the name bindings of the transaction, the bindings of the snapshot become visible
+        // again.
+        Reverse_named_tag_map::iterator it_names = m_reverse_named_tags.find(*it);
+        if (it_names != m_reverse_named_tags.end()) {
+            Name_binding_list& bindings = it_names->second;
+            size_t n = 0;
+            for (size_t i = 0; i < bindings.size(); ++i) {
+                const Name_binding& binding = bindings[i];
+                if (binding.m_transaction_id != id) {
+                    bindings[n++] = binding;
+                    continue;
+                }
+                Named_tag_map::iterator it_tags = m_named_tags.find(*binding.m_name);
+                if (it_tags == m_named_tags.end())
+                    continue;
+                erase_bindings(it_tags->second, id, *it);
+                if (it_tags->second.size() <= 1)
+                    m_names_with_multiple_bindings.erase(*binding.m_name);
+                if (it_tags->second.empty())
+                    m_named_tags.erase(it_tags);
+            }
+            bindings.resize(n);
+
+            if (n <= 1)
+                m_tags_with_multiple_bindings.erase(*it);
+            if (n == 0)
+                m_reverse_named_tags.erase(it_names);
+        }
+
+        Tag_map::iterator it_tag = m_tags.find(*it);
+        if (it_tag == m_tags.end())
+            continue;
+
+        Info_list& versions = it_tag->second;
+        size_t n = 0;
+        for (size_t i = 0; i < versions.size(); ++i) {
+            DB::Info* info = versions[i];
+            if (info->get_transaction_id() == id)
+                info->unpin();
+            else
+                versions[n++] = info;
+        }
+        versions.resize(n);
+
+        // tags created by the transaction do not have any version left
+        if (n == 0)
+            emptied_tags.push_back(it_tag);
+        else if (n == 1)
+            m_tags_with_multiple_versions.erase(*it);
+    }
+
+    for (size_t i = 0; i < emptied_tags.size(); ++i)
+        erase_tag(emptied_tags[i]);
+
+    Journal_map::iterator it_journal = m_journal.find(id);
+    if (it_journal != m_journal.end()) {
+        m_journal_size -= it_journal->second.size();
+        m_journal.erase(it_journal);
+    }
+}
+
+void Database_impl::add_journal_entry(
+    DB::Transaction_id transaction_id,
+    Uint32 version,
+    DB::Scope_id scope_id,
+    DB::Tag tag,
+    DB::Journal_type journal_type)
+{
+    Journal_entry entry;
+    entry.m_version = version;
+    entry.m_scope_id = scope_id;
+    entry.m_tag = tag;
+    entry.m_journal_type = journal_type;
+    m_journal[transaction_id].push_back(entry);
+    ++m_journal_size;
+
+    while (m_journal_size > JOURNAL_CAPACITY) {
+        Journal_map::iterator it = m_journal.begin();
+        m_journal_size -= it->second.size();
+        if (m_journal_pruned_transaction_id < it->first)
+            m_journal_pruned_transaction_id = it->first;
+        m_journal.erase(it);
+    }
 }
 
+void Database_impl::add_version(DB::Tag tag, DB::Info* info)
+{
+    Info_list& versions = m_tags[tag];
+
+    // Versions are usually created in ascending order. Only concurrent transactions with smaller
+    // IDs need to insert before the end.
+    Info_list::iterator it = versions.end();
+    while (it != versions.begin() && DB::Info_base::compare(*(it-1), info) < 0)
+        --it;
+    versions.insert(it, info);
+
+    if (versions.size() > 1)
+        m_tags_with_multiple_versions.insert(tag);
+}
+
+void Database_impl::add_name_binding(const Name_binding& binding)
+{
+    if (insert_binding(m_named_tags[*binding.m_name], binding) > 1)
+        m_names_with_multiple_bindings.insert(*binding.m_name);
+    if (insert_binding(m_reverse_named_tags[binding.m_tag], binding) > 1)
+        m_tags_with_multiple_bindings.insert(binding.m_tag);
+}
+
+void Database_impl::erase_bindings(
+    Name_binding_list& bindings, DB::Transaction_id id, DB::Tag tag)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < bindings.size(); ++i)
+        if (bindings[i].m_tag != tag || bindings[i].m_transaction_id != id)
+            bindings[n++] = bindings[i];
+    bindings.resize(n);
+}
 
 DB::Database* factory()
 {
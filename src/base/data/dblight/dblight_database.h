@@ -36,9 +36,13 @@
 #define BASE_DATA_DBLIGHT_DBLIGHT_IMPL_H
 
 #include <base/data/db/i_db_database.h>
+#include <base/data/db/i_db_journal_type.h>
 
 #include <string>
 #include <map>
+#include <set>
+#include <vector>
+#include <boost/shared_ptr.hpp>
 #include <mi/base/atom.h>
 #include <mi/base/lock.h>
 
@@ -50,18 +54,80 @@ namespace DB { class Info; }
 namespace DBLIGHT {
 
 class Scope_impl;
+class Transaction_impl;
+
+/// The versions of a tag, sorted by scope ID, transaction ID, and version in ascending order.
+///
+/// Each transaction creates a new version when storing or editing a tag. Old versions are kept as
+/// long as they might be visible to some open transaction, see
+/// #Database_impl::lowest_open_transaction_id_changed().
+typedef std::vector<DB::Info*> Info_list;
+
+/// Map of tags to their versions
+typedef std::map<DB::Tag, Info_list> Tag_map;
+
+/// A bound name.
+///
+/// Names are reference-counted such that names returned by #Transaction_impl::tag_to_name() stay
+/// valid while the bindings are reallocated, compacted, or released.
+typedef boost::shared_ptr<const std::string> Name_ptr;
+
+/// One binding of a name to a tag, i.e., the name passed to a store operation.
+///
+/// Like versions of tags, bindings are stamped with the scope of the stored version, the creating
+/// transaction ID, and the per-transaction version. Hence, each transaction sees the binding of
+/// its snapshot, and bindings in a scope shadow bindings in its ancestor scopes.
+struct Name_binding
+{
+    /// The bound name
+    Name_ptr m_name;
+    /// The bound tag
+    DB::Tag m_tag;
+    /// The scope of the binding
+    DB::Scope_id m_scope_id;
+    /// The ID of the transaction that created the binding
+    DB::Transaction_id m_transaction_id;
+    /// The version of the tag in the creating transaction
+    Uint32 m_version;
+};
+
+/// The bindings of a name or of a tag, sorted by scope ID, transaction ID, and version in ascending
+/// order.
+typedef std::vector<Name_binding> Name_binding_list;
+
+/// Map of names (strings) to their bindings
+typedef std::map<std::string, Name_binding_list> Named_tag_map;
+
+/// Map of tags to their bindings
+typedef std::map<DB::Tag, Name_binding_list> Reverse_named_tag_map;
 
-/// Map of tags to infos
-typedef std::map<DB::Tag, DB::Info*> Tag_map;
+/// Map of tags flagged for removal to the ID of the removing transaction
+typedef std::map<DB::Tag, DB::Transaction_id> Flagged_for_removal_map;
 
-/// Map of names (strings) to tags
-typedef std::map<std::string, DB::Tag> Named_tag_map;
+/// Map of scope IDs to scopes
+typedef std::map<DB::Scope_id, Scope_impl*> Scope_map;
 
-/// Map of tags to names (strings)
-typedef std::map<DB::Tag, std::string> Reverse_named_tag_map;
+/// Map of scope names to scope IDs
+typedef std::map<std::string, DB::Scope_id> Named_scope_map;
+
+/// Map of open transaction IDs to the corresponding transactions
+typedef std::map<DB::Transaction_id, Transaction_impl*> Open_transaction_map;
+
+/// One entry of the journal, i.e., a change of a tag
+struct Journal_entry
+{
+    /// The version of the tag in the changing transaction
+    Uint32 m_version;
+    /// The scope of the changed version
+    DB::Scope_id m_scope_id;
+    /// The changed tag
+    DB::Tag m_tag;
+    /// The kind of the change
+    DB::Journal_type m_journal_type;
+};
 
-/// Set of tags flagged for removal
-typedef std::set<DB::Tag> Flagged_for_removal_set;
+/// Map of transaction IDs to the journal entries of that transaction (in the order of changes)
+typedef std::map<DB::Transaction_id, std::vector<Journal_entry> > Journal_map;
 
 /// Map of tags to reference count
 typedef std::map<DB::Tag, Uint32> Reference_count_map;
@@ -105,7 +171,6 @@ public:
     void unregister_transaction_listener(DB::ITransaction_listener* listener);
     void register_scope_listener(DB::IScope_listener* listener);
     void unregister_scope_listener(DB::IScope_listener* listener);
-    void lowest_open_transaction_id_changed(DB::Transaction_id transaction_id);
 
     void set_ready_event(EVENT::Event0_base* event);
     DB::Transaction* get_transaction(DB::Transaction_id id);
@@ -125,12 +190,30 @@ public:
     DB::Transaction_id allocate_transaction_id()
     { return DB::Transaction_id(++m_next_transaction_id); }
 
+    /// Used by the scope to create child scopes.
+    ///
+    /// Returns an existing scope if a scope with the same name, parent, and level exists already.
+    /// Returns \c NULL if \p level is not larger than the level of \p parent, if \p parent has been
+    /// removed, or if a scope with the same name but different parent or level exists.
+    Scope_impl* create_scope(
+        Scope_impl* parent, DB::Privacy_level level, const std::string& name);
+
+    /// Used by the scope to start transactions.
+    ///
+    /// Returns \c NULL if \p scope has been removed.
+    Transaction_impl* start_transaction(Scope_impl* scope);
+
+    /// Used by the transaction during commit(). Removes the transaction from the set of open
+    /// transactions, and from time to time releases versions that became invisible and collects
+    /// garbage.
+    void end_transaction(Transaction_impl* transaction);
+
     /// Used by the info/transaction to increment the reference count of the tag.
     /// Needs #m_lock.
     void increment_reference_count(DB::Tag tag);
 
-    /// Used by the info/transaction to decrement the reference counts of the tag.
-    /// Needs #m_lock.
+    /// Used by the info/transaction to decrement the reference counts of the tag. Tags that were
+    /// erased already are skipped. Needs #m_lock.
     void decrement_reference_count(DB::Tag tag);
 
     /// Used by the info to increment the reference counts of the referenced elements.
@@ -144,47 +227,161 @@ public:
     /// Returns the reference count of the tag.
     Uint32 get_tag_reference_count(DB::Tag tag);
 
-    /// Used by the transaction during commit(). The caller must ensure that there is no open
-    /// transaction.
-    void garbage_collection_internal();
+    /// Used by the transaction during abort(). Removes all versions and name bindings created by
+    /// the transaction \p id for the tags in \p changed_tags, undoes its removal requests for the
+    /// tags in \p removed_tags, and drops its journal. Tags without any remaining version are
+    /// removed completely. Needs #m_lock.
+    void discard_transaction(
+        DB::Transaction_id id, const DB::Tag_set& changed_tags, const DB::Tag_set& removed_tags);
+
+    /// Collects all garbage, i.e., releases all unreferenced tags flagged for removal by
+    /// transactions with IDs smaller than \p transaction_id. Removals by these transactions are
+    /// visible to all open transactions, see #lowest_open_transaction_id_changed().
+    void garbage_collection_internal(DB::Transaction_id transaction_id);
+
+    /// Invoked when the lowest ID of all transactions that might still see old versions
+    /// changes. All transactions with smaller IDs are committed and visible to all open and future
+    /// transactions. Hence, for each tag only the most recent version created by such
+    /// transactions is kept per scope, older versions are released.
+    void lowest_open_transaction_id_changed(DB::Transaction_id transaction_id);
+
+    /// Used by the transaction to record a change in the journal. Needs #m_lock.
+    ///
+    /// If the journal exceeds #JOURNAL_CAPACITY entries, the journals of the oldest transactions
+    /// are dropped.
+    void add_journal_entry(
+        DB::Transaction_id transaction_id,
+        Uint32 version,
+        DB::Scope_id scope_id,
+        DB::Tag tag,
+        DB::Journal_type journal_type);
+
+    /// Used by the transaction to access the journal. Needs #m_lock.
+    const Journal_map& get_journal_map() const { return m_journal; }
+
+    /// Returns the ID of the most recent transaction whose journal was dropped (or 0 if the
+    /// journal was never pruned). Needs #m_lock.
+    DB::Transaction_id get_journal_pruned_transaction_id() const
+    { return m_journal_pruned_transaction_id; }
+
+    /// The maximum number of journal entries kept.
+    static const size_t JOURNAL_CAPACITY = 1 << 18;
+
+    /// Adds a new version of an existing tag. Needs #m_lock.
+    void add_version(DB::Tag tag, DB::Info* info);
+
+    /// Binds a name to a tag. Older bindings of the name and the tag are kept for concurrent
+    /// transactions. Needs #m_lock.
+    void add_name_binding(const Name_binding& binding);
+
+    /// Number of commits after which old versions are released and garbage is collected.
+    static const Uint32 GC_COMMIT_INTERVAL = 16;
+
+    /// Number of unreferenced tags that triggers releasing old versions and collecting garbage
+    /// at the next commit.
+    static const size_t GC_CANDIDATE_THRESHOLD = 1024;
 
     /// Used by the transaction to access the tag map. Needs #m_lock.
     Tag_map& get_tag_map() { return m_tags; }
     /// Used by the transaction to access the named tag map. Needs #m_lock.
-    Named_tag_map& get_named_tag_map() { return m_named_tags; }
+    const Named_tag_map& get_named_tag_map() const { return m_named_tags; }
     /// Used by the transaction to access the reverse tag map. Needs #m_lock.
-    Reverse_named_tag_map& get_reverse_named_tag_map() { return m_reverse_named_tags; }
+    const Reverse_named_tag_map& get_reverse_named_tag_map() const
+    { return m_reverse_named_tags; }
     /// Used by the transaction to track removal requests. Needs #m_lock.
-    Flagged_for_removal_set& get_flagged_for_removal_set() { return m_tags_flagged_for_removal; }
+    Flagged_for_removal_map& get_flagged_for_removal_map() { return m_tags_flagged_for_removal; }
 
 
 private:
+    /// Returns the lowest ID of all transactions that might still see old versions. Needs
+    /// #m_transaction_lock.
+    DB::Transaction_id get_lowest_open_transaction_id() const;
+
+    /// Removes a tag with all its versions and names. Needs #m_lock.
+    void erase_tag(Tag_map::iterator it);
+
+    /// Releases the bindings in \p bindings that are not visible to any transaction anymore, see
+    /// #lowest_open_transaction_id_changed(). Returns the number of remaining bindings. Needs
+    /// #m_lock.
+    static size_t release_old_bindings(
+        Name_binding_list& bindings, DB::Transaction_id transaction_id);
+
+    /// Removes all bindings in the given scopes. Needs #m_lock.
+    void erase_bindings(const std::set<DB::Scope_id>& scope_ids);
+
+    /// Removes all bindings of \p tag to \p name from \p bindings. Needs #m_lock.
+    static void erase_bindings(
+        Name_binding_list& bindings, const std::string& name, DB::Tag tag);
+
+    /// Removes all bindings of \p tag created by the transaction \p id from \p bindings. Needs
+    /// #m_lock.
+    static void erase_bindings(
+        Name_binding_list& bindings, DB::Transaction_id id, DB::Tag tag);
+
+    /// Releases old versions and collects garbage that is not visible to any open transaction.
+    /// Needs #m_transaction_lock.
+    void collect();
+
     /// This is used for allocating tags
     mi::base::Atom32 m_next_tag;
     /// This is used for allocating transaction ids
     mi::base::Atom32 m_next_transaction_id;
+    /// This is used for allocating scope ids. Needs #m_scope_lock.
+    DB::Scope_id m_next_scope_id;
 
 public:
-    /// The lock for the six containers below.
+    /// The lock for the containers below.
     mi::base::Lock m_lock;
 
 private:
-    /// Holds the DB::Info for each tag. Needs #m_lock.
+    /// Holds the versions of DB::Info for each tag. Needs #m_lock.
     Tag_map m_tags;
     /// This is used for converting names in the corresponding tags. Needs #m_lock.
     Named_tag_map m_named_tags;
     /// This is used for converting tags into names. Needs #m_lock.
     Reverse_named_tag_map m_reverse_named_tags;
     /// This holds the tags flagged for removal. Needs #m_lock.
-    Flagged_for_removal_set m_tags_flagged_for_removal;
+    Flagged_for_removal_map m_tags_flagged_for_removal;
     /// Holds the reference count for each tag. Needs #m_lock.
     Reference_count_map m_reference_counts;
     /// Holds the tags with reference count zero. Needs #m_lock.
     Reference_count_zero_set m_reference_count_zero;
-
-    /// The global scope is currently the only scope
+    /// Holds the tags with more than one version, i.e., candidates for releasing old versions.
+    /// Needs #m_lock.
+    DB::Tag_set m_tags_with_multiple_versions;
+    /// Holds the names with more than one binding, i.e., candidates for releasing old bindings.
+    /// Needs #m_lock.
+    std::set<std::string> m_names_with_multiple_bindings;
+    /// Holds the tags with more than one binding, i.e., candidates for releasing old bindings.
+    /// Needs #m_lock.
+    DB::Tag_set m_tags_with_multiple_bindings;
+    /// Holds the journal entries of all transactions. Needs #m_lock.
+    Journal_map m_journal;
+    /// The number of entries in #m_journal. Needs #m_lock.
+    size_t m_journal_size;
+    /// See #get_journal_pruned_transaction_id(). Needs #m_lock.
+    DB::Transaction_id m_journal_pruned_transaction_id;
+
+    /// The global scope.
     Scope_impl* m_global_scope;
 
+    /// The lock for #m_scopes and #m_named_scopes. Needs to be acquired before
+    /// #m_transaction_lock.
+    mi::base::Lock m_scope_lock;
+    /// All scopes including the global scope. Holds one reference for each scope. Needs
+    /// #m_scope_lock.
+    Scope_map m_scopes;
+    /// Maps names of named scopes to their IDs. Needs #m_scope_lock.
+    Named_scope_map m_named_scopes;
+
+    /// The lock for #m_open_transactions. Needs to be acquired before #m_lock.
+    mi::base::Lock m_transaction_lock;
+    /// The transactions started and not yet committed in all scopes. Each transaction is pinned
+    /// once by this map. Needs #m_transaction_lock.
+    Open_transaction_map m_open_transactions;
+    /// The number of commits since the last call of #collect(). Needs #m_transaction_lock.
+    Uint32 m_commits_since_collection;
+
 };
 
 } // namespace DBLIGHT
@@ -56,10 +56,6 @@ int Info_base::compare(Info_base* first, Info_base* second)
     return 0;
 }
 
-Cacheable::Cacheable(DBNR::Cache* cache) { }
-
-Cacheable::~Cacheable() { }
-
 Info::Info(
     DBNR::Info_container* container,
     Tag tag,
@@ -42,19 +42,31 @@
 
 namespace MI {
 
+
 namespace DBLIGHT {
 
-Scope_impl::Scope_impl(Database_impl* database)
+Scope_impl::Scope_impl(
+    Database_impl* database,
+    Scope_impl* parent,
+    DB::Scope_id id,
+    DB::Privacy_level level,
+    const std::string& name)
   : m_database(database)
+  , m_parent(parent)
+  , m_id(id)
+  , m_level(level)
+  , m_name(name)
   , m_refcount(1)
-  , m_transaction(0)
+  , m_is_removed(false)
 {
+    if (m_parent)
+        m_parent->pin();
 }
 
 Scope_impl::~Scope_impl()
 {
-    if (m_transaction)
-        m_transaction->unpin();
+    if (m_parent)
+        m_parent->unpin();
 }
 
 void Scope_impl::pin()
@@ -71,30 +83,28 @@ void Scope_impl::unpin()
 DB::Scope* Scope_impl::create_child(
     DB::Privacy_level level, bool is_temporary, const std::string& name)
 {
-    return 0;
+    return m_database->create_scope(this, level, name);
 }
 
-DB::Scope_id Scope_impl::get_id() { return DB::Scope_id(); }
+DB::Scope_id Scope_impl::get_id() { return m_id; }
 
 const std::string& Scope_impl::get_name() const { return m_name; }
 
-DB::Scope* Scope_impl::get_parent() { return 0; }
+DB::Scope* Scope_impl::get_parent() { return m_parent; }
 
-DB::Privacy_level Scope_impl::get_level() { return 0; }
+DB::Privacy_level Scope_impl::get_level() { return m_level; }
 
 DB::Transaction* Scope_impl::start_transaction()
 {
-    Uint32 counter = increment_transaction_count();
-    if (counter > 1) {
-        decrement_transaction_count();
-        return 0;
-    }
-
-    if (m_transaction)
-        m_transaction->unpin();
-    DB::Transaction_id transaction_id = m_database->allocate_transaction_id();
-    m_transaction = new Transaction_impl(m_database, this, transaction_id);
-    return m_transaction;
+    return m_database->start_transaction(this);
+}
+
+bool Scope_impl::is_self_or_ancestor(const Scope_impl* scope) const
+{
+    for (const Scope_impl* s = this; s; s = s->m_parent)
+        if (s == scope)
+            return true;
+    return false;
 }
 
 } // namespace DB
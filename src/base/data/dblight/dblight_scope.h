@@ -44,10 +44,30 @@ namespace DBLIGHT {
 
 class Database_impl;
 
+/// A scope of the lightweight database.
+///
+/// Each scope sees the versions stored in its own scope and, with lower priority, the versions
+/// stored in its ancestor scopes. Storing or editing a tag in a child scope creates a new version
+/// in that child scope which shadows the versions in the ancestor scopes.
+///
+/// Scopes are owned by the database and are destroyed when removed via Database_impl::remove()
+/// (and no longer pinned), or when the database is destroyed.
 class Scope_impl : public DB::Scope
 {
 public:
-    Scope_impl(Database_impl* database);
+    /// Constructor.
+    ///
+    /// \param database   The database this scope belongs to.
+    /// \param parent     The parent scope, or \c NULL for the global scope.
+    /// \param id         The ID of the scope.
+    /// \param level      The privacy level of the scope.
+    /// \param name       The name of the scope, or the empty string for unnamed scopes.
+    Scope_impl(
+        Database_impl* database,
+        Scope_impl* parent,
+        DB::Scope_id id,
+        DB::Privacy_level level,
+        const std::string& name);
     ~Scope_impl();
     void pin();
     void unpin();
@@ -59,22 +79,28 @@ public:
     DB::Privacy_level get_level();
     DB::Transaction* start_transaction();
 
-    /// Increments #m_transaction_count.
-    Uint32 increment_transaction_count() { return ++m_transaction_count; }
-    /// Decrements #m_transaction_count.
-    void decrement_transaction_count() { --m_transaction_count; }
+    /// Returns the parent scope (or \c NULL for the global scope).
+    Scope_impl* get_parent_scope() const { return m_parent; }
+
+    /// Indicates whether \p scope is this scope or one of its ancestors.
+    bool is_self_or_ancestor(const Scope_impl* scope) const;
+
+    /// Used by the database when removing the scope. No new transactions or child scopes can be
+    /// created afterwards. Needs the scope lock and the transaction lock of the database.
+    void set_removed() { m_is_removed = true; }
+
+    /// Indicates whether the scope has been removed. Needs the scope lock or the transaction lock
+    /// of the database.
+    bool is_removed() const { return m_is_removed; }
 
 private:
     Database_impl* m_database;
+    Scope_impl* m_parent;
+    DB::Scope_id m_id;
+    DB::Privacy_level m_level;
     std::string m_name;
     mi::base::Atom32 m_refcount;
-
-    // The current (or last) transaction.
-    DB::Transaction* m_transaction;
-
-    // Number of transactions started and not yet committed in this scope. Used to limit the number
-    // of such transaction1 to 1.
-    mi::base::Atom32 m_transaction_count;
+    bool m_is_removed;
 };
 
 } // namespace DB
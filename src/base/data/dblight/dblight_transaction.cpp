@@ -46,14 +46,25 @@ namespace MI {
 namespace DBLIGHT {
 
 Transaction_impl::Transaction_impl(
-    Database_impl* database, Scope_impl* scope, DB::Transaction_id id)
+    Database_impl* database,
+    Scope_impl* scope,
+    DB::Transaction_id id,
+    const Open_transaction_map& open_transactions)
   : m_database(database)
   , m_scope(scope)
   , m_id(id)
+  , m_visibility_bound(id)
   , m_refcount(1)
   , m_next_sequence_number(0)
   , m_is_open(true)
 {
+    Open_transaction_map::const_iterator it     = open_transactions.begin();
+    Open_transaction_map::const_iterator it_end = open_transactions.end();
+    for ( ; it != it_end; ++it) {
+        m_invisible_transactions.insert(it->first);
+        if (it->first < m_visibility_bound)
+            m_visibility_bound = it->first;
+    }
 }
 
 Transaction_impl::~Transaction_impl() { }
@@ -86,13 +97,32 @@ bool Transaction_impl::commit()
     if (!m_is_open)
         return false;
 
-    m_database->garbage_collection_internal();
-    m_scope->decrement_transaction_count();
     m_is_open = false;
+    m_changed_tags.clear();
+    m_removed_tags.clear();
+    // Might release the last reference to this transaction.
+    m_database->end_transaction(this);
     return true;
 }
 
-void Transaction_impl::abort() { MI_ASSERT(false); }
+void Transaction_impl::abort()
+{
+    if (!m_is_open)
+        return;
+
+    // The transaction is still registered as open while its changes are discarded. Hence, they are
+    // invisible to all other transactions at any time.
+    {
+        mi::base::Lock::Block block(&m_database->m_lock);
+        m_database->discard_transaction(m_id, m_changed_tags, m_removed_tags);
+        m_changed_tags.clear();
+        m_removed_tags.clear();
+    }
+
+    m_is_open = false;
+    // Might release the last reference to this transaction.
+    m_database->end_transaction(this);
+}
 
 bool Transaction_impl::is_open() { return m_is_open; }
 
@@ -110,19 +140,21 @@ DB::Tag Transaction_impl::store(
     DB::Tag tag = m_database->allocate_tag();
     element->prepare_store(this, tag);
 
+    Scope_impl* scope = get_store_scope(store_level);
     Uint32 version = m_next_sequence_number++;
-    DB::Info* info = new DB::Info(m_database, tag, this, DB::Scope_id(0), version, element);
+    DB::Info* info = new DB::Info(m_database, tag, this, scope->get_id(), version, element);
+    info->set_privacy_level(privacy_level);
 
     mi::base::Lock::Block block(&m_database->m_lock);
 
     info->store_references();
-    m_database->get_tag_map()[tag] = info;
+    m_database->get_tag_map()[tag].push_back(info);
     m_database->increment_reference_count(tag);
+    m_database->add_journal_entry(m_id, version, scope->get_id(), tag, DB::JOURNAL_ALL);
+    m_changed_tags.insert(tag);
 
-    if (name) {
-        m_database->get_named_tag_map()[name] = tag;
-        m_database->get_reverse_named_tag_map()[tag] = name;
-    }
+    if (name)
+        add_name_binding(name, tag, scope, version);
 
     return tag;
 }
@@ -140,8 +172,10 @@ void Transaction_impl::store(
 
     element->prepare_store(this, tag);
 
+    Scope_impl* scope = get_store_scope(store_level);
     Uint32 version = m_next_sequence_number++;
-    DB::Info* info = new DB::Info(m_database, tag, this, DB::Scope_id(0), version, element);
+    DB::Info* info = new DB::Info(m_database, tag, this, scope->get_id(), version, element);
+    info->set_privacy_level(privacy_level);
 
     mi::base::Lock::Block block(&m_database->m_lock);
 
@@ -149,18 +183,26 @@ void Transaction_impl::store(
 
     Tag_map::iterator it = m_database->get_tag_map().find(tag);
     if (it != m_database->get_tag_map().end()) {
-         it->second->unpin();
-         it->second = info;
-         // leave self-reference as is
+         // keep older versions for concurrent transactions, leave self-reference as is
+         m_database->add_version(tag, info);
+
+         // Storing a tag removed by another transaction, but not yet collected, revokes the
+         // removal. Otherwise the deferred garbage collection would drop the new version.
+         Flagged_for_removal_map& flagged = m_database->get_flagged_for_removal_map();
+         Flagged_for_removal_map::iterator it_flag = flagged.find(tag);
+         if (it_flag != flagged.end() && it_flag->second != m_id) {
+             flagged.erase(it_flag);
+             m_database->increment_reference_count(tag);
+         }
     } else {
-        m_database->get_tag_map()[tag] = info;
+        m_database->get_tag_map()[tag].push_back(info);
         m_database->increment_reference_count(tag);
     }
+    m_database->add_journal_entry(m_id, version, scope->get_id(), tag, journal_type);
+    m_changed_tags.insert(tag);
 
-    if (name) {
-         m_database->get_named_tag_map()[name] = tag;
-         m_database->get_reverse_named_tag_map()[tag] = name;
-    }
+    if (name)
+        add_name_binding(name, tag, scope, version);
 }
 
 DB::Tag Transaction_impl::store(
@@ -239,10 +281,12 @@ bool Transaction_impl::remove(DB::Tag tag, bool remove_local_copy)
         return false;
 
     mi::base::Lock::Block block(&m_database->m_lock);
-    std::pair<Flagged_for_removal_set::iterator,bool> result
-        = m_database->get_flagged_for_removal_set().insert(tag);
-    if (result.second)
+    std::pair<Flagged_for_removal_map::iterator,bool> result
+        = m_database->get_flagged_for_removal_map().insert(std::make_pair(tag, m_id));
+    if (result.second) {
         m_database->decrement_reference_count(tag);
+        m_removed_tags.insert(tag);
+    }
 
     return true;
 }
@@ -255,7 +299,20 @@ void Transaction_impl::advise(DB::Tag tag)
 void Transaction_impl::localize(
     DB::Tag tag, DB::Privacy_level privacy_level, DB::Journal_type journal_type)
 {
-    MI_ASSERT(false);
+    if (!m_is_open)
+        return;
+
+    mi::base::Lock::Block block(&m_database->m_lock);
+
+    DB::Info* old_info = lookup_info(tag);
+    if (!old_info)
+        return;
+
+    DB::Info* new_info
+        = create_version(tag, old_info, get_store_scope(privacy_level), privacy_level);
+    m_database->add_journal_entry(
+        m_id, new_info->get_version(), new_info->get_scope_id(), tag, journal_type);
+    new_info->unpin();
 }
 
 const char* Transaction_impl::tag_to_name(DB::Tag tag)
@@ -264,10 +321,17 @@ const char* Transaction_impl::tag_to_name(DB::Tag tag)
         return 0;
 
     mi::base::Lock::Block block(&m_database->m_lock);
+    if (!lookup_info(tag))
+        return 0;
     Reverse_named_tag_map::const_iterator it = m_database->get_reverse_named_tag_map().find(tag);
     if (it == m_database->get_reverse_named_tag_map().end())
         return 0;
-    return it->second.c_str(); // TODO unsafe
+    const Name_binding* binding = lookup_binding(it->second);
+    if (!binding)
+        return 0;
+    // the binding might be released by other transactions, keep the name alive
+    m_names.insert(binding->m_name);
+    return binding->m_name->c_str();
 }
 
 DB::Tag Transaction_impl::name_to_tag(const char* name)
@@ -279,7 +343,11 @@ DB::Tag Transaction_impl::name_to_tag(const char* name)
     Named_tag_map::const_iterator it = m_database->get_named_tag_map().find(name);
     if (it == m_database->get_named_tag_map().end())
          return DB::Tag();
-    return it->second;
+    // bindings by concurrent transactions are hidden, older bindings stay visible
+    const Name_binding* binding = lookup_binding(it->second);
+    if (!binding)
+         return DB::Tag();
+    return binding->m_tag;
 }
 
 SERIAL::Class_id Transaction_impl::get_class_id(DB::Tag tag)
@@ -288,8 +356,10 @@ SERIAL::Class_id Transaction_impl::get_class_id(DB::Tag tag)
         return SERIAL::Class_id();
 
     DB::Info* info = Transaction_impl::get_element(tag, true);
+    if (!info)
+        return SERIAL::Class_id();
     SERIAL::Class_id class_id = info->get_element()->get_class_id();
-    info->unpin();
+    unpin_info(info);
     return class_id;
 }
 
@@ -303,7 +373,7 @@ DB::Tag_version Transaction_impl::get_tag_version(DB::Tag tag)
     result.m_tag = tag;
     result.m_transaction_id = info->get_transaction_id();
     result.m_version = info->get_version();
-    info->unpin();
+    unpin_info(info);
     return result;
 }
 
@@ -335,15 +405,38 @@ bool Transaction_impl::get_tag_is_removed(DB::Tag tag)
         return false;
 
     mi::base::Lock::Block block(&m_database->m_lock);
-    const Flagged_for_removal_set& set = m_database->get_flagged_for_removal_set();
-    return set.find(tag) != set.end();
+    const Flagged_for_removal_map& map = m_database->get_flagged_for_removal_map();
+    return map.find(tag) != map.end();
 }
 
 bool Transaction_impl::get_tag_is_job(DB::Tag tag) { return false; }
 
-DB::Privacy_level Transaction_impl::get_tag_privacy_level(DB::Tag tag) { return 0; }
+DB::Privacy_level Transaction_impl::get_tag_privacy_level(DB::Tag tag)
+{
+    if (!m_is_open)
+        return 0;
+
+    mi::base::Lock::Block block(&m_database->m_lock);
+    DB::Info* info = lookup_info(tag);
+    return info ? info->get_privacy_level() : 0;
+}
+
+DB::Privacy_level Transaction_impl::get_tag_storage_level(DB::Tag tag)
+{
+    if (!m_is_open)
+        return 0;
 
-DB::Privacy_level Transaction_impl::get_tag_storage_level(DB::Tag tag) { return 0; }
+    mi::base::Lock::Block block(&m_database->m_lock);
+    DB::Info* info = lookup_info(tag);
+    if (!info)
+        return 0;
+
+    for (Scope_impl* scope = m_scope; scope; scope = scope->get_parent_scope())
+        if (scope->get_id() == info->get_scope_id())
+            return scope->get_level();
+    MI_ASSERT(false);
+    return 0;
+}
 
 DB::Transaction_id Transaction_impl::get_id() const { return m_id; }
 
@@ -353,8 +446,52 @@ std::vector<std::pair<DB::Tag, DB::Journal_type> >* Transaction_impl::get_journa
     DB::Journal_type journal_type,
     bool lookup_parent_scopes)
 {
-    MI_ASSERT(false);
-    return 0;
+    if (!m_is_open)
+        return 0;
+
+    mi::base::Lock::Block block(&m_database->m_lock);
+
+    // The journal is incomplete, the caller has to assume that everything has changed.
+    DB::Transaction_id pruned_id = m_database->get_journal_pruned_transaction_id();
+    if (pruned_id() != 0 && last_transaction_id <= pruned_id)
+        return 0;
+
+    // Merge all changes of a tag into a single entry.
+    std::map<DB::Tag, DB::Journal_type> changes;
+
+    const Journal_map& journal = m_database->get_journal_map();
+    Journal_map::const_iterator it     = journal.lower_bound(last_transaction_id);
+    Journal_map::const_iterator it_end = journal.end();
+    for ( ; it != it_end; ++it) {
+
+        if (!is_visible(it->first))
+            continue;
+
+        bool is_last_transaction = it->first == last_transaction_id;
+        const std::vector<Journal_entry>& entries = it->second;
+        for (size_t i = 0; i < entries.size(); ++i) {
+
+            const Journal_entry& entry = entries[i];
+            if (is_last_transaction && entry.m_version < last_transaction_change_version)
+                continue;
+            if ((entry.m_journal_type.get_type() & journal_type.get_type()) == 0)
+                continue;
+
+            Scope_impl* scope = m_scope;
+            while (scope && scope->get_id() != entry.m_scope_id)
+                scope = lookup_parent_scopes ? scope->get_parent_scope() : 0;
+            if (!scope)
+                continue;
+
+            DB::Journal_type type = entry.m_journal_type;
+            type.restrict_journal(journal_type);
+            changes[entry.m_tag].add_journal(type);
+        }
+    }
+
+    std::vector<std::pair<DB::Tag, DB::Journal_type> >* result
+        = new std::vector<std::pair<DB::Tag, DB::Journal_type> >(changes.begin(), changes.end());
+    return result;
 }
 
 Sint32 Transaction_impl::execute_fragmented(DB::Fragmented_job* job, size_t count)
@@ -393,21 +530,11 @@ DB::Info* Transaction_impl::edit_element(DB::Tag tag)
 
     mi::base::Lock::Block block(&m_database->m_lock);
 
-    Tag_map::const_iterator it = m_database->get_tag_map().find(tag);
-    if (it == m_database->get_tag_map().end())
+    DB::Info* old_info = lookup_info(tag);
+    if (!old_info)
          return 0;
 
-    DB::Info* old_info = it->second;
-    DB::Element_base* new_element = old_info->get_element()->copy();
-    Uint32 version = m_next_sequence_number++;
-    DB::Info* new_info = new DB::Info(m_database, tag, this, DB::Scope_id(0), version, new_element);
-    new_info->store_references();
-
-    old_info->unpin();
-    m_database->get_tag_map()[tag] = new_info;
-
-    new_info->pin();
-    return new_info;
+    return create_version(tag, old_info, m_scope, old_info->get_privacy_level());
 }
 
 void Transaction_impl::finish_edit(DB::Info* info, DB::Journal_type journal_type)
@@ -416,6 +543,8 @@ void Transaction_impl::finish_edit(DB::Info* info, DB::Journal_type journal_type
 
     mi::base::Lock::Block block(&m_database->m_lock);
     info->store_references();
+    m_database->add_journal_entry(
+        m_id, info->get_version(), info->get_scope_id(), info->get_tag(), journal_type);
 }
 
 DB::Info* Transaction_impl::get_element(DB::Tag tag, bool do_wait)
@@ -425,11 +554,10 @@ DB::Info* Transaction_impl::get_element(DB::Tag tag, bool do_wait)
 
     mi::base::Lock::Block block(&m_database->m_lock);
 
-    Tag_map::const_iterator it = m_database->get_tag_map().find(tag);
-    if (it == m_database->get_tag_map().end())
+    DB::Info* info = lookup_info(tag);
+    if (!info)
         return 0;
 
-    DB::Info* info = it->second;
     info->pin();
     return info;
 }
@@ -442,6 +570,94 @@ DB::Element_base* Transaction_impl::construct_empty_element(SERIAL::Class_id cla
 
 DB::Transaction* Transaction_impl::get_real_transaction() { return this; }
 
+void Transaction_impl::unpin_info(DB::Info* info)
+{
+    mi::base::Lock::Block block(&m_database->m_lock);
+    info->unpin();
+}
+
+bool Transaction_impl::is_visible(DB::Transaction_id id) const
+{
+    if (id == m_id)
+        return true;
+    if (id > m_id)
+        return false;
+    // Transactions with smaller IDs are committed unless they were open when we started.
+    return m_invisible_transactions.find(id) == m_invisible_transactions.end();
+}
+
+DB::Info* Transaction_impl::lookup_info(DB::Tag tag) const
+{
+    Tag_map::const_iterator it = m_database->get_tag_map().find(tag);
+    if (it == m_database->get_tag_map().end())
+        return 0;
+
+    const Info_list& versions = it->second;
+    for (Scope_impl* scope = m_scope; scope; scope = scope->get_parent_scope()) {
+        DB::Scope_id scope_id = scope->get_id();
+        Info_list::const_reverse_iterator it_version     = versions.rbegin();
+        Info_list::const_reverse_iterator it_version_end = versions.rend();
+        for ( ; it_version != it_version_end; ++it_version) {
+            DB::Info* info = *it_version;
+            if (info->get_scope_id() == scope_id && is_visible(info->get_transaction_id()))
+                return info;
+        }
+    }
+
+    return 0;
+}
+
+const Name_binding* Transaction_impl::lookup_binding(const Name_binding_list& bindings) const
+{
+    for (Scope_impl* scope = m_scope; scope; scope = scope->get_parent_scope()) {
+        DB::Scope_id scope_id = scope->get_id();
+        Name_binding_list::const_reverse_iterator it     = bindings.rbegin();
+        Name_binding_list::const_reverse_iterator it_end = bindings.rend();
+        for ( ; it != it_end; ++it)
+            if (it->m_scope_id == scope_id && is_visible(it->m_transaction_id))
+                return &*it;
+    }
+
+    return 0;
+}
+
+void Transaction_impl::add_name_binding(
+    const char* name, DB::Tag tag, Scope_impl* scope, Uint32 version)
+{
+    Name_binding binding;
+    binding.m_name.reset(new std::string(name));
+    binding.m_tag = tag;
+    binding.m_scope_id = scope->get_id();
+    binding.m_transaction_id = m_id;
+    binding.m_version = version;
+    m_database->add_name_binding(binding);
+}
+
+Scope_impl* Transaction_impl::get_store_scope(DB::Privacy_level store_level) const
+{
+    Scope_impl* scope = m_scope;
+    while (scope->get_level() > store_level && scope->get_parent_scope())
+        scope = scope->get_parent_scope();
+    return scope;
+}
+
+DB::Info* Transaction_impl::create_version(
+    DB::Tag tag, DB::Info* old_info, Scope_impl* scope, DB::Privacy_level privacy_level)
+{
+    DB::Element_base* new_element = old_info->get_element()->copy();
+    Uint32 version = m_next_sequence_number++;
+    DB::Info* new_info = new DB::Info(m_database, tag, this, scope->get_id(), version, new_element);
+    new_info->set_privacy_level(privacy_level);
+    new_info->store_references();
+
+    // the old version stays in place for concurrent transactions and other scopes
+    m_database->add_version(tag, new_info);
+    m_changed_tags.insert(tag);
+
+    new_info->pin();
+    return new_info;
+}
+
 } // namespace DBLIGHT
 
 } // namespace MI
@@ -38,17 +38,37 @@
 #include <mi/base/atom.h>
 #include <base/data/db/i_db_tag.h>
 
+#include <set>
+
+#include "dblight_database.h"
+
 namespace MI {
 
 namespace DBLIGHT {
 
-class Database_impl;
 class Scope_impl;
 
+/// A transaction of the lightweight database.
+///
+/// Transactions use snapshot isolation: a transaction sees its own changes and the changes of all
+/// transactions that have been committed before it was started. Changes of concurrent transactions
+/// are not visible. If several transactions change the same tag, the version of the transaction
+/// with the highest ID wins.
+///
+/// Versions in the scope of the transaction shadow versions in its ancestor scopes. New versions
+/// created by edits are always put into the scope of the transaction (copy-on-write).
 class Transaction_impl : public DB::Transaction
 {
 public:
-    Transaction_impl(Database_impl* database, Scope_impl* scope, DB::Transaction_id id);
+    /// Constructor.
+    ///
+    /// \param open_transactions   The transactions (in all scopes) that are open at the time this
+    ///                            transaction is started.
+    Transaction_impl(
+        Database_impl* database,
+        Scope_impl* scope,
+        DB::Transaction_id id,
+        const Open_transaction_map& open_transactions);
 
     ~Transaction_impl();
 
@@ -133,6 +153,7 @@ public:
     void localize(
         DB::Tag tag, DB::Privacy_level privacy_level, DB::Journal_type journal_type);
 
+    /// The returned name stays valid until this transaction is destroyed.
     const char* tag_to_name(DB::Tag tag);
 
     DB::Tag name_to_tag(const char* name);
@@ -199,10 +220,55 @@ public:
 
     Transaction* get_real_transaction();
 
+    /// Returns the lowest transaction ID among this transaction and the transactions that were
+    /// open when this transaction was started. All transactions with smaller IDs are visible.
+    DB::Transaction_id get_visibility_bound() const { return m_visibility_bound; }
+
+    /// Unpins \p info under the database lock. The last unpin destroys the info, which updates
+    /// the reference counts of the database. Must not be called with the database lock held.
+    void unpin_info(DB::Info* info);
+
 private:
+    /// Indicates whether changes of the transaction with the given ID are visible.
+    bool is_visible(DB::Transaction_id id) const;
+
+    /// Returns the most recent version of \p tag visible to this transaction (or \c NULL).
+    /// Searches the scope of the transaction first, then its ancestor scopes. Does not pin the
+    /// return value. Needs the database lock.
+    DB::Info* lookup_info(DB::Tag tag) const;
+
+    /// Returns the most recent binding in \p bindings visible to this transaction (or \c NULL).
+    /// Searches the scope of the transaction first, then its ancestor scopes. Needs the database
+    /// lock.
+    const Name_binding* lookup_binding(const Name_binding_list& bindings) const;
+
+    /// Binds \p name to \p tag in \p scope for this transaction and all later ones. Needs the
+    /// database lock.
+    void add_name_binding(const char* name, DB::Tag tag, Scope_impl* scope, Uint32 version);
+
+    /// Returns the scope for new versions with the given store level, i.e., the closest scope
+    /// (starting with the scope of the transaction) whose level is not larger than \p store_level.
+    Scope_impl* get_store_scope(DB::Privacy_level store_level) const;
+
+    /// Creates a new version of \p tag in \p scope from a copy of \p old_info.
+    /// Pins the return value. Needs the database lock.
+    DB::Info* create_version(
+        DB::Tag tag, DB::Info* old_info, Scope_impl* scope, DB::Privacy_level privacy_level);
+
     Database_impl* m_database;
     Scope_impl* m_scope;
     DB::Transaction_id m_id;
+    /// The IDs of transactions that were open when this transaction was started.
+    std::set<DB::Transaction_id> m_invisible_transactions;
+    /// See #get_visibility_bound().
+    DB::Transaction_id m_visibility_bound;
+    /// The tags for which this transaction created versions. Needs the database lock.
+    DB::Tag_set m_changed_tags;
+    /// The tags flagged for removal by this transaction. Needs the database lock.
+    DB::Tag_set m_removed_tags;
+    /// The names returned by #tag_to_name(), kept alive for the lifetime of this transaction.
+    /// Needs the database lock.
+    std::set<Name_ptr> m_names;
     mi::base::Atom32 m_refcount;
     mi::base::Atom32 m_next_sequence_number;
     bool m_is_open;
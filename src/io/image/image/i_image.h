@@ -97,6 +97,7 @@ namespace MI {
 
 namespace SYSTEM { class Module_registration_entry; }
 namespace SERIAL { class Serializer; class Deserializer; }
+namespace DBNR { class Cache; }
 
 namespace IMAGE {
 
@@ -583,6 +584,12 @@ public:
     /// ... or \c NULL if no callback is set.
     virtual IMdr_callback* get_mdr_callback() const = 0;
 
+    /// Returns the cache for regenerable image data (computed miplevels and lazily loaded tiles).
+    ///
+    /// The memory limit of the cache is set from the configuration option "cache_memory_limit".
+    /// The cache is flushed when the module is shut down.
+    virtual DBNR::Cache* get_cache() const = 0;
+
     // Methods for testing
     // ===================
 
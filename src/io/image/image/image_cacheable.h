@@ -0,0 +1,98 @@
+/***************************************************************************************************
+ * Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************************************/
+
+#ifndef IO_IMAGE_IMAGE_IMAGE_CACHEABLE_H
+#define IO_IMAGE_IMAGE_IMAGE_CACHEABLE_H
+
+#include <mi/base/types.h>
+
+#include <base/data/db/i_db_cache.h>
+#include <base/data/db/i_db_cacheable.h>
+
+namespace MI {
+
+namespace IMAGE {
+
+/// Registers regenerable data of an image class (the owner) with the cache of the IMAGE module (see
+/// #Image_module::get_cache()).
+///
+/// The owner needs to implement a method
+///
+///   ptrdiff_t offload_cacheable( mi::Uint32 index);
+///
+/// which is invoked with the lock of the cache being held. Since the owner typically calls methods
+/// of the cache while holding its own lock, the owner must not block on its own lock in that
+/// method, i.e., it has to use mi::base::Lock::try_lock() and return 0 on failure. Cacheables for
+/// which 0 is returned are retried during later offload requests.
+///
+/// The cacheable is flushable right from the beginning, i.e., the owner is expected to check in
+/// #offload_cacheable() whether the data is still referenced elsewhere.
+template <class T>
+class Cacheable_adapter : public DB::Cacheable
+{
+public:
+    /// Constructor.
+    ///
+    /// \param cache   The cache of the IMAGE module.
+    /// \param owner   The owner of the regenerable data.
+    /// \param index   An index passed back to the owner to distinguish several cacheables.
+    Cacheable_adapter( DBNR::Cache* cache, T* owner, mi::Uint32 index)
+      : DB::Cacheable( cache), m_cache( cache), m_owner( owner), m_index( index)
+    {
+        m_cache->unpin( this);
+    }
+
+    /// Destructor.
+    ///
+    /// Unregisters the cacheable before the owner might become invalid.
+    ~Cacheable_adapter() { m_cache->unregister_cacheable( this); }
+
+    ptrdiff_t offload() { return m_owner->offload_cacheable( m_index); }
+
+    /// Marks the cacheable as recently used.
+    void touch() { m_cache->touch( this); }
+
+    /// Reports a change of the memory usage of the data represented by this cacheable.
+    void update_memory_usage( ptrdiff_t delta) { m_cache->update_memory_usage( this, delta); }
+
+private:
+    /// The cache this cacheable is registered with.
+    DBNR::Cache* m_cache;
+
+    /// The owner of the regenerable data.
+    T* m_owner;
+
+    /// The index passed back to the owner.
+    mi::Uint32 m_index;
+};
+
+} // namespace IMAGE
+
+} // namespace MI
+
+#endif // IO_IMAGE_IMAGE_IMAGE_CACHEABLE_H
@@ -57,6 +57,7 @@ Canvas_impl::Canvas_impl(
     mi::Uint32 layers,
     bool is_cubemap,
     mi::Float32 gamma)
+  : m_cacheable( 0)
 {
     // check incorrect arguments
     ASSERT( M_IMAGE, pixel_type != PT_UNDEF);
@@ -102,6 +103,7 @@ Canvas_impl::Canvas_impl(
     mi::Uint32 tile_height,
     mi::neuraylib::IImage_file* image_file,
     mi::Sint32* errors)
+  : m_cacheable( 0)
 {
     mi::Sint32 dummy_errors = 0;
     if( !errors)
@@ -196,6 +198,8 @@ Canvas_impl::Canvas_impl(
     m_tiles = new mi::neuraylib::ITile*[m_nr_of_tiles];
     for( mi::Uint32 i = 0; i < m_nr_of_tiles; ++i)
         m_tiles[i] = 0;
+    SYSTEM::Access_module<Image_module> image_module( false);
+    m_cacheable = new Cacheable_adapter<Canvas_impl>( image_module->get_cache(), this, 0);
 
     *errors = 0;
 }
@@ -209,6 +213,7 @@ Canvas_impl::Canvas_impl(
     mi::Uint32 tile_height,
     mi::neuraylib::IImage_file* image_file,
     mi::Sint32* errors)
+  : m_cacheable( 0)
 {
     mi::Sint32 dummy_errors = 0;
     if( !errors)
@@ -305,6 +310,8 @@ Canvas_impl::Canvas_impl(
         m_tiles = new mi::neuraylib::ITile*[m_nr_of_tiles];
         for( mi::Uint32 i = 0; i < m_nr_of_tiles; ++i)
             m_tiles[i] = 0;
+        SYSTEM::Access_module<Image_module> image_module( false);
+        m_cacheable = new Cacheable_adapter<Canvas_impl>( image_module->get_cache(), this, 0);
         *errors = 0;
         return;
     }
@@ -342,6 +349,7 @@ Canvas_impl::Canvas_impl(
     mi::Uint32 tile_height,
     mi::neuraylib::IImage_file* image_file,
     mi::Sint32* errors)
+  : m_cacheable( 0)
 {
     ASSERT( M_IMAGE, reader);
     ASSERT( M_IMAGE, image_format);
@@ -454,6 +462,7 @@ Canvas_impl::Canvas_impl(
 }
 
 Canvas_impl::Canvas_impl( mi::neuraylib::ITile* tile, Float32 gamma)
+  : m_cacheable( 0)
 {
     // check incorrect arguments
     ASSERT( M_IMAGE, tile);
@@ -479,6 +488,9 @@ Canvas_impl::Canvas_impl( mi::neuraylib::ITile* tile, Float32 gamma)
 
 Canvas_impl::~Canvas_impl()
 {
+    // unregister from the cache first, offload_cacheable() must not be invoked anymore
+    delete m_cacheable;
+
     for( mi::Uint32 i = 0; i < m_nr_of_tiles; ++i)
         if( m_tiles[i])
             m_tiles[i]->release();
@@ -511,6 +523,7 @@ const mi::neuraylib::ITile* Canvas_impl::get_tile(
 
     if( m_tiles[index] == 0) {
         ASSERT( M_IMAGE, supports_lazy_loading());
+        mi::Size old_size = m_cacheable ? get_tiles_size() : 0;
 #ifdef MI_IMAGE_LOAD_ONLY_REQUESTED_TILE
         m_tiles[index] = create_tile( m_pixel_type, m_tile_width, m_tile_height);
         load_tile( m_tiles[index], tile_x * m_tile_width, tile_y * m_tile_height, layer);
@@ -521,9 +534,16 @@ const mi::neuraylib::ITile* Canvas_impl::get_tile(
         }
         load_tile( 0, 0, 0, 0);
 #endif
-    }
+        m_tiles[index]->retain();
+        if( m_cacheable)
+            m_cacheable->update_memory_usage(
+                static_cast<ptrdiff_t>( get_tiles_size()) - static_cast<ptrdiff_t>( old_size));
+    } else
+        m_tiles[index]->retain();
+
+    if( m_cacheable)
+        m_cacheable->touch();
 
-    m_tiles[index]->retain();
     return m_tiles[index];
 }
 
@@ -541,8 +561,8 @@ mi::neuraylib::ITile* Canvas_impl::get_tile(
     mi::base::Lock::Block block( &m_lock);
 
     if( m_tiles[index] == 0) {
-
         ASSERT( M_IMAGE, supports_lazy_loading());
+        mi::Size old_size = m_cacheable ? get_tiles_size() : 0;
 #ifdef MI_IMAGE_LOAD_ONLY_REQUESTED_TILE
         m_tiles[index] = create_tile( m_pixel_type, m_tile_width, m_tile_height);
         load_tile( m_tiles[index], tile_x * m_tile_width, tile_y * m_tile_height, layer);
@@ -553,9 +573,17 @@ mi::neuraylib::ITile* Canvas_impl::get_tile(
         }
         load_tile( 0, 0, 0, 0);
 #endif
-    }
+        m_tiles[index]->retain();
+        if( m_cacheable)
+            m_cacheable->update_memory_usage(
+                static_cast<ptrdiff_t>( get_tiles_size()) - static_cast<ptrdiff_t>( old_size));
+    } else
+        m_tiles[index]->retain();
+
+    // the tiles might be modified by the caller, i.e., they can no longer be offloaded
+    delete m_cacheable;
+    m_cacheable = 0;
 
-    m_tiles[index]->retain();
     return m_tiles[index];
 }
 
@@ -565,7 +593,17 @@ mi::Size Canvas_impl::get_size() const
 
     size += m_nr_of_tiles * sizeof( mi::neuraylib::ITile*); // m_tiles
 
-    for( mi::Uint32 i = 0; i < m_nr_of_tiles; ++i)          // m_tiles[i]
+    mi::base::Lock::Block block( &m_lock);
+    size += get_tiles_size();                               // m_tiles[i]
+
+    return size;
+}
+
+mi::Size Canvas_impl::get_tiles_size() const
+{
+    mi::Size size = 0;
+
+    for( mi::Uint32 i = 0; i < m_nr_of_tiles; ++i)
         if( m_tiles[i]) {
             mi::base::Handle<ITile> tile_internal( m_tiles[i]->get_interface<ITile>());
             if( tile_internal.is_valid_interface())         // exact memory usage
@@ -579,6 +617,32 @@ mi::Size Canvas_impl::get_size() const
     return size;
 }
 
+ptrdiff_t Canvas_impl::offload_cacheable( mi::Uint32 index)
+{
+    // Invoked with the lock of the cache being held. Do not block on m_lock since the lock might
+    // be held by a thread waiting for the cache lock.
+    mi::base::Lock::Block block;
+    if( !block.try_set( &m_lock))
+        return 0;
+
+    // tiles that are still referenced elsewhere cannot be dropped
+    for( mi::Uint32 i = 0; i < m_nr_of_tiles; ++i)
+        if( m_tiles[i]) {
+            m_tiles[i]->retain();
+            if( m_tiles[i]->release() > 1)
+                return 0;
+        }
+
+    mi::Size size = get_tiles_size();
+    for( mi::Uint32 i = 0; i < m_nr_of_tiles; ++i)
+        if( m_tiles[i]) {
+            m_tiles[i]->release();
+            m_tiles[i] = 0;
+        }
+
+    return -static_cast<ptrdiff_t>( size);
+}
+
 bool Canvas_impl::supports_lazy_loading() const
 {
     // either both m_archive_filename or m_member_filename are set or none
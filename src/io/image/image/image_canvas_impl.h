@@ -35,6 +35,7 @@
 #include <mi/base/lock.h>
 
 #include "i_image_utilities.h"
+#include "image_cacheable.h"
 
 #include <string>
 #include <boost/core/noncopyable.hpp>
@@ -268,6 +269,21 @@ private:
     void load_tile(
         mi::neuraylib::ITile* tile, mi::Uint32 x, mi::Uint32 y, mi::Uint32 z) const;
 
+    /// Returns the memory used by the loaded tiles in bytes.
+    ///
+    /// \note The caller needs to hold the lock m_lock.
+    mi::Size get_tiles_size() const;
+
+    /// Drops all tiles of a file-based canvas such that they are reloaded on demand.
+    ///
+    /// Invoked by the cache via #m_cacheable. Fails (and returns 0) if the lock m_lock is not
+    /// available, or if any tile is still referenced elsewhere.
+    ///
+    /// \return        The change of the memory usage in bytes.
+    ptrdiff_t offload_cacheable( mi::Uint32 index);
+
+    friend class Cacheable_adapter<Canvas_impl>;
+
     /// Returns the reader used by #load_tile();
     mi::neuraylib::IReader* get_reader( std::string& filename_error_msg) const;
 
@@ -307,9 +323,17 @@ private:
     /// \note Any access needs to be protected by m_lock.
     mutable mi::neuraylib::ITile** m_tiles;
 
-    /// The lock that protects m_tiles;
+    /// The lock that protects m_tiles and m_cacheable;
     mutable mi::base::Lock m_lock;
 
+    /// Registers the lazily loaded tiles with the cache.
+    ///
+    /// Only set for canvases that support lazy loading. Reset as soon as a tile is requested via
+    /// the non-const variant of #get_tile() since modified tiles cannot be reloaded.
+    ///
+    /// \note Any access needs to be protected by m_lock.
+    mutable Cacheable_adapter<Canvas_impl>* m_cacheable;
+
     /// The file used to load this canvas.
     ///
     /// Non-empty for file-based canvases, empty for memory-based canvases (including archives).
@@ -323,6 +323,13 @@ Mipmap_impl::Mipmap_impl(
     m_is_cubemap = is_cubemap;
 }
 
+Mipmap_impl::~Mipmap_impl()
+{
+    // unregister from the cache first, offload_cacheable() must not be invoked anymore
+    for( mi::Size i = 0; i < m_cacheables.size(); ++i)
+        delete m_cacheables[i];
+}
+
 mi::Uint32 Mipmap_impl::get_nlevels() const
 {
     return m_nr_of_levels;
@@ -349,6 +356,8 @@ const mi::neuraylib::ICanvas* Mipmap_impl::get_level( mi::Uint32 level) const
 
     ASSERT( M_IMAGE, m_last_created_level >= level);
     ASSERT( M_IMAGE, m_levels[level]);
+    if( level < m_cacheables.size() && m_cacheables[level])
+        m_cacheables[level]->touch();
     m_levels[level]->retain();
     return m_levels[level].get();
 }
@@ -369,10 +378,21 @@ mi::neuraylib::ICanvas* Mipmap_impl::get_level( mi::Uint32 level) //-V659 PVS
 
     // destroy higher levels if needed
     mi::Uint32 first_level_to_destroy = std::max( level+1, m_nr_of_provided_levels);
-    for( mi::Uint32 i = first_level_to_destroy; i <= m_last_created_level; ++i)
+    for( mi::Uint32 i = first_level_to_destroy; i <= m_last_created_level; ++i) {
         m_levels[i] = 0;
+        if( i < m_cacheables.size()) {
+            delete m_cacheables[i];
+            m_cacheables[i] = 0;
+        }
+    }
     m_last_created_level = first_level_to_destroy - 1;
 
+    // the miplevel might be modified by the caller, i.e., it can no longer be offloaded
+    if( level < m_cacheables.size()) {
+        delete m_cacheables[level];
+        m_cacheables[level] = 0;
+    }
+
     ASSERT( M_IMAGE, m_last_created_level >= level);
     ASSERT( M_IMAGE, m_levels[level]);
     m_levels[level]->retain();
@@ -387,22 +407,49 @@ mi::Size Mipmap_impl::get_size() const
 
     size += m_nr_of_levels * sizeof( mi::neuraylib::ICanvas*);   // m_levels
 
-    for( mi::Uint32 i = 0; i <= m_last_created_level; ++i) {     // m_level[i]
-        mi::base::Handle<ICanvas> canvas_internal( m_levels[i]->get_interface<ICanvas>());
-        if( canvas_internal.is_valid_interface())                // exact memory usage
-            size += canvas_internal->get_size();
-        else  {                                                  // approximate memory usage
-            mi::Size width  = m_levels[i]->get_resolution_x();
-            mi::Size height = m_levels[i]->get_resolution_y();
-            Pixel_type pixel_type
-                = convert_pixel_type_string_to_enum( m_levels[i]->get_type());
-            size += width * height * get_bytes_per_pixel( pixel_type);
-        }
-    }
+    for( mi::Uint32 i = 0; i <= m_last_created_level; ++i)       // m_level[i]
+        size += get_canvas_size( m_levels[i].get());
 
     return size;
 }
 
+mi::Size Mipmap_impl::get_canvas_size( const mi::neuraylib::ICanvas* canvas)
+{
+    mi::base::Handle<const ICanvas> canvas_internal( canvas->get_interface<ICanvas>());
+    if( canvas_internal.is_valid_interface())                    // exact memory usage
+        return canvas_internal->get_size();
+
+    mi::Size width  = canvas->get_resolution_x();                // approximate memory usage
+    mi::Size height = canvas->get_resolution_y();
+    Pixel_type pixel_type = convert_pixel_type_string_to_enum( canvas->get_type());
+    return width * height * get_bytes_per_pixel( pixel_type);
+}
+
+ptrdiff_t Mipmap_impl::offload_cacheable( mi::Uint32 level)
+{
+    // Invoked with the lock of the cache being held. Do not block on m_lock since the lock might
+    // be held by a thread waiting for the cache lock.
+    mi::base::Lock::Block block;
+    if( !block.try_set( &m_lock))
+        return 0;
+
+    // Only the last created miplevel can be dropped since the created miplevels need to be
+    // contiguous. Lower miplevels are retried later.
+    if( level != m_last_created_level || level < std::max( m_nr_of_provided_levels, 1u))
+        return 0;
+
+    // miplevels that are still referenced elsewhere cannot be dropped
+    ASSERT( M_IMAGE, m_levels[level]);
+    m_levels[level]->retain();
+    if( m_levels[level]->release() > 1)
+        return 0;
+
+    mi::Size size = get_canvas_size( m_levels[level].get());
+    m_levels[level] = 0;
+    m_last_created_level = level - 1;
+    return -static_cast<ptrdiff_t>( size);
+}
+
 void Mipmap_impl::create_miplevel( mi::Uint32 level) const
 {
     // NOTE: This implementation creates the new miplevel tile by tile. For each tile, it retrieves
@@ -412,7 +459,7 @@ void Mipmap_impl::create_miplevel( mi::Uint32 level) const
     ASSERT( M_IMAGE, level > 0);
     ASSERT( M_IMAGE, m_last_created_level == level-1);
 
-    mi::neuraylib::ICanvas* prev_canvas = m_levels[level-1].get();
+    const mi::neuraylib::ICanvas* prev_canvas = m_levels[level-1].get();
     ASSERT( M_IMAGE, prev_canvas);
 
     // Get properties of previous miplevel
@@ -471,7 +518,7 @@ void Mipmap_impl::create_miplevel( mi::Uint32 level) const
 
                 // Lookup involved tiles from the previous miplevel (note that these tiles are not
                 // necessarily distinct).
-                mi::base::Handle<mi::neuraylib::ITile> prev_tiles[4];
+                mi::base::Handle<const mi::neuraylib::ITile> prev_tiles[4];
                 prev_tiles[0] = prev_canvas->get_tile( prev_x_begin, prev_y_begin);
                 prev_tiles[1] = prev_canvas->get_tile( prev_x_end-1, prev_y_begin);
                 prev_tiles[2] = prev_canvas->get_tile( prev_x_begin, prev_y_end-1);
@@ -533,6 +580,17 @@ void Mipmap_impl::create_miplevel( mi::Uint32 level) const
 
     m_levels[level] = canvas;
     m_last_created_level = level;
+
+    // computed miplevels can be regenerated, register them with the cache
+    if( m_cacheables.size() < m_nr_of_levels)
+        m_cacheables.resize( m_nr_of_levels, 0);
+    if( !m_cacheables[level]) {
+        SYSTEM::Access_module<Image_module> image_module( false);
+        m_cacheables[level] = new Cacheable_adapter<Mipmap_impl>(
+            image_module->get_cache(), const_cast<Mipmap_impl*>( this), level);
+    }
+    m_cacheables[level]->touch();
+    m_cacheables[level]->update_memory_usage( static_cast<ptrdiff_t>( get_canvas_size( canvas)));
 }
 
 } // namespace IMAGE
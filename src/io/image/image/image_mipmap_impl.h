@@ -36,6 +36,7 @@
 #include <mi/base/lock.h>
 
 #include "i_image_utilities.h"
+#include "image_cacheable.h"
 
 #include <string>
 #include <vector>
@@ -58,8 +59,9 @@ namespace IMAGE {
 /// Construction for higher-level mipmaps is done lazily, but when a certain level is requested
 /// all tiles of it are computed (and hence all tiles from the previous level are needed).
 ///
-/// File-based or archive-based mipmaps could flush unused tiles if memory gets tight (not yet
-/// implemented).
+/// Computed miplevels are registered with the cache and dropped in LRU order if memory gets tight
+/// (unless they are still referenced elsewhere). File-based or archive-based canvases flush their
+/// tiles in the same way.
 class Mipmap_impl
   : public mi::base::Interface_implement<IMipmap>,
     public boost::noncopyable
@@ -195,6 +197,9 @@ public:
     Mipmap_impl(
         std::vector<mi::base::Handle<mi::neuraylib::ICanvas> >& canvases, bool is_cubemap);
 
+    /// Destructor.
+    ~Mipmap_impl();
+
     // methods of mi::neuraylib::IMipmap
 
     mi::Uint32 get_nlevels() const;
@@ -218,6 +223,20 @@ private:
     /// \param level         The miplevel to be created.
     void create_miplevel( mi::Uint32 level) const;
 
+    /// Drops the given computed miplevel such that it is recomputed on demand.
+    ///
+    /// Invoked by the cache via #m_cacheables. Fails (and returns 0) if the lock m_lock is not
+    /// available, if \p level is not the last created miplevel, or if the miplevel is still
+    /// referenced elsewhere.
+    ///
+    /// \return        The change of the memory usage in bytes.
+    ptrdiff_t offload_cacheable( mi::Uint32 level);
+
+    friend class Cacheable_adapter<Mipmap_impl>;
+
+    /// Returns the memory used by a miplevel in bytes.
+    static mi::Size get_canvas_size( const mi::neuraylib::ICanvas* canvas);
+
     /// The number of miplevels of this mipmap.
     ///
     /// The number of miplevels is determined from the width and height of the base level. The last
@@ -230,7 +249,7 @@ private:
     /// Higher miplevels will be computed.
     mi::Uint32 m_nr_of_provided_levels;
 
-    /// The lock that protects m_levels and m_last_created_level;
+    /// The lock that protects m_levels, m_last_created_level, and m_cacheables;
     mutable mi::base::Lock m_lock;
 
     /// The last miplevel that was already created.
@@ -246,6 +265,15 @@ private:
     /// \note Any access needs to be protected by m_lock.
     mutable std::vector<mi::base::Handle<mi::neuraylib::ICanvas> > m_levels;
 
+    /// The cacheables for the computed miplevels.
+    ///
+    /// Indexed like m_levels, \c NULL for provided miplevels, for miplevels that have not yet been
+    /// computed, and for miplevels that were handed out via the non-const variant of #get_level()
+    /// (since they might have been modified).
+    ///
+    /// \note Any access needs to be protected by m_lock.
+    mutable std::vector<Cacheable_adapter<Mipmap_impl>*> m_cacheables;
+
     /// Flag for cubemaps.
     bool m_is_cubemap;
 };
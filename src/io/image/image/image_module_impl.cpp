@@ -41,6 +41,7 @@
 #include <queue>
 #include <base/system/main/module_registration.h>
 #include <base/system/main/access_module.h>
+#include <base/lib/config/config.h>
 #include <base/lib/log/i_log_logger.h>
 #include <base/lib/plug/i_plug.h>
 #include <base/util/string_utils/i_string_utils.h>
@@ -48,6 +49,7 @@
 #include <base/hal/disk/disk_memory_reader_writer_impl.h>
 #include <base/hal/hal/i_hal_ospath.h>
 #include <base/data/serial/i_serializer.h>
+#include <base/util/registry/i_config_registry.h>
 
 #include "image_canvas_impl.h"
 #include "image_tile_impl.h"
@@ -110,6 +112,16 @@ bool Image_module_impl::init()
         descriptor = m_plug_module->get_plugin( ++index);
     }
 
+    // Limit the memory used by regenerable image data (computed miplevels and lazily loaded
+    // tiles). Controlled by the configuration option "cache_memory_limit" (in bytes, default 0,
+    // i.e., unlimited). If the limit is exceeded, data is offloaded until the memory usage drops
+    // to 3/4 of the limit.
+    SYSTEM::Access_module<CONFIG::Config_module> config_module( false);
+    const CONFIG::Config_registry& registry = config_module->get_configuration();
+    mi::Size memory_limit = 0;
+    if( registry.get_value( "cache_memory_limit", memory_limit) && memory_limit > 0)
+        m_cache.set_memory_limits( memory_limit / 4 * 3, memory_limit);
+
     return true;
 }
 
@@ -129,6 +141,10 @@ void Image_module_impl::exit()
     }
     m_plugins.clear();
 
+    // Drop all regenerable image data that is not in use anymore.
+    m_cache.set_memory_limits( 0, 0);
+    m_cache.offload( 0);
+
     m_plug_module.reset();
 }
 
@@ -1010,6 +1026,11 @@ IMdr_callback* Image_module_impl::get_mdr_callback() const
     return m_mdr_callback.get();
 }
 
+DBNR::Cache* Image_module_impl::get_cache() const
+{
+    return &m_cache;
+}
+
 void Image_module_impl::dump() const
 {
     mi::Size i = 0;
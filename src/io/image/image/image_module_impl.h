@@ -36,6 +36,7 @@
 
 #include <vector>
 #include <base/system/main/access_module.h>
+#include <base/data/db/i_db_cache.h>
 
 namespace mi { namespace base { class IPlugin_descriptor; } }
 
@@ -194,6 +195,8 @@ public:
 
     IMdr_callback* get_mdr_callback() const;
 
+    DBNR::Cache* get_cache() const;
+
     void dump() const;
 
 private:
@@ -244,6 +247,9 @@ private:
 
     /// Callback to support lazy loading of images in MDL archives.
     mi::base::Handle<IMdr_callback> m_mdr_callback;
+
+    /// The cache for regenerable image data.
+    mutable DBNR::Cache m_cache;
 };
 
 } // namespace IMAGE
@@ -60,12 +60,16 @@ static const char* magic_reflection = "MBSDF_DATA_REFLECTION=\n";
 static const char* magic_transmission = "MBSDF_DATA_TRANSMISSION=\n";
 
 Bsdf_measurement::Bsdf_measurement()
+  : m_is_deferred( false)
 {
 }
 
 Bsdf_measurement::Bsdf_measurement( const Bsdf_measurement& other)
   : SCENE::Scene_element<Bsdf_measurement, ID_BSDF_MEASUREMENT>( other)
 {
+    mi::base::Lock::Block block( &other.m_deferred_lock);
+
+    m_is_deferred = other.m_is_deferred.load();
     m_reflection = other.m_reflection;
     m_transmission = other.m_transmission;
     m_original_filename = other.m_original_filename;
@@ -109,6 +113,7 @@ mi::Sint32 Bsdf_measurement::reset_file( const std::string& original_filename)
 
     m_reflection = reflection;
     m_transmission = transmission;
+    m_is_deferred = false;
 
     m_original_filename = original_filename;
     m_resolved_filename = resolved_filename;
@@ -135,6 +140,7 @@ mi::Sint32 Bsdf_measurement::reset_reader( mi::neuraylib::IReader* reader)
 
     m_reflection = reflection;
     m_transmission = transmission;
+    m_is_deferred = false;
 
     m_original_filename.clear();
     m_resolved_filename.clear();
@@ -162,6 +168,7 @@ mi::Sint32 Bsdf_measurement::reset_file_mdl(
 
     m_reflection = reflection;
     m_transmission = transmission;
+    m_is_deferred = false;
 
     m_original_filename.clear();
     m_resolved_filename = resolved_filename;
@@ -193,6 +200,7 @@ mi::Sint32 Bsdf_measurement::reset_archive_mdl(
 
     m_reflection = reflection;
     m_transmission = transmission;
+    m_is_deferred = false;
 
     m_original_filename.clear();
     m_resolved_filename.clear();
@@ -210,8 +218,102 @@ mi::Sint32 Bsdf_measurement::reset_archive_mdl(
     return 0;
 }
 
+void Bsdf_measurement::reset_file_mdl_deferred(
+    const std::string& resolved_filename, const std::string& mdl_file_path)
+{
+    m_reflection = 0;
+    m_transmission = 0;
+    m_is_deferred = true;
+
+    m_original_filename.clear();
+    m_resolved_filename = resolved_filename;
+    m_resolved_archive_filename.clear();
+    m_resolved_archive_membername.clear();
+    m_mdl_file_path = mdl_file_path;
+}
+
+void Bsdf_measurement::reset_archive_mdl_deferred(
+    const std::string& archive_filename,
+    const std::string& archive_membername,
+    const std::string& mdl_file_path)
+{
+    m_reflection = 0;
+    m_transmission = 0;
+    m_is_deferred = true;
+
+    m_original_filename.clear();
+    m_resolved_filename.clear();
+    m_resolved_archive_filename = archive_filename;
+    m_resolved_archive_membername = archive_membername;
+    m_mdl_file_path = mdl_file_path;
+}
+
+void Bsdf_measurement::load_deferred() const
+{
+    // fast path: the flag is cleared only after the data has been imported
+    if( !m_is_deferred.load( std::memory_order_acquire))
+        return;
+
+    mi::base::Lock::Block block( &m_deferred_lock);
+    if( !m_is_deferred.load( std::memory_order_relaxed))
+        return;
+
+    // The DB element itself is never const, only the access to it. Importing the data does not
+    // change the observable state of this element.
+    Bsdf_measurement* self = const_cast<Bsdf_measurement*>( this);
+
+    mi::neuraylib::IBsdf_isotropic_data* reflection = 0;
+    mi::neuraylib::IBsdf_isotropic_data* transmission = 0;
+    bool success = false;
+    std::string filename;
+    if( !m_resolved_archive_filename.empty()) {
+        filename = m_resolved_archive_membername + "\" in \"" + m_resolved_archive_filename;
+        MDL::DETAIL::Mdr_callback callback;
+        mi::base::Handle<mi::neuraylib::IReader> reader( callback.get_reader(
+            m_resolved_archive_filename.c_str(), m_resolved_archive_membername.c_str()));
+        if( reader)
+            success = import_from_reader( reader.get(), m_resolved_archive_filename,
+                m_resolved_archive_membername, reflection, transmission);
+    } else {
+        filename = m_resolved_filename;
+        success = import_from_file( m_resolved_filename, reflection, transmission);
+    }
+
+    if( !success) {
+        LOG::mod_log->error( M_SCENE, LOG::Mod_log::C_IO,
+            "File format error or invalid filename extension in deferred BSDF measurement "
+            "\"%s\".", filename.c_str());
+        self->m_is_deferred.store( false, std::memory_order_release);
+        return;
+    }
+
+    self->m_reflection = reflection;
+    self->m_transmission = transmission;
+    self->m_is_deferred.store( false, std::memory_order_release);
+
+    std::ostringstream s;
+    s << "Loading deferred BSDF measurement \"" << filename
+      << "\", reflection: " << dump_data( m_reflection.get())
+      << ", transmission: " << dump_data( m_transmission.get());
+    LOG::mod_log->info( M_SCENE, LOG::Mod_log::C_IO, "%s", s.str().c_str());
+}
+
+bool Bsdf_measurement::is_valid() const
+{
+    load_deferred();
+    return m_reflection.is_valid_interface() || m_transmission.is_valid_interface();
+}
+
+bool Bsdf_measurement::is_deferred() const
+{
+    return m_is_deferred.load( std::memory_order_acquire);
+}
+
 void Bsdf_measurement::set_reflection( const mi::neuraylib::IBsdf_isotropic_data* bsdf_data)
 {
+    // keep the transmission data
+    load_deferred();
+
     m_original_filename.clear();
     m_resolved_filename.clear();
     m_resolved_archive_filename.clear();
@@ -222,6 +324,7 @@ void Bsdf_measurement::set_reflection( const mi::neuraylib::IBsdf_isotropic_data
 
 const mi::base::IInterface* Bsdf_measurement::get_reflection() const
 {
+    load_deferred();
     if( !m_reflection)
         return 0;
     m_reflection->retain();
@@ -230,6 +333,9 @@ const mi::base::IInterface* Bsdf_measurement::get_reflection() const
 
 void Bsdf_measurement::set_transmission( const mi::neuraylib::IBsdf_isotropic_data* bsdf_data)
 {
+    // keep the reflection data
+    load_deferred();
+
     m_original_filename.clear();
     m_resolved_filename.clear();
     m_resolved_archive_filename.clear();
@@ -240,6 +346,7 @@ void Bsdf_measurement::set_transmission( const mi::neuraylib::IBsdf_isotropic_da
 
 const mi::base::IInterface* Bsdf_measurement::get_transmission() const
 {
+    load_deferred();
     if( !m_transmission)
         return 0;
     m_transmission->retain();
@@ -274,6 +381,9 @@ const SERIAL::Serializable* Bsdf_measurement::serialize( SERIAL::Serializer* ser
 {
     Scene_element_base::serialize( serializer);
 
+    // the serialized representation always contains the data
+    load_deferred();
+
     serializer->write( serializer->is_remote() ? "" : m_original_filename);
     serializer->write( serializer->is_remote() ? "" : m_resolved_filename);
     serializer->write( serializer->is_remote() ? "" : m_resolved_archive_filename);
@@ -343,6 +453,8 @@ SERIAL::Serializable* Bsdf_measurement::deserialize( SERIAL::Deserializer* deser
 
 void Bsdf_measurement::dump() const
 {
+    load_deferred();
+
     std::ostringstream s;
 
     s << "Original filename: " << m_original_filename << std::endl;
@@ -359,6 +471,9 @@ void Bsdf_measurement::dump() const
 
 size_t Bsdf_measurement::get_size() const
 {
+    // load_deferred() sets the reflection and transmission data under this lock
+    mi::base::Lock::Block block( &m_deferred_lock);
+
     size_t result = sizeof( *this)
         + dynamic_memory_consumption( m_original_filename)
         + dynamic_memory_consumption( m_resolved_filename)
@@ -699,6 +814,12 @@ DB::Tag load_mdl_bsdf_measurement(
         return tag;
 
     Bsdf_measurement* bsdfm = new Bsdf_measurement();
+    if( MDL::DETAIL::use_deferred_resource_loading()) {
+        bsdfm->reset_file_mdl_deferred( resolved_filename, mdl_file_path);
+        return transaction->store_for_reference_counting(
+            bsdfm, db_name.c_str(), transaction->get_scope()->get_level());
+    }
+
     mi::Sint32 result = bsdfm->reset_file_mdl( resolved_filename, mdl_file_path);
     ASSERT( M_BSDF_MEASUREMENT, result == 0 || result == -3);
     if( result == -3)
@@ -732,6 +853,12 @@ DB::Tag load_mdl_bsdf_measurement(
         return tag;
 
     Bsdf_measurement* bsdfm = new Bsdf_measurement();
+    if( MDL::DETAIL::use_deferred_resource_loading()) {
+        bsdfm->reset_archive_mdl_deferred( archive_filename, archive_membername, mdl_file_path);
+        return transaction->store_for_reference_counting(
+            bsdfm, db_name.c_str(), transaction->get_scope()->get_level());
+    }
+
     mi::Sint32 result = bsdfm->reset_archive_mdl(
         reader, archive_filename, archive_membername, mdl_file_path);
     ASSERT( M_BSDF_MEASUREMENT, result == 0 || result == -3);
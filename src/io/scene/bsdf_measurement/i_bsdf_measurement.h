@@ -30,6 +30,8 @@
 #define IO_SCENE_BSDF_MEASUREMENT_I_BSDF_MEASUREMENT_H
 
 #include <mi/base/handle.h>
+#include <mi/base/lock.h>
+#include <atomic>
 #include <base/data/db/i_db_journal_type.h>
 #include <io/scene/scene/i_scene_scene_element.h>
 
@@ -119,6 +121,29 @@ public:
         const std::string& archive_membername,
         const std::string& mdl_file_path);
 
+    /// Records a BSDF measurement from a file without importing it (used by MDL integration).
+    ///
+    /// The file is imported on first access to the BSDF data. Used if deferred resource loading
+    /// is enabled.
+    ///
+    /// \param resolved_filename     The resolved filename of the BSDF measurement.
+    /// \param mdl_file_path         The MDL file path.
+    void reset_file_mdl_deferred(
+        const std::string& resolved_filename, const std::string& mdl_file_path);
+
+    /// Records a BSDF measurement from an archive without importing it (used by MDL integration).
+    ///
+    /// The archive member is imported on first access to the BSDF data. Used if deferred resource
+    /// loading is enabled.
+    ///
+    /// \param archive_filename      The resolved archive filename.
+    /// \param archive_membername    The resolved archive member name.
+    /// \param mdl_file_path         The MDL file path.
+    void reset_archive_mdl_deferred(
+        const std::string& archive_filename,
+        const std::string& archive_membername,
+        const std::string& mdl_file_path);
+
     const std::string& get_filename() const;
 
     const std::string& get_original_filename() const;
@@ -178,10 +203,12 @@ public:
     // internal methods
 
     /// Indicates whether this BSDF measurement contains valid reflection or transmission data.
-    bool is_valid() const
-    {
-        return m_reflection.is_valid_interface() || m_transmission.is_valid_interface();
-    }
+    bool is_valid() const;
+
+    /// Indicates whether the data of this BSDF measurement has not been imported yet.
+    ///
+    /// \see #reset_file_mdl_deferred(), #reset_archive_mdl_deferred()
+    bool is_deferred() const;
 
     /// Indicates whether this BSDF measurement is file-based.
     bool is_file_based() const { return !m_resolved_filename.empty(); }
@@ -204,6 +231,11 @@ private:
     /// or none. Let's make the assignment operator private for now.
     Bsdf_measurement& operator=( const Bsdf_measurement&);
 
+    /// Imports the data recorded by one of the deferred reset methods, if not yet done.
+    ///
+    /// Thread-safe. Failures are logged and result in an invalid BSDF measurement.
+    void load_deferred() const;
+
     /// Serializes an instance of #mi::neuraylib::IBsdf_isotropic_data.
     static void serialize_bsdf_data(
         SERIAL::Serializer* serializer, const mi::neuraylib::IBsdf_isotropic_data* bsdf_data);
@@ -249,6 +281,15 @@ private:
 
     /// The MDL file path.
     std::string m_mdl_file_path;
+
+    /// Indicates whether the data still needs to be imported from the recorded file or archive.
+    ///
+    /// Cleared only after the data has been imported, so accessors can skip #m_deferred_lock
+    /// once it is \c false.
+    std::atomic<bool> m_is_deferred;
+
+    /// Protects the data while it is imported by #load_deferred().
+    mutable mi::base::Lock m_deferred_lock;
 };
 
 /// Imports BSDF data from a file.
@@ -50,6 +50,18 @@
 namespace {
 
     std::string empty_str;
+
+    /// Creates a memory-based mipmap with a 1x1 canvas with a pink pixel.
+    MI::IMAGE::IMipmap* create_pink_dummy_mipmap()
+    {
+        MI::SYSTEM::Access_module<MI::IMAGE::Image_module> image_module( false);
+        MI::IMAGE::IMipmap* mipmap = image_module->create_mipmap( MI::IMAGE::PT_RGBA, 1, 1);
+        mi::base::Handle<mi::neuraylib::ICanvas> canvas( mipmap->get_level( 0));
+        mi::base::Handle<mi::neuraylib::ITile> tile( canvas->get_tile( 0, 0));
+        mi::math::Color pink( 1.0f, 0.0f, 1.0f, 1.0f);
+        tile->set_pixel( 0, 0, &pink.r);
+        return mipmap;
+    }
 }
 
 namespace MI {
@@ -165,14 +177,15 @@ private:
     std::vector<std::pair<mi::Sint32, mi::Sint32> > m_uvs;
 };
 
-Image::Image() : m_is_uvtile(false)
+Image::Image() : m_is_uvtile(false), m_is_deferred(false)
 {
     set_default_pink_dummy_mipmap();
 }
 
 Image::Image( const Image& other)
   : SCENE::Scene_element<Image, ID_IMAGE>( other),
-    m_is_uvtile(false)
+    m_is_uvtile(false),
+    m_is_deferred(false)
 {
     set_default_pink_dummy_mipmap();
 }
@@ -203,6 +216,8 @@ mi::Sint32 Image::reset_reader( mi::neuraylib::IReader* reader, const char* imag
     m_uv_to_index.reset();
     m_uvtiles.resize(1);
     m_uvtiles[0].m_mipmap = mipmap;
+    m_deferred_image_set = 0;
+    m_is_deferred = false;
 
     m_original_filename.clear();
     m_mdl_file_path.clear();
@@ -213,6 +228,19 @@ mi::Sint32 Image::reset_reader( mi::neuraylib::IReader* reader, const char* imag
 
 mi::Sint32 Image::reset(
     const Image_set* image_set)
+{
+    return reset_shared( image_set, /*deferred*/ false);
+}
+
+mi::Sint32 Image::reset_deferred(
+    const Image_set* image_set)
+{
+    return reset_shared( image_set, /*deferred*/ true);
+}
+
+mi::Sint32 Image::reset_shared(
+    const Image_set* image_set,
+    bool deferred)
 {
     if( !image_set)
         return -1;
@@ -246,6 +274,8 @@ mi::Sint32 Image::reset(
             result = -2;
             break;
         }
+        if( deferred)
+            continue;
         temp_mipmaps[i] = image_set->create_mipmap( i);
         if ( !temp_mipmaps[i].is_valid_interface())
         {
@@ -285,14 +315,57 @@ mi::Sint32 Image::reset(
         m_uvtiles[ i].m_mipmap = temp_mipmaps[ i];
     }
 
+    if( deferred)
+        m_deferred_image_set = make_handle_dup( image_set);
+    else
+        m_deferred_image_set = 0;
+    m_is_deferred = deferred;
+
 #undef set_str
     return 0;
 }
 
+bool Image::is_deferred() const
+{
+    return m_is_deferred.load( std::memory_order_acquire);
+}
+
+void Image::load_deferred() const
+{
+    // fast path: the flag is cleared only after the mipmaps have been imported
+    if( !m_is_deferred.load( std::memory_order_acquire))
+        return;
+
+    mi::base::Lock::Block block( &m_deferred_lock);
+    if( !m_deferred_image_set)
+        return;
+
+    // The DB element itself is never const, only the access to it. Importing the mipmaps does not
+    // change the observable state of this element.
+    Image* self = const_cast<Image*>( this);
+
+    for( mi::Size i = 0, n = m_uvtiles.size(); i < n; ++i) {
+        Uvtile& uvtile = self->m_uvtiles[i];
+        uvtile.m_mipmap = m_deferred_image_set->create_mipmap( i);
+        if( !uvtile.m_mipmap) {
+            const std::string& name = !uvtile.m_resolved_filename.empty()
+                ? uvtile.m_resolved_filename : uvtile.m_resolved_archive_membername;
+            LOG::mod_log->error( M_SCENE, LOG::Mod_log::C_IO,
+                "Failed to load deferred image \"%s\".", name.c_str());
+            uvtile.m_mipmap = create_pink_dummy_mipmap();
+        }
+    }
+
+    self->m_deferred_image_set = 0;
+    self->m_is_deferred.store( false, std::memory_order_release);
+}
+
 void Image::set_mipmap( IMAGE::IMipmap* mipmap)
 {
     ASSERT( M_SCENE, mipmap);
 
+    m_deferred_image_set = 0;
+    m_is_deferred = false;
     m_is_uvtile = false;
     m_uvtiles.resize(1);
     m_uvtiles[0].m_mipmap = make_handle_dup( mipmap);
@@ -315,6 +388,8 @@ IMAGE::IMipmap* Image::get_mipmap()
     if(m_is_uvtile)
         return NULL;
 
+    load_deferred();
+
     m_uvtiles[0].m_resolved_filename.clear();
     m_uvtiles[0].m_resolved_archive_membername.clear();
     m_uvtiles[0].m_mdl_file_path.clear();
@@ -330,6 +405,7 @@ const IMAGE::IMipmap* Image::get_mipmap(mi::Uint32 uvtile_id) const //-V659 PVS
 {
     if(uvtile_id > m_uvtiles.size())
         return NULL;
+    load_deferred();
     m_uvtiles[uvtile_id].m_mipmap->retain();
     return m_uvtiles[uvtile_id].m_mipmap.get();
 }
@@ -370,7 +446,10 @@ const std::string& Image::get_mdl_file_path( ) const
 bool Image::get_is_cubemap() const
 {
     // a uv-tile set cannot be a cubemap
-    return m_is_uvtile ? false : m_uvtiles[0].m_mipmap->get_is_cubemap();
+    if( m_is_uvtile)
+        return false;
+    load_deferred();
+    return m_uvtiles[0].m_mipmap->get_is_cubemap();
 }
 
 bool Image::is_valid() const
@@ -381,6 +460,8 @@ bool Image::is_valid() const
     if (m_uvtiles.size() > 1)
         return true;
 
+    load_deferred();
+
     if( m_uvtiles[0].m_mipmap->get_nlevels() > 1)
         return true;
 
@@ -401,6 +482,9 @@ const SERIAL::Serializable* Image::serialize( SERIAL::Serializer* serializer) co
 {
     Scene_element_base::serialize( serializer);
 
+    // the serialized representation always contains the pixel data
+    load_deferred();
+
     serializer->write( serializer->is_remote() ? "" : m_original_filename);
     serializer->write( serializer->is_remote() ? "" : m_mdl_file_path);
     serializer->write( serializer->is_remote() ? "" : m_resolved_archive_filename);
@@ -513,6 +597,8 @@ SERIAL::Serializable* Image::deserialize( SERIAL::Deserializer* deserializer)
 
 void Image::dump() const
 {
+    load_deferred();
+
     std::ostringstream s;
 
     s << "Original filename: " << m_original_filename << std::endl;
@@ -544,13 +630,18 @@ void Image::dump() const
 
 size_t Image::get_size() const
 {
+    // load_deferred() replaces the mipmaps under this lock
+    mi::base::Lock::Block block( &m_deferred_lock);
+
     size_t s = 0;
     for( std::vector<Uvtile>::const_iterator it = m_uvtiles.begin(); it<m_uvtiles.end(); ++it)
     {
         s += dynamic_memory_consumption( it->m_resolved_filename);
         s += dynamic_memory_consumption( it->m_resolved_archive_membername);
         s += dynamic_memory_consumption( it->m_mdl_file_path);
-        s +=it->m_mipmap->get_size();
+        // mipmaps of deferred images have not been imported yet
+        if( it->m_mipmap)
+            s += it->m_mipmap->get_size();
     }
     return sizeof( *this)
         + dynamic_memory_consumption( m_original_filename)
@@ -580,13 +671,10 @@ void Image::set_default_pink_dummy_mipmap()
     m_is_uvtile = false;
     m_uvtiles.resize(1);
     m_uv_to_index.reset();
+    m_deferred_image_set = 0;
+    m_is_deferred = false;
 
-    SYSTEM::Access_module<IMAGE::Image_module> image_module( false);
-    m_uvtiles[0].m_mipmap = image_module->create_mipmap( IMAGE::PT_RGBA, 1, 1);
-    mi::base::Handle<mi::neuraylib::ICanvas> canvas( m_uvtiles[0].m_mipmap->get_level( 0));
-    mi::base::Handle<mi::neuraylib::ITile> tile( canvas->get_tile( 0, 0));
-    mi::math::Color pink( 1.0f, 0.0f, 1.0f, 1.0f);
-    tile->set_pixel( 0, 0, &pink.r);
+    m_uvtiles[0].m_mipmap = create_pink_dummy_mipmap();
 }
 
 // Parse a file name and enter it into a resource set.
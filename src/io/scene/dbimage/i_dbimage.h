@@ -29,10 +29,12 @@
 #ifndef IO_SCENE_DBIMAGE_I_DBIMAGE_H
 #define IO_SCENE_DBIMAGE_I_DBIMAGE_H
 
+#include <atomic>
 #include <vector>
 
 #include <mi/base/handle.h>
 #include <mi/base/interface_implement.h>
+#include <mi/base/lock.h>
 #include <base/system/main/access_module.h>
 #include <io/scene/scene/i_scene_scene_element.h>
 
@@ -198,6 +200,20 @@ public:
     Sint32 reset(
         const Image_set* image_set);
 
+    /// Records mipmaps according to an image description without importing them.
+    ///
+    /// Only the resolved filenames and the uv-tile mapping are stored. The image set is kept and
+    /// the mipmaps are imported from it on first access to the pixel data, e.g., via
+    /// #get_mipmap(). Used by the MDL integration if deferred resource loading is enabled.
+    ///
+    /// \param image_set            The image description to use.
+    /// \return
+    ///                              -  0: Success.
+    ///                              - -1: The image set is NULL or empty
+    ///                              - -2: The uv-tile mapping is invalid.
+    Sint32 reset_deferred(
+        const Image_set* image_set);
+
     /// Sets a memory-based mipmap.
     ///
     /// Actually, the mipmap might not be memory-based, but it will be treated as if it was a
@@ -271,6 +287,11 @@ public:
 
     // internal methods
 
+    /// Indicates whether the mipmaps of this image have not been imported yet.
+    ///
+    /// \see #reset_deferred()
+    bool is_deferred() const;
+
     /// Indicates whether this mipmap is file-based.
     bool is_file_based() const { return !m_uvtiles[0].m_resolved_filename.empty(); }
 
@@ -411,6 +432,15 @@ private:
     /// Does not affect the stored filenames.
     void set_default_pink_dummy_mipmap();
 
+    /// Implements #reset() and #reset_deferred().
+    Sint32 reset_shared( const Image_set* image_set, bool deferred);
+
+    /// Imports the mipmaps from the image set recorded by #reset_deferred(), if any.
+    ///
+    /// Tiles that fail to import are replaced by a dummy mipmap with a 1x1 canvas with a pink
+    /// pixel. Thread-safe.
+    void load_deferred() const;
+
     /// Searches for files matching the given path or udim/uv-tile pattern 
     /// 
     /// \param path path to resolve
@@ -454,6 +484,21 @@ private:
     std::string m_resolved_archive_filename;
 
     bool m_is_uvtile;
+
+    /// The image set whose mipmaps have not been imported yet.
+    ///
+    /// Non-NULL exactly for images reset via #reset_deferred() until the first access to the
+    /// pixel data.
+    mi::base::Handle<const Image_set> m_deferred_image_set;
+
+    /// Indicates whether #m_deferred_image_set still needs to be imported.
+    ///
+    /// Cleared only after the mipmaps have been imported, so accessors can skip
+    /// #m_deferred_lock once it is \c false.
+    std::atomic<bool> m_is_deferred;
+
+    /// Protects #m_deferred_image_set and the mipmaps while they are imported.
+    mutable mi::base::Lock m_deferred_lock;
 };
 
 } // namespace DBIMAGE
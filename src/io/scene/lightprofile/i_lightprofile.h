@@ -29,7 +29,9 @@
 #ifndef IO_SCENE_LIGHTPROFILE_I_LIGHTPROFILE_H
 #define IO_SCENE_LIGHTPROFILE_I_LIGHTPROFILE_H
 
+#include <mi/base/lock.h>
 #include <mi/neuraylib/ilightprofile.h>
+#include <atomic>
 #include <vector>
 #include <base/data/db/i_db_journal_type.h>
 #include <io/scene/scene/i_scene_scene_element.h>
@@ -52,6 +54,9 @@ public:
     /// Default constructor.
     Lightprofile();
 
+    /// Copy constructor.
+    Lightprofile( const Lightprofile& other);
+
     // methods of mi::neuraylib::ILightprofile
 
     /// Imports a light profile from a file.
@@ -138,6 +143,46 @@ public:
         mi::neuraylib::Lightprofile_degree degree = mi::neuraylib::LIGHTPROFILE_HERMITE_BASE_1,
         mi::Uint32 flags = mi::neuraylib::LIGHTPROFILE_COUNTER_CLOCKWISE);
 
+    /// Records a light profile from a file without importing it (used by MDL integration).
+    ///
+    /// The file is imported on first access to the light profile data. Used if deferred resource
+    /// loading is enabled.
+    ///
+    /// \param resolved_filename     The resolved filename of the light profile.
+    /// \param mdl_file_path         The MDL file path.
+    /// \param resolution_phi        See #reset_file().
+    /// \param resolution_theta      See #reset_file().
+    /// \param degree                See #reset_file().
+    /// \param flags                 See #reset_file().
+    void reset_file_mdl_deferred(
+        const std::string& resolved_filename,
+        const std::string& mdl_file_path,
+        mi::Uint32 resolution_phi = 0,
+        mi::Uint32 resolution_theta = 0,
+        mi::neuraylib::Lightprofile_degree degree = mi::neuraylib::LIGHTPROFILE_HERMITE_BASE_1,
+        mi::Uint32 flags = mi::neuraylib::LIGHTPROFILE_COUNTER_CLOCKWISE);
+
+    /// Records a light profile from an archive without importing it (used by MDL integration).
+    ///
+    /// The archive member is imported on first access to the light profile data. Used if deferred
+    /// resource loading is enabled.
+    ///
+    /// \param archive_filename      The resolved archive filename.
+    /// \param archive_membername    The resolved archive member name.
+    /// \param mdl_file_path         The MDL file path.
+    /// \param resolution_phi        See #reset_file().
+    /// \param resolution_theta      See #reset_file().
+    /// \param degree                See #reset_file().
+    /// \param flags                 See #reset_file().
+    void reset_archive_mdl_deferred(
+        const std::string& archive_filename,
+        const std::string& archive_membername,
+        const std::string& mdl_file_path,
+        mi::Uint32 resolution_phi = 0,
+        mi::Uint32 resolution_theta = 0,
+        mi::neuraylib::Lightprofile_degree degree = mi::neuraylib::LIGHTPROFILE_HERMITE_BASE_1,
+        mi::Uint32 flags = mi::neuraylib::LIGHTPROFILE_COUNTER_CLOCKWISE);
+
     const std::string& get_filename() const;
 
     const std::string& get_original_filename() const;
@@ -164,6 +209,11 @@ public:
 
     mi::Float32 sample( mi::Float32 phi, mi::Float32 theta, bool candela) const;
 
+    mi::Float32 sample_direction(
+        mi::Float32 xi_phi, mi::Float32 xi_theta, mi::Float32* phi, mi::Float32* theta) const;
+
+    mi::Float32 get_pdf( mi::Float32 phi, mi::Float32 theta) const;
+
     // methods of SERIAL::Serializable
 
     const SERIAL::Serializable* serialize( SERIAL::Serializer* serializer) const;
@@ -197,7 +247,19 @@ public:
     mi::Float32 get_maximum() const { return get_candela_multiplier(); }
 
     /// Indicates whether this light profile contains valid light profile data.
-    bool is_valid() const { return !m_data.empty(); }
+    bool is_valid() const;
+
+    /// Evaluates the light profile in candela for a direction.
+    ///
+    /// Same result as #sample() with \c candela set to \c true, but the direction is mapped to
+    /// its grid cell with clamps and selects instead of floor(), such that batched callers (e.g.
+    /// the native MDL runtime) can vectorize it.
+    mi::Float32 evaluate( mi::Float32 phi, mi::Float32 theta) const;
+
+    /// Indicates whether the data of this light profile has not been imported yet.
+    ///
+    /// \see #reset_file_mdl_deferred(), #reset_archive_mdl_deferred()
+    bool is_deferred() const;
 
     /// Indicates whether this light profile is file-based.
     bool is_file_based() const { return !m_resolved_filename.empty(); }
@@ -227,6 +289,26 @@ private:
         mi::neuraylib::Lightprofile_degree degree = mi::neuraylib::LIGHTPROFILE_HERMITE_BASE_1,
         mi::Uint32 flags = mi::neuraylib::LIGHTPROFILE_COUNTER_CLOCKWISE);
 
+    /// Computes the sampling tables used by #sample_direction() and #get_pdf() from #m_data.
+    void compute_sampling_tables();
+
+    /// Maps a direction to its grid cell.
+    ///
+    /// The indices and interpolation weights are clamped to the grid. Returns \c false if the
+    /// direction is outside of the grid.
+    bool find_cell(
+        mi::Float32 phi,
+        mi::Float32 theta,
+        mi::Uint32& index_phi,
+        mi::Uint32& index_theta,
+        mi::Float32& u,
+        mi::Float32& v) const;
+
+    /// Imports the data recorded by one of the deferred reset methods, if not yet done.
+    ///
+    /// Thread-safe. Failures are logged and result in an invalid light profile.
+    void load_deferred() const;
+
     /// Comments on DB::Element_base and DB::Element say that the copy constructor is needed.
     /// But the assignment operator is not implemented, although usually, they are implemented both
     /// or none. Let's make the assignment operator private for now.
@@ -275,6 +357,21 @@ private:
     // Computed data
     mi::Float32 m_candela_multiplier;
     mi::Float32 m_power;
+
+    // Sampling tables, computed from m_data (not serialized)
+    std::vector<mi::Float32> m_cos_theta;  ///< cos() of every theta sample
+    std::vector<mi::Float32> m_cdf_phi;    ///< marginal CDF over the phi cells
+    std::vector<mi::Float32> m_cdf_theta;  ///< conditional CDF over theta for each phi cell
+    std::vector<mi::Float32> m_pdf;        ///< pdf w.r.t. solid angle of every cell
+
+    /// Indicates whether the data still needs to be imported from the recorded file or archive.
+    ///
+    /// Cleared only after the data has been imported, so accessors can skip #m_deferred_lock
+    /// once it is \c false.
+    std::atomic<bool> m_is_deferred;
+
+    /// Protects the data while it is imported by #load_deferred().
+    mutable mi::base::Lock m_deferred_lock;
 };
 
 /// Exports the light profile to a file.
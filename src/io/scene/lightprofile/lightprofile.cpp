@@ -45,6 +45,7 @@
 #include <io/scene/scene/i_scene_journal_types.h>
 #include <io/scene/mdl_elements/mdl_elements_detail.h>
 
+#include <algorithm>
 #include <sstream>
 
 
@@ -52,6 +53,34 @@ namespace MI {
 
 namespace LIGHTPROFILE {
 
+namespace {
+
+/// Finds the interval i with cdf[i-1] <= x < cdf[i] of a non-decreasing table of n > 0 entries.
+///
+/// Uses a fixed number of iterations without data dependent branches.
+mi::Uint32 find_interval( const mi::Float32* cdf, mi::Uint32 n, mi::Float32 x)
+{
+    mi::Uint32 first = 0;
+    mi::Uint32 len   = n;
+    while( len > 0) {
+        mi::Uint32 half = len >> 1;
+        bool larger = cdf[first + half] <= x;
+        first = larger ? first + half + 1 : first;
+        len   = larger ? len - half - 1   : half;
+    }
+    return std::min( first, n - 1);
+}
+
+/// Remaps a random number that selected the interval i of a CDF back to [0,1].
+mi::Float32 remap_in_interval( const mi::Float32* cdf, mi::Uint32 i, mi::Float32 x)
+{
+    mi::Float32 prev = i > 0 ? cdf[i-1] : 0.0f;
+    mi::Float32 w    = cdf[i] - prev;
+    return w > 0.0f ? std::min( (x - prev) / w, 1.0f) : 0.5f;
+}
+
+} // namespace
+
 // implemented in lightprofile_ies_parser.cpp
 bool setup_lightprofile(
     mi::neuraylib::IReader* reader,
@@ -76,8 +105,37 @@ Lightprofile::Lightprofile()
     m_delta_phi( 0.0f),
     m_delta_theta( 0.0f),
     m_candela_multiplier( 0.0f),
-    m_power( 0.0f)
+    m_power( 0.0f),
+    m_is_deferred( false)
+{
+}
+
+Lightprofile::Lightprofile( const Lightprofile& other)
+  : SCENE::Scene_element<Lightprofile, ID_LIGHTPROFILE>( other)
 {
+    mi::base::Lock::Block block( &other.m_deferred_lock);
+
+    m_original_filename = other.m_original_filename;
+    m_resolved_filename = other.m_resolved_filename;
+    m_resolved_archive_filename = other.m_resolved_archive_filename;
+    m_resolved_archive_membername = other.m_resolved_archive_membername;
+    m_mdl_file_path = other.m_mdl_file_path;
+    m_resolution_phi = other.m_resolution_phi;
+    m_resolution_theta = other.m_resolution_theta;
+    m_degree = other.m_degree;
+    m_flags = other.m_flags;
+    m_start_phi = other.m_start_phi;
+    m_start_theta = other.m_start_theta;
+    m_delta_phi = other.m_delta_phi;
+    m_delta_theta = other.m_delta_theta;
+    m_data = other.m_data;
+    m_candela_multiplier = other.m_candela_multiplier;
+    m_power = other.m_power;
+    m_cos_theta = other.m_cos_theta;
+    m_cdf_phi = other.m_cdf_phi;
+    m_cdf_theta = other.m_cdf_theta;
+    m_pdf = other.m_pdf;
+    m_is_deferred = other.m_is_deferred.load();
 }
 
 mi::Sint32 Lightprofile::reset_file(
@@ -202,6 +260,96 @@ mi::Sint32 Lightprofile::reset_archive_mdl(
     return 0;
 }
 
+void Lightprofile::reset_file_mdl_deferred(
+    const std::string& resolved_filename,
+    const std::string& mdl_file_path,
+    mi::Uint32 resolution_phi,
+    mi::Uint32 resolution_theta,
+    mi::neuraylib::Lightprofile_degree degree,
+    mi::Uint32 flags)
+{
+    m_resolved_archive_filename.clear();
+    m_resolved_archive_membername.clear();
+    m_original_filename.clear();
+    m_resolved_filename = resolved_filename;
+    m_mdl_file_path = mdl_file_path;
+
+    m_resolution_phi   = resolution_phi;
+    m_resolution_theta = resolution_theta;
+    m_degree           = degree;
+    m_flags            = flags;
+    m_data.clear();
+    compute_sampling_tables();
+    m_is_deferred      = true;
+}
+
+void Lightprofile::reset_archive_mdl_deferred(
+    const std::string& archive_filename,
+    const std::string& archive_membername,
+    const std::string& mdl_file_path,
+    mi::Uint32 resolution_phi,
+    mi::Uint32 resolution_theta,
+    mi::neuraylib::Lightprofile_degree degree,
+    mi::Uint32 flags)
+{
+    m_original_filename.clear();
+    m_resolved_filename.clear();
+    m_resolved_archive_filename = archive_filename;
+    m_resolved_archive_membername = archive_membername;
+    m_mdl_file_path = mdl_file_path;
+
+    m_resolution_phi   = resolution_phi;
+    m_resolution_theta = resolution_theta;
+    m_degree           = degree;
+    m_flags            = flags;
+    m_data.clear();
+    compute_sampling_tables();
+    m_is_deferred      = true;
+}
+
+void Lightprofile::load_deferred() const
+{
+    // fast path: the flag is cleared only after the data has been imported
+    if( !m_is_deferred.load( std::memory_order_acquire))
+        return;
+
+    mi::base::Lock::Block block( &m_deferred_lock);
+    if( !m_is_deferred.load( std::memory_order_relaxed))
+        return;
+
+    // The DB element itself is never const, only the access to it. Importing the data does not
+    // change the observable state of this element.
+    Lightprofile* self = const_cast<Lightprofile*>( this);
+
+    mi::Sint32 result = -2;
+    std::string filename;
+    if( !m_resolved_archive_filename.empty()) {
+        filename = m_resolved_archive_membername + "\" in \"" + m_resolved_archive_filename;
+        MDL::DETAIL::Mdr_callback callback;
+        mi::base::Handle<mi::neuraylib::IReader> reader( callback.get_reader(
+            m_resolved_archive_filename.c_str(), m_resolved_archive_membername.c_str()));
+        if( reader)
+            result = self->reset_file_shared( reader.get(), filename,
+                m_resolution_phi, m_resolution_theta, m_degree, m_flags);
+    } else {
+        filename = m_resolved_filename;
+        DISK::File_reader_impl reader;
+        if( reader.open( m_resolved_filename.c_str()))
+            result = self->reset_file_shared( &reader, filename,
+                m_resolution_phi, m_resolution_theta, m_degree, m_flags);
+    }
+
+    // also on failure, the element stays invalid then
+    self->m_is_deferred.store( false, std::memory_order_release);
+
+    if( result == -4)
+        LOG::mod_log->error( M_SCENE, LOG::Mod_log::C_IO,
+            "File format error in deferred light profile \"%s\".", filename.c_str());
+    else if( result != 0)
+        LOG::mod_log->error( M_SCENE, LOG::Mod_log::C_IO,
+            "Failed to load deferred light profile \"%s\".", filename.c_str());
+}
+
 mi::Sint32 Lightprofile::reset_file_shared(
     mi::neuraylib::IReader* reader,
     const std::string& filename,
@@ -282,6 +430,10 @@ mi::Sint32 Lightprofile::reset_file_shared(
     // grid cell
     m_power *= m_candela_multiplier * m_delta_phi * 0.25f;
 
+    compute_sampling_tables();
+
+    m_is_deferred = false;
+
     return 0;
 }
 
@@ -311,11 +463,13 @@ const std::string& Lightprofile::get_mdl_file_path() const
 
 mi::Uint32 Lightprofile::get_resolution_phi() const
 {
+    load_deferred();
     return m_resolution_phi;
 }
 
 mi::Uint32 Lightprofile::get_resolution_theta() const
 {
+    load_deferred();
     return m_resolution_theta;
 }
 
@@ -331,16 +485,19 @@ mi::Uint32 Lightprofile::get_flags() const
 
 mi::Float32 Lightprofile::get_phi( mi::Uint32 index) const
 {
+    load_deferred();
     return index >= m_resolution_phi ? 0.0f : m_start_phi + index * m_delta_phi;
 }
 
 mi::Float32 Lightprofile::get_theta( mi::Uint32 index) const
 {
+    load_deferred();
     return index >= m_resolution_theta ? 0.0f : m_start_theta + index * m_delta_theta;
 }
 
 mi::Float32 Lightprofile::get_data( mi::Uint32 index_phi, mi::Uint32 index_theta) const
 {
+    load_deferred();
     if( index_phi >= m_resolution_phi || index_theta >= m_resolution_theta)
         return 0;
     return m_data[index_phi * m_resolution_theta + index_theta];
@@ -348,16 +505,19 @@ mi::Float32 Lightprofile::get_data( mi::Uint32 index_phi, mi::Uint32 index_theta
 
 const mi::Float32* Lightprofile::get_data() const
 {
+    load_deferred();
     return m_data.size() > 0 ? &m_data[0] : 0;
 }
 
 mi::Float32 Lightprofile::get_candela_multiplier() const
 {
+    load_deferred();
     return m_candela_multiplier;
 }
 
 mi::Float32 Lightprofile::sample( mi::Float32 phi, mi::Float32 theta, bool candela) const
 {
+    load_deferred();
     if( m_data.empty())
         return 0.0f;
 
@@ -395,10 +555,174 @@ mi::Float32 Lightprofile::sample( mi::Float32 phi, mi::Float32 theta, bool cande
     return candela ? value * m_candela_multiplier : value;
 }
 
+mi::Float32 Lightprofile::sample_direction(
+    mi::Float32 xi_phi, mi::Float32 xi_theta, mi::Float32* phi, mi::Float32* theta) const
+{
+    load_deferred();
+    if( m_pdf.empty()) {
+        *phi   = 0.0f;
+        *theta = 0.0f;
+        return 0.0f;
+    }
+
+    mi::Uint32 cells_phi   = m_resolution_phi - 1;
+    mi::Uint32 cells_theta = m_resolution_theta - 1;
+
+    // select the phi cell from the marginal CDF and reuse the remainder of xi_phi inside it
+    mi::Uint32 i = find_interval( &m_cdf_phi[0], cells_phi, xi_phi);
+    mi::Float32 s_phi = remap_in_interval( &m_cdf_phi[0], i, xi_phi);
+
+    // select the theta cell from the conditional CDF of that phi cell
+    const mi::Float32* cdf = &m_cdf_theta[i * cells_theta];
+    mi::Uint32 j = find_interval( cdf, cells_theta, xi_theta);
+    mi::Float32 s_theta = remap_in_interval( cdf, j, xi_theta);
+
+    // uniform in phi and in cos(theta) inside the cell, so the pdf is constant over the cell
+    mi::Float32 cos_theta = m_cos_theta[j] + s_theta * (m_cos_theta[j+1] - m_cos_theta[j]);
+    *phi   = m_start_phi + (i + s_phi) * m_delta_phi;
+    *theta = acosf( mi::math::clamp( cos_theta, -1.0f, 1.0f));
+    return m_pdf[i * cells_theta + j];
+}
+
+mi::Float32 Lightprofile::get_pdf( mi::Float32 phi, mi::Float32 theta) const
+{
+    load_deferred();
+    if( m_pdf.empty())
+        return 0.0f;
+
+    mi::Uint32 index_phi, index_theta;
+    mi::Float32 u, v;
+    bool inside = find_cell( phi, theta, index_phi, index_theta, u, v);
+
+    mi::Float32 pdf = m_pdf[index_phi * (m_resolution_theta - 1) + index_theta];
+    return inside ? pdf : 0.0f;
+}
+
+mi::Float32 Lightprofile::evaluate( mi::Float32 phi, mi::Float32 theta) const
+{
+    load_deferred();
+    if( m_data.empty())
+        return 0.0f;
+
+    mi::Uint32 index_phi, index_theta;
+    mi::Float32 u, v;
+    bool inside = find_cell( phi, theta, index_phi, index_theta, u, v);
+
+    // bilinear interpolation
+    mi::Size index0 = index_phi * m_resolution_theta + index_theta;
+    mi::Size index1 = index0 + m_resolution_theta;
+    mi::Float32 value = (1.0f-u) * ((1.0f-v) * m_data[index0] + v * m_data[index0 + 1])
+                        +     u  * ((1.0f-v) * m_data[index1] + v * m_data[index1 + 1]);
+
+    return inside ? value * m_candela_multiplier : 0.0f;
+}
+
+bool Lightprofile::find_cell(
+    mi::Float32 phi,
+    mi::Float32 theta,
+    mi::Uint32& index_phi,
+    mi::Uint32& index_theta,
+    mi::Float32& u,
+    mi::Float32& v) const
+{
+    const mi::Float32 two_pi = static_cast<mi::Float32>( 2*M_PI);
+
+    // reduce phi_offset into [0,2*pi) without calling floor()
+    mi::Float32 phi_offset = phi - m_start_phi;
+    phi_offset += phi_offset <  0.0f   ? two_pi : 0.0f;
+    phi_offset -= phi_offset >= two_pi ? two_pi : 0.0f;
+
+    mi::Float32 fu = phi_offset / m_delta_phi;
+    mi::Float32 fv = (theta - m_start_theta) / m_delta_theta;
+
+    mi::Float32 max_u = static_cast<mi::Float32>( m_resolution_phi - 1);
+    mi::Float32 max_v = static_cast<mi::Float32>( m_resolution_theta - 1);
+    bool inside = fu >= 0.0f && fu <= max_u && fv >= 0.0f && fv <= max_v;
+
+    // clamp instead of branching, the result is masked by the caller
+    fu = mi::math::clamp( fu, 0.0f, max_u);
+    fv = mi::math::clamp( fv, 0.0f, max_v);
+    index_phi   = std::min( static_cast<mi::Uint32>( fu), m_resolution_phi   - 2);
+    index_theta = std::min( static_cast<mi::Uint32>( fv), m_resolution_theta - 2);
+    u = fu - index_phi;
+    v = fv - index_theta;
+
+    return inside;
+}
+
+void Lightprofile::compute_sampling_tables()
+{
+    m_cos_theta.clear();
+    m_cdf_phi.clear();
+    m_cdf_theta.clear();
+    m_pdf.clear();
+
+    if( m_data.empty() || m_resolution_phi < 2 || m_resolution_theta < 2)
+        return;
+
+    mi::Uint32 cells_phi   = m_resolution_phi - 1;
+    mi::Uint32 cells_theta = m_resolution_theta - 1;
+
+    m_cos_theta.resize( m_resolution_theta);
+    for( mi::Uint32 j = 0; j < m_resolution_theta; ++j)
+        m_cos_theta[j] = cosf( m_start_theta + j * m_delta_theta);
+
+    // the weight of a cell is its average value times its solid angle
+    std::vector<mi::Float32> cell_value( cells_phi * cells_theta);
+    m_cdf_phi.resize( cells_phi);
+    m_cdf_theta.resize( cells_phi * cells_theta);
+
+    mi::Float64 total = 0.0;
+    for( mi::Uint32 i = 0; i < cells_phi; ++i) {
+        const mi::Float32* row0 = &m_data[i * m_resolution_theta];
+        const mi::Float32* row1 = row0 + m_resolution_theta;
+        mi::Float32* cdf = &m_cdf_theta[i * cells_theta];
+
+        mi::Float64 row_sum = 0.0;
+        for( mi::Uint32 j = 0; j < cells_theta; ++j) {
+            mi::Float32 solid_angle
+                = std::max( 0.0f, m_delta_phi * (m_cos_theta[j] - m_cos_theta[j+1]));
+            mi::Float32 value = 0.25f * (row0[j] + row0[j+1] + row1[j] + row1[j+1]);
+            cell_value[i * cells_theta + j] = solid_angle > 0.0f ? value : 0.0f;
+            row_sum += value * solid_angle;
+            cdf[j] = static_cast<mi::Float32>( row_sum);
+        }
+
+        // normalize the conditional CDF, an empty row is sampled uniformly
+        for( mi::Uint32 j = 0; j < cells_theta; ++j)
+            cdf[j] = row_sum > 0.0
+                ? static_cast<mi::Float32>( cdf[j] / row_sum)
+                : static_cast<mi::Float32>( j+1) / cells_theta;
+        cdf[cells_theta-1] = 1.0f;
+
+        total += row_sum;
+        m_cdf_phi[i] = static_cast<mi::Float32>( total);
+    }
+
+    // nothing to sample
+    if( total <= 0.0) {
+        m_cdf_phi.clear();
+        m_cdf_theta.clear();
+        return;
+    }
+
+    for( mi::Uint32 i = 0; i < cells_phi; ++i)
+        m_cdf_phi[i] = static_cast<mi::Float32>( m_cdf_phi[i] / total);
+    m_cdf_phi[cells_phi-1] = 1.0f;
+
+    // the pdf w.r.t. solid angle is piecewise constant over the cells
+    m_pdf.resize( cells_phi * cells_theta);
+    for( mi::Size k = 0; k < m_pdf.size(); ++k)
+        m_pdf[k] = static_cast<mi::Float32>( cell_value[k] / total);
+}
+
 const SERIAL::Serializable* Lightprofile::serialize( SERIAL::Serializer* serializer) const
 {
     Scene_element_base::serialize( serializer);
 
+    // the serialized representation always contains the data
+    load_deferred();
+
     serializer->write( serializer->is_remote() ? "" : m_original_filename);
     serializer->write( serializer->is_remote() ? "" : m_resolved_filename);
     serializer->write( serializer->is_remote() ? "" : m_resolved_archive_filename);
@@ -446,6 +770,7 @@ SERIAL::Serializable* Lightprofile::deserialize( SERIAL::Deserializer* deseriali
     SERIAL::read( deserializer, &m_data);
     deserializer->read( &m_candela_multiplier);
     deserializer->read( &m_power);
+    compute_sampling_tables();
 
     // Adjust m_original_filename and m_resolved_filename for this host.
     if( !m_original_filename.empty()) {
@@ -488,6 +813,8 @@ SERIAL::Serializable* Lightprofile::deserialize( SERIAL::Deserializer* deseriali
 
 void Lightprofile::dump() const
 {
+    load_deferred();
+
     std::ostringstream s;
 
     s << "Original filename: " << m_original_filename << std::endl;
@@ -513,13 +840,20 @@ void Lightprofile::dump() const
 
 size_t Lightprofile::get_size() const
 {
+    // load_deferred() fills m_data under this lock
+    mi::base::Lock::Block block( &m_deferred_lock);
+
     return sizeof( *this)
         + dynamic_memory_consumption( m_original_filename)
         + dynamic_memory_consumption( m_resolved_filename)
         + dynamic_memory_consumption( m_resolved_archive_filename)
         + dynamic_memory_consumption( m_resolved_archive_membername)
         + dynamic_memory_consumption( m_mdl_file_path)
-        + dynamic_memory_consumption( m_data);
+        + dynamic_memory_consumption( m_data)
+        + dynamic_memory_consumption( m_cos_theta)
+        + dynamic_memory_consumption( m_cdf_phi)
+        + dynamic_memory_consumption( m_cdf_theta)
+        + dynamic_memory_consumption( m_pdf);
 }
 
 DB::Journal_type Lightprofile::get_journal_flags() const
@@ -540,9 +874,21 @@ void Lightprofile::get_scene_element_references( DB::Tag_set* result) const
 
 mi::Float32 Lightprofile::get_power() const
 {
+    load_deferred();
     return m_power;
 }
 
+bool Lightprofile::is_valid() const
+{
+    load_deferred();
+    return !m_data.empty();
+}
+
+bool Lightprofile::is_deferred() const
+{
+    return m_is_deferred.load( std::memory_order_acquire);
+}
+
 namespace { float round_3_digits( float x) { return mi::math::round( x*1000.0f)/1000.0f; } }
 
 bool export_to_file(
@@ -669,6 +1015,12 @@ DB::Tag load_mdl_lightprofile(
         return tag;
 
     Lightprofile* lp = new Lightprofile();
+    if( MDL::DETAIL::use_deferred_resource_loading()) {
+        lp->reset_file_mdl_deferred( resolved_filename, mdl_file_path);
+        return transaction->store_for_reference_counting(
+            lp, db_name.c_str(), transaction->get_scope()->get_level());
+    }
+
     mi::Sint32 result = lp->reset_file_mdl( resolved_filename, mdl_file_path);
     ASSERT( M_LIGHTPROFILE, result == 0 || result == -4);
     if( result == -4)
@@ -702,6 +1054,12 @@ DB::Tag load_mdl_lightprofile(
         return tag;
 
     Lightprofile* lp = new Lightprofile();
+    if( MDL::DETAIL::use_deferred_resource_loading()) {
+        lp->reset_archive_mdl_deferred( archive_filename, archive_membername, mdl_file_path);
+        return transaction->store_for_reference_counting(
+            lp, db_name.c_str(), transaction->get_scope()->get_level());
+    }
+
     mi::Sint32 result = lp->reset_archive_mdl(
         reader, archive_filename, archive_membername, mdl_file_path);
     ASSERT( M_LIGHTPROFILE, result == 0 || result == -4);
@@ -38,6 +38,7 @@
 #include <mi/mdl/mdl_generated_dag.h>
 
 #include <string>
+#include <vector>
 
 #include "i_mdl_elements_expression.h" // needed by Visual Studio
 
@@ -63,6 +64,24 @@ class Mdl_compiled_material
 {
 public:
 
+    /// An input of the compilation, i.e., a call or a constant in the argument graph of the
+    /// compiled material instance.
+    ///
+    /// Inputs are identified by their parameter path, e.g., "tint" for an argument of the
+    /// material instance, or "base.color" for an argument of the call which is the argument
+    /// "base" of the material instance. In class compilation mode, the arguments of the
+    /// compiled material are named by these paths.
+    struct Compilation_input
+    {
+        std::string m_path;                        ///< The parameter path.
+        DB::Tag m_call;                            ///< The call, or invalid for constants.
+        DB::Tag m_definition;                      ///< The definition of the call, or invalid.
+        mi::base::Handle<const IValue> m_value;    ///< The constant, or \c NULL for calls.
+    };
+
+    /// The inputs of a compilation in depth-first order.
+    typedef std::vector<Compilation_input> Compilation_inputs;
+
     /// Default constructor.
     ///
     /// Does not create a valid instance, to be used by the deserializer only.
@@ -86,6 +105,36 @@ public:
         mi::Float32 mdl_wavelength_min,
         mi::Float32 mdl_wavelength_max);
 
+    /// Constructor that reuses the structure of another compiled material.
+    ///
+    /// Body, temporaries, hashes and the scene unit and wavelength parameters are shared with
+    /// \p other, only the arguments and the properties are taken from \p instance. This is only
+    /// valid if #has_same_structure() returns \c true for \p instance.
+    ///
+    /// \param other                       The compiled material whose structure is reused.
+    /// \param transaction                 The DB transaction to use.
+    /// \param instance                    The wrapped MDL material instance.
+    /// \param module_filename             The filename of the module.
+    /// \param module_name                 The fully-qualified MDL module name.
+    Mdl_compiled_material(
+        const Mdl_compiled_material& other,
+        DB::Transaction* transaction,
+        const mi::mdl::IGenerated_code_dag::IMaterial_instance* instance,
+        const char* module_filename,
+        const char* module_name);
+
+    /// Constructor that reuses everything but the arguments of another compiled material.
+    ///
+    /// Only valid for class-compiled materials, and only if \p arguments differ from the
+    /// arguments of \p other at most in values (not in names or types), and none of the changed
+    /// values contains resources.
+    ///
+    /// \param other                       The compiled material to copy.
+    /// \param arguments                   The new arguments.
+    Mdl_compiled_material(
+        const Mdl_compiled_material& other,
+        const IValue_list* arguments);
+
     // methods corresponding to mi::neuraylib::ICompiled_material
 
     const IExpression_direct_call* get_body() const;
@@ -122,6 +171,37 @@ public:
 
     const IExpression_list* get_temporaries() const;
 
+    /// Indicates whether the class-compiled MDL material instance \p instance differs from this
+    /// compiled material only in the values of its arguments.
+    ///
+    /// This is the case if hash values, parameter names, and the number of temporaries are
+    /// identical. Target code generated for this compiled material can then be used with the
+    /// arguments of \p instance.
+    bool has_same_structure(
+        const mi::mdl::IGenerated_code_dag::IMaterial_instance* instance) const;
+
+    /// Records the inputs this compiled material was created from.
+    ///
+    /// The inputs allow later compilations to decide whether this compiled material (or its
+    /// structure) can be reused. They are not serialized, i.e., a deserialized compiled material
+    /// has no recorded inputs.
+    ///
+    /// \param definition          The material definition of the compiled material instance.
+    /// \param class_compilation   Whether class compilation was used.
+    /// \param inputs              The inputs. The vector is swapped into this compiled material.
+    void set_compilation_inputs(
+        DB::Tag definition, bool class_compilation, Compilation_inputs& inputs);
+
+    /// Returns the material definition recorded by #set_compilation_inputs(), or an invalid tag
+    /// if no inputs have been recorded.
+    DB::Tag get_compilation_definition() const { return m_compilation_definition; }
+
+    /// Indicates whether class compilation was used as recorded by #set_compilation_inputs().
+    bool get_class_compilation() const { return m_class_compilation; }
+
+    /// Returns the inputs recorded by #set_compilation_inputs().
+    const Compilation_inputs& get_compilation_inputs() const { return m_compilation_inputs; }
+
     /// Swaps *this and \p other.
     ///
     /// Used by the API to move the content of just constructed DB elements into the already
@@ -181,12 +261,38 @@ public:
         return m_properties;
     }
 
+    /// Returns the statistics of the material instance initialization that produced this
+    /// compiled material.
+    const mi::mdl::Compile_statistics& get_statistics() const { return m_statistics; }
+
+    /// Sets the statistics of the module defining the material, i.e., the front-end phases of
+    /// the module (if compiled from source) and its DAG generation.
+    ///
+    /// They are shared by all materials of the module and are kept apart from the statistics
+    /// of the instance, such that they can be counted once per module.
+    void set_module_statistics(
+        const char* module_name, const mi::mdl::Compile_statistics& statistics);
+
+    /// Returns the name of the module passed to #set_module_statistics().
+    const std::string& get_module_name() const { return m_module_name; }
+
+    /// Returns the statistics passed to #set_module_statistics().
+    const mi::mdl::Compile_statistics& get_module_statistics() const
+    { return m_module_statistics; }
+
 private:
 
     /// Converts a hash from the MDL API representation to the base API representation.
     static mi::base::Uuid convert_hash(
         const mi::mdl::DAG_hash& hash);
 
+    /// Sets #m_arguments from the parameter defaults of \p instance.
+    void convert_arguments(
+        DB::Transaction* transaction,
+        const mi::mdl::IGenerated_code_dag::IMaterial_instance* instance,
+        const char* module_filename,
+        const char* module_name);
+
     mi::base::Handle<IType_factory> m_tf;             ///< The type factory.
     mi::base::Handle<IValue_factory> m_vf;            ///< The value factory.
     mi::base::Handle<IExpression_factory> m_ef;       ///< The expression factory.
@@ -205,6 +311,14 @@ private:
 
     mi::mdl::IGenerated_code_dag::IMaterial_instance::Properties
         m_properties;                                 ///< Instance properties.
+
+    mi::mdl::Compile_statistics m_statistics;         ///< The instance statistics.
+    std::string m_module_name;                        ///< The module of the material.
+    mi::mdl::Compile_statistics m_module_statistics;  ///< The module statistics.
+
+    DB::Tag m_compilation_definition;                 ///< The definition (not serialized).
+    bool m_class_compilation;                         ///< The compilation mode (not serialized).
+    Compilation_inputs m_compilation_inputs;          ///< The inputs (not serialized).
 };
 
 } // namespace MDL
@@ -158,6 +158,20 @@ public:
        bool immutable = false,
        mi::Sint32* errors = 0) const;
 
+    /// Checks whether a function call could be created for the given arguments.
+    ///
+    /// Performs the same checks as #create_function_call_internal() and
+    /// #create_array_constructor_call_internal(), but does not create (or copy) any arguments.
+    /// Used for overload resolution.
+    ///
+    /// \param allow_ek_parameter See #create_function_call_internal().
+    /// \return                   0 if a function call could be created, or the error code that
+    ///                           #create_function_call_internal() would report otherwise.
+    mi::Sint32 check_arguments(
+       DB::Transaction* transaction,
+       const IExpression_list* arguments,
+       bool allow_ek_parameter = false) const;
+
     /// Returns the MDL semantic of this definition.
     mi::mdl::IDefinition::Semantics get_mdl_semantic() const;
 
@@ -212,6 +226,19 @@ private:
     /// Does not create a valid instance, to be used by the deserializer only.
     Mdl_function_definition();
 
+    /// Checks the provided arguments for #create_function_call_internal().
+    ///
+    /// Does not check whether defaults exist for missing arguments.
+    mi::Sint32 check_provided_arguments(
+       DB::Transaction* transaction,
+       const IExpression_list* arguments,
+       bool allow_ek_parameter) const;
+
+    /// Checks the provided arguments for #create_array_constructor_call_internal().
+    mi::Sint32 check_array_constructor_arguments(
+       DB::Transaction* transaction,
+       const IExpression_list* arguments) const;
+
 private:
 
     mi::base::Handle<IType_factory> m_tf;        ///< The type factory.
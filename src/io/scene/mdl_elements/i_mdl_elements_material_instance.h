@@ -99,13 +99,30 @@ public:
     mi::Sint32 set_argument(
         DB::Transaction* transaction, const char* name, const IExpression* argument);
 
+    /// Creates a compiled material.
+    ///
+    /// If \p previous is given, its recorded compilation inputs are compared with the current
+    /// argument graph of this material instance. If the material definition, the options, and
+    /// all calls and constants in the argument graph are unchanged, a copy of \p previous is
+    /// returned. In class compilation mode, if only values of constants changed, the body and
+    /// temporaries of \p previous are reused and only the changed arguments are replaced; if
+    /// the compilation yields the same structure, body and temporaries are reused as well.
+    ///
+    /// \param previous               An optional compiled material created earlier, typically
+    ///                               from this material instance before the latest edits.
+    /// \param target_code_reusable   An optional pointer to a bool which is set to \c true if the
+    ///                               result differs from \p previous at most in the arguments,
+    ///                               i.e., target code generated for \p previous can be kept and
+    ///                               only its argument block needs to be updated.
     Mdl_compiled_material* create_compiled_material(
         DB::Transaction* transaction,
         bool class_compilation,
         mi::Float32 mdl_meters_per_scene_unit,
         mi::Float32 mdl_wavelength_min,
         mi::Float32 mdl_wavelength_max,
-        mi::Sint32* errors = 0) const;
+        mi::Sint32* errors = 0,
+        const Mdl_compiled_material* previous = 0,
+        bool* target_code_reusable = 0) const;
 
     // internal methods
 
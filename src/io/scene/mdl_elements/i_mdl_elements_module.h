@@ -32,6 +32,7 @@
 #include <mi/base/enums.h>
 #include <mi/base/handle.h>
 
+#include <map>
 #include <vector>
 #include <base/data/db/i_db_access.h>
 #include <base/data/db/i_db_tag.h>
@@ -614,6 +615,9 @@ private:
         const std::vector<std::string>& functions,
         const std::vector<std::string>& materials);
 
+    /// Recomputes #m_overload_index from #m_functions.
+    void update_overload_index();
+
     /// The main MDL interface.
     mi::base::Handle<mi::mdl::IMDL> m_mdl;
     /// The underlying MDL module.
@@ -647,6 +651,11 @@ private:
     std::vector<std::string> m_functions;        ///< Names of the contained function definitions.
     std::vector<std::string> m_materials;        ///< Names of the contained material definitions.
 
+    /// Maps DB names of function definitions without signature to the indices of all overloads
+    /// in #m_functions. Not serialized, recomputed from #m_functions.
+    typedef std::map<std::string, std::vector<mi::Size> > Overload_index_map;
+    Overload_index_map m_overload_index;
+
     // Resource tags
     // This vector has en entry for each item in mi::mdl::IModules' resource table
     // and contains a list of tags corresponding to the resource (a texture used with different
@@ -420,6 +420,23 @@ private:
     mutable Module_set m_resolved_modules;
 };
 
+/// Invalidates the name lookups cached by #Mdl_call_resolver and #Module_cache.
+///
+/// Lookups are cached per transaction. This function needs to be called whenever MDL modules or
+/// definitions are stored in or removed from the DB since this might change the lookup results.
+void invalidate_call_resolution_cache();
+
+/// Returns statistics about the name lookups cached by #Mdl_call_resolver and #Module_cache.
+///
+/// The counters accumulate over the lifetime of the library and are logged (debug level) when
+/// neuray shuts down.
+///
+/// \param[out] hits           The number of lookups answered from the cache.
+/// \param[out] misses         The number of lookups that required DB accesses.
+/// \param[out] invalidations  The number of calls of #invalidate_call_resolution_cache().
+void get_call_resolution_cache_statistics(
+    mi::Uint64& hits, mi::Uint64& misses, mi::Uint64& invalidations);
+
 
 // **********  Resource names **********************************************************************
 
@@ -33,6 +33,7 @@
 #include "i_mdl_elements_utilities.h"
 #include "mdl_elements_utilities.h"
 
+#include <cstring>
 #include <sstream>
 #include <mi/mdl/mdl_mdl.h>
 #include <mi/neuraylib/icompiled_material.h>
@@ -54,7 +55,8 @@ Mdl_compiled_material::Mdl_compiled_material()
   : m_mdl_meters_per_scene_unit( 1.0f),   // avoid warning
     m_mdl_wavelength_min( 0.0f),
     m_mdl_wavelength_max( 0.0f),
-    m_properties( 0)  // avoid ubsan warning with swap() and temporaries
+    m_properties( 0), // avoid ubsan warning with swap() and temporaries
+    m_class_compilation( false)
 {
     m_tf = get_type_factory();
     m_vf = get_value_factory();
@@ -72,7 +74,9 @@ Mdl_compiled_material::Mdl_compiled_material(
   : m_mdl_meters_per_scene_unit( mdl_meters_per_scene_unit),
     m_mdl_wavelength_min( mdl_wavelength_min),
     m_mdl_wavelength_max( mdl_wavelength_max),
-    m_properties( instance->get_properties())
+    m_properties( instance->get_properties()),
+    m_statistics( instance->access_statistics()),
+    m_class_compilation( false)
 {
     m_tf = get_type_factory();
     m_vf = get_value_factory();
@@ -111,7 +115,78 @@ Mdl_compiled_material::Mdl_compiled_material(
         m_temporaries->add_expression( name.c_str(), temporary.get());
     }
 
-    n = instance->get_parameter_count();
+    convert_arguments( transaction, instance, module_filename, module_name);
+
+    const mi::mdl::DAG_hash* h = instance->get_hash();
+    m_hash = convert_hash( *h);
+
+    for( int i = 0; i <= mi::mdl::IGenerated_code_dag::IMaterial_instance::MS_LAST; ++i) {
+        h = instance->get_slot_hash(
+            static_cast<mi::mdl::IGenerated_code_dag::IMaterial_instance::Slot>( i));
+        m_slot_hashes[i] = convert_hash( *h);
+    }
+}
+
+Mdl_compiled_material::Mdl_compiled_material(
+    const Mdl_compiled_material& other,
+    DB::Transaction* transaction,
+    const mi::mdl::IGenerated_code_dag::IMaterial_instance* instance,
+    const char* module_filename,
+    const char* module_name)
+  : m_tf( other.m_tf),
+    m_vf( other.m_vf),
+    m_ef( other.m_ef),
+    m_body( other.m_body),               // shared, compiled materials are immutable
+    m_temporaries( other.m_temporaries), // shared, compiled materials are immutable
+    m_hash( other.m_hash),
+    m_mdl_meters_per_scene_unit( other.m_mdl_meters_per_scene_unit),
+    m_mdl_wavelength_min( other.m_mdl_wavelength_min),
+    m_mdl_wavelength_max( other.m_mdl_wavelength_max),
+    m_properties( instance->get_properties()),
+    m_statistics( instance->access_statistics()),
+    m_class_compilation( false)
+{
+    ASSERT( M_SCENE, other.has_same_structure( instance));
+
+    for( int i = 0; i <= mi::mdl::IGenerated_code_dag::IMaterial_instance::MS_LAST; ++i)
+        m_slot_hashes[i] = other.m_slot_hashes[i];
+
+    convert_arguments( transaction, instance, module_filename, module_name);
+}
+
+Mdl_compiled_material::Mdl_compiled_material(
+    const Mdl_compiled_material& other,
+    const IValue_list* arguments)
+  : SCENE::Scene_element<Mdl_compiled_material, ID_MDL_COMPILED_MATERIAL>( other),
+    m_tf( other.m_tf),
+    m_vf( other.m_vf),
+    m_ef( other.m_ef),
+    m_body( other.m_body),               // shared, compiled materials are immutable
+    m_temporaries( other.m_temporaries), // shared, compiled materials are immutable
+    m_arguments( m_vf->clone( arguments)),
+    m_hash( other.m_hash),
+    m_mdl_meters_per_scene_unit( other.m_mdl_meters_per_scene_unit),
+    m_mdl_wavelength_min( other.m_mdl_wavelength_min),
+    m_mdl_wavelength_max( other.m_mdl_wavelength_max),
+    m_properties( other.m_properties),
+    m_statistics( other.m_statistics),
+    m_module_name( other.m_module_name),
+    m_module_statistics( other.m_module_statistics),
+    m_class_compilation( false)
+{
+    ASSERT( M_SCENE, arguments->get_size() == other.m_arguments->get_size());
+
+    for( int i = 0; i <= mi::mdl::IGenerated_code_dag::IMaterial_instance::MS_LAST; ++i)
+        m_slot_hashes[i] = other.m_slot_hashes[i];
+}
+
+void Mdl_compiled_material::convert_arguments(
+    DB::Transaction* transaction,
+    const mi::mdl::IGenerated_code_dag::IMaterial_instance* instance,
+    const char* module_filename,
+    const char* module_name)
+{
+    mi::Size n = instance->get_parameter_count();
     m_arguments = m_vf->create_value_list();
     for( mi::Size i = 0; i < n; ++i) {
         const char* name = instance->get_parameter_name( i);
@@ -121,15 +196,41 @@ Mdl_compiled_material::Mdl_compiled_material(
         ASSERT( M_SCENE, argument);
         m_arguments->add_value( name, argument.get());
     }
+}
 
-    const mi::mdl::DAG_hash* h = instance->get_hash();
-    m_hash = convert_hash( *h);
+bool Mdl_compiled_material::has_same_structure(
+    const mi::mdl::IGenerated_code_dag::IMaterial_instance* instance) const
+{
+    if( convert_hash( *instance->get_hash()) != m_hash)
+        return false;
 
-    for( int i = 0; i <= mi::mdl::IGenerated_code_dag::IMaterial_instance::MS_LAST; ++i) {
-        h = instance->get_slot_hash(
-            static_cast<mi::mdl::IGenerated_code_dag::IMaterial_instance::Slot>( i));
-        m_slot_hashes[i] = convert_hash( *h);
-    }
+    if( instance->get_temporary_count() != m_temporaries->get_size())
+        return false;
+
+    mi::Size n = instance->get_parameter_count();
+    if( n != m_arguments->get_size())
+        return false;
+
+    for( mi::Size i = 0; i < n; ++i)
+        if( strcmp( instance->get_parameter_name( i), m_arguments->get_name( i)) != 0)
+            return false;
+
+    return true;
+}
+
+void Mdl_compiled_material::set_compilation_inputs(
+    DB::Tag definition, bool class_compilation, Compilation_inputs& inputs)
+{
+    m_compilation_definition = definition;
+    m_class_compilation = class_compilation;
+    m_compilation_inputs.swap( inputs);
+}
+
+void Mdl_compiled_material::set_module_statistics(
+    const char* module_name, const mi::mdl::Compile_statistics& statistics)
+{
+    m_module_name = module_name;
+    m_module_statistics = statistics;
 }
 
 const IExpression_direct_call* Mdl_compiled_material::get_body() const
@@ -268,6 +369,13 @@ void Mdl_compiled_material::swap( Mdl_compiled_material& other)
     std::swap( m_mdl_wavelength_min, other.m_mdl_wavelength_min);
     std::swap( m_mdl_wavelength_max, other.m_mdl_wavelength_max);
     std::swap( m_properties, other.m_properties);
+    std::swap( m_statistics, other.m_statistics);
+    std::swap( m_module_name, other.m_module_name);
+    std::swap( m_module_statistics, other.m_module_statistics);
+
+    std::swap( m_compilation_definition, other.m_compilation_definition);
+    std::swap( m_class_compilation, other.m_class_compilation);
+    m_compilation_inputs.swap( other.m_compilation_inputs);
 }
 
 const IExpression* Mdl_compiled_material::lookup_sub_expression(
@@ -310,6 +418,30 @@ void read( SERIAL::Deserializer* deserializer, mi::base::Uuid& uuid)
     deserializer->read( &uuid.m_id4);
 }
 
+void write( SERIAL::Serializer* serializer, const mi::mdl::Compile_statistics& statistics)
+{
+    for( int i = 0; i <= mi::mdl::CP_LAST; ++i) {
+        const mi::mdl::Phase_statistics& stats
+            = statistics.get( static_cast<mi::mdl::Compile_phase>( i));
+        serializer->write( stats.wall_time);
+        serializer->write_size_t( stats.allocated_bytes);
+        serializer->write_size_t( stats.node_count);
+        serializer->write_size_t( stats.invocations);
+    }
+}
+
+void read( SERIAL::Deserializer* deserializer, mi::mdl::Compile_statistics& statistics)
+{
+    for( int i = 0; i <= mi::mdl::CP_LAST; ++i) {
+        mi::mdl::Phase_statistics stats;
+        deserializer->read( &stats.wall_time);
+        deserializer->read_size_t( &stats.allocated_bytes);
+        deserializer->read_size_t( &stats.node_count);
+        deserializer->read_size_t( &stats.invocations);
+        statistics.set( static_cast<mi::mdl::Compile_phase>( i), stats);
+    }
+}
+
 }
 
 const SERIAL::Serializable* Mdl_compiled_material::serialize(
@@ -329,6 +461,10 @@ const SERIAL::Serializable* Mdl_compiled_material::serialize(
     serializer->write( m_mdl_wavelength_min);
     serializer->write( m_mdl_wavelength_max);
     serializer->write( m_properties);
+
+    write( serializer, m_statistics);
+    serializer->write( m_module_name);
+    write( serializer, m_module_statistics);
     return this + 1;
 }
 
@@ -350,6 +486,10 @@ SERIAL::Serializable* Mdl_compiled_material::deserialize(
     deserializer->read( &m_mdl_wavelength_min);
     deserializer->read( &m_mdl_wavelength_max);
     deserializer->read( &m_properties);
+
+    read( deserializer, m_statistics);
+    deserializer->read( &m_module_name);
+    read( deserializer, m_module_statistics);
     return this + 1;
 }
 
@@ -389,12 +529,21 @@ void Mdl_compiled_material::dump( DB::Transaction* transaction) const
 
 size_t Mdl_compiled_material::get_size() const
 {
+    size_t compilation_inputs_size
+        = m_compilation_inputs.capacity() * sizeof( Compilation_input);
+    for( size_t i = 0, n = m_compilation_inputs.size(); i < n; ++i)
+        compilation_inputs_size
+            += dynamic_memory_consumption( m_compilation_inputs[i].m_path)
+             + dynamic_memory_consumption( m_compilation_inputs[i].m_value);
+
     return sizeof( *this)
         + SCENE::Scene_element<Mdl_compiled_material, Mdl_compiled_material::id>::get_size()
             - sizeof( SCENE::Scene_element<Mdl_compiled_material, Mdl_compiled_material::id>)
         + dynamic_memory_consumption( m_body)
         + dynamic_memory_consumption( m_temporaries)
-        + dynamic_memory_consumption( m_arguments);
+        + dynamic_memory_consumption( m_arguments)
+        + dynamic_memory_consumption( m_module_name)
+        + compilation_inputs_size;
 }
 
 DB::Journal_type Mdl_compiled_material::get_journal_flags() const
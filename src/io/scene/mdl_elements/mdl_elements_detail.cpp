@@ -46,9 +46,11 @@
 #include <base/system/main/access_module.h>
 #include <base/hal/disk/disk.h>
 #include <base/hal/hal/i_hal_ospath.h>
+#include <base/lib/config/config.h>
 #include <base/lib/log/i_log_logger.h>
 #include <base/lib/path/i_path.h>
 #include <base/data/db/i_db_transaction.h>
+#include <base/util/registry/i_config_registry.h>
 #include <mdl/integration/mdlnr/i_mdlnr.h>
 #include <io/scene/bsdf_measurement/i_bsdf_measurement.h>
 #include <io/scene/lightprofile/i_lightprofile.h>
@@ -262,6 +264,15 @@ std::string unresolve_resource_filename(
     return file_path;
 }
 
+bool use_deferred_resource_loading()
+{
+    SYSTEM::Access_module<CONFIG::Config_module> config_module( false);
+    const CONFIG::Config_registry& registry = config_module->get_configuration();
+    bool flag = false;
+    registry.get_value( "mdl_deferred_resource_loading", flag);
+    return flag;
+}
+
 DB::Tag mdl_resource_to_tag(
     DB::Transaction* transaction,
     const mi::mdl::IValue_resource* value,
@@ -341,10 +352,12 @@ DB::Tag mdl_texture_to_tag(
     ASSERT( M_SCENE, first_filename);
 
     DB::Tag tag;
-    Mdl_image_set image_set( res_set.get(), file_path, get_archive_filename( first_filename));
+    // allocated on the heap since the image might keep a reference for deferred loading
+    mi::base::Handle<Mdl_image_set> image_set( new Mdl_image_set(
+        res_set.get(), file_path, get_archive_filename( first_filename)));
 
     tag = TEXTURE::load_mdl_texture(
-        transaction, &image_set, shared, gamma);
+        transaction, image_set.get(), shared, gamma);
 
     LOG::mod_log->debug( M_SCENE, LOG::Mod_log::C_IO,
         "... and mapped to texture \"%s\" (tag %u).",
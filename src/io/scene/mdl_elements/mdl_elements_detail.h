@@ -87,6 +87,13 @@ std::string lookup_thumbnail(
     const IAnnotation_block* annotations,
     mi::mdl::IArchive_tool* archive_tool);
 
+/// Indicates whether resources referenced by MDL modules are loaded on first use.
+///
+/// Controlled by the boolean configuration option "mdl_deferred_resource_loading" (default
+/// \c false). If set, the DB elements created for textures, light profiles, and BSDF measurements
+/// carry only the resolved filenames, and the actual data is loaded on the first access to it.
+bool use_deferred_resource_loading();
+
 /// Returns the DB tag corresponding to an MDL resource.
 ///
 /// For values with known tags, the tag is returned immediately. Otherwise, the string from the
@@ -264,51 +264,11 @@ Mdl_function_call* Mdl_function_definition::create_function_call_internal(
     if( errors == NULL)
         errors = &dummy_errors;
 
-    // prevent instantiation of non-exported function definitions
-    if( !m_is_exported) {
-        *errors = -4;
-        return NULL;
-    }
-
     // check that the provided arguments are parameters of the function definition and that their
     // types match the expected types
-    if( arguments) {
-        mi::Size n = arguments->get_size();
-        for( mi::Size i = 0; i < n; ++i) {
-            const char* name = arguments->get_name( i);
-            mi::base::Handle<const IType> expected_type( m_parameter_types->get_type( name));
-            if( !expected_type) {
-                *errors = -1;
-                return NULL;
-            }
-            mi::base::Handle<const IExpression> argument( arguments->get_expression( i));
-            mi::base::Handle<const IType> actual_type( argument->get_type());
-            if( !argument_type_matches_parameter_type(
-                m_tf.get(), actual_type.get(), expected_type.get())) {
-                *errors = -2;
-                return NULL;
-            }
-            bool actual_type_varying
-                = (actual_type->get_all_type_modifiers()   & IType::MK_VARYING) != 0;
-            bool expected_type_uniform
-                = (expected_type->get_all_type_modifiers() & IType::MK_UNIFORM) != 0;
-            if( actual_type_varying && expected_type_uniform) {
-                *errors = -5;
-                return NULL;
-            }
-            IExpression::Kind kind = argument->get_kind();
-            if(     kind != IExpression::EK_CONSTANT
-                &&  kind != IExpression::EK_CALL
-                && (kind != IExpression::EK_PARAMETER || !allow_ek_parameter)) {
-                *errors = -6;
-                return NULL;
-            }
-            if( expected_type_uniform && return_type_is_varying( transaction, argument.get())) {
-                *errors = -8;
-                return NULL;
-            }
-        }
-    }
+    *errors = check_provided_arguments( transaction, arguments, allow_ek_parameter);
+    if( *errors != 0)
+        return NULL;
 
     // build up complete argument set using the defaults where necessary
     mi::base::Handle<IExpression_list> complete_arguments( m_ef->create_expression_list());
@@ -371,54 +331,15 @@ Mdl_function_call* Mdl_function_definition::create_array_constructor_call_intern
     if( errors == NULL)
         errors = &dummy_errors;
 
-    // check that this method is only used for the array constructor
-    ASSERT( M_SCENE, m_mdl_semantic == mi::mdl::IDefinition::DS_INTRINSIC_DAG_ARRAY_CONSTRUCTOR);
-
-    // the array constructor is always exported
-    ASSERT( M_SCENE, m_is_exported);
-
-    // the array constructor has no defaults
-    if( !arguments) {
-        *errors = -3;
+    // check that the provided arguments are all of the same type
+    *errors = check_array_constructor_arguments( transaction, arguments);
+    if( *errors != 0)
         return NULL;
-    }
 
-    // the array constructor needs at least one argument
     mi::Size n = arguments->get_size();
-    if( n == 0) {
-        *errors = -3;
-        return NULL;
-    }
-
-    // check that the provided arguments are all of the same type
     mi::base::Handle<const IExpression> first_argument(
         arguments->get_expression( static_cast<mi::Size>( 0)));
     mi::base::Handle<const IType> expected_type( first_argument->get_type());
-    bool expected_type_uniform
-        = (expected_type->get_all_type_modifiers() & IType::MK_UNIFORM) != 0;
-    for( mi::Size i = 1; i < n; ++i) {
-        mi::base::Handle<const IExpression> argument( arguments->get_expression( i));
-        mi::base::Handle<const IType> actual_type( argument->get_type());
-        if( m_tf->compare( actual_type.get(), expected_type.get()) != 0) {
-            *errors = -2;
-            return NULL;
-        }
-        bool actual_type_varying
-            = (actual_type->get_all_type_modifiers() & IType::MK_VARYING) != 0;
-        if( actual_type_varying && expected_type_uniform) {
-            *errors = -5;
-            return NULL;
-        }
-        IExpression::Kind kind = argument->get_kind();
-        if( kind != IExpression::EK_CONSTANT &&  kind != IExpression::EK_CALL) {
-            *errors = -6;
-            return NULL;
-        }
-        if( expected_type_uniform && return_type_is_varying( transaction, argument.get())) {
-            *errors = -8;
-            return NULL;
-        }
-    }
 
     // clone arguments
     mi::base::Handle<IExpression_list> complete_arguments( m_ef->clone( arguments));
@@ -446,6 +367,123 @@ Mdl_function_call* Mdl_function_definition::create_array_constructor_call_intern
     return function_call;
 }
 
+mi::Sint32 Mdl_function_definition::check_arguments(
+   DB::Transaction* transaction,
+   const IExpression_list* arguments,
+   bool allow_ek_parameter) const
+{
+    if( m_mdl_semantic == mi::mdl::IDefinition::DS_INTRINSIC_DAG_ARRAY_CONSTRUCTOR)
+        return check_array_constructor_arguments( transaction, arguments);
+
+    mi::Sint32 result = check_provided_arguments( transaction, arguments, allow_ek_parameter);
+    if( result != 0)
+        return result;
+
+    // check that defaults are available for all missing arguments
+    for( mi::Size i = 0, n = m_parameter_types->get_size(); i < n;  ++i) {
+        const char* name = get_parameter_name( i);
+        mi::base::Handle<const IExpression> argument(
+            arguments ? arguments->get_expression( name) : NULL);
+        if( argument)
+            continue;
+        mi::base::Handle<const IExpression> default_( m_defaults->get_expression( name));
+        if( !default_)
+            return -3;
+        mi::base::Handle<const IType> expected_type( m_parameter_types->get_type( name));
+        bool expected_type_uniform
+            = (expected_type->get_all_type_modifiers() & IType::MK_UNIFORM) != 0;
+        if( expected_type_uniform && return_type_is_varying( transaction, default_.get()))
+            return -8;
+    }
+
+    return 0;
+}
+
+mi::Sint32 Mdl_function_definition::check_provided_arguments(
+   DB::Transaction* transaction,
+   const IExpression_list* arguments,
+   bool allow_ek_parameter) const
+{
+    // prevent instantiation of non-exported function definitions
+    if( !m_is_exported)
+        return -4;
+
+    if( !arguments)
+        return 0;
+
+    mi::Size n = arguments->get_size();
+    for( mi::Size i = 0; i < n; ++i) {
+        const char* name = arguments->get_name( i);
+        mi::base::Handle<const IType> expected_type( m_parameter_types->get_type( name));
+        if( !expected_type)
+            return -1;
+        mi::base::Handle<const IExpression> argument( arguments->get_expression( i));
+        mi::base::Handle<const IType> actual_type( argument->get_type());
+        if( !argument_type_matches_parameter_type(
+            m_tf.get(), actual_type.get(), expected_type.get()))
+            return -2;
+        bool actual_type_varying
+            = (actual_type->get_all_type_modifiers()   & IType::MK_VARYING) != 0;
+        bool expected_type_uniform
+            = (expected_type->get_all_type_modifiers() & IType::MK_UNIFORM) != 0;
+        if( actual_type_varying && expected_type_uniform)
+            return -5;
+        IExpression::Kind kind = argument->get_kind();
+        if(     kind != IExpression::EK_CONSTANT
+            &&  kind != IExpression::EK_CALL
+            && (kind != IExpression::EK_PARAMETER || !allow_ek_parameter))
+            return -6;
+        if( expected_type_uniform && return_type_is_varying( transaction, argument.get()))
+            return -8;
+    }
+
+    return 0;
+}
+
+mi::Sint32 Mdl_function_definition::check_array_constructor_arguments(
+   DB::Transaction* transaction,
+   const IExpression_list* arguments) const
+{
+    // check that this method is only used for the array constructor
+    ASSERT( M_SCENE, m_mdl_semantic == mi::mdl::IDefinition::DS_INTRINSIC_DAG_ARRAY_CONSTRUCTOR);
+
+    // the array constructor is always exported
+    ASSERT( M_SCENE, m_is_exported);
+
+    // the array constructor has no defaults
+    if( !arguments)
+        return -3;
+
+    // the array constructor needs at least one argument
+    mi::Size n = arguments->get_size();
+    if( n == 0)
+        return -3;
+
+    // check that the provided arguments are all of the same type
+    mi::base::Handle<const IExpression> first_argument(
+        arguments->get_expression( static_cast<mi::Size>( 0)));
+    mi::base::Handle<const IType> expected_type( first_argument->get_type());
+    bool expected_type_uniform
+        = (expected_type->get_all_type_modifiers() & IType::MK_UNIFORM) != 0;
+    for( mi::Size i = 1; i < n; ++i) {
+        mi::base::Handle<const IExpression> argument( arguments->get_expression( i));
+        mi::base::Handle<const IType> actual_type( argument->get_type());
+        if( m_tf->compare( actual_type.get(), expected_type.get()) != 0)
+            return -2;
+        bool actual_type_varying
+            = (actual_type->get_all_type_modifiers() & IType::MK_VARYING) != 0;
+        if( actual_type_varying && expected_type_uniform)
+            return -5;
+        IExpression::Kind kind = argument->get_kind();
+        if( kind != IExpression::EK_CONSTANT &&  kind != IExpression::EK_CALL)
+            return -6;
+        if( expected_type_uniform && return_type_is_varying( transaction, argument.get()))
+            return -8;
+    }
+
+    return 0;
+}
+
 DB::Tag Mdl_function_definition::get_module() const
 {
     return m_module_tag;
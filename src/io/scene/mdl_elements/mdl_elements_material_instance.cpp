@@ -32,6 +32,8 @@
 
 #include "i_mdl_elements_compiled_material.h"
 #include "i_mdl_elements_expression.h"
+#include "i_mdl_elements_function_call.h"
+#include "i_mdl_elements_function_definition.h"
 #include "i_mdl_elements_material_definition.h"
 #include "i_mdl_elements_module.h"
 #include "i_mdl_elements_type.h"
@@ -205,14 +207,239 @@ mi::Sint32 Mdl_material_instance::set_argument(
     return set_argument( transaction, index, argument);
 }
 
+namespace {
+
+/// Appends the calls and constants of the argument graph \p arguments to \p inputs (depth-first,
+/// paths relative to \p prefix).
+///
+/// Returns \c false if the graph contains other expressions than constants and calls of function
+/// calls or material instances, or if it contains a call cycle.
+bool collect_compilation_inputs(
+    DB::Transaction* transaction,
+    const IExpression_list* arguments,
+    const std::string& prefix,
+    DB::Tag_set& call_stack,
+    Mdl_compiled_material::Compilation_inputs& inputs)
+{
+    for( mi::Size i = 0, n = arguments->get_size(); i < n; ++i) {
+
+        Mdl_compiled_material::Compilation_input input;
+        input.m_path = prefix.empty()
+            ? std::string( arguments->get_name( i))
+            : prefix + '.' + arguments->get_name( i);
+
+        mi::base::Handle<const IExpression> argument( arguments->get_expression( i));
+        switch( argument->get_kind()) {
+
+            case IExpression::EK_CONSTANT: {
+                mi::base::Handle<const IExpression_constant> constant(
+                    argument->get_interface<IExpression_constant>());
+                input.m_value = constant->get_value();
+                inputs.push_back( input);
+                break;
+            }
+
+            case IExpression::EK_CALL: {
+                mi::base::Handle<const IExpression_call> call(
+                    argument->get_interface<IExpression_call>());
+                input.m_call = call->get_call();
+                if( !call_stack.insert( input.m_call).second)
+                    return false;
+
+                mi::base::Handle<const IExpression_list> call_arguments;
+                SERIAL::Class_id class_id = transaction->get_class_id( input.m_call);
+                if( class_id == ID_MDL_FUNCTION_CALL) {
+                    DB::Access<Mdl_function_call> function_call( input.m_call, transaction);
+                    input.m_definition = function_call->get_function_definition();
+                    call_arguments = function_call->get_arguments();
+                } else if( class_id == ID_MDL_MATERIAL_INSTANCE) {
+                    DB::Access<Mdl_material_instance> material_instance(
+                        input.m_call, transaction);
+                    input.m_definition = material_instance->get_material_definition();
+                    call_arguments = material_instance->get_arguments();
+                } else
+                    return false;
+
+                inputs.push_back( input);
+                bool success = collect_compilation_inputs(
+                    transaction, call_arguments.get(), input.m_path, call_stack, inputs);
+                call_stack.erase( input.m_call);
+                if( !success)
+                    return false;
+                break;
+            }
+
+            default:
+                return false;
+        }
+    }
+
+    return true;
+}
+
+/// Indicates whether \p value is or contains a resource.
+bool contains_resource( const IValue* value)
+{
+    switch( value->get_kind()) {
+        case IValue::VK_TEXTURE:
+        case IValue::VK_LIGHT_PROFILE:
+        case IValue::VK_BSDF_MEASUREMENT:
+            return true;
+        case IValue::VK_VECTOR:
+        case IValue::VK_MATRIX:
+        case IValue::VK_COLOR:
+        case IValue::VK_ARRAY:
+        case IValue::VK_STRUCT: {
+            mi::base::Handle<const IValue_compound> compound(
+                value->get_interface<IValue_compound>());
+            for( mi::Size i = 0, n = compound->get_size(); i < n; ++i) {
+                mi::base::Handle<const IValue> element( compound->get_value( i));
+                if( contains_resource( element.get()))
+                    return true;
+            }
+            return false;
+        }
+        default:
+            return false;
+    }
+}
+
+/// Indicates whether \p inputs contain a resource.
+bool contains_resource( const Mdl_compiled_material::Compilation_inputs& inputs)
+{
+    for( size_t i = 0, n = inputs.size(); i < n; ++i)
+        if( inputs[i].m_value && contains_resource( inputs[i].m_value.get()))
+            return true;
+    return false;
+}
+
+/// Indicates whether \p lhs and \p rhs have the same structure, i.e., they differ at most in the
+/// values of constants.
+bool have_same_structure(
+    const Mdl_compiled_material::Compilation_inputs& lhs,
+    const Mdl_compiled_material::Compilation_inputs& rhs)
+{
+    if( lhs.size() != rhs.size())
+        return false;
+
+    for( size_t i = 0, n = lhs.size(); i < n; ++i)
+        if(    lhs[i].m_path != rhs[i].m_path
+            || lhs[i].m_call != rhs[i].m_call
+            || lhs[i].m_definition != rhs[i].m_definition
+            || !lhs[i].m_value != !rhs[i].m_value)
+            return false;
+
+    return true;
+}
+
+} // namespace
+
 Mdl_compiled_material* Mdl_material_instance::create_compiled_material(
     DB::Transaction* transaction,
     bool class_compilation,
     mi::Float32 mdl_meters_per_scene_unit,
     mi::Float32 mdl_wavelength_min,
     mi::Float32 mdl_wavelength_max,
-    mi::Sint32* errors) const
+    mi::Sint32* errors,
+    const Mdl_compiled_material* previous,
+    bool* target_code_reusable) const
 {
+    mi::Sint32 dummy_errors = 0;
+    if( !errors)
+        errors = &dummy_errors;
+    bool dummy_target_code_reusable = false;
+    if( !target_code_reusable)
+        target_code_reusable = &dummy_target_code_reusable;
+    *target_code_reusable = false;
+
+    Mdl_compiled_material::Compilation_inputs inputs;
+    DB::Tag_set call_stack;
+    bool has_inputs = collect_compilation_inputs(
+        transaction, m_arguments.get(), std::string(), call_stack, inputs);
+    if( !has_inputs)
+        inputs.clear();
+
+    bool same_options = previous
+        && previous->get_mdl_meters_per_scene_unit() == mdl_meters_per_scene_unit
+        && previous->get_mdl_wavelength_min() == mdl_wavelength_min
+        && previous->get_mdl_wavelength_max() == mdl_wavelength_max;
+
+    if( same_options
+        && has_inputs
+        && previous->get_compilation_definition() == m_definition_tag
+        && previous->get_class_compilation() == class_compilation
+        && have_same_structure( previous->get_compilation_inputs(), inputs)) {
+
+        const Mdl_compiled_material::Compilation_inputs& previous_inputs
+            = previous->get_compilation_inputs();
+
+        // Collect the constants whose values changed.
+        std::vector<size_t> changed;
+        for( size_t i = 0, n = inputs.size(); i < n; ++i)
+            if( inputs[i].m_value
+                && m_vf->compare( inputs[i].m_value.get(), previous_inputs[i].m_value.get()) != 0)
+                changed.push_back( i);
+
+        // Nothing changed, reuse the previous result. Instance compilation might have folded
+        // properties of resources, whose data might have changed under the same tag.
+        if( changed.empty() && (class_compilation || !contains_resource( inputs))) {
+            Mdl_compiled_material* compiled_material = new Mdl_compiled_material( *previous);
+            compiled_material->set_compilation_inputs( m_definition_tag, class_compilation, inputs);
+            *errors = 0;
+            *target_code_reusable = true;
+            return compiled_material;
+        }
+
+        // In class compilation mode, each constant is turned into an argument of the compiled
+        // material named by its path. If that mapping is one-to-one, only the arguments for the
+        // changed constants need to be replaced. Resources are excluded since they might have
+        // been modified during compilation.
+        mi::Size constant_count = 0;
+        for( size_t i = 0, n = inputs.size(); i < n; ++i)
+            if( inputs[i].m_value)
+                ++constant_count;
+
+        mi::base::Handle<const IValue_list> previous_arguments( previous->get_arguments());
+        bool update_arguments = class_compilation
+            && constant_count == previous_arguments->get_size();
+        for( size_t i = 0, n = inputs.size(); update_arguments && i < n; ++i) {
+            if( !inputs[i].m_value)
+                continue;
+            mi::base::Handle<const IValue> previous_argument(
+                previous_arguments->get_value( inputs[i].m_path.c_str()));
+            if( !previous_argument)
+                update_arguments = false;
+        }
+
+        mi::base::Handle<IValue_list> arguments;
+        if( update_arguments)
+            arguments = m_vf->clone( previous_arguments.get());
+        for( size_t i = 0, n = changed.size(); update_arguments && i < n; ++i) {
+            const Mdl_compiled_material::Compilation_input& input = inputs[changed[i]];
+            mi::base::Handle<const IValue> previous_argument(
+                previous_arguments->get_value( input.m_path.c_str()));
+            mi::base::Handle<const IType> type( input.m_value->get_type());
+            mi::base::Handle<const IType> previous_type( previous_argument->get_type());
+            mi::base::Handle<const IType> type_stripped( type->skip_all_type_aliases());
+            mi::base::Handle<const IType> previous_type_stripped(
+                previous_type->skip_all_type_aliases());
+            if(    m_tf->compare( type_stripped.get(), previous_type_stripped.get()) != 0
+                || contains_resource( input.m_value.get())
+                || contains_resource( previous_argument.get())
+                || arguments->set_value( input.m_path.c_str(), input.m_value.get()) != 0)
+                update_arguments = false;
+        }
+
+        if( update_arguments) {
+            Mdl_compiled_material* compiled_material
+                = new Mdl_compiled_material( *previous, arguments.get());
+            compiled_material->set_compilation_inputs( m_definition_tag, class_compilation, inputs);
+            *errors = 0;
+            *target_code_reusable = true;
+            return compiled_material;
+        }
+    }
+
     mi::base::Handle<const mi::mdl::IGenerated_code_dag::IMaterial_instance> instance(
         create_dag_material_instance( transaction, /*use_temporaries*/ true, class_compilation,
             mdl_meters_per_scene_unit, mdl_wavelength_min, mdl_wavelength_max, errors));
@@ -224,9 +451,26 @@ Mdl_compiled_material* Mdl_material_instance::create_compiled_material(
     const char* module_filename = module->get_filename();
     const char* module_name = module->get_mdl_name();
 
-    return new Mdl_compiled_material(
-        transaction, instance.get(), module_filename, module_name, mdl_meters_per_scene_unit,
-        mdl_wavelength_min, mdl_wavelength_max);
+    Mdl_compiled_material* compiled_material = 0;
+    if( class_compilation
+        && same_options
+        && previous->has_same_structure( instance.get())) {
+        // Only argument values changed, reuse body and temporaries of the previous result.
+        compiled_material = new Mdl_compiled_material(
+            *previous, transaction, instance.get(), module_filename, module_name);
+        *target_code_reusable = true;
+    } else
+        compiled_material = new Mdl_compiled_material(
+            transaction, instance.get(), module_filename, module_name, mdl_meters_per_scene_unit,
+            mdl_wavelength_min, mdl_wavelength_max);
+
+    compiled_material->set_compilation_inputs(
+        has_inputs ? m_definition_tag : DB::Tag(), class_compilation, inputs);
+
+    mi::base::Handle<const mi::mdl::IGenerated_code_dag> code_dag( module->get_code_dag());
+    compiled_material->set_module_statistics( module_name, code_dag->access_statistics());
+
+    return compiled_material;
 }
 
 const mi::mdl::IGenerated_code_dag::IMaterial_instance*
@@ -41,6 +41,7 @@
 #include "mdl_elements_utilities.h"
 
 #include <sstream>
+#include <thread>
 #include <mi/mdl/mdl_code_generators.h>
 #include <mi/mdl/mdl_generated_dag.h>
 #include <mi/mdl/mdl_mdl.h>
@@ -50,7 +51,9 @@
 #include <mi/neuraylib/istring.h>
 #include <base/system/main/access_module.h>
 #include <boost/core/ignore_unused.hpp>
+#include <base/lib/config/config.h>
 #include <base/lib/log/i_log_logger.h>
+#include <base/util/registry/i_config_registry.h>
 #include <base/data/db/i_db_access.h>
 #include <base/data/db/i_db_transaction.h>
 #include <base/data/serial/i_serializer.h>
@@ -1255,6 +1258,18 @@ mi::Sint32 Mdl_module::create_module_internal(
     generator_dag->access_options().set_option( MDL_CG_DAG_OPTION_INCLUDE_LOCAL_ENTITIES, "true");
     /// enable simple_glossy_bsdf() mapping in the IRAY SDK, disable it in the MDL SDK
 
+    // Compile the materials of the module concurrently. The number of threads is taken from the
+    // configuration option "mdl_compile_threads" and defaults to the number of hardware threads.
+    // The DAG backend takes the additional threads from a process-wide budget, so concurrent
+    // module compilations in several transactions do not oversubscribe the machine.
+    SYSTEM::Access_module<CONFIG::Config_module> config_module( false);
+    const CONFIG::Config_registry& registry = config_module->get_configuration();
+    int compile_threads = static_cast<int>( std::thread::hardware_concurrency());
+    registry.get_value( "mdl_compile_threads", compile_threads);
+    if( compile_threads > 1)
+        generator_dag->access_options().set_option(
+            MDL_CG_DAG_OPTION_COMPILE_THREADS, std::to_string( compile_threads).c_str());
+
     Module_cache module_cache( transaction);
     if( !module->restore_import_entries( &module_cache)) {
         LOG::mod_log->error( M_SCENE, LOG::Mod_log::C_DATABASE,
@@ -1386,6 +1401,9 @@ mi::Sint32 Mdl_module::create_module_internal(
                 material_tag, db_material, material_names[i].c_str(), privacy_level);
     }
 
+    // The new module and definitions might change the result of name lookups.
+    invalidate_call_resolution_cache();
+
     if( module_tag)
         *module_tag = db_module_tag;
     return 0;
@@ -1509,6 +1527,7 @@ Mdl_module::Mdl_module( const Mdl_module& other)
     m_annotations( other.m_annotations),
     m_functions( other.m_functions),
     m_materials( other.m_materials),
+    m_overload_index( other.m_overload_index),
     m_resource_reference_tags(other.m_resource_reference_tags)
 {
 }
@@ -1542,6 +1561,7 @@ Mdl_module::Mdl_module(
     m_imports = imports;
     m_functions = functions;
     m_materials = materials;
+    update_overload_index();
 
     // convert types
     m_types = m_tf->create_type_list();
@@ -1707,42 +1727,47 @@ const std::vector<std::string> Mdl_module::get_function_overloads(
     if( !name)
         return result;
 
-    // compute prefix length (without signature)
+    // strip signature
     const char* pos = strchr( name,'(');
-    size_t prefix_len = pos ? pos - name : strlen( name);
+    std::string prefix = pos ? std::string( name, pos - name) : std::string( name);
 
     // find overloads
-    for( mi::Size i = 0; i < m_functions.size(); ++i) {
-        const char* f = m_functions[i].c_str();
-        if( strncmp( f, name, prefix_len) != 0)
-            continue;
-        const char next = f[prefix_len];
-        if( next != '\0' && next != '(')
-            continue;
+    Overload_index_map::const_iterator it = m_overload_index.find( prefix);
+    if( it == m_overload_index.end())
+        return result;
+
+    const std::vector<mi::Size>& overloads = it->second;
+    for( mi::Size i = 0, n = overloads.size(); i < n; ++i) {
+        const std::string& f = m_functions[overloads[i]];
         // no arguments provided, don't check for exact match
         if( !arguments) {
-            result.push_back( m_functions[i]);
+            result.push_back( f);
             continue;
         }
         // arguments provided, check for exact match
-        DB::Tag tag = definition_name_to_tag( transaction, f);
+        DB::Tag tag = definition_name_to_tag( transaction, f.c_str());
         if( !tag)
             continue;
         if( transaction->get_class_id( tag) != Mdl_function_definition::id)
             continue;
         DB::Access<Mdl_function_definition> definition( tag, transaction);
-        mi::Sint32 errors = 0;
-        // TODO check whether we can avoid the function call creation
-        Mdl_function_call* call = definition->create_function_call(
-            transaction, arguments, &errors);
-        if( call && errors == 0)
-            result.push_back( m_functions[i]);
-        delete call;
+        if( definition->check_arguments( transaction, arguments) == 0)
+            result.push_back( f);
     }
 
     return result;
 }
 
+void Mdl_module::update_overload_index()
+{
+    m_overload_index.clear();
+    for( mi::Size i = 0, n = m_functions.size(); i < n; ++i) {
+        const std::string& f = m_functions[i];
+        std::string::size_type p = f.find( '(');
+        m_overload_index[p == std::string::npos ? f : f.substr( 0, p)].push_back( i);
+    }
+}
+
 const std::vector<std::string> Mdl_module::get_function_overloads_by_signature(
     DB::Transaction* transaction,
     const char* name,
@@ -1896,6 +1921,7 @@ SERIAL::Serializable* Mdl_module::deserialize( SERIAL::Deserializer* deserialize
     SERIAL::read( deserializer, &m_functions);
     SERIAL::read( deserializer, &m_materials);
     SERIAL::read( deserializer, &m_resource_reference_tags);
+    update_overload_index();
 
     return this + 1;
 }
@@ -1953,6 +1979,7 @@ size_t Mdl_module::get_size() const
         + dynamic_memory_consumption( m_annotations)
         + dynamic_memory_consumption( m_functions)
         + dynamic_memory_consumption( m_materials)
+        + dynamic_memory_consumption( m_overload_index)
         + m_module->get_memory_size()
         + (m_code_dag ? m_code_dag->get_memory_size() : 0);
 }
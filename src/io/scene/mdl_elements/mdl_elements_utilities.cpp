@@ -1675,6 +1675,134 @@ Mdl_material_instance_builder::create_material_instance(
 };
 
 
+// **********  Call resolution cache ***************************************************************
+
+namespace {
+
+/// Caches the results of the name lookups done by Mdl_call_resolver and Module_cache.
+///
+/// Entries (including negative results) are only reused within the transaction that created them.
+/// All entries are dropped by invalidate_call_resolution_cache().
+class Call_resolution_cache
+{
+public:
+    /// The kind of looked up names.
+    enum Kind {
+        OWNER_MODULE, ///< Name of a function or material definition, the owner module is cached.
+        MODULE        ///< Name of a module.
+    };
+
+    Call_resolution_cache() : m_hits( 0), m_misses( 0), m_invalidations( 0) { }
+
+    /// Looks up the cached result for \p name.
+    ///
+    /// \param transaction   The transaction used for the lookup.
+    /// \param kind          The kind of \p name.
+    /// \param name          The MDL name to look up.
+    /// \param[out] module   The cached module (with increased reference count), or \c NULL for
+    ///                      cached negative results.
+    /// \return              \c true if the name was found in the cache, \c false otherwise.
+    bool lookup(
+        DB::Transaction* transaction,
+        Kind kind,
+        const char* name,
+        const mi::mdl::IModule*& module)
+    {
+        mi::base::Lock::Block block( &m_lock);
+
+        Transaction_map::iterator it_trans = m_transactions.find( transaction->get_id()());
+        if( it_trans != m_transactions.end()) {
+            const Module_map& map = it_trans->second.m_maps[kind];
+            Module_map::const_iterator it = map.find( name);
+            if( it != map.end()) {
+                ++m_hits;
+                module = it->second.get();
+                if( module)
+                    module->retain();
+                return true;
+            }
+        }
+
+        ++m_misses;
+        return false;
+    }
+
+    /// Stores the result for \p name.
+    void insert(
+        DB::Transaction* transaction,
+        Kind kind,
+        const char* name,
+        const mi::mdl::IModule* module)
+    {
+        mi::base::Lock::Block block( &m_lock);
+
+        mi::Uint32 id = transaction->get_id()();
+        if( m_transactions.size() >= max_transactions
+            && m_transactions.find( id) == m_transactions.end())
+            m_transactions.erase( m_transactions.begin());
+
+        m_transactions[id].m_maps[kind][name] = make_handle_dup( module);
+    }
+
+    /// Drops all cached entries.
+    void invalidate()
+    {
+        mi::base::Lock::Block block( &m_lock);
+        m_transactions.clear();
+        ++m_invalidations;
+    }
+
+    /// Returns the statistics.
+    void get_statistics( mi::Uint64& hits, mi::Uint64& misses, mi::Uint64& invalidations)
+    {
+        mi::base::Lock::Block block( &m_lock);
+        hits          = m_hits;
+        misses        = m_misses;
+        invalidations = m_invalidations;
+    }
+
+private:
+    /// The maximum number of transactions with cached entries. Entries of the transaction with
+    /// the smallest ID are dropped first.
+    static const size_t max_transactions = 8;
+
+    typedef std::map<std::string, mi::base::Handle<const mi::mdl::IModule> > Module_map;
+
+    /// The cached entries of one transaction, one map per kind.
+    struct Transaction_cache
+    {
+        Module_map m_maps[2];
+    };
+
+    typedef std::map<mi::Uint32, Transaction_cache> Transaction_map;
+
+    /// The cached entries per transaction ID.
+    Transaction_map m_transactions;
+
+    /// Lock for all members.
+    mi::base::Lock m_lock;
+
+    mi::Uint64 m_hits;
+    mi::Uint64 m_misses;
+    mi::Uint64 m_invalidations;
+};
+
+Call_resolution_cache g_call_resolution_cache;
+
+} // namespace
+
+void invalidate_call_resolution_cache()
+{
+    g_call_resolution_cache.invalidate();
+}
+
+void get_call_resolution_cache_statistics(
+    mi::Uint64& hits, mi::Uint64& misses, mi::Uint64& invalidations)
+{
+    g_call_resolution_cache.get_statistics( hits, misses, invalidations);
+}
+
+
 // **********  Mdl_call_resolver *******************************************************************
 
 Mdl_call_resolver::~Mdl_call_resolver()
@@ -1687,21 +1815,24 @@ Mdl_call_resolver::~Mdl_call_resolver()
     }
 }
 
-const mi::mdl::IModule* Mdl_call_resolver::get_owner_module( char const* name) const
+namespace {
+
+/// Finds the owning module of a function or material definition without using the cache.
+const mi::mdl::IModule* lookup_owner_module( DB::Transaction* transaction, char const* name)
 {
     std::string db_name = add_mdl_db_prefix(name);
-    DB::Tag tag = m_transaction->name_to_tag(db_name.c_str());
+    DB::Tag tag = transaction->name_to_tag(db_name.c_str());
     if (!tag)
         return NULL;
 
     DB::Tag module_tag;
 
-    SERIAL::Class_id id = m_transaction->get_class_id(tag);
+    SERIAL::Class_id id = transaction->get_class_id(tag);
     if (id == Mdl_function_definition::id) {
-        DB::Access<Mdl_function_definition> material_definition(tag, m_transaction);
+        DB::Access<Mdl_function_definition> material_definition(tag, transaction);
         module_tag = material_definition->get_module();
     } else if (id == Mdl_material_definition::id) {
-        DB::Access<Mdl_material_definition> material_definition(tag, m_transaction);
+        DB::Access<Mdl_material_definition> material_definition(tag, transaction);
         module_tag = material_definition->get_module();
     } else {
         return NULL;
@@ -1710,11 +1841,24 @@ const mi::mdl::IModule* Mdl_call_resolver::get_owner_module( char const* name) c
     if (!module_tag)
         return NULL;
 
-    if (m_transaction->get_class_id(module_tag) != Mdl_module::id)
+    if (transaction->get_class_id(module_tag) != Mdl_module::id)
         return NULL;
 
-    DB::Access<Mdl_module> mdl_module(module_tag, m_transaction);
-    const mi::mdl::IModule *module = mdl_module->get_mdl_module();
+    DB::Access<Mdl_module> mdl_module(module_tag, transaction);
+    return mdl_module->get_mdl_module();
+}
+
+} // namespace
+
+const mi::mdl::IModule* Mdl_call_resolver::get_owner_module( char const* name) const
+{
+    const mi::mdl::IModule* module = NULL;
+    if (!g_call_resolution_cache.lookup(
+        m_transaction, Call_resolution_cache::OWNER_MODULE, name, module)) {
+        module = lookup_owner_module(m_transaction, name);
+        g_call_resolution_cache.insert(
+            m_transaction, Call_resolution_cache::OWNER_MODULE, name, module);
+    }
 
     if (module != NULL) {
         // ensure that all import entries are restored before the module is returned
@@ -3453,6 +3597,7 @@ DB::Tag definition_name_to_tag( DB::Transaction* transaction, const char* name)
             transaction, module_tag, material_tag, code_dag.get(),
             static_cast<mi::Uint32>( i), module->get_filename(), module->get_mdl_name());
         transaction->store( material_tag, material, definition_name.c_str(), privacy_level);
+        invalidate_call_resolution_cache();
         LOG::mod_log->debug( M_SCENE, LOG::Mod_log::C_DATABASE, "Re-created \"%s\".", name);
         return material_tag;
     }
@@ -3468,6 +3613,7 @@ DB::Tag definition_name_to_tag( DB::Transaction* transaction, const char* name)
             transaction,module_tag, function_tag, code_dag.get(),
             static_cast<mi::Uint32>( i), module->get_filename(), module->get_mdl_name());
         transaction->store( function_tag, function, definition_name.c_str(), privacy_level);
+        invalidate_call_resolution_cache();
         LOG::mod_log->debug( M_SCENE, LOG::Mod_log::C_DATABASE, "Re-created \"%s\".", name);
         return function_tag;
     }
@@ -4346,6 +4492,19 @@ Module_cache::~Module_cache()
 }
 
 const mi::mdl::IModule* Module_cache::lookup( const char* module_name) const
+{
+    const mi::mdl::IModule* module = 0;
+    if( g_call_resolution_cache.lookup(
+        m_transaction, Call_resolution_cache::MODULE, module_name, module))
+        return module;
+
+    module = lookup_uncached( module_name);
+    g_call_resolution_cache.insert(
+        m_transaction, Call_resolution_cache::MODULE, module_name, module);
+    return module;
+}
+
+const mi::mdl::IModule* Module_cache::lookup_uncached( const char* module_name) const
 {
     std::string db_name = add_mdl_db_prefix( module_name);
     DB::Tag tag = m_transaction->name_to_tag( db_name.c_str());
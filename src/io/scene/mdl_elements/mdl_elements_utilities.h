@@ -526,9 +526,14 @@ public:
    virtual ~Module_cache();
 
    /// If the DB contains the MDL module \p module_name, return it, otherwise \c NULL.
+   ///
+   /// Lookup results are cached per transaction, see #invalidate_call_resolution_cache().
    const mi::mdl::IModule* lookup( const char* module_name) const;
 
 private:
+   /// Same as #lookup(), but bypasses the cache.
+   const mi::mdl::IModule* lookup_uncached( const char* module_name) const;
+
     DB::Transaction* m_transaction;
 };
 
@@ -148,7 +148,11 @@ private:
 /// the tag of the existing DB element is returned.
 ///
 /// \param transaction         The DB transaction to be used.
-/// \param image_set_desc      Description of the resolved image set to be loaded.
+/// If deferred resource loading is enabled (see #MDL::DETAIL::use_deferred_resource_loading()),
+/// the image only records the image set and imports the pixel data on first access.
+///
+/// \param image_set_desc      Description of the resolved image set to be loaded. Needs to be
+///                            heap-allocated since the image might keep a reference to it.
 /// \param shared              Indicates whether a possibly already existing DB element for that
 ///                            resource should simply be reused. Otherwise, independent DB
 ///                            elements are created, even if the resource has already been loaded.
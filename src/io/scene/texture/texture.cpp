@@ -211,7 +211,10 @@ MI::DB::Tag load_mdl_texture(
     DB::Tag image_tag = transaction->name_to_tag( db_image_name.c_str());
     if( !image_tag) {
         DBIMAGE::Image* image = new DBIMAGE::Image();
-        image->reset( image_set);
+        if( MDL::DETAIL::use_deferred_resource_loading())
+            image->reset_deferred( image_set);
+        else
+            image->reset( image_set);
         image_tag = transaction->store_for_reference_counting(
             image, db_image_name.c_str(), privacy_level);
     }
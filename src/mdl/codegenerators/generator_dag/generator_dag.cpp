@@ -236,6 +236,10 @@ Code_generator_dag::Code_generator_dag(
         MDL_CG_DAG_OPTION_MARK_DAG_GENERATED,
         "true",
         "Mark all DAG backend generated entities");
+    m_options.add_option(
+        MDL_CG_DAG_OPTION_COMPILE_THREADS,
+        "1",
+        "The number of threads used to compile the materials of a module");
 }
 
 char const *Code_generator_dag::get_target_language() const
@@ -264,7 +268,8 @@ IGenerated_code_dag *Code_generator_dag::compile(IModule const *module)
         options,
         m_options.get_string_option(MDL_CG_DAG_OPTION_CONTEXT_NAME));
 
-    result->compile(module);
+    int n_threads = m_options.get_int_option(MDL_CG_DAG_OPTION_COMPILE_THREADS);
+    result->compile(module, n_threads > 1 ? unsigned(n_threads) : 1u);
 
     if (m_options.get_bool_option(MDL_CG_DAG_OPTION_DUMP_MATERIAL_DAG)) {
         for (int i = 0, n = result->get_material_count(); i < n; ++i) {
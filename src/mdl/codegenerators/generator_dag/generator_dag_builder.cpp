@@ -127,16 +127,30 @@ public:
     explicit Variable_lookup_handler(
         IModule const *module,
         ICall_evaluator const *call_evaluator,
-        DAG_builder::Definition_temporary_map &tmp_value_map)
+        DAG_builder::Definition_temporary_map &tmp_value_map,
+        mi::base::Lock *module_lock)
         : m_module(module)
         , m_call_evaluator(call_evaluator)
         , m_tmp_value_map(tmp_value_map)
+        , m_module_lock(module_lock)
         , m_error_state(false)
         , m_iter_var(NULL)
         , m_iter_value(NULL)
     {
     }
 
+    /// Fold the given expression using the module of this handler.
+    ///
+    /// Folding creates values in the module's value factory, hence this is serialized
+    /// if the module is shared between several builders.
+    ///
+    /// \param expr  the expression to fold
+    IValue const *fold(IExpression const *expr)
+    {
+        mi::base::Lock::Block block(m_module_lock);
+        return expr->fold(m_module, this);
+    }
+
     /// Clear the captures error state.
     void clear_error_state() { m_error_state = false; }
 
@@ -180,6 +194,9 @@ private:
     /// The map from definitions to temporary indices.
     DAG_builder::Definition_temporary_map &m_tmp_value_map;
 
+    /// If non-NULL, the lock serializing accesses to the module's factories.
+    mi::base::Lock *m_module_lock;
+
     /// Set to true once an exception occurs.
     bool     m_error_state;
 
@@ -190,6 +207,8 @@ private:
 // Try to update the iteration variable with the given expression.
 bool Variable_lookup_handler::update_iteration_variable(IExpression const *update_expr)
 {
+    mi::base::Lock::Block block(m_module_lock);
+
     IValue const *new_val = NULL;
     IValue_factory *factory = m_module->get_value_factory();
 
@@ -322,19 +341,21 @@ public:
     /// \param call                a call-site of this function
     /// \param forbid_local_calls  if set, calls to local functions are forbidden
     /// \param tmp_value_map       map of argument values
+    /// \param module_lock         if non-NULL, serializes accesses to the module's factories
     Inline_checker(
         IModule const                          *module,
         ICall_evaluator const                  *call_evaluator,
         IDeclaration_function const            *func_decl,
         IExpression_call const                 *call,
         bool                                   forbid_local_calls,
-        DAG_builder::Definition_temporary_map  &tmp_value_map)
+        DAG_builder::Definition_temporary_map  &tmp_value_map,
+        mi::base::Lock                         *module_lock)
     : m_module(module)
     , m_func_decl(func_decl)
     , m_call(call)
     , m_arg_types(NULL)
     , m_forbid_local_calls(forbid_local_calls)
-    , m_var_lookup_handler(module, call_evaluator, tmp_value_map)
+    , m_var_lookup_handler(module, call_evaluator, tmp_value_map, module_lock)
     , m_skip_flags(INL_NO_SKIP)
     {
     }
@@ -347,19 +368,21 @@ public:
     /// \param arg_types           list of argument types of the call site
     /// \param forbid_local_calls  if set, calls to local functions are forbidden
     /// \param tmp_value_map       map of argument values
+    /// \param module_lock         if non-NULL, serializes accesses to the module's factories
     Inline_checker(
         IModule const                          *module,
         ICall_evaluator const                  *call_evaluator,
         IDeclaration_function const            *func_decl,
         Type_vector const                      &arg_types,
         bool                                   forbid_local_calls,
-        DAG_builder::Definition_temporary_map  &tmp_value_map)
+        DAG_builder::Definition_temporary_map  &tmp_value_map,
+        mi::base::Lock                         *module_lock)
     : m_module(module)
     , m_func_decl(func_decl)
     , m_call(NULL)
     , m_arg_types(&arg_types)
     , m_forbid_local_calls(forbid_local_calls)
-    , m_var_lookup_handler(module, call_evaluator, tmp_value_map)
+    , m_var_lookup_handler(module, call_evaluator, tmp_value_map, module_lock)
     , m_skip_flags(INL_NO_SKIP)
     {
     }
@@ -722,8 +745,8 @@ bool Inline_checker::can_inline(IStatement const *stmt)
         {
             IStatement_if const *if_stmt = cast<IStatement_if>(stmt);
 
-            IValue const *cond_result = if_stmt->get_condition()->fold(
-                m_module, &m_var_lookup_handler);
+            IValue const *cond_result = m_var_lookup_handler.fold(
+                if_stmt->get_condition());
             if (is<IValue_bad>(cond_result))
                 return false;
 
@@ -742,8 +765,8 @@ bool Inline_checker::can_inline(IStatement const *stmt)
         {
             IStatement_switch const *switch_stmt = cast<IStatement_switch>(stmt);
 
-            IValue const *cond_result = switch_stmt->get_condition()->fold(
-                m_module, &m_var_lookup_handler);
+            IValue const *cond_result = m_var_lookup_handler.fold(
+                switch_stmt->get_condition());
             if (is<IValue_bad>(cond_result))
                 return false;
             IValue_int_valued const *cond_val = cast<IValue_int_valued>(cond_result);
@@ -817,8 +840,8 @@ bool Inline_checker::can_inline(IStatement const *stmt)
             IDeclaration_variable const *decl =
                 cast<IDeclaration_variable>(decl_stmt->get_declaration());
             if (decl == NULL || decl->get_variable_count() != 1) return false;
-            IValue const *init_val = decl->get_variable_init(0)->fold(
-                m_module, &m_var_lookup_handler);
+            IValue const *init_val = m_var_lookup_handler.fold(
+                decl->get_variable_init(0));
             if (is<IValue_bad>(init_val)) return false;
 
             // set iteration variable in lookup handler
@@ -832,7 +855,7 @@ bool Inline_checker::can_inline(IStatement const *stmt)
             bool res = true;
             int steps;
             for (steps = 0; steps <= max_steps; ++steps) {
-                IValue const *cond_result = cond->fold(m_module, &m_var_lookup_handler);
+                IValue const *cond_result = m_var_lookup_handler.fold(cond);
                 if (cond_result->is_zero()) {
                     break;
                 } else if (!cond_result->is_one()) {
@@ -929,6 +952,7 @@ DAG_builder::DAG_builder(
 , m_printer(mangler.get_printer())
 , m_resolver(resolver)
 , m_resource_modifier(&null_modifier)
+, m_module_lock(NULL)
 , m_tmp_value_map(
     0, Definition_temporary_map::hasher(), Definition_temporary_map::key_equal(), alloc)
 , m_module_stack(alloc)
@@ -1311,9 +1335,10 @@ DAG_node const *DAG_builder::stmt_to_dag(
             Variable_lookup_handler var_lookup_handler(
                 tos_module(),
                 m_node_factory.get_call_evaluator(),
-                m_tmp_value_map);
+                m_tmp_value_map,
+                m_module_lock);
             IValue const *cond_result =
-                if_stmt->get_condition()->fold(tos_module(), &var_lookup_handler);
+                var_lookup_handler.fold(if_stmt->get_condition());
             if (is<IValue_bad>(cond_result)) {
                 MDL_ASSERT(!"try_inline lied about condition of if statement");
                 return NULL;
@@ -1339,9 +1364,10 @@ DAG_node const *DAG_builder::stmt_to_dag(
             Variable_lookup_handler var_lookup_handler(
                 tos_module(),
                 m_node_factory.get_call_evaluator(),
-                m_tmp_value_map);
+                m_tmp_value_map,
+                m_module_lock);
             IValue const *cond_result =
-                switch_stmt->get_condition()->fold(tos_module(), &var_lookup_handler);
+                var_lookup_handler.fold(switch_stmt->get_condition());
             if (is<IValue_bad>(cond_result)) {
                 MDL_ASSERT(!"try_inline lied about condition of switch statement");
                 return NULL;
@@ -1394,11 +1420,11 @@ DAG_node const *DAG_builder::stmt_to_dag(
     case IStatement::SK_FOR:
         {
             IStatement_for const *for_stmt = cast<IStatement_for>(stmt);
-            IModule const *module = tos_module();
             Variable_lookup_handler var_lookup_handler(
                 tos_module(),
                 m_node_factory.get_call_evaluator(),
-                m_tmp_value_map);
+                m_tmp_value_map,
+                m_module_lock);
             IExpression const *cond = for_stmt->get_condition();
 
             Inline_scope for_scope(*this, /*in_same_function=*/ true);
@@ -1408,7 +1434,7 @@ DAG_node const *DAG_builder::stmt_to_dag(
             const unsigned max_steps = 4;
             unsigned steps;
             for (steps = 0; steps <= max_steps; ++steps) {
-                IValue const *cond_result = cond->fold(module, &var_lookup_handler);
+                IValue const *cond_result = var_lookup_handler.fold(cond);
                 if (cond_result->is_zero()) {
                     break;
                 } else if (!cond_result->is_one()) {
@@ -1496,6 +1522,9 @@ DAG_constant const *DAG_builder::lit_to_dag(
     IValue const *value = lit->get_value();
     value = m_value_factory.import(value);
     if (IValue_resource const *res = as<IValue_resource>(value)) {
+        // the file resolver and the resource modifier are not necessarily thread-safe
+        mi::base::Lock::Block block(m_module_lock);
+
         res = process_resource_urls(res, lit->access_position());
         value = m_resource_modifier->modify(res, tos_module(), m_value_factory);
     }
@@ -1709,8 +1738,12 @@ DAG_node const *DAG_builder::unary_to_dag(
     }
 
     // if we got here, we have a post/pre increment/decrement
-    DAG_constant const *one = m_node_factory.create_constant(
-        tos_module()->get_value_factory()->create_int(1));
+    DAG_constant const *one = NULL;
+    {
+        mi::base::Lock::Block block(m_module_lock);
+        one = m_node_factory.create_constant(
+            tos_module()->get_value_factory()->create_int(1));
+    }
 
     DAG_node const *pre_node = exp_to_dag(arg);
     DAG_node const *res = NULL;
@@ -2591,7 +2624,8 @@ DAG_node const *DAG_builder::try_inline(
             func_decl,
             call,
             m_forbid_local_calls,
-            m_tmp_value_map);
+            m_tmp_value_map,
+            m_module_lock);
         if (!checker.can_inline())
             return NULL;
     }
@@ -2665,7 +2699,8 @@ DAG_node const *DAG_builder::try_inline(
             func_decl,
             arg_types,
             m_forbid_local_calls,
-            m_tmp_value_map);
+            m_tmp_value_map,
+            m_module_lock);
         if (!checker.can_inline())
             return NULL;
     }
@@ -29,6 +29,7 @@
 #ifndef MDL_GENERATOR_DAG_BUILDER_H
 #define MDL_GENERATOR_DAG_BUILDER_H 1
 
+#include <mi/base/lock.h>
 #include <mi/mdl/mdl_expressions.h>
 #include <mi/mdl/mdl_generated_dag.h>
 #include "mdl/compiler/compilercore/compilercore_allocator.h"
@@ -144,6 +145,15 @@ public:
     /// Set a resource modifier.
     void set_resource_modifier(IResource_modifier *modifier);
 
+    /// Set the lock that serializes accesses to module owned factories.
+    ///
+    /// Constant folding and resource processing write into the value factories of the
+    /// processed modules. If several builders work on the same modules concurrently,
+    /// all of them must share one lock.
+    ///
+    /// \param lock  the shared lock or NULL if this builder is used exclusively
+    void set_module_lock(mi::base::Lock *lock) { m_module_lock = lock; }
+
     /// Enable/disable local function calls.
     ///
     /// \param flag  True if local function calls are forbidden, False otherwise
@@ -497,6 +507,9 @@ private:
     /// The used Resource modifier.
     IResource_modifier *m_resource_modifier;
 
+    /// If non-NULL, the lock serializing accesses to module owned factories.
+    mi::base::Lock *m_module_lock;
+
     /// The map from definitions to temporary indices.
     Definition_temporary_map m_tmp_value_map;
 
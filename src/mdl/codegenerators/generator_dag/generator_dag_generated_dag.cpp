@@ -36,9 +36,12 @@
 #include <mdl/compiler/compilercore/compilercore_mdl.h>
 #include <mdl/compiler/compilercore/compilercore_visitor.h>
 #include <mdl/compiler/compilercore/compilercore_file_resolution.h>
+#include <mdl/compiler/compilercore/compilercore_statistics.h>
 #include <mdl/codegenerators/generator_code/generator_code_hash.h>
 
+#include <atomic>
 #include <cstring>
+#include <thread>
 
 #include "generator_dag_generated_dag.h"
 #include "generator_dag_walker.h"
@@ -55,6 +58,37 @@ namespace mdl {
 
 namespace {
 
+/// The number of helper threads currently used by all concurrent module compilations of this
+/// process.
+MISTD::atomic<unsigned> g_busy_compile_threads(0);
+
+/// Reserves up to \p wanted helper threads from the process-wide budget of one less than the
+/// number of hardware threads (the calling threads are not counted). Concurrent compilations,
+/// e.g., from several transactions, hence do not oversubscribe the machine.
+///
+/// \returns  The number of reserved threads, to be released with #release_compile_threads().
+unsigned reserve_compile_threads(unsigned wanted)
+{
+    unsigned hw_threads = MISTD::thread::hardware_concurrency();
+    unsigned budget     = hw_threads > 1 ? hw_threads - 1 : 0;
+
+    unsigned busy = g_busy_compile_threads.load();
+    for (;;) {
+        unsigned available = busy < budget ? budget - busy : 0;
+        unsigned reserved  = wanted < available ? wanted : available;
+        if (reserved == 0)
+            return 0;
+        if (g_busy_compile_threads.compare_exchange_weak(busy, busy + reserved))
+            return reserved;
+    }
+}
+
+/// Releases helper threads reserved with #reserve_compile_threads().
+void release_compile_threads(unsigned reserved)
+{
+    g_busy_compile_threads -= reserved;
+}
+
 /// Translate function properties.
 unsigned char get_function_properties(IDefinition const *f_def)
 {
@@ -1616,9 +1650,281 @@ void Generated_code_dag::compile_local_material(
     // with them
 }
 
+namespace {
+
+/// Helper class: copies the DAGs of a material compiled by a worker DAG into another DAG.
+///
+/// Unlike the instance cloner, temporaries and the node sharing of the source are kept.
+class Material_dag_copier {
+public:
+    /// Constructor.
+    ///
+    /// \param alloc         an allocator
+    /// \param node_factory  the node factory of the destination DAG
+    Material_dag_copier(
+        IAllocator            *alloc,
+        DAG_node_factory_impl &node_factory)
+    : m_alloc(alloc)
+    , m_marker_map(0, Visited_node_map::hasher(), Visited_node_map::key_equal(), alloc)
+    , m_node_factory(node_factory)
+    , m_type_factory(*node_factory.get_type_factory())
+    , m_value_factory(*node_factory.get_value_factory())
+    {
+    }
+
+    /// Import a type into the destination type factory.
+    ///
+    /// \param type  the type to import
+    IType const *import(IType const *type)
+    {
+        return type != NULL ? m_type_factory.import(type) : NULL;
+    }
+
+    /// Creates a copy of a DAG.
+    ///
+    /// \param node  the root node of the DAG to copy, might be NULL
+    DAG_node const *copy_dag(DAG_node const *node);
+
+    /// Replaces all DAGs of a vector by its copies.
+    ///
+    /// \param dags  the DAG vector
+    void copy_dags(Generated_code_dag::Dag_vector &dags)
+    {
+        for (size_t i = 0, n = dags.size(); i < n; ++i)
+            dags[i] = copy_dag(dags[i]);
+    }
+
+private:
+    /// The allocator.
+    IAllocator *m_alloc;
+
+    typedef ptr_hash_map<DAG_node const, DAG_node const *>::Type Visited_node_map;
+
+    /// The marker map for walking DAGs.
+    Visited_node_map m_marker_map;
+
+    /// The node factory of the destination DAG.
+    DAG_node_factory_impl &m_node_factory;
+
+    /// The type factory of the destination DAG.
+    Type_factory          &m_type_factory;
+
+    /// The value factory of the destination DAG.
+    Value_factory         &m_value_factory;
+};
+
+// Creates a copy of a DAG.
+DAG_node const *Material_dag_copier::copy_dag(DAG_node const *node)
+{
+    if (node == NULL)
+        return NULL;
+
+    Visited_node_map::const_iterator it = m_marker_map.find(node);
+    if (it != m_marker_map.end()) {
+        // already processed
+        return it->second;
+    }
+
+    DAG_node const *res = NULL;
+
+    switch (node->get_kind()) {
+    case DAG_node::EK_CONSTANT:
+        {
+            DAG_constant const *c = cast<DAG_constant>(node);
+            res = m_node_factory.create_constant(m_value_factory.import(c->get_value()));
+        }
+        break;
+    case DAG_node::EK_PARAMETER:
+        {
+            DAG_parameter const *p = cast<DAG_parameter>(node);
+            res = m_node_factory.create_parameter(import(p->get_type()), p->get_index());
+        }
+        break;
+    case DAG_node::EK_TEMPORARY:
+        {
+            DAG_temporary const *t = cast<DAG_temporary>(node);
+            res = m_node_factory.create_temporary(copy_dag(t->get_expr()), t->get_index());
+        }
+        break;
+    case DAG_node::EK_CALL:
+        {
+            DAG_call const *call     = cast<DAG_call>(node);
+            int            n_params  = call->get_argument_count();
+
+            VLA<DAG_call::Call_argument> args(m_alloc, n_params);
+
+            for (int i = 0; i < n_params; ++i) {
+                args[i].param_name = call->get_parameter_name(i);
+                args[i].arg        = copy_dag(call->get_argument(i));
+            }
+
+            // beware: annotations are calls without a return type
+            res = m_node_factory.create_call(
+                call->get_name(),
+                call->get_semantic(),
+                args.data(),
+                args.size(),
+                import(call->get_type()));
+        }
+        break;
+    }
+    m_marker_map.insert(Visited_node_map::value_type(node, res));
+    return res;
+}
+
+} // anonymous
+
+// Copy a material compiled by a worker DAG into this DAG.
+void Generated_code_dag::import_material(Material_info const &src)
+{
+    // The source is already optimized and has its temporaries: copy it literally.
+    No_CSE_scope    no_cse(m_node_factory);
+    No_OPT_scope    no_opt(m_node_factory);
+    No_INLINE_scope no_inline(m_node_factory);
+
+    Material_dag_copier copier(get_allocator(), m_node_factory);
+
+    Material_info mat(src);
+
+    for (size_t k = 0, n = mat.m_parameters.size(); k < n; ++k) {
+        Parameter_info &param = mat.m_parameters[k];
+
+        param.m_type           = copier.import(param.m_type);
+        param.m_default        = copier.copy_dag(param.m_default);
+        param.m_enable_if_cond = copier.copy_dag(param.m_enable_if_cond);
+        copier.copy_dags(param.m_annotations);
+    }
+    copier.copy_dags(mat.m_annotations);
+    copier.copy_dags(mat.m_temporaries);
+    mat.m_body = copier.copy_dag(mat.m_body);
+
+    m_materials.push_back(mat);
+}
+
+// Compile every stride'th material of a list, starting at first.
+void Generated_code_dag::compile_material_slice(
+    IModule const                *module,
+    Dependence_node_vector const *materials,
+    size_t                       first,
+    size_t                       stride,
+    mi::base::Lock               *module_lock,
+    int                          *results)
+{
+    m_node_factory.enable_cse(true);
+
+    // Note: The file resolver might produce error messages when non-existing resources are
+    // processed. Catch them but throw them away
+    Messages_impl dummy_msgs(get_allocator(), module->get_filename());
+    File_resolver file_resolver(
+        *m_mdl.get(),
+        /*module_cache=*/NULL,
+        m_mdl->get_search_path(),
+        m_mdl->get_search_path_lock(),
+        dummy_msgs,
+        /*front_path=*/NULL);
+
+    DAG_builder  dag_builder(get_allocator(), m_node_factory, m_mangler, file_resolver);
+    Module_scope scope(dag_builder, module);
+
+    dag_builder.set_module_lock(module_lock);
+
+    for (size_t i = first, n = materials->size(); i < n; i += stride) {
+        size_t index = m_materials.size();
+
+        compile_material(dag_builder, (*materials)[i]);
+
+        // materials with errors are not added
+        results[i] = m_materials.size() > index ? int(index) : -1;
+    }
+}
+
+// Compile a list of materials using several worker threads and merge the results.
+void Generated_code_dag::compile_materials_parallel(
+    IModule const                *module,
+    Dependence_node_vector const &materials,
+    unsigned                     n_threads)
+{
+    size_t n_materials = materials.size();
+    if (n_threads > n_materials)
+        n_threads = unsigned(n_materials);
+
+    // the calling thread plus the helper threads left in the process-wide budget
+    unsigned n_helpers = reserve_compile_threads(n_threads - 1);
+    n_threads = n_helpers + 1;
+
+    // Every worker owns its arena and factories, only the value factories of the
+    // compiled modules are shared and must be accessed under this lock.
+    mi::base::Lock module_lock;
+
+    typedef vector<mi::base::Handle<Generated_code_dag> >::Type Worker_vector;
+
+    Worker_vector workers(get_allocator());
+    workers.reserve(n_threads);
+    for (unsigned i = 0; i < n_threads; ++i) {
+        workers.push_back(mi::base::make_handle(
+            m_builder.create<Generated_code_dag>(
+                get_allocator(),
+                m_mdl.get(),
+                module,
+                m_internal_space.c_str(),
+                m_options,
+                m_renderer_context_name.c_str())));
+    }
+
+    Index_vector results(n_materials, -1, get_allocator());
+
+    // the calling thread processes the first slice
+    MISTD::vector<MISTD::thread> threads;
+    threads.reserve(n_threads - 1);
+    for (unsigned i = 1; i < n_threads; ++i) {
+        threads.push_back(MISTD::thread(
+            &Generated_code_dag::compile_material_slice,
+            workers[i].get(),
+            module,
+            &materials,
+            size_t(i),
+            size_t(n_threads),
+            &module_lock,
+            results.data()));
+    }
+    workers[0]->compile_material_slice(
+        module, &materials, 0, n_threads, &module_lock, results.data());
+
+    for (size_t i = 0, n = threads.size(); i < n; ++i)
+        threads[i].join();
+
+    release_compile_threads(n_helpers);
+
+    // merge in list order, so the result is independent of the thread scheduling
+    for (size_t i = 0; i < n_materials; ++i) {
+        int index = results[i];
+        if (index < 0)
+            continue;
+
+        Generated_code_dag const *worker = workers[i % n_threads].get();
+
+        import_material(worker->m_materials[index]);
+        ++m_current_material_index;
+    }
+
+    for (unsigned i = 0; i < n_threads; ++i) {
+        Generated_code_dag const *worker = workers[i].get();
+
+        m_messages.copy_messages(worker->m_messages);
+
+        if (worker->m_node_factory.needs_state_import())
+            m_node_factory.import_state();
+        if (worker->m_node_factory.needs_nvidia_df_import())
+            m_node_factory.import_nvidia_df();
+        m_needs_anno = m_needs_anno || worker->m_needs_anno;
+    }
+}
+
 // Compile the module.
-void Generated_code_dag::compile(IModule const *module)
+void Generated_code_dag::compile(IModule const *module, unsigned n_threads)
 {
+    Phase_timer timer(&m_statistics, CP_DAG_GENERATION, &m_arena);
+
     m_current_material_index = 0;
 
     m_node_factory.enable_cse(true);
@@ -1691,15 +1997,25 @@ void Generated_code_dag::compile(IModule const *module)
     Node_list const &topo_list(dep_graph.get_module_entities(has_loops));
     MDL_ASSERT(!has_loops && "Dependency graph has loops");
 
+    // Materials do not reference each other's DAGs, so if several threads are allowed,
+    // they are collected here and compiled concurrently after the functions.
+    Dependence_node_vector materials(get_allocator());
+
     for (Node_list::const_iterator it(topo_list.begin()), end(topo_list.end()); it != end; ++it) {
         Dependence_node const *n = *it;
 
-        if (n->is_export())
-            compile_entity(dag_builder, n);
-        else if (n->is_local())
+        if (n->is_export()) {
+            compile_entity(dag_builder, n, n_threads > 1 ? &materials : NULL);
+        } else if (n->is_local())
             compile_local_entity(dag_builder, n);
     }
 
+    if (materials.size() > 1) {
+        compile_materials_parallel(module, materials, n_threads);
+    } else if (!materials.empty()) {
+        compile_material(dag_builder, materials[0]);
+    }
+
     // if the state must be imported, check if is was, else add it
     if (m_node_factory.needs_state_import()) {
         add_import("::state");
@@ -1716,6 +2032,11 @@ void Generated_code_dag::compile(IModule const *module)
     // compilation has finished: clear the CSE table, so it will be safe to
     // update resource values with tags
     m_node_factory.identify_clear();
+
+    timer.set_node_count(m_node_factory.get_node_count());
+
+    // carry the front-end statistics of the module along with the DAG
+    m_statistics.merge(impl_cast<Module>(module)->get_statistics());
 }
 
 // Helper function, adds a "hidden" annotation to a generated function.
@@ -2097,8 +2418,9 @@ void Generated_code_dag::collect_types(
 
 // Compile the given entity to the DAG representation.
 void Generated_code_dag::compile_entity(
-    DAG_builder           &dag_builder,
-    Dependence_node const *node)
+    DAG_builder            &dag_builder,
+    Dependence_node const  *node,
+    Dependence_node_vector *deferred)
 {
     IModule const *module = dag_builder.tos_module();
 
@@ -2112,7 +2434,10 @@ void Generated_code_dag::compile_entity(
     IType const       *ret_type = node->get_return_type();
     if (def != NULL && def->get_kind() == IDefinition::DK_FUNCTION && is_material_type(ret_type)) {
         // functions returning materials ARE materials
-        compile_material(dag_builder, node);
+        if (deferred != NULL)
+            deferred->push_back(node);
+        else
+            compile_material(dag_builder, node);
     } else {
         compile_function(module, node);
     }
@@ -2822,6 +3147,11 @@ Generated_code_dag::Error_code Generated_code_dag::Material_instance::initialize
     }
 #endif
 
+    m_statistics.clear();
+
+    Phase_timer timer(&m_statistics, CP_INSTANCE_INITIALIZE, &m_arena);
+    size_t      start_node_count = m_node_factory.get_node_count();
+
     int parameter_count = code_dag->get_material_parameter_count(m_material_index);
     if (argc < parameter_count)
         return EC_TOO_FEW_ARGUMENTS;
@@ -3017,6 +3347,7 @@ Generated_code_dag::Error_code Generated_code_dag::Material_instance::initialize
     }
 #endif
 
+    timer.set_node_count(m_node_factory.get_node_count() - start_node_count);
     return res;
 }
 
@@ -722,6 +722,9 @@ public:
         /// Access messages.
         Messages const &access_messages() const MDL_FINAL;
 
+        /// Access the statistics of the initialization of this instance.
+        Compile_statistics const &access_statistics() const MDL_FINAL { return m_statistics; }
+
         /// Get the instance properties.
         Properties get_properties() const MDL_FINAL;
 
@@ -1127,6 +1130,9 @@ public:
         /// Instanciation messages;
         Messages_impl m_messages;
 
+        /// Statistics of the initialization.
+        Compile_statistics m_statistics;
+
         /// The index of the material definition this instance is based on.
         int m_material_index;
 
@@ -1282,6 +1288,9 @@ public:
     /// Access messages.
     Messages const &access_messages() const MDL_FINAL;
 
+    /// Access the statistics of the DAG generation.
+    Compile_statistics const &access_statistics() const MDL_FINAL { return m_statistics; }
+
     /// Get the number of materials in the generated code.
     ///
     /// \returns    The number of materials in this generated code.
@@ -1818,13 +1827,18 @@ private:
         IDefinition const *def,
         Type_collector    &collector);
 
+    /// The type of vectors of dependence graph nodes.
+    typedef vector<Dependence_node const *>::Type Dependence_node_vector;
+
     /// Compile the given entity to the DAG representation.
     ///
     /// \param dag_builder  the DAG builder to be used
     /// \param node         the node inside the dependence graph of the entity
+    /// \param deferred     if non-NULL, materials are not compiled but appended to this list
     void compile_entity(
-        DAG_builder           &dag_builder,
-        Dependence_node const *node);
+        DAG_builder            &dag_builder,
+        Dependence_node const  *node,
+        Dependence_node_vector *deferred = NULL);
 
     /// Compile the given local entity to the DAG representation.
     ///
@@ -1943,10 +1957,49 @@ private:
         DAG_builder       &dag_builder,
         IDefinition const *material_def);
 
+    /// Compile every stride'th material of a list, starting at first.
+    ///
+    /// This is the body of one worker thread: this DAG is a private worker DAG with its own
+    /// arena and factories, only the accesses to the (shared) module factories are
+    /// serialized by the given lock.
+    ///
+    /// \param module       the module to compile
+    /// \param materials    the dependence graph nodes of all materials to compile
+    /// \param first        the index of the first material compiled by this worker
+    /// \param stride       the number of workers
+    /// \param module_lock  the lock serializing accesses to the module factories
+    /// \param results      for every material, receives its index in this worker DAG or -1
+    void compile_material_slice(
+        IModule const                *module,
+        Dependence_node_vector const *materials,
+        size_t                       first,
+        size_t                       stride,
+        mi::base::Lock               *module_lock,
+        int                          *results);
+
+    /// Compile a list of materials using several worker threads and merge the results.
+    ///
+    /// The materials are compiled into private worker DAGs and copied back in the
+    /// order of the given list, so the result does not depend on thread scheduling.
+    ///
+    /// \param module     the module to compile
+    /// \param materials  the dependence graph nodes of the materials in topological order
+    /// \param n_threads  the number of worker threads
+    void compile_materials_parallel(
+        IModule const                *module,
+        Dependence_node_vector const &materials,
+        unsigned                     n_threads);
+
+    /// Copy a material compiled by a worker DAG into this DAG.
+    ///
+    /// \param src  the material info of the worker DAG
+    void import_material(Material_info const &src);
+
     /// Compile a module.
     ///
-    /// \param module  The module to compile.
-    void compile(IModule const *module);
+    /// \param module     The module to compile.
+    /// \param n_threads  The number of threads used to compile the materials of the module.
+    void compile(IModule const *module, unsigned n_threads = 1);
 
     /// Helper function, adds a "hidden" annotation to a generated function.
     ///
@@ -2168,6 +2221,9 @@ private:
     /// The list of generated messages while this module was translated by the code generator.
     Messages_impl m_messages;
 
+    /// Statistics of the DAG generation.
+    Compile_statistics m_statistics;
+
     /// The names of imported modules.
     String_vector m_module_imports;
 
@@ -155,6 +155,9 @@ public:
     /// Mark that nvidia::df must be imported.
     void import_nvidia_df() { m_needs_nvidia_df_import = true; }
 
+    /// Mark that the state module must be imported.
+    void import_state() { m_needs_state_import = true; }
+
     /// Enable function call inlining.
     ///
     /// \param flag  If true, inlining will be enabled, else disabled.
@@ -275,6 +278,9 @@ public:
     /// Get the internal space.
     char const *get_internal_space() const { return m_internal_space; }
 
+    /// Get the number of IR nodes created by this factory so far.
+    size_t get_node_count() const { return m_next_id; }
+
     /// Check if this node factory owns the given DAG node.
     bool is_owner(DAG_node const *n) const;
 
@@ -2154,9 +2154,6 @@ public:
 
                     if (needs_ior(sema))
                         m_flags |= FL_NEEDS_MATERIAL_IOR;
-
-                    if (sema == IDefinition::DS_INTRINSIC_DF_MEASURED_BSDF)
-                        m_flags |= FL_CONTAINS_UNSUPPORTED_DF;
                 }
 
                 res = is_eval_state_dependent_direct(call);
@@ -54,6 +54,7 @@
 #include "compilercore_assert.h"
 #include "compilercore_positions.h"
 #include "compilercore_file_resolution.h"
+#include "compilercore_statistics.h"
 
 #ifdef WIN_NT
 #define strcasecmp(s1, s2) _stricmp(s1, s2)
@@ -1150,6 +1151,21 @@ public:
         return NULL;
     }
 
+    /// Announce that the compiler is going to compile a module.
+    IModule const *begin_loading(char const *absname) MDL_FINAL
+    {
+        if (m_cache != NULL)
+            return m_cache->begin_loading(absname);
+        return NULL;
+    }
+
+    /// Report the result of a compilation announced by begin_loading().
+    void loaded(char const *absname, IModule const *module) MDL_FINAL
+    {
+        if (m_cache != NULL)
+            m_cache->loaded(absname, module);
+    }
+
 private:
     /// The module whose import list should be lookup'ed.
     Module const &m_mod;
@@ -14411,7 +14427,11 @@ void NT_analysis::run()
 
 
     // run auto-typing
-    AT_analysis::run(m_compiler, m_module, m_ctx, m_cg);
+    {
+        Phase_timer timer(
+            &m_module.access_statistics(), CP_AT_ANALYSIS, &m_module.get_arena());
+        AT_analysis::run(m_compiler, m_module, m_ctx, m_cg);
+    }
 
     // check additional restrictions on resources if we have a handler
     if (IResource_restriction_handler *rrh = m_ctx.get_resource_restriction_handler()) {
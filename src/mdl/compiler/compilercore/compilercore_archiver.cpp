@@ -29,6 +29,11 @@
 #include "pch.h"
 
 #include <base/lib/libzip/zip.h>
+#include <base/lib/zlib/i_zlib.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 // defined in zipint.h
 extern "C" int zip_source_remove(zip_source_t *);
@@ -36,6 +41,7 @@ extern "C" zip_int64_t zip_source_supports(zip_source_t *src);
 
 #include "compilercore_file_utils.h"
 #include "compilercore_mdl.h"
+#include "compilercore_module_cache.h"
 #include "compilercore_errors.h"
 #include "compilercore_streams.h"
 #include "compilercore_tools.h"
@@ -270,6 +276,388 @@ private:
     zip_error_t m_ze;
 };
 
+
+/// An archive entry that was deflated ahead of the archive assembly.
+struct Deflated_entry {
+    /// Constructor.
+    explicit Deflated_entry(IAllocator *alloc)
+    : data(alloc)
+    , size(0)
+    , crc(0)
+    , comp_size(0)
+    , mtime(0)
+    , has_mtime(false)
+    , zip_err(ZIP_ER_OK)
+    , ready(false)
+    {
+    }
+
+    vector<unsigned char>::Type data;       ///< The raw deflate stream.
+    zip_uint64_t                size;       ///< The uncompressed size.
+    zip_uint64_t                comp_size;  ///< The size of the deflate stream.
+    zip_uint32_t                crc;        ///< The CRC32 of the uncompressed data.
+    time_t                      mtime;      ///< The modification time of the source file.
+    bool                        has_mtime;  ///< True if mtime is valid.
+    int                         zip_err;    ///< A libzip error code if deflating failed.
+    bool                        ready;      ///< True once the entry was deflated.
+};
+
+/// Deflate a file into an entry.
+///
+/// The file is read through a libzip file source, so the entry gets the same attributes
+/// as if the file had been added to the archive directly.
+///
+/// \param fname  the name of the file
+/// \param entry  the entry to fill
+static void deflate_file(char const *fname, Deflated_entry &entry)
+{
+    zip_error_t ze;
+    zip_source_t *src = zip_source_file_create(fname, 0, -1, &ze);
+    if (src == NULL) {
+        entry.zip_err = ze.zip_err;
+        return;
+    }
+
+    zip_stat_t st;
+    if (zip_source_stat(src, &st) == 0 && (st.valid & ZIP_STAT_MTIME) != 0) {
+        entry.mtime     = st.mtime;
+        entry.has_mtime = true;
+    }
+
+    if (zip_source_open(src) != 0) {
+        entry.zip_err = zip_source_error(src)->zip_err;
+        zip_source_free(src);
+        return;
+    }
+
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    if (deflateInit2(
+        &zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, MAX_MEM_LEVEL,
+        Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        entry.zip_err = ZIP_ER_ZLIB;
+        zip_source_close(src);
+        zip_source_free(src);
+        return;
+    }
+
+    unsigned char in_buf[65536];
+    unsigned char out_buf[65536];
+    mi::Uint32    crc = 0;
+    int           flush;
+
+    do {
+        zip_int64_t n = zip_source_read(src, in_buf, sizeof(in_buf));
+        if (n < 0) {
+            entry.zip_err = zip_source_error(src)->zip_err;
+            break;
+        }
+        crc = MI::ZLIB::crc32(crc, in_buf, size_t(n));
+        entry.size += zip_uint64_t(n);
+
+        flush       = n == 0 ? Z_FINISH : Z_NO_FLUSH;
+        zs.next_in  = in_buf;
+        zs.avail_in = uInt(n);
+        do {
+            zs.next_out  = out_buf;
+            zs.avail_out = uInt(sizeof(out_buf));
+            if (deflate(&zs, flush) == Z_STREAM_ERROR) {
+                entry.zip_err = ZIP_ER_ZLIB;
+                break;
+            }
+            entry.data.insert(
+                entry.data.end(), out_buf, out_buf + sizeof(out_buf) - zs.avail_out);
+        } while (zs.avail_out == 0);
+    } while (flush != Z_FINISH && entry.zip_err == ZIP_ER_OK);
+
+    entry.crc       = crc;
+    entry.comp_size = entry.data.size();
+
+    deflateEnd(&zs);
+    zip_source_close(src);
+    zip_source_free(src);
+}
+
+/// Deflates files on a pool of threads while libzip writes the archive.
+///
+/// libzip reads the sources of the entries in order when the archive is closed. The workers
+/// deflate at most a window of entries ahead of the one libzip is reading, and the data of an
+/// entry is freed once libzip has copied it, so the memory needed is bounded by the window and
+/// not by the size of the archive.
+class Deflate_pipeline {
+public:
+    /// Constructor.
+    ///
+    /// \param alloc  the allocator
+    explicit Deflate_pipeline(IAllocator *alloc)
+    : m_alloc(alloc)
+    , m_mutex()
+    , m_cond()
+    , m_fnames(alloc)
+    , m_entries(alloc)
+    , m_next(0)
+    , m_consumed(0)
+    , m_window(0)
+    , m_stop(false)
+    , m_threads()
+    {
+    }
+
+    /// Destructor, stops the workers.
+    ~Deflate_pipeline()
+    {
+        finish();
+    }
+
+    /// Add a file to deflate, must be called before start().
+    ///
+    /// \param fname  the name of the file
+    ///
+    /// \return the index of its entry
+    size_t add(string const &fname)
+    {
+        m_fnames.push_back(fname);
+        m_entries.push_back(Deflated_entry(m_alloc));
+        return m_entries.size() - 1;
+    }
+
+    /// Get the number of entries.
+    size_t size() const { return m_entries.size(); }
+
+    /// Start the workers.
+    ///
+    /// \param n_threads  the number of worker threads
+    /// \param window     the maximum number of entries deflated but not yet released
+    void start(unsigned n_threads, size_t window)
+    {
+        m_window = window > 0 ? window : 1;
+        for (unsigned i = 0; i < n_threads; ++i)
+            m_threads.push_back(MISTD::thread(&Deflate_pipeline::worker, this));
+    }
+
+    /// Wait until an entry is deflated.
+    ///
+    /// \param idx  the index of the entry
+    Deflated_entry const &wait(size_t idx)
+    {
+        MISTD::unique_lock<MISTD::mutex> lock(m_mutex);
+        while (!m_entries[idx].ready)
+            m_cond.wait(lock);
+        return m_entries[idx];
+    }
+
+    /// Free the deflated data of an entry once libzip has copied it.
+    ///
+    /// \param idx  the index of the entry
+    void release(size_t idx)
+    {
+        {
+            MISTD::lock_guard<MISTD::mutex> guard(m_mutex);
+            vector<unsigned char>::Type(m_alloc).swap(m_entries[idx].data);
+            if (m_consumed < idx + 1)
+                m_consumed = idx + 1;
+        }
+        m_cond.notify_all();
+    }
+
+    /// Stop the workers and wait for them.
+    void finish()
+    {
+        {
+            MISTD::lock_guard<MISTD::mutex> guard(m_mutex);
+            m_stop = true;
+        }
+        m_cond.notify_all();
+        for (size_t i = 0, n = m_threads.size(); i < n; ++i)
+            m_threads[i].join();
+        m_threads.clear();
+    }
+
+private:
+    /// Deflate entries in order until all are done or the pipeline is stopped.
+    void worker()
+    {
+        for (;;) {
+            size_t idx;
+            {
+                MISTD::unique_lock<MISTD::mutex> lock(m_mutex);
+                while (!m_stop && m_next < m_entries.size() && m_next >= m_consumed + m_window)
+                    m_cond.wait(lock);
+                if (m_stop || m_next >= m_entries.size())
+                    return;
+                idx = m_next++;
+            }
+
+            // the entry is not accessed by other threads before it is ready
+            deflate_file(m_fnames[idx].c_str(), m_entries[idx]);
+
+            {
+                MISTD::lock_guard<MISTD::mutex> guard(m_mutex);
+                m_entries[idx].ready = true;
+            }
+            m_cond.notify_all();
+        }
+    }
+
+private:
+    /// The allocator.
+    IAllocator *m_alloc;
+
+    /// Protects the entry states and the counters.
+    MISTD::mutex m_mutex;
+
+    /// Signaled when an entry is ready or released.
+    MISTD::condition_variable m_cond;
+
+    /// The names of all files to deflate.
+    vector<string>::Type m_fnames;
+
+    /// The entries, one per file.
+    vector<Deflated_entry>::Type m_entries;
+
+    /// The index of the next entry to deflate.
+    size_t m_next;
+
+    /// The number of entries released so far.
+    size_t m_consumed;
+
+    /// The maximum number of entries deflated ahead of the released ones.
+    size_t m_window;
+
+    /// Set to stop the workers.
+    bool m_stop;
+
+    /// The worker threads.
+    MISTD::vector<MISTD::thread> m_threads;
+};
+
+/// A libzip source delivering an entry deflated by a Deflate_pipeline.
+///
+/// libzip copies the data of sources that report the compression method of the target entry
+/// without recompressing it.
+class Deflated_zip_source {
+public:
+    /// Constructor.
+    ///
+    /// \param pipeline  the pipeline deflating the entry, must live until the archive is closed
+    /// \param idx       the index of the entry in the pipeline
+    Deflated_zip_source(Deflate_pipeline &pipeline, size_t idx)
+    : m_pipeline(pipeline)
+    , m_idx(idx)
+    , m_pos(0)
+    {
+        zip_error_init(&m_ze);
+    }
+
+    /// Destructor.
+    ~Deflated_zip_source()
+    {
+        zip_error_fini(&m_ze);
+    }
+
+    /// Create a libzip source for this entry.
+    zip_source_t *open(zip_error_t &ze) {
+        return zip_source_function_create(callback, this, &ze);
+    }
+
+private:
+    /// Wait for the entry, returns NULL and sets the error if deflating it failed.
+    Deflated_entry const *get_entry()
+    {
+        Deflated_entry const &entry = m_pipeline.wait(m_idx);
+        if (entry.zip_err != ZIP_ER_OK) {
+            zip_error_set(&m_ze, entry.zip_err, 0);
+            return NULL;
+        }
+        return &entry;
+    }
+
+    /// The libzip callback function.
+    static zip_int64_t callback(
+        void             *env,
+        void             *data,
+        zip_uint64_t     len,
+        zip_source_cmd_t cmd)
+    {
+        Deflated_zip_source *self = reinterpret_cast<Deflated_zip_source *>(env);
+
+        switch (cmd) {
+        case ZIP_SOURCE_OPEN:
+            if (self->get_entry() == NULL)
+                return -1;
+            self->m_pos = 0;
+            return 0;
+        case ZIP_SOURCE_READ:
+            {
+                Deflated_entry const &entry = *self->get_entry();
+
+                size_t n = entry.data.size() - self->m_pos;
+                if (n > len)
+                    n = size_t(len);
+                if (n > 0) {
+                    memcpy(data, &entry.data[self->m_pos], n);
+                    self->m_pos += n;
+                }
+                return zip_int64_t(n);
+            }
+        case ZIP_SOURCE_CLOSE:
+            // libzip has copied the data
+            self->m_pipeline.release(self->m_idx);
+            return 0;
+        case ZIP_SOURCE_STAT:
+            {
+                zip_stat_t *st = ZIP_SOURCE_GET_ARGS(zip_stat_t, data, len, &self->m_ze);
+                if (st == NULL)
+                    return -1;
+
+                Deflated_entry const *entry = self->get_entry();
+                if (entry == NULL)
+                    return -1;
+
+                zip_stat_init(st);
+                st->size              = entry->size;
+                st->comp_size         = entry->comp_size;
+                st->comp_method       = ZIP_CM_DEFLATE;
+                st->encryption_method = ZIP_EM_NONE;
+                st->crc               = entry->crc;
+                st->valid |=
+                    ZIP_STAT_SIZE | ZIP_STAT_COMP_SIZE | ZIP_STAT_COMP_METHOD |
+                    ZIP_STAT_ENCRYPTION_METHOD | ZIP_STAT_CRC;
+                if (entry->has_mtime) {
+                    st->mtime = entry->mtime;
+                    st->valid |= ZIP_STAT_MTIME;
+                }
+                return sizeof(*st);
+            }
+        case ZIP_SOURCE_ERROR:
+            return zip_error_to_data(&self->m_ze, data, len);
+        case ZIP_SOURCE_FREE:
+            return 0;
+        case ZIP_SOURCE_SUPPORTS:
+            return zip_source_make_command_bitmap(
+                ZIP_SOURCE_OPEN, ZIP_SOURCE_READ, ZIP_SOURCE_CLOSE, ZIP_SOURCE_STAT,
+                ZIP_SOURCE_ERROR, ZIP_SOURCE_FREE, -1);
+        default:
+            zip_error_set(&self->m_ze, ZIP_ER_OPNOTSUPP, 0);
+            return -1;
+        }
+    }
+
+private:
+    /// The pipeline deflating the entry.
+    Deflate_pipeline &m_pipeline;
+
+    /// The index of the entry in the pipeline.
+    size_t m_idx;
+
+    /// The current read position.
+    size_t m_pos;
+
+    /// The last error.
+    zip_error_t m_ze;
+};
+
 /// Implementation of the IInput_stream interface wrapping a IMDL_resource_reader.
 class Resource_Input_stream : public Allocator_interface_implement<IInput_stream>
 {
@@ -469,6 +857,11 @@ public:
     /// \param suffix  the suffix WITHOUT leading '.'
     void add_compressed_resource_suffix(char const *suffix);
 
+    /// Set the number of threads used to compile modules and to compress entries.
+    ///
+    /// \param n_threads  the number of threads, 0 for the number of hardware threads
+    void set_thread_count(unsigned n_threads);
+
     /// Collect all files.
     ///
     /// \param root_path     The path to the root of all files to store into the archive.
@@ -515,6 +908,17 @@ private:
     /// Check if a resource name has one on the known file extensions that should be compressed.
     bool should_be_compressed(string const &fname) const;
 
+    /// The shared state of the module compilation threads.
+    struct Compile_queue;
+
+    /// Compile modules from the queue until it is empty.
+    ///
+    /// \param queue  the compilation queue
+    void compile_worker(Compile_queue *queue);
+
+    /// Get the number of threads to use for the given number of work items.
+    unsigned get_thread_count(size_t n_items) const;
+
     /// Update the current manifest from the given module.
     ///
     /// \param[in]  mod       current module
@@ -583,6 +987,12 @@ private:
 
     /// Set to true if extra files in the source directory are allowed (and ignored).
     bool const m_allow_extra_files;
+
+    /// The number of worker threads, 0 for the number of hardware threads.
+    unsigned m_n_threads;
+
+    /// Serializes events fired from worker threads.
+    mi::base::Lock m_event_lock;
 };
 
 /// Helper class for extracting an archive.
@@ -1101,6 +1511,8 @@ Archive_builder::Archive_builder(
 , m_ignored_files(m_alloc)
 , m_overwrite(overwrite)
 , m_allow_extra_files(allow_extra_files)
+, m_n_threads(0)
+, m_event_lock()
 {
     // Fill the uncompressed suffix set with known suffixes from the MDL spec that
     // should NEVER be compressed
@@ -1135,6 +1547,25 @@ void Archive_builder::add_compressed_resource_suffix(
     m_compressed_suffix_set.insert(s);
 }
 
+// Set the number of threads used to compile modules and to compress entries.
+void Archive_builder::set_thread_count(unsigned n_threads)
+{
+    m_n_threads = n_threads;
+}
+
+// Get the number of threads to use for the given number of work items.
+unsigned Archive_builder::get_thread_count(size_t n_items) const
+{
+    unsigned n_threads = m_n_threads;
+    if (n_threads == 0)
+        n_threads = MISTD::thread::hardware_concurrency();
+    if (n_threads == 0)
+        n_threads = 1;
+    if (n_threads > n_items)
+        n_threads = unsigned(n_items);
+    return n_threads;
+}
+
 // Collect all files.
 bool Archive_builder::collect(
     char const *root_path,
@@ -1413,18 +1844,75 @@ private:
 
 }  // anonymous
 
-// Compile all collected modules.
-bool Archive_builder::compile_modules()
+/// The shared state of the module compilation threads.
+struct Archive_builder::Compile_queue {
+    typedef vector<mi::base::Handle<Thread_context> >::Type Context_vector;
+    typedef vector<mi::base::Handle<Module const> >::Type   Module_vector;
+
+    /// Constructor.
+    Compile_queue(
+        IAllocator                    *alloc,
+        IResource_restriction_handler *rrh)
+    : lock()
+    , next(0)
+    , names(alloc)
+    , contexts(alloc)
+    , modules(alloc)
+    , cache(alloc)
+    , rrh(rrh)
+    {
+    }
+
+    mi::base::Lock                lock;      ///< Protects next.
+    size_t                        next;      ///< The index of the next module to compile.
+    vector<string>::Type          names;     ///< The absolute names of all modules.
+    Context_vector                contexts;  ///< The thread context of every module.
+    Module_vector                 modules;   ///< The compiled modules.
+    Shared_module_cache           cache;     ///< Modules already compiled by any thread.
+    IResource_restriction_handler *rrh;      ///< The resource restriction handler.
+};
+
+// Compile modules from the queue until it is empty.
+void Archive_builder::compile_worker(Compile_queue *queue)
 {
-    mi::base::Handle<mi::mdl::Thread_context> ctx(m_compiler->create_thread_context());
+    for (;;) {
+        size_t idx;
+        {
+            mi::base::Lock::Block block(&queue->lock);
+            if (queue->next >= queue->names.size())
+                return;
+            idx = queue->next++;
+        }
 
-    // archives are always build in STRICT mode
-    Options &opt = ctx->access_options();
-    opt.set_option(MDL::option_strict, "true");
+        string const &mod_name = queue->names[idx];
+
+        {
+            mi::base::Lock::Block block(&m_event_lock);
+            fire_event(IArchive_tool_event::EV_COMPILING, mod_name.c_str());
+        }
 
-    // add the root path in front, to ensure that modules are first searched here
-    ctx->set_front_path(m_root_path.c_str());
+        mi::base::Handle<Thread_context> ctx(m_compiler->create_thread_context());
 
+        // archives are always build in STRICT mode
+        Options &opt = ctx->access_options();
+        opt.set_option(MDL::option_strict, "true");
+
+        // add the root path in front, to ensure that modules are first searched here
+        ctx->set_front_path(m_root_path.c_str());
+        ctx->set_resource_restriction_handler(queue->rrh);
+
+        mi::base::Handle<Module const> mod(
+            m_compiler->load_module(ctx.get(), mod_name.c_str(), &queue->cache));
+        queue->cache.enter(mod.get());
+
+        queue->contexts[idx] = ctx;
+        queue->modules[idx]  = mod;
+    }
+}
+
+// Compile all collected modules.
+bool Archive_builder::compile_modules()
+{
     Dependency_map dep_map(0, Dependency_map::hasher(), Dependency_map::key_equal(), m_alloc);
 
     // prepare the set of all resources
@@ -1452,31 +1940,46 @@ bool Archive_builder::compile_modules()
         resources.insert(res);
     }
 
-    // set the resource restriction handler
+    // the resource restriction handler is shared by all threads, it only reads the set
     Archive_resource_restrictions rrh(*this, resources);
-    ctx->set_resource_restriction_handler(&rrh);
 
-    bool res = true;
+    Compile_queue queue(m_alloc, &rrh);
     for (String_list::const_iterator it(m_module_list.begin()), end(m_module_list.end());
         it != end;
         ++it)
     {
-        string const &entry = *it;
-
-        string mod_name = convert_to_module_name(entry);
-
-        fire_event(IArchive_tool_event::EV_COMPILING, mod_name.c_str());
+        queue.names.push_back(convert_to_module_name(*it));
+    }
+    size_t n_modules = queue.names.size();
+    queue.contexts.resize(n_modules);
+    queue.modules.resize(n_modules);
+
+    // compile the modules in parallel, modules imported by several of them are compiled
+    // only once and shared through the cache
+    unsigned n_threads = get_thread_count(n_modules);
+    if (n_threads > 0) {
+        MISTD::vector<MISTD::thread> threads;
+        threads.reserve(n_threads - 1);
+        for (unsigned i = 1; i < n_threads; ++i) {
+            threads.push_back(MISTD::thread(&Archive_builder::compile_worker, this, &queue));
+        }
+        compile_worker(&queue);
 
-        mi::base::Handle<mi::mdl::Module const> mod(
-            m_compiler->load_module(ctx.get(), mod_name.c_str(), /*module_cache=*/NULL));
+        for (size_t i = 0, n = threads.size(); i < n; ++i)
+            threads[i].join();
+    }
 
-        mi::mdl::Messages const &msgs = ctx->access_messages();
+    // collect the results in list order, so messages and the manifest do not depend on
+    // the thread scheduling
+    bool res = true;
+    for (size_t i = 0; i < n_modules; ++i) {
+        mi::mdl::Messages const &msgs = queue.contexts[i]->access_messages();
         copy_messages(msgs);
 
         if (msgs.get_error_message_count() > 0) {
             res = false;
         } else {
-            update_manifest(mod.get(), mod_name, dep_map);
+            update_manifest(queue.modules[i].get(), queue.names[i], dep_map);
         }
     }
 
@@ -1530,6 +2033,34 @@ bool Archive_builder::create_zip_archive()
 
     set_archive_name(arc_name);
 
+    // Deflate all modules and compressed resources on a pool of threads while the archive
+    // is written, libzip then only copies the raw deflate streams.
+    Deflate_pipeline pipeline(m_alloc);
+
+    for (String_list::const_iterator it(m_module_list.begin()), end(m_module_list.end());
+        it != end;
+        ++it)
+    {
+        pipeline.add(join_path(m_root_path, *it));
+    }
+    for (String_list::const_iterator it(m_resource_list.begin()), end(m_resource_list.end());
+        it != end;
+        ++it)
+    {
+        string fname = join_path(m_root_path, *it);
+        if (should_be_compressed(fname))
+            pipeline.add(fname);
+    }
+
+    unsigned n_threads = get_thread_count(pipeline.size());
+    pipeline.start(n_threads, 2 * size_t(n_threads));
+
+    // the libzip sources for the deflated entries, must live until zip_close()
+    typedef list<Deflated_zip_source>::Type Source_list;
+
+    Source_list sources(m_alloc);
+    size_t      deflated_idx = 0;
+
     // create the the writable stream
     zip_error_t ze;
     zip_source_t *src = zip_source_file_create(arc_name.c_str(), 0, -1, &ze);
@@ -1613,10 +2144,10 @@ bool Archive_builder::create_zip_archive()
         {
             string const &entry = *it;
 
-            string fname = join_path(m_root_path, entry);
+            sources.push_back(Deflated_zip_source(pipeline, deflated_idx++));
 
             zip_error_t err;
-            zip_source_t *source = zip_source_file_create(fname.c_str(), 0, -1, &err);
+            zip_source_t *source = sources.back().open(err);
             if (source == NULL) {
                 translate_zip_error(err);
                 break;
@@ -1626,6 +2157,7 @@ bool Archive_builder::create_zip_archive()
 
             zip_int64_t index = zip_file_add(za, entry.c_str(), source, ZIP_FL_ENC_UTF_8);
             if (index < 0) {
+                zip_source_free(source);
                 translate_zip_error(za);
                 break;
             }
@@ -1646,19 +2178,23 @@ bool Archive_builder::create_zip_archive()
 
             string fname = join_path(m_root_path, entry);
 
+            // do not compress resources by default
+            zip_int32_t comp_method = ZIP_CM_STORE;
+
             zip_error_t err;
-            zip_source_t *source = zip_source_file_create(fname.c_str(), 0, -1, &err);
+            zip_source_t *source = NULL;
+            if (should_be_compressed(fname)) {
+                comp_method = ZIP_CM_DEFLATE;
+                sources.push_back(Deflated_zip_source(pipeline, deflated_idx++));
+                source = sources.back().open(err);
+            } else {
+                source = zip_source_file_create(fname.c_str(), 0, -1, &err);
+            }
             if (source == NULL) {
                 translate_zip_error(err.zip_err);
                 break;
             }
 
-            // do not compress resources by default
-            zip_int32_t comp_method = ZIP_CM_STORE;
-
-            if (should_be_compressed(fname))
-                comp_method = ZIP_CM_DEFAULT;
-
             fire_event(
                 comp_method == ZIP_CM_STORE ?
                     IArchive_tool_event::EV_STORING :
@@ -1667,6 +2203,7 @@ bool Archive_builder::create_zip_archive()
 
             zip_int64_t index = zip_file_add(za, entry.c_str(), source, ZIP_FL_ENC_UTF_8);
             if (index < 0) {
+                zip_source_free(source);
                 translate_zip_error(zip_get_error(za)->zip_err);
                 break;
             }
@@ -2760,6 +3297,10 @@ Archive_tool::Archive_tool(
         MDL_ARC_OPTION_COMPRESS_SUFFIXES,
         ".ies,.mbsdf,.txt,.html",
         "Comma separated list of resource suffixes that should be stored compressed");
+    m_options.add_option(
+        MDL_ARC_OPTION_THREADS,
+        "0",
+        "The number of threads used to build an archive, 0 for all hardware threads");
 }
 
 // Create a new archive.
@@ -2786,6 +3327,9 @@ IArchive const *Archive_tool::create_archive(
         the_manifest.get(),
         m_cb);
 
+    int n_threads = m_options.get_int_option(MDL_ARC_OPTION_THREADS);
+    arc_builder.set_thread_count(n_threads > 0 ? unsigned(n_threads) : 0u);
+
     // set compressed resource suffixes
     char const *suffixes = m_options.get_string_option(MDL_ARC_OPTION_COMPRESS_SUFFIXES);
     if (suffixes != NULL) {
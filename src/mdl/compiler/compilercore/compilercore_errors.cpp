@@ -661,6 +661,8 @@ char const *get_error_template(
             return "function '$0' in user-specified state module has wrong return type";
         case API_STRUCT_TYPE_MUST_BE_OPAQUE:
             return "opaque API struct '$0' in user-specified state module may not be redefined";
+        case UNKNOWN_TARGET_CPU:
+            return "'$0' is not a known CPU of the native target, generating generic code";
 
         // ------------------------------------------------------------- //
         case INTERNAL_JIT_BACKEND_ERROR:
@@ -349,6 +349,7 @@ enum Jit_backend_error {
     STATE_MODULE_FUNCTION_MISSING,
     WRONG_RETURN_TYPE_FOR_STATE_MODULE_FUNCTION,
     API_STRUCT_TYPE_MUST_BE_OPAQUE,
+    UNKNOWN_TARGET_CPU,
 
     INTERNAL_JIT_BACKEND_ERROR = 999,
 };
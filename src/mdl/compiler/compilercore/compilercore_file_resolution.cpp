@@ -629,6 +629,206 @@ private:
     mi::base::Handle<Manifest const> m_manifest;
 };
 
+// Constructor.
+Archive_directory_cache::Archive_directory_cache(IAllocator *alloc)
+: m_alloc(alloc)
+, m_lock()
+, m_directories(0, Directory_map::hasher(), Directory_map::key_equal(), alloc)
+{
+}
+
+// Check whether an archive contains the given file.
+bool Archive_directory_cache::contains(
+    char const        *archive_name,
+    char const        *file_name,
+    Archiv_error_code &err)
+{
+    // ZIP uses '/'
+    string forward(file_name, m_alloc);
+    forward = convert_os_separators_to_slashes(forward);
+
+    mi::base::Handle<Directory const> dir(get_directory(archive_name, err));
+    if (!dir.is_valid_interface())
+        return false;
+    return dir->names.find(forward) != dir->names.end();
+}
+
+// Check whether an archive contains a file matching the given mask.
+bool Archive_directory_cache::contains_mask(
+    char const        *archive_name,
+    char const        *file_mask,
+    Archiv_error_code &err)
+{
+    // ZIP uses '/'
+    string forward(file_mask, m_alloc);
+    forward = convert_os_separators_to_slashes(forward);
+
+    mi::base::Handle<Directory const> dir(get_directory(archive_name, err));
+    if (!dir.is_valid_interface())
+        return false;
+    for (Name_set::const_iterator it(dir->names.begin()), end(dir->names.end()); it != end; ++it) {
+        if (utf8_match(forward.c_str(), it->c_str()))
+            return true;
+    }
+    return false;
+}
+
+// Drop all cached directories.
+void Archive_directory_cache::clear()
+{
+    mi::base::Lock::Block block(&m_lock);
+
+    m_directories.clear();
+}
+
+// Get the up-to-date directory of an archive.
+mi::base::Handle<Archive_directory_cache::Directory const> Archive_directory_cache::get_directory(
+    char const        *archive_name,
+    Archiv_error_code &err)
+{
+    string name(archive_name, m_alloc);
+
+    Uint64 mtime = 0, size = 0;
+    if (!get_file_stamp_utf8(m_alloc, archive_name, mtime, size)) {
+        // the archive was removed
+        mi::base::Lock::Block block(&m_lock);
+        m_directories.erase(name);
+        err = EC_ARC_NOT_EXIST;
+        return mi::base::Handle<Directory const>();
+    }
+
+    {
+        mi::base::Lock::Block block(&m_lock);
+
+        Directory_map::const_iterator it(m_directories.find(name));
+        if (it != m_directories.end()) {
+            Directory const *dir = it->second.get();
+            if (dir->mtime == mtime && dir->size == size) {
+                err = dir->err;
+                if (dir->err != EC_OK)
+                    return mi::base::Handle<Directory const>();
+                return it->second;
+            }
+        }
+    }
+
+    // read the archive without holding the lock, if several threads do this concurrently,
+    // the last one wins
+    Allocator_builder builder(m_alloc);
+    mi::base::Handle<Directory> dir(builder.create<Directory>(m_alloc));
+    dir->mtime = mtime;
+    dir->size  = size;
+
+    if (MDL_archive *archive = MDL_archive::open(m_alloc, archive_name, dir->err, false)) {
+        for (int i = 0, n = archive->get_num_entries(); i < n; ++i) {
+            if (char const *entry_name = archive->get_entry_name(i))
+                dir->names.insert(string(entry_name, m_alloc));
+        }
+        archive->close();
+        dir->err = EC_OK;
+    }
+
+    {
+        mi::base::Lock::Block block(&m_lock);
+        m_directories[name] = dir;
+    }
+
+    err = dir->err;
+    if (dir->err != EC_OK)
+        return mi::base::Handle<Directory const>();
+    return mi::base::Handle<Directory const>(dir);
+}
+
+// Constructor.
+File_resolution_cache::File_resolution_cache(IAllocator *alloc)
+: m_lock()
+, m_paths(alloc)
+, m_results(0, Result_map::hasher(), Result_map::key_equal(), alloc)
+, m_last_sweep(Clock::now())
+{
+}
+
+// Lookup a search result.
+bool File_resolution_cache::lookup(
+    string const &paths,
+    string const &key,
+    int          max_age,
+    string       &result)
+{
+    mi::base::Lock::Block block(&m_lock);
+
+    check_paths(paths);
+
+    Result_map::iterator it(m_results.find(key));
+    if (it == m_results.end())
+        return false;
+    if (max_age > 0 && Clock::now() - it->second.time > MISTD::chrono::seconds(max_age)) {
+        // the search paths might have changed since, search again
+        m_results.erase(it);
+        return false;
+    }
+    result = it->second.path;
+    return true;
+}
+
+// Enter a search result.
+void File_resolution_cache::insert(
+    string const &paths,
+    string const &key,
+    int          max_age,
+    string const &result)
+{
+    mi::base::Lock::Block block(&m_lock);
+
+    check_paths(paths);
+
+    Clock::time_point now(Clock::now());
+    sweep(now, max_age);
+
+    Result_map::iterator it(m_results.find(key));
+    if (it != m_results.end())
+        it->second = Result(result, now);
+    else
+        m_results.insert(Result_map::value_type(key, Result(result, now)));
+}
+
+// Drop all cached results.
+void File_resolution_cache::clear()
+{
+    mi::base::Lock::Block block(&m_lock);
+
+    m_results.clear();
+}
+
+// Drop all results if they were computed for other search paths, the lock must be held.
+void File_resolution_cache::check_paths(string const &paths)
+{
+    if (paths != m_paths) {
+        m_results.clear();
+        m_paths = paths;
+    }
+}
+
+// Drop all results older than max_age seconds, at most once per max_age seconds,
+// the lock must be held.
+void File_resolution_cache::sweep(Clock::time_point now, int max_age)
+{
+    if (max_age <= 0)
+        return;
+
+    MISTD::chrono::seconds age(max_age);
+    if (now - m_last_sweep <= age)
+        return;
+    m_last_sweep = now;
+
+    for (Result_map::iterator it(m_results.begin()); it != m_results.end();) {
+        if (now - it->second.time > age)
+            it = m_results.erase(it);
+        else
+            ++it;
+    }
+}
+
 /// Helper class to transparently handle files on file system and inside archives.
 class File_handle {
     friend class Allocator_builder;
@@ -1036,6 +1236,8 @@ File_resolver::File_resolver(
 , m_resolver_lock(sp_lock)
 , m_paths(m_alloc)
 , m_resource_paths(m_alloc)
+, m_paths_signature(m_alloc)
+, m_searched_front_path(m_alloc)
 , m_killed_packages(String_set::key_compare(), m_alloc)
 , m_front_path(front_path)
 , m_resolve_entity(NULL)
@@ -1178,19 +1380,13 @@ bool File_resolver::archive_contains(
     char const *archive_name,
     char const *file_name)
 {
-    bool res = false;
-
-    Archiv_error_code err;
-    if (MDL_archive *archive = MDL_archive::open(m_alloc, archive_name, err, false)) {
-        res = archive->contains(file_name);
-        archive->close();
-    } else {
-        if (err == EC_INVALID_ARCHIVE) {
-            warning(
-                INVALID_MDL_ARCHIVE_DETECTED,
-                *m_pos,
-                Error_params(m_alloc).add(archive_name));
-        }
+    Archiv_error_code err = EC_OK;
+    bool res = m_mdl.get_archive_directory_cache().contains(archive_name, file_name, err);
+    if (!res && err == EC_INVALID_ARCHIVE) {
+        warning(
+            INVALID_MDL_ARCHIVE_DETECTED,
+            *m_pos,
+            Error_params(m_alloc).add(archive_name));
     }
     return res;
 }
@@ -1200,19 +1396,13 @@ bool File_resolver::archive_contains_mask(
     char const *archive_name,
     char const *file_mask)
 {
-    bool res = false;
-
-    Archiv_error_code err;
-    if (MDL_archive *archive = MDL_archive::open(m_alloc, archive_name, err, false)) {
-        res = archive->contains_mask(file_mask);
-        archive->close();
-    } else {
-        if (err == EC_INVALID_ARCHIVE) {
-            warning(
-                INVALID_MDL_ARCHIVE_DETECTED,
-                *m_pos,
-                Error_params(m_alloc).add(archive_name));
-        }
+    Archiv_error_code err = EC_OK;
+    bool res = m_mdl.get_archive_directory_cache().contains_mask(archive_name, file_mask, err);
+    if (!res && err == EC_INVALID_ARCHIVE) {
+        warning(
+            INVALID_MDL_ARCHIVE_DETECTED,
+            *m_pos,
+            Error_params(m_alloc).add(archive_name));
     }
     return res;
 }
@@ -1558,7 +1748,6 @@ string File_resolver::consider_search_paths(
     string resolved_filename      = search_mdl_path(
         canonical_file_mask_os.c_str() + 1,
         /*in_extra_resource_path=*/false,
-        m_front_path,
         udim_mode);
 
     // For backward compatibility we also consider the resource search paths for resources.
@@ -1566,7 +1755,6 @@ string File_resolver::consider_search_paths(
         resolved_filename      = search_mdl_path(
             canonical_file_mask_os.c_str() + 1,
             /*in_extra_resource_path=*/true,
-            m_front_path,
             udim_mode);
         if (!resolved_filename.empty()) {
             warning(
@@ -1828,9 +2016,10 @@ bool File_resolver::is_killed(
 string File_resolver::search_mdl_path(
     char const *file_mask,
     bool       in_resource_path,
-    char const *front_path,
     UDIM_mode  udim_mode)
 {
+    char const *front_path = m_front_path;
+
     // Calls to IMDL_search_path are not thread-safe.
     // Ensure that at least this compiler will serialize it.
     // Note that this is still unsafe, if more than one compiler share the same module
@@ -1844,9 +2033,11 @@ string File_resolver::search_mdl_path(
         if (!m_pathes_read) {
             size_t n = m_search_path->get_search_path_count(IMDL_search_path::MDL_SEARCH_PATH);
             m_paths.reserve(n + (front_path != NULL ? 1 : 0));
-            if (front_path != NULL)
-                m_paths.push_back(
-                convert_slashes_to_os_separators(string(front_path, m_alloc)));
+            if (front_path != NULL) {
+                m_searched_front_path =
+                    convert_slashes_to_os_separators(string(front_path, m_alloc));
+                m_paths.push_back(m_searched_front_path);
+            }
             for (size_t i = 0; i < n; ++i) {
                 char const *path = m_search_path->get_search_path(
                     IMDL_search_path::MDL_SEARCH_PATH, i);
@@ -1866,10 +2057,56 @@ string File_resolver::search_mdl_path(
                         convert_slashes_to_os_separators(string(path, m_alloc)));
                 }
             }
+
+            // the front path is part of the cache key, not of the signature
+            size_t first = front_path != NULL ? 1 : 0;
+            for (size_t i = first, n = m_paths.size(); i < n; ++i) {
+                m_paths_signature += m_paths[i];
+                m_paths_signature += '\n';
+            }
+            m_paths_signature += '\n';
+            for (size_t i = 0, n = m_resource_paths.size(); i < n; ++i) {
+                m_paths_signature += m_resource_paths[i];
+                m_paths_signature += '\n';
+            }
         }
         m_pathes_read = true;
     }
 
+    // key on the front path that is actually searched, resource paths have none
+    string key(m_alloc);
+    key += in_resource_path ? 'R' : 'M';
+    key += char('0' + int(udim_mode));
+    if (!in_resource_path)
+        key += m_searched_front_path;
+    key += '\n';
+    key += file_mask;
+
+    File_resolution_cache &cache = m_mdl.get_file_resolution_cache();
+    int max_age = m_mdl.get_file_resolution_cache_ttl();
+
+    string result(m_alloc);
+    if (cache.lookup(m_paths_signature, key, max_age, result))
+        return result;
+
+    size_t n_msgs = m_msgs.get_message_count();
+
+    result = search_mdl_path_uncached(file_mask, in_resource_path, udim_mode);
+
+    // results that produced messages (ambiguities, conflicts, broken archives) are not
+    // cached, so every request reports them
+    if (m_msgs.get_message_count() == n_msgs)
+        cache.insert(m_paths_signature, key, max_age, result);
+    return result;
+}
+
+// Search the given path in all MDL search paths without consulting the cache.
+string File_resolver::search_mdl_path_uncached(
+    char const *file_mask,
+    bool       in_resource_path,
+    UDIM_mode  udim_mode)
+{
+
     // the archive name ('.' separators)
     string archive_path = to_archive(file_mask);
 
@@ -2037,13 +2274,9 @@ bool File_resolver::file_exists(
     string archive_name(fname, p + 4, m_alloc);
     char const *a_fname = p + 5;
 
-    Archiv_error_code err;
-    if (MDL_archive *archiv = MDL_archive::open(m_alloc, archive_name.c_str(), err, false)) {
-        bool res = archiv->contains_mask(a_fname);
-        archiv->close();
-        return res;
-    }
-    return false;
+    Archiv_error_code err = EC_OK;
+    return m_mdl.get_archive_directory_cache().contains_mask(
+        archive_name.c_str(), a_fname, err);
 }
 
 // Resolve a MDL file name.
@@ -29,6 +29,8 @@
 #ifndef MDL_COMPILERCORE_FILE_RESOLUTION_H
 #define MDL_COMPILERCORE_FILE_RESOLUTION_H 1
 
+#include <chrono>
+
 #include <mi/mdl/mdl_mdl.h>
 #include <mi/mdl/mdl_entity_resolver.h>
 #include <mi/base/handle.h>
@@ -73,6 +75,177 @@ enum Archiv_error_code {
 #define UDIM_ZBRUSH_MARKER  "<UVTILE0>"
 #define UDIM_MUDBOX_MARKER  "<UVTILE1>"
 
+/// A cache of the central directories of MDL archives.
+///
+/// One cache is shared by all file resolvers of a compiler. Every archive is opened once,
+/// and the names of its entries are stored in a hash set, so checking whether an archive
+/// contains a file is a hash lookup. An entry is rebuilt if the modification time or the
+/// size of the archive file changes. Archives are opened and read without holding the cache
+/// lock, lookups of other threads only wait for the map access.
+class Archive_directory_cache {
+    typedef hash_set<string, string_hash<string> >::Type Name_set;
+
+    /// The cached directory of one archive, immutable once it was built.
+    class Directory : public Allocator_interface_implement<mi::base::IInterface> {
+        typedef Allocator_interface_implement<mi::base::IInterface> Base;
+        friend class Allocator_builder;
+    public:
+        Uint64            mtime;  ///< The modification time of the archive file.
+        Uint64            size;   ///< The size of the archive file.
+        Archiv_error_code err;    ///< The error if the archive could not be opened.
+        Name_set          names;  ///< The names of all entries, using '/' separators.
+
+    private:
+        /// Constructor.
+        explicit Directory(IAllocator *alloc)
+        : Base(alloc)
+        , mtime(0)
+        , size(0)
+        , err(EC_OK)
+        , names(0, Name_set::hasher(), Name_set::key_equal(), alloc)
+        {
+        }
+    };
+
+    typedef hash_map<
+        string,
+        mi::base::Handle<Directory const>,
+        string_hash<string> >::Type Directory_map;
+
+public:
+    /// Constructor.
+    ///
+    /// \param alloc  the allocator
+    explicit Archive_directory_cache(IAllocator *alloc);
+
+    /// Check whether an archive contains the given file.
+    ///
+    /// \param[in]  archive_name  the UTF8 encoded archive path
+    /// \param[in]  file_name     the file name inside the archive (OS separators)
+    /// \param[out] err           error code if the archive could not be opened
+    bool contains(
+        char const        *archive_name,
+        char const        *file_name,
+        Archiv_error_code &err);
+
+    /// Check whether an archive contains a file matching the given mask.
+    ///
+    /// \param[in]  archive_name  the UTF8 encoded archive path
+    /// \param[in]  file_mask     the file mask inside the archive (OS separators)
+    /// \param[out] err           error code if the archive could not be opened
+    bool contains_mask(
+        char const        *archive_name,
+        char const        *file_mask,
+        Archiv_error_code &err);
+
+    /// Drop all cached directories.
+    void clear();
+
+private:
+    /// Get the up-to-date directory of an archive.
+    ///
+    /// \param[in]  archive_name  the UTF8 encoded archive path
+    /// \param[out] err           error code if the archive could not be opened
+    ///
+    /// \return the directory or an invalid handle if the archive could not be opened
+    mi::base::Handle<Directory const> get_directory(
+        char const        *archive_name,
+        Archiv_error_code &err);
+
+private:
+    /// The allocator.
+    IAllocator *m_alloc;
+
+    /// Protects the directory map.
+    mi::base::Lock m_lock;
+
+    /// The cached directories, indexed by archive path.
+    Directory_map m_directories;
+};
+
+/// A cache of search path lookups, holding both found and not found results.
+///
+/// One cache is shared by all file resolvers of a compiler. The results are valid for one
+/// set of search paths only: the cache is cleared if a resolver sees different search paths,
+/// if a new search path helper is installed, or if the user requests it explicitly. Results
+/// older than the maximum age given by the caller (see the "file_resolution_cache_ttl" compiler
+/// option) are searched again, so files added to or removed from the search paths are noticed
+/// without an explicit request. Expired results are swept periodically by insert().
+class File_resolution_cache {
+    typedef MISTD::chrono::steady_clock Clock;
+
+    /// A cached result.
+    struct Result {
+        /// Constructor.
+        Result(string const &path, Clock::time_point time)
+        : path(path)
+        , time(time)
+        {
+        }
+
+        string            path;  ///< The found path, empty if the search failed.
+        Clock::time_point time;  ///< The time of the search.
+    };
+
+    typedef hash_map<string, Result, string_hash<string> >::Type Result_map;
+
+public:
+    /// Constructor.
+    ///
+    /// \param alloc  the allocator
+    explicit File_resolution_cache(IAllocator *alloc);
+
+    /// Lookup a search result.
+    ///
+    /// \param[in]  paths    the signature of the search paths used by the caller
+    /// \param[in]  key      the search key
+    /// \param[in]  max_age  the maximum age of a result in seconds, 0 if results never expire
+    /// \param[out] result   the cached result, empty if the search failed
+    ///
+    /// \return true if the result is cached
+    bool lookup(
+        string const &paths,
+        string const &key,
+        int          max_age,
+        string       &result);
+
+    /// Enter a search result.
+    ///
+    /// \param paths    the signature of the search paths used by the caller
+    /// \param key      the search key
+    /// \param max_age  the maximum age of a result in seconds, 0 if results never expire
+    /// \param result   the result, empty if the search failed
+    void insert(
+        string const &paths,
+        string const &key,
+        int          max_age,
+        string const &result);
+
+    /// Drop all cached results.
+    void clear();
+
+private:
+    /// Drop all results if they were computed for other search paths, the lock must be held.
+    void check_paths(string const &paths);
+
+    /// Drop all results older than max_age seconds, at most once per max_age seconds,
+    /// the lock must be held.
+    void sweep(Clock::time_point now, int max_age);
+
+private:
+    /// Protects the cache.
+    mi::base::Lock m_lock;
+
+    /// The signature of the search paths the cached results belong to.
+    string m_paths;
+
+    /// The cached results.
+    Result_map m_results;
+
+    /// The time of the last sweep over all results.
+    Clock::time_point m_last_sweep;
+};
+
 /// Implements file resolution.
 class File_resolver {
     typedef set<string>::Type       String_set;
@@ -395,16 +568,28 @@ private:
 
     /// Search the given path in all MDL search paths and return the absolute path if found.
     ///
+    /// The front path of the resolver, if any, is searched first.
+    ///
     /// \param file_mask    the path to search (maybe a regex)
     /// \param is_resource  true if search in extra resource path
-    /// \param front_path   if non-NULL, search this MDL path first
     /// \param udim_mode    if != NO_UDIM the returned value is a file mask
     ///
     /// \return the absolute path or mask if found
     string search_mdl_path(
         char const *file_mask,
         bool       in_resource_path,
-        char const *front_path,
+        UDIM_mode  udim_mode);
+
+    /// Search the given path in all MDL search paths without consulting the cache.
+    ///
+    /// \param file_mask         the path to search (maybe a regex)
+    /// \param in_resource_path  true if search in extra resource path
+    /// \param udim_mode         if != NO_UDIM the returned value is a file mask
+    ///
+    /// \return the absolute path or mask if found
+    string search_mdl_path_uncached(
+        char const *file_mask,
+        bool       in_resource_path,
         UDIM_mode  udim_mode);
 
     /// Check if the given file name (UTF8 encoded) names a file on the file system or inside
@@ -471,6 +656,12 @@ private:
     /// Cache for the MDL resource paths.
     String_vec m_resource_paths;
 
+    /// The signature of the search paths, used to validate cached search results.
+    string m_paths_signature;
+
+    /// The front path as it was entered into m_paths, empty if there is none.
+    string m_searched_front_path;
+
     /// The set of "killed" packages.
     String_set m_killed_packages;
 
@@ -183,6 +183,43 @@ bool is_file_utf8(
     return false;
 }
 
+// Get the modification time and the size of a file.
+bool get_file_stamp_utf8(
+    IAllocator *alloc,
+    char const *fname,
+    Uint64     &mtime,
+    Uint64     &size)
+{
+#ifdef MI_PLATFORM_WINDOWS
+    wstring path(alloc);
+    utf8_to_utf16(path, fname);
+
+    // the last write time in 100 ns units
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (::GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &data)) {
+        mtime = (Uint64(data.ftLastWriteTime.dwHighDateTime) << 32) |
+            data.ftLastWriteTime.dwLowDateTime;
+        size  = (Uint64(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+        return true;
+    }
+#else
+    struct stat st;
+
+    // assume native UTF8-support
+    if (!::stat(fname, &st)) {
+        // the modification time in ns, a file rewritten within a second gets another stamp
+#ifdef MI_PLATFORM_MACOSX
+        mtime = Uint64(st.st_mtimespec.tv_sec) * 1000000000u + Uint64(st.st_mtimespec.tv_nsec);
+#else
+        mtime = Uint64(st.st_mtim.tv_sec) * 1000000000u + Uint64(st.st_mtim.tv_nsec);
+#endif
+        size  = Uint64(st.st_size);
+        return true;
+    }
+#endif
+    return false;
+}
+
 // Check if in the given directory a file matching the given mask exists.
 bool has_file_utf8(
     IAllocator *alloc,
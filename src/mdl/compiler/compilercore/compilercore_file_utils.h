@@ -86,6 +86,21 @@ bool is_file_utf8(
     IAllocator *alloc,
     char const *fname);
 
+/// Get the modification time and the size of a file.
+///
+/// \param[in]  alloc  an allocator
+/// \param[in]  fname  an UTF8 encoded file name
+/// \param[out] mtime  the modification time of the file with sub-second resolution, only
+///                    meaningful for comparisons
+/// \param[out] size   the size of the file in bytes
+///
+/// \return false if the file does not exist
+bool get_file_stamp_utf8(
+    IAllocator *alloc,
+    char const *fname,
+    Uint64     &mtime,
+    Uint64     &size);
+
 /// Check if in the given directory a file matching the given mask exists.
 ///
 /// \param alloc      an allocator
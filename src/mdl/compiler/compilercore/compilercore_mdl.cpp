@@ -35,6 +35,7 @@
 
 #include "compilercore_cc_conf.h"
 #include "compilercore_mdl.h"
+#include "compilercore_statistics.h"
 #include "compilercore_allocator.h"
 #include "compilercore_debug_tools.h"
 #include "compilercore_factories.h"
@@ -77,6 +78,7 @@ char const *MDL::option_limits_float_max              = MDL_OPTION_LIMITS_FLOAT_
 char const *MDL::option_limits_double_min             = MDL_OPTION_LIMITS_DOUBLE_MIN;
 char const *MDL::option_limits_double_max             = MDL_OPTION_LIMITS_DOUBLE_MAX;
 char const *MDL::option_state_wavelength_base_max     = MDL_OPTION_STATE_WAVELENGTH_BASE_MAX;
+char const *MDL::option_file_resolution_cache_ttl     = MDL_OPTION_FILE_RESOLUTION_CACHE_TTL;
 
 // forward
 class Jitted_code;
@@ -351,6 +353,8 @@ MDL::MDL(IAllocator *alloc)
 , m_global_lock()
 , m_search_path_lock()
 , m_weak_module_lock()
+, m_archive_dir_cache(alloc)
+, m_file_resolution_cache(alloc)
 , m_builtin_modules_created(false)
 , m_predefined_types_build(false)
 , m_jitted_code(NULL)
@@ -424,6 +428,8 @@ void MDL::install_search_path(IMDL_search_path *search_path)
     if (search_path == NULL)
         search_path = m_builder.create<Empty_search_path>(get_allocator());
     m_search_path = search_path;
+
+    clear_file_resolution_cache();
 }
 
 // Build all builtin modules.
@@ -961,6 +967,8 @@ void MDL::create_options()
         "The largest double value supported by the current platform");
     m_options.add_option(option_state_wavelength_base_max, STR(1),
         "The number of wavelengths returned in the result of wavelength base()");
+    m_options.add_option(option_file_resolution_cache_ttl, "2",
+        "Maximum age of cached file resolution results in seconds, 0 keeps them until cleared");
 
 
 #undef _STR
@@ -997,7 +1005,12 @@ Module *MDL::load_module(
     parser.set_imdl(get_allocator(), this);
 
     parser.set_module(module);
-    parser.Parse();
+    {
+        // recorded into the module, analyze() adds its statistics to the thread context
+        Phase_timer timer(&module->access_statistics(), CP_PARSER, &module->get_arena());
+        parser.Parse();
+        timer.set_node_count(size_t(module->get_declaration_count()));
+    }
 
     mi::base::Handle<IArchive_input_stream> ias(s->get_interface<IArchive_input_stream>());
     if (ias.is_valid_interface()) {
@@ -1133,15 +1146,29 @@ Module const *MDL::compile_module(
             }
             return cached_mod;
         }
+
+        // another thread might be compiling this module right now, wait for it
+        cached_mod = impl_cast<Module>(module_cache->begin_loading(mname.c_str()));
+        if (cached_mod != NULL) {
+            if (!cached_mod->is_analyzed()) {
+                cached_mod->release();
+                return NULL;
+            }
+            return cached_mod;
+        }
     }
 
     mi::base::Handle<IInput_stream> input(resolver.open(mname.c_str()));
 
     if (! input) {
         // FIXME: add an error ??
+        if (module_cache != NULL)
+            module_cache->loaded(mname.c_str(), NULL);
         return NULL;
     }
     Module *mod = load_module(module_cache, &ctx, mname.c_str(), input.get(), Module::MF_STANDARD);
+    if (module_cache != NULL)
+        module_cache->loaded(mname.c_str(), mod);
     if (mod == NULL) {
         // any error was already handled by load_module() above
         return NULL;
@@ -1734,6 +1761,13 @@ IArchive_tool *MDL::create_archive_tool()
     return m_builder.create<Archive_tool>(get_allocator(), this);
 }
 
+// Drop all cached file resolution results.
+void MDL::clear_file_resolution_cache()
+{
+    m_file_resolution_cache.clear();
+    m_archive_dir_cache.clear();
+}
+
 // Check if the compiler supports a requested MDL version.
 bool MDL::check_version(int major, int minor, MDL_version &version)
 {
@@ -2017,6 +2051,25 @@ mi::base::Lock &MDL::get_search_path_lock() const
     return m_search_path_lock;
 }
 
+// Get the cache of archive directories shared by all file resolvers.
+Archive_directory_cache &MDL::get_archive_directory_cache() const
+{
+    return m_archive_dir_cache;
+}
+
+// Get the cache of search path lookups shared by all file resolvers.
+File_resolution_cache &MDL::get_file_resolution_cache() const
+{
+    return m_file_resolution_cache;
+}
+
+// Get the maximum age of cached search path lookups in seconds, 0 if they never expire.
+int MDL::get_file_resolution_cache_ttl() const
+{
+    int ttl = m_options.get_int_option(option_file_resolution_cache_ttl);
+    return ttl > 0 ? ttl : 0;
+}
+
 // Get the Jitted code singleton.
 Jitted_code *MDL::get_jitted_code()
 {
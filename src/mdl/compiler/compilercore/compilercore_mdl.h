@@ -41,6 +41,7 @@
 #include "compilercore_printers.h"
 #include "compilercore_cstring_hash.h"
 #include "compilercore_thread_context.h"
+#include "compilercore_file_resolution.h"
 
 namespace mi {
 namespace mdl {
@@ -93,6 +94,9 @@ public:
     /// The value of state::WAVELENGTH_BASE_MAX.
     static char const *option_state_wavelength_base_max;
 
+    /// The maximum age of cached file resolution results in seconds.
+    static char const *option_file_resolution_cache_ttl;
+
 
     /// Get the type factory.
     Type_factory *get_type_factory() const MDL_FINAL;
@@ -344,6 +348,9 @@ public:
     /// Create an MDL archive tool using this compiler.
     IArchive_tool *create_archive_tool() MDL_FINAL;
 
+    /// Drop all cached file resolution results.
+    void clear_file_resolution_cache() MDL_FINAL;
+
     // ------------------- non interface methods ---------------------------
 
     /// Check if the compiler supports a requested MDL version.
@@ -516,6 +523,15 @@ public:
     /// Get the search path lock.
     mi::base::Lock &get_search_path_lock() const;
 
+    /// Get the cache of archive directories shared by all file resolvers.
+    Archive_directory_cache &get_archive_directory_cache() const;
+
+    /// Get the cache of search path lookups shared by all file resolvers.
+    File_resolution_cache &get_file_resolution_cache() const;
+
+    /// Get the maximum age of cached search path lookups in seconds, 0 if they never expire.
+    int get_file_resolution_cache_ttl() const;
+
     /// Get the Jitted code singleton.
     ///
     /// \note Does NOT increase the reference count of the returned
@@ -655,6 +671,12 @@ private:
     /// The shared lock for all module's weak import tables.
     mutable mi::base::Lock m_weak_module_lock;
 
+    /// The cache of archive directories.
+    mutable Archive_directory_cache m_archive_dir_cache;
+
+    /// The cache of search path lookups.
+    mutable File_resolution_cache m_file_resolution_cache;
+
     /// Set once the builtin modules are created.
     volatile bool m_builtin_modules_created;
 
@@ -0,0 +1,165 @@
+/******************************************************************************
+ * Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include "pch.h"
+
+#include "compilercore_module_cache.h"
+
+namespace mi {
+namespace mdl {
+
+// Constructor.
+Shared_module_cache::Shared_module_cache(IAllocator *alloc)
+: m_alloc(alloc)
+, m_mutex()
+, m_cond()
+, m_modules(Module_map::key_compare(), alloc)
+, m_waiting(Wait_map::key_compare(), alloc)
+{
+}
+
+// Lookup a module.
+IModule const *Shared_module_cache::lookup(char const *absname) const
+{
+    MISTD::lock_guard<MISTD::mutex> guard(m_mutex);
+
+    Module_map::const_iterator it(m_modules.find(string(absname, m_alloc)));
+    if (it == m_modules.end() || it->second.loading)
+        return NULL;
+    IModule const *module = it->second.module.get();
+    module->retain();
+    return module;
+}
+
+// Announce that the calling thread is going to compile a module.
+IModule const *Shared_module_cache::begin_loading(char const *absname)
+{
+    MISTD::unique_lock<MISTD::mutex> lock(m_mutex);
+    MISTD::thread::id self(MISTD::this_thread::get_id());
+    string name(absname, m_alloc);
+
+    for (;;) {
+        Module_map::iterator it(m_modules.find(name));
+        if (it == m_modules.end()) {
+            Entry &e = m_modules[name];
+            e.owner   = self;
+            e.loading = true;
+            return NULL;
+        }
+        Entry const &e = it->second;
+        if (!e.loading) {
+            IModule const *module = e.module.get();
+            module->retain();
+            return module;
+        }
+        if (would_deadlock(e.owner, self)) {
+            // an import loop between threads, compile it here, loaded() ignores the result
+            return NULL;
+        }
+        m_waiting.insert(Wait_map::value_type(self, name));
+        m_cond.wait(lock);
+        m_waiting.erase(self);
+    }
+}
+
+// Report the result of a compilation announced by begin_loading().
+void Shared_module_cache::loaded(char const *absname, IModule const *module)
+{
+    {
+        MISTD::lock_guard<MISTD::mutex> guard(m_mutex);
+
+        Module_map::iterator it(m_modules.find(string(absname, m_alloc)));
+        if (it != m_modules.end() &&
+            it->second.loading &&
+            it->second.owner == MISTD::this_thread::get_id())
+        {
+            if (module != NULL && module->is_valid()) {
+                enter_locked(module);
+            } else {
+                // let the waiting threads compile it themselves to report the errors
+                m_modules.erase(it);
+            }
+        }
+    }
+    m_cond.notify_all();
+}
+
+// Enter a valid module and all its non-standard imports.
+void Shared_module_cache::enter(IModule const *module)
+{
+    if (module == NULL || !module->is_valid())
+        return;
+
+    {
+        MISTD::lock_guard<MISTD::mutex> guard(m_mutex);
+        enter_locked(module);
+    }
+    m_cond.notify_all();
+}
+
+// Enter a module and its imports, the lock must be held.
+void Shared_module_cache::enter_locked(IModule const *module)
+{
+    if (module->is_builtins() || module->is_stdlib())
+        return;
+
+    Entry &e = m_modules[string(module->get_name(), m_alloc)];
+    if (e.module.is_valid_interface())
+        return;
+    module->retain();
+    e.module  = mi::base::make_handle(module);
+    e.loading = false;
+
+    for (int i = 0, n = module->get_import_count(); i < n; ++i) {
+        mi::base::Handle<IModule const> import(module->get_import(i));
+        if (import.is_valid_interface())
+            enter_locked(import.get());
+    }
+}
+
+// Check if waiting for a module compiled by owner would close a cycle of waiting threads.
+bool Shared_module_cache::would_deadlock(
+    MISTD::thread::id owner,
+    MISTD::thread::id self) const
+{
+    for (size_t i = 0, n = m_waiting.size(); i <= n; ++i) {
+        if (owner == self)
+            return true;
+        Wait_map::const_iterator w(m_waiting.find(owner));
+        if (w == m_waiting.end())
+            return false;
+        Module_map::const_iterator it(m_modules.find(w->second));
+        if (it == m_modules.end() || !it->second.loading)
+            return false;
+        owner = it->second.owner;
+    }
+    return false;
+}
+
+}  // mdl
+}  // mi
@@ -0,0 +1,119 @@
+/******************************************************************************
+ * Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef MDL_COMPILERCORE_MODULE_CACHE_H
+#define MDL_COMPILERCORE_MODULE_CACHE_H 1
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <mi/base/handle.h>
+#include <mi/base/iallocator.h>
+#include <mi/mdl/mdl_modules.h>
+
+#include "compilercore_allocator.h"
+
+namespace mi {
+namespace mdl {
+
+/// A thread safe module cache shared by several threads compiling modules with the same
+/// compiler.
+///
+/// Every valid module loaded by one thread is entered together with its imports, so other
+/// threads reuse already compiled dependencies instead of compiling them again. A module that is
+/// being compiled has an in-flight entry, threads needing it wait for its owner to finish.
+class Shared_module_cache : public IModule_cache
+{
+public:
+    /// Constructor.
+    ///
+    /// \param alloc  the allocator
+    explicit Shared_module_cache(IAllocator *alloc);
+
+    /// Lookup a module.
+    IModule const *lookup(char const *absname) const MDL_FINAL;
+
+    /// Announce that the calling thread is going to compile a module.
+    IModule const *begin_loading(char const *absname) MDL_FINAL;
+
+    /// Report the result of a compilation announced by begin_loading().
+    void loaded(char const *absname, IModule const *module) MDL_FINAL;
+
+    /// Enter a valid module and all its non-standard imports.
+    ///
+    /// \param module  the module, invalid modules and NULL are ignored
+    void enter(IModule const *module);
+
+private:
+    /// Enter a module and its imports, the lock must be held.
+    void enter_locked(IModule const *module);
+
+    /// Check if waiting for a module compiled by \p owner would close a cycle of threads
+    /// waiting for each other, the lock must be held.
+    bool would_deadlock(MISTD::thread::id owner, MISTD::thread::id self) const;
+
+private:
+    /// A cache entry.
+    struct Entry {
+        /// Constructor.
+        Entry()
+        : module()
+        , owner()
+        , loading(false)
+        {
+        }
+
+        mi::base::Handle<IModule const> module;  ///< The module, if already loaded.
+        MISTD::thread::id                owner;   ///< The thread compiling the module.
+        bool                             loading; ///< True while the module is compiled.
+    };
+
+    typedef map<string, Entry>::Type             Module_map;
+    typedef map<MISTD::thread::id, string>::Type Wait_map;
+
+    /// The allocator.
+    IAllocator *m_alloc;
+
+    /// Protects the module and the wait maps.
+    mutable MISTD::mutex m_mutex;
+
+    /// Signaled whenever an in-flight module was finished.
+    MISTD::condition_variable m_cond;
+
+    /// The cached and in-flight modules, indexed by absolute name.
+    Module_map m_modules;
+
+    /// The module every blocked thread is waiting for.
+    Wait_map m_waiting;
+};
+
+}  // mdl
+}  // mi
+
+#endif // MDL_COMPILERCORE_MODULE_CACHE_H
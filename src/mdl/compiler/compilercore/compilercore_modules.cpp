@@ -54,6 +54,7 @@
 #include "compilercore_tools.h"
 #include "compilercore_fatal.h"
 #include "compilercore_file_resolution.h"
+#include "compilercore_statistics.h"
 
 namespace mi {
 namespace mdl {
@@ -567,18 +568,31 @@ bool Module::analyze(
         ctx  = hctx.get();
     }
 
+    // the statistics stay with the module, so they are not lost with the thread context
+    Compile_statistics &stats = m_statistics;
+
     NT_analysis nt_analysis(m_compiler, *this, *ctx, cache);
-    nt_analysis.run();
+    {
+        Phase_timer timer(&stats, CP_NT_ANALYSIS, &m_arena);
+        nt_analysis.run();
+        timer.set_node_count(m_declarations.size());
+    }
 
     Sema_analysis sema_analysis(m_compiler, *this, *ctx);
-    sema_analysis.run();
+    {
+        Phase_timer timer(&stats, CP_SEMA_ANALYSIS, &m_arena);
+        sema_analysis.run();
+    }
 
-    Optimizer::run(
-        m_compiler,
-        *this,
-        *ctx,
-        nt_analysis,
-        sema_analysis.get_statement_info_data());
+    {
+        Phase_timer timer(&stats, CP_OPTIMIZER, &m_arena);
+        Optimizer::run(
+            m_compiler,
+            *this,
+            *ctx,
+            nt_analysis,
+            sema_analysis.get_statement_info_data());
+    }
 
     // run the checker
     Module_checker::check(m_compiler, this, /*verbose=*/false);
@@ -586,6 +600,8 @@ bool Module::analyze(
     // we have analyzed it
     set_analyze_result(access_messages().get_error_message_count() == 0);
 
+    ctx->access_statistics().merge(m_statistics);
+
     // drop the reference count of all imports, it was increased
     // during load_module_to_import() inside NT_analysis::run().
     // Note that this does NOT drop all imports, it just sets the count
@@ -34,6 +34,7 @@
 #include <mi/mdl/mdl_mdl.h>
 #include <mi/mdl/mdl_streams.h>
 #include <mi/mdl/mdl_modules.h>
+#include <mi/mdl/mdl_statistics.h>
 
 #include "compilercore_cc_conf.h"
 #include "compilercore_allocator.h"
@@ -514,6 +515,15 @@ public:
     /// Access messages.
     Messages_impl const &access_messages_impl() const;
 
+    /// Get the memory arena of this module.
+    Memory_arena const &get_arena() const { return m_arena; }
+
+    /// Get the statistics of the front-end phases that produced this module.
+    Compile_statistics const &get_statistics() const { return m_statistics; }
+
+    /// Access the statistics of the front-end phases that produced this module.
+    Compile_statistics &access_statistics() { return m_statistics; }
+
     /// Get the symbol table of this module.
     Symbol_table &get_symbol_table() { return m_sym_tab; }
 
@@ -1120,6 +1130,9 @@ private:
     /// The compiler Messages of this module
     Messages_impl m_msg_list;
 
+    /// The statistics of the front-end phases, not serialized.
+    Compile_statistics m_statistics;
+
     /// The symbol table of this module.
     Symbol_table m_sym_tab;
 
@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef MDL_COMPILERCORE_STATISTICS_H
+#define MDL_COMPILERCORE_STATISTICS_H 1
+
+#include <chrono>
+
+#include <mi/mdl/mdl_statistics.h>
+
+#include "compilercore_memory_arena.h"
+
+namespace mi {
+namespace mdl {
+
+/// Records the wall time of a compilation phase on destruction.
+///
+/// If a memory arena is given, the growth of its chunks during the lifetime of the timer
+/// is recorded as the allocation volume of the phase.
+class Phase_timer {
+    typedef MISTD::chrono::steady_clock Clock;
+public:
+    /// Constructor.
+    ///
+    /// \param stats  the statistics to record into, may be NULL
+    /// \param phase  the phase to record
+    /// \param arena  if non-NULL, the arena whose growth is recorded
+    Phase_timer(
+        Compile_statistics *stats,
+        Compile_phase      phase,
+        Memory_arena const *arena = NULL)
+    : m_stats(stats)
+    , m_phase(phase)
+    , m_arena(arena)
+    , m_arena_size(arena != NULL ? arena->get_chunks_size() : 0)
+    , m_node_count(0)
+    , m_start(Clock::now())
+    {
+    }
+
+    /// Destructor, records the phase.
+    ~Phase_timer()
+    {
+        if (m_stats == NULL)
+            return;
+
+        double seconds = MISTD::chrono::duration<double>(Clock::now() - m_start).count();
+        size_t bytes   = 0;
+        if (m_arena != NULL) {
+            size_t size = m_arena->get_chunks_size();
+            bytes = size > m_arena_size ? size - m_arena_size : 0;
+        }
+        m_stats->record(m_phase, seconds, bytes, m_node_count);
+    }
+
+    /// Set the number of nodes produced by the phase.
+    void set_node_count(size_t count) { m_node_count = count; }
+
+private:
+    // non copyable
+    Phase_timer(Phase_timer const &) MDL_DELETED_FUNCTION;
+    Phase_timer &operator=(Phase_timer const &) MDL_DELETED_FUNCTION;
+
+private:
+    /// The statistics to record into.
+    Compile_statistics *m_stats;
+
+    /// The recorded phase.
+    Compile_phase m_phase;
+
+    /// The observed memory arena if any.
+    Memory_arena const *m_arena;
+
+    /// The chunk size of the arena at the start of the phase.
+    size_t m_arena_size;
+
+    /// The number of nodes produced.
+    size_t m_node_count;
+
+    /// The start time.
+    Clock::time_point m_start;
+};
+
+}  // mdl
+}  // mi
+
+#endif // MDL_COMPILERCORE_STATISTICS_H
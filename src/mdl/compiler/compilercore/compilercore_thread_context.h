@@ -89,6 +89,12 @@ public:
     ///
     Options_impl &access_options() MDL_FINAL;
 
+    /// Access the per-phase statistics of all front-end operations that used this context.
+    Compile_statistics const &access_statistics() const MDL_FINAL { return m_statistics; }
+
+    /// Access the per-phase statistics of all front-end operations that used this context.
+    Compile_statistics &access_statistics() MDL_FINAL { return m_statistics; }
+
 public:
     enum String_buffer_id {
         SBI_MANGLE_BUFFER,
@@ -159,6 +165,9 @@ private:
 
     /// Front path.
     string m_front_path;
+
+    /// Per-phase statistics.
+    Compile_statistics m_statistics;
 };
 
 }  // mdl
@@ -4937,6 +4937,10 @@ class SignatureParser:
 		self.register_mdl_runtime_func("mdl_df_light_profile_maximum",  "FF_PTII")
 		self.register_mdl_runtime_func("mdl_df_light_profile_valid",    "BB_PTII")
 		self.register_mdl_runtime_func("mdl_df_bsdf_measurement_valid", "BB_PTII")
+		self.register_mdl_runtime_func("mdl_df_bsdf_measurement_evaluate", "FA3_PTIIFA2FA2II")
+		self.register_mdl_runtime_func("mdl_df_bsdf_measurement_sample",   "FA3_PTIIFA2FA3II")
+		self.register_mdl_runtime_func("mdl_df_bsdf_measurement_pdf",      "FF_PTIIFA2FA2II")
+		self.register_mdl_runtime_func("mdl_df_bsdf_measurement_albedos",  "FA4_PTIIFA2")
 
 		# exception handling
 		self.register_mdl_runtime_func("mdl_out_of_bounds",          "VV_xsIIZZCSII")
@@ -5337,6 +5341,9 @@ class SignatureParser:
 		# generate the constructor
 		self.create_constructor(f)
 
+		self.write(f, "/// Returns true if a resource handler I/F is available.\n")
+		self.write(f, "bool has_res_handler() const { return m_has_res_handler; }\n\n")
+
 		# write prototypes of internal function creation functions
 		self.write(f, "/// Generate LLVM IR for state::set_normal(float3)\n")
 		self.write(f, "llvm::Function *create_state_set_normal(Internal_function const *int_func);\n\n")
@@ -95,6 +95,22 @@ Code_generator_jit::Code_generator_jit(
         MDL_JIT_OPTION_LINK_LIBDEVICE,
         "true",
         "Link libdevice into PTX module");
+    m_options.add_option(
+        MDL_JIT_OPTION_LAZY_COMPILATION,
+        "false",
+        "Compile native code lazily on the first call of a function");
+    m_options.add_option(
+        MDL_JIT_OPTION_OBJECT_CACHE_DIR,
+        "",
+        "The directory of the persistent native object code cache (disabled if empty)");
+    m_options.add_option(
+        MDL_JIT_OPTION_TARGET_CPU,
+        "",
+        "The CPU native code is tuned for (\"host\" or an LLVM CPU name, generic if empty)");
+    m_options.add_option(
+        MDL_JIT_OPTION_TARGET_FEATURES,
+        "",
+        "Comma separated target features for native code, e.g. \"+avx2,+fma\"");
     m_options.add_option(
         MDL_JIT_OPTION_USE_BITANGENT,
         "false",
@@ -189,6 +205,7 @@ IGenerated_code_lambda_function *Code_generator_jit::compile_into_environment(
         /*incremental=*/false,
         get_state_mapping(),
         &res_manag, /*enable_debug=*/false);
+    code_gen.set_statistics(&code->access_statistics());
 
     llvm::Function *func = code_gen.compile_environment_lambda(
         /*incremental=*/false, *lambda, resolver);
@@ -351,6 +368,7 @@ IGenerated_code_lambda_function *Code_generator_jit::compile_into_const_function
         get_state_mapping(),
         &res_manag,
         /*enable_debug=*/false);
+    code_gen.set_statistics(&code->access_statistics());
 
     if (llvm::Function *func = code_gen.compile_const_lambda(
             *lambda, resolver, attr, world_to_object, object_to_world, object_id))
@@ -429,6 +447,7 @@ IGenerated_code_lambda_function *Code_generator_jit::compile_into_switch_functio
         /*incremental=*/false,
         get_state_mapping(),
         &res_manag, /*enable_debug=*/false);
+    code_gen.set_statistics(&code->access_statistics());
 
     // Enable the read-only data segment
     code_gen.enable_ro_data_segment();
@@ -519,6 +538,7 @@ IGenerated_code_executable *Code_generator_jit::compile_into_switch_function_for
         /*incremental=*/false,
         get_state_mapping(),
         &res_manag, /*enable_debug=*/false);
+    code_gen.set_statistics(&code->access_statistics());
 
     // Enable the read-only data segment
     code_gen.enable_ro_data_segment();
@@ -607,6 +627,7 @@ IGenerated_code_lambda_function *Code_generator_jit::compile_into_generic_functi
         /*incremental=*/false,
         get_state_mapping(),
         &res_manag, /*enable_debug=*/false);
+    code_gen.set_statistics(&code->access_statistics());
 
     llvm::Function *func = code_gen.compile_generic_lambda(
         /*incremental=*/false, *lambda, resolver, transformer);
@@ -687,6 +708,7 @@ IGenerated_code_executable *Code_generator_jit::compile_into_llvm_ir(
         /*incremental=*/false,
         get_state_mapping(),
         &res_manag, /*enable_debug=*/false);
+    code_gen.set_statistics(&code->access_statistics());
 
     // enable name mangling
     code_gen.enable_name_mangling();
@@ -778,6 +800,7 @@ IGenerated_code_executable *Code_generator_jit::compile_distribution_function_cp
         /*incremental=*/false,
         get_state_mapping(),
         &res_manag, /*enable_debug=*/false);
+    code_gen.set_statistics(&code->access_statistics());
 
     LLVM_code_generator::Function_vector llvm_funcs(get_allocator());
     llvm::Module *module = code_gen.compile_distribution_function(
@@ -853,6 +876,7 @@ IGenerated_code_executable *Code_generator_jit::compile_distribution_function_gp
         /*incremental=*/false,
         get_state_mapping(),
         &res_manag, /*enable_debug=*/false);
+    code_gen.set_statistics(&code->access_statistics());
 
     // enable name mangling
     code_gen.enable_name_mangling();
@@ -1017,6 +1041,7 @@ IGenerated_code_executable *Code_generator_jit::compile_into_ptx(
         /*incremental=*/false,
         get_state_mapping(),
         &res_manag, /*enable_debug=*/false);
+    code_gen.set_statistics(&code->access_statistics());
 
     // enable name mangling
     code_gen.enable_name_mangling();
@@ -1302,6 +1327,7 @@ Link_unit_jit::Link_unit_jit(
     }
 
     m_code_gen.set_resource_manag(m_res_manag);
+    m_code_gen.set_statistics(&access_statistics());
 }
 
 // Destructor.
@@ -1457,6 +1483,29 @@ llvm::LLVMContext *Link_unit_jit::get_llvm_context()
     }
     return &m_source_only_llvm_context;
 }
+
+// Get write access to the compile statistics of the generated code.
+Compile_statistics &Link_unit_jit::access_statistics()
+{
+    switch (m_target_kind)
+    {
+    case TK_NATIVE:
+        {
+            mi::base::Handle<Generated_code_lambda_function> native_code(
+                m_code->get_interface<mi::mdl::Generated_code_lambda_function>());
+            return native_code->access_statistics();
+        }
+    case TK_CUDA_PTX:
+    case TK_LLVM_IR:
+    default:
+        {
+            mi::base::Handle<Generated_code_source> source_code(
+                m_code->get_interface<mi::mdl::Generated_code_source>());
+            return source_code->access_statistics();
+        }
+    }
+}
+
 // Add a lambda function to this link unit.
 bool Link_unit_jit::add(
     ILambda_function const    *ilambda,
@@ -241,6 +241,9 @@ private:
     /// Get the LLVM context to use with this link unit.
     llvm::LLVMContext *get_llvm_context();
 
+    /// Get write access to the compile statistics of the generated code.
+    Compile_statistics &access_statistics();
+
 private:
     /// The kind of targeted code.
     Target_kind m_target_kind;
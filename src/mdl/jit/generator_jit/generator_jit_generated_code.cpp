@@ -647,6 +647,12 @@ Messages const &Generated_code_jit::access_messages() const
     return m_messages;
 }
 
+// Access the compile statistics.
+Compile_statistics const &Generated_code_jit::access_statistics() const
+{
+    return m_statistics;
+}
+
 // Acquires a const interface.
 mi::base::IInterface const *Generated_code_jit::get_interface(
     mi::base::Uuid const &interface_id) const
@@ -846,6 +852,12 @@ Messages const &Generated_code_source::access_messages() const
     return m_messages;
 }
 
+// Access the compile statistics.
+Compile_statistics const &Generated_code_source::access_statistics() const
+{
+    return m_statistics;
+}
+
 // Returns the assembler code of the executable code module if available.
 char const *Generated_code_source::get_source_code(size_t &size) const
 {
@@ -1045,6 +1057,12 @@ Messages const &Generated_code_lambda_function::access_messages() const
     return m_messages;
 }
 
+// Access the compile statistics.
+Compile_statistics const &Generated_code_lambda_function::access_statistics() const
+{
+    return m_statistics;
+}
+
 // Returns the assembler code of the executable code module if available.
 char const *Generated_code_lambda_function::get_source_code(size_t &size) const
 {
@@ -202,6 +202,9 @@ public:
     /// Access messages.
     Messages const &access_messages() const MDL_FINAL;
 
+    /// Access the compile statistics.
+    Compile_statistics const &access_statistics() const MDL_FINAL;
+
     /// Acquires a const interface.
     ///
     /// If this interface is derived from or is the interface with the passed
@@ -300,6 +303,9 @@ private:
     /// Retrieve the PTX code.
     char const *get_ptx_code() const { return m_ptx_code.c_str(); }
 
+    /// Write access to the compile statistics.
+    Compile_statistics &access_statistics() { return m_statistics; }
+
 private:
     /// The allocator builder.
     mutable Allocator_builder m_builder;
@@ -316,6 +322,9 @@ private:
     /// The messages if any.
     Messages_impl m_messages;
 
+    /// The compile statistics.
+    Compile_statistics m_statistics;
+
     /// Generated PTX code if any.
     string m_ptx_code;
 
@@ -404,6 +413,9 @@ public:
     /// Access messages.
     Messages const &access_messages() const MDL_FINAL;
 
+    /// Access the compile statistics.
+    Compile_statistics const &access_statistics() const MDL_FINAL;
+
     /// Returns the source code of the module if available.
     ///
     /// \param size  will be assigned to the length of the assembler code
@@ -453,6 +465,9 @@ public:
     /// Write access to the messages.
     Messages_impl &access_messages() { return m_messages; }
 
+    /// Write access to the compile statistics.
+    Compile_statistics &access_statistics() { return m_statistics; }
+
     /// Set the Read-Only data segment.
     void set_ro_segment(char const *data, size_t size) {
         m_ro_segment.assign(data, data + size);
@@ -504,6 +519,9 @@ private:
     /// The Messages.
     Messages_impl m_messages;
 
+    /// The compile statistics.
+    Compile_statistics m_statistics;
+
     /// The source code.
     string m_src_code;
 
@@ -696,6 +714,9 @@ public:
     /// Access messages.
     Messages const &access_messages() const MDL_FINAL;
 
+    /// Access the compile statistics.
+    Compile_statistics const &access_statistics() const MDL_FINAL;
+
     /// Returns the source code of the module if available.
     ///
     /// \param size  will be assigned to the length of the assembler code
@@ -742,6 +763,9 @@ public:
     /// Write access to the messages.
     Messages_impl &access_messages() { return m_messages; }
 
+    /// Write access to the compile statistics.
+    Compile_statistics &access_statistics() { return m_statistics; }
+
     /// Initialize a JIT compiled lambda function.
     ///
     /// \param[in] ctx          a used defined context parameter
@@ -1220,6 +1244,9 @@ private:
     /// The Messages.
     Messages_impl m_messages;
 
+    /// The compile statistics.
+    Compile_statistics m_statistics;
+
     /// The resource helper objects for this function.
     Res_data m_res_data;
 
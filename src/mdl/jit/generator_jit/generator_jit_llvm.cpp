@@ -33,6 +33,7 @@
 
 #include <base/system/stlext/i_stlext_restore.h>
 #include <base/system/stlext/i_stlext_binary_cast.h>
+#include <base/system/version/i_version.h>
 
 #include <vector>
 #include <algorithm>
@@ -44,6 +45,9 @@
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/ExecutionEngine/JIT.h>
 #include <llvm/ExecutionEngine/JITEventListener.h>
+#include <llvm/ExecutionEngine/MCJIT.h>
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <llvm/ExecutionEngine/SectionMemoryManager.h>
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/DerivedTypes.h>
 #include <llvm/IR/Function.h>
@@ -51,16 +55,20 @@
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
+#include <llvm/MC/MCSubtargetInfo.h>
 #include <llvm/Support/CodeGen.h>
 #include <llvm/Support/Dwarf.h>
 #include <llvm/Support/DynamicLibrary.h>
+#include <llvm/Support/FileSystem.h>
 #include <llvm/Support/FormattedStream.h>
+#include <llvm/Support/Host.h>
 #include <llvm/Support/ManagedStatic.h>
 #include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/MutexGuard.h>
 #include <llvm/Support/PrettyStackTrace.h>
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Support/TargetRegistry.h>
+#include <llvm/Target/TargetMachine.h>
 #include <llvm/Transforms/IPO.h>
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
 #include <llvm/DIBuilder.h>
@@ -77,6 +85,7 @@
 #include "mdl/codegenerators/generator_dag/generator_dag_tools.h"
 #include "mdl/codegenerators/generator_dag/generator_dag_walker.h"
 #include "mdl/codegenerators/generator_code/generator_code.h"
+#include "mdl/codegenerators/generator_code/generator_code_hash.h"
 
 #include "generator_jit_llvm.h"
 #include "generator_jit_llvm_passes.h"
@@ -169,6 +178,156 @@ float exp2f(const float x)
     return ::powf(2.0f, x);
 }
 
+/// An LLVM object cache storing the object code of exactly one module in a directory.
+///
+/// The file name is an MD5 hash of the module bitcode, the target machine settings and the
+/// SDK build, so any change of the generated LLVM IR, the target or the code generator results
+/// in a new entry.
+class Object_code_cache : public llvm::ObjectCache
+{
+public:
+    /// Constructor.
+    ///
+    /// \param llvm_module     the LLVM module whose object code is cached
+    /// \param cache_dir       the cache directory
+    /// \param target_machine  the target machine the object code is generated with
+    Object_code_cache(
+        llvm::Module const        &llvm_module,
+        char const                *cache_dir,
+        llvm::TargetMachine const &target_machine)
+    : m_cache_dir(cache_dir)
+    {
+        MISTD::string bitcode;
+        {
+            llvm::raw_string_ostream os(bitcode);
+            llvm::WriteBitcodeToFile(&llvm_module, os);
+        }
+
+        MD5_hasher hasher;
+
+        // bump this if the object code changes without a change of the LLVM IR
+        hasher.update("MDL JIT object code 2");
+
+        // LLVM is built with the SDK, so the SDK build identifies the code generator, too
+        hasher.update(MI::VERSION::get_platform_version());
+        hasher.update(MI::VERSION::get_platform_date());
+        hasher.update(target_machine.getTargetTriple().str().c_str());
+        hasher.update(target_machine.getTargetCPU().str().c_str());
+        hasher.update(target_machine.getTargetFeatureString().str().c_str());
+        hasher.update(mi::Uint32(target_machine.getOptLevel()));
+        hasher.update(mi::Uint32(target_machine.Options.AllowFPOpFusion));
+
+        hasher.update((unsigned char const *)bitcode.data(), bitcode.size());
+
+        unsigned char key[16];
+        hasher.final(key);
+
+        static char const hex[] = "0123456789abcdef";
+        MISTD::string name;
+        for (size_t i = 0; i < 16; ++i) {
+            name += hex[key[i] >> 4];
+            name += hex[key[i] & 0x0F];
+        }
+        m_file_name = m_cache_dir + "/" + name + ".o";
+    }
+
+    /// Store the object code of the module into the cache.
+    ///
+    /// The code is written to a temporary file first, so concurrent processes never
+    /// see a partially written entry.
+    void notifyObjectCompiled(llvm::Module const *, llvm::MemoryBuffer const *obj) LLVM_OVERRIDE
+    {
+        if (llvm::sys::fs::create_directories(m_cache_dir))
+            return;
+
+        int fd = -1;
+        llvm::SmallString<128> tmp_name;
+        if (llvm::sys::fs::createUniqueFile(m_file_name + "-%%%%%%%%.tmp", fd, tmp_name))
+            return;
+
+        bool ok;
+        {
+            llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+            os << obj->getBuffer();
+            os.close();
+            ok = !os.has_error();
+            os.clear_error();
+        }
+
+        if (!ok || llvm::sys::fs::rename(tmp_name.str(), m_file_name))
+            llvm::sys::fs::remove(tmp_name.str());
+    }
+
+    /// Load the object code of the module from the cache.
+    ///
+    /// \return a new buffer owned by the caller or NULL if the module is not cached
+    llvm::MemoryBuffer *getObject(llvm::Module const *) LLVM_OVERRIDE
+    {
+        llvm::OwningPtr<llvm::MemoryBuffer> buffer;
+        if (llvm::MemoryBuffer::getFile(
+                m_file_name, buffer, /*FileSize=*/-1, /*RequiresNullTerminator=*/false))
+            return NULL;
+
+        // reject anything that is not an object file instead of crashing the dynamic linker
+        switch (llvm::sys::fs::identify_magic(buffer->getBuffer())) {
+        case llvm::sys::fs::file_magic::elf_relocatable:
+        case llvm::sys::fs::file_magic::macho_object:
+            return buffer.take();
+        default:
+            return NULL;
+        }
+    }
+
+private:
+    /// The cache directory.
+    MISTD::string m_cache_dir;
+
+    /// The file name of the cache entry of the module.
+    MISTD::string m_file_name;
+};
+
+/// Get the LLVM target attributes for the given CPU and feature list.
+///
+/// \param cpu       the target CPU name, empty or "host" for the host CPU
+/// \param features  comma separated target features, e.g. "+avx2,-fma", may be empty
+/// \param attrs     the target attributes to append to
+///
+/// \return the LLVM name of the target CPU
+static MISTD::string get_target_attributes(
+    char const                    *cpu,
+    char const                    *features,
+    MISTD::vector<MISTD::string>  &attrs)
+{
+    MISTD::string name(cpu);
+    if (name.empty() || name == "host") {
+        name = llvm::sys::getHostCPUName();
+
+        // the host features are only available on some platforms, the CPU name implies them
+        // on all others
+        llvm::StringMap<bool> host_features;
+        if (llvm::sys::getHostCPUFeatures(host_features)) {
+            for (llvm::StringMap<bool>::const_iterator it(host_features.begin()),
+                    end(host_features.end());
+                it != end;
+                ++it)
+            {
+                attrs.push_back((it->second ? "+" : "-") + it->getKey().str());
+            }
+
+            // keep the feature string (and hence the object code cache key) stable
+            MISTD::sort(attrs.begin(), attrs.end());
+        }
+    }
+
+    // explicit features come last, so they override the host ones
+    llvm::SmallVector<llvm::StringRef, 8> parts;
+    llvm::StringRef(features).split(parts, ",", /*MaxSplit=*/-1, /*KeepEmpty=*/false);
+    for (size_t i = 0, n = parts.size(); i < n; ++i)
+        attrs.push_back(parts[i].trim().str());
+
+    return name;
+}
+
 bool Jitted_code::m_first_time_init = true;
 
 // Constructor.
@@ -176,6 +335,9 @@ Jitted_code::Jitted_code(mi::mdl::IAllocator *alloc)
 : Base(alloc)
 , m_llvm_context(NULL)
 , m_execution_engine(NULL)
+, m_target_options()
+, m_standalone_engines(0, Standalone_engine_map::hasher(), Standalone_engine_map::key_equal(), alloc)
+, m_standalone_engines_lock()
 {
     llvm::TargetOptions target_options;
 
@@ -208,6 +370,8 @@ Jitted_code::Jitted_code(mi::mdl::IAllocator *alloc)
         .setTargetOptions(target_options)
         .create();
 
+    m_target_options = target_options;
+
     // The following functions have no effect if their respective profiling
     // support wasn't enabled in the build configuration.
     m_execution_engine->RegisterJITEventListener(
@@ -271,6 +435,15 @@ Jitted_code::Jitted_code(mi::mdl::IAllocator *alloc)
 // Destructor.
 Jitted_code::~Jitted_code()
 {
+    for (Standalone_engine_map::iterator it(m_standalone_engines.begin()), end(m_standalone_engines.end());
+        it != end;
+        ++it)
+    {
+        // the engine owns the module
+        delete it->second.engine;
+        delete it->second.cache;
+    }
+
     delete m_execution_engine;
     delete m_llvm_context;
 
@@ -331,9 +504,161 @@ void Jitted_code::add_llvm_module(llvm::Module *llvm_module)
     m_execution_engine->addModule(llvm_module);
 }
 
+// Create a target machine for native code of the given target CPU.
+llvm::TargetMachine *Jitted_code::create_target_machine(
+    llvm::Module *llvm_module,
+    char const   *cpu,
+    char const   *features,
+    bool         fp_fusion)
+{
+    MISTD::vector<MISTD::string> attrs;
+    MISTD::string name(get_target_attributes(cpu, features, attrs));
+
+    // the MCJIT dynamic linker cannot load COFF objects, so generate ELF on Windows
+    llvm::Triple triple(llvm_module->getTargetTriple().empty() ?
+        llvm::sys::getProcessTriple() : llvm_module->getTargetTriple());
+    if (triple.isOSWindows() && triple.getEnvironment() != llvm::Triple::ELF) {
+        triple.setEnvironment(llvm::Triple::ELF);
+        llvm_module->setTargetTriple(triple.str());
+    }
+
+    llvm::TargetOptions target_options(m_target_options);
+    if (fp_fusion)
+        target_options.AllowFPOpFusion = llvm::FPOpFusion::Fast;
+
+    // the builder does not take ownership of the module unless an engine is created
+    return llvm::EngineBuilder(llvm_module)
+        .setUseMCJIT(true)
+        .setOptLevel(llvm::CodeGenOpt::Aggressive)
+        .setTargetOptions(target_options)
+        .setMCPU(name)
+        .setMAttrs(attrs)
+        .selectTarget();
+}
+
+// Check if the given CPU name is known to the native target.
+bool Jitted_code::is_known_target_cpu(char const *cpu)
+{
+    llvm::StringRef name(cpu);
+    if (name.empty() || name == "host")
+        return true;
+
+    MISTD::string triple(llvm::sys::getProcessTriple());
+    MISTD::string error;
+    llvm::Target const *target = llvm::TargetRegistry::lookupTarget(triple, error);
+    if (target == NULL)
+        return false;
+
+    llvm::OwningPtr<llvm::MCSubtargetInfo> sti(target->createMCSubtargetInfo(triple, "", ""));
+    return sti && sti->isCPUStringValid(name);
+}
+
+// Add this LLVM module to its own execution engine.
+void Jitted_code::add_standalone_llvm_module(
+    llvm::Module *llvm_module,
+    char const   *cpu,
+    char const   *features,
+    bool         fp_fusion,
+    char const   *cache_dir)
+{
+    llvm::TargetMachine *target_machine =
+        create_target_machine(llvm_module, cpu, features, fp_fusion);
+    if (target_machine == NULL) {
+        // unknown target, fall back to the global engine
+        add_llvm_module(llvm_module);
+        return;
+    }
+
+    Object_code_cache *cache = NULL;
+    if (cache_dir[0] != '\0')
+        cache = new Object_code_cache(*llvm_module, cache_dir, *target_machine);
+
+    // takes ownership of the target machine
+    MISTD::string error;
+    llvm::ExecutionEngine *engine = llvm::EngineBuilder(llvm_module)
+        .setEngineKind(llvm::EngineKind::JIT)
+        .setUseMCJIT(true)
+        .setMCJITMemoryManager(new llvm::SectionMemoryManager())
+        .setErrorStr(&error)
+        .create(target_machine);
+
+    if (engine == NULL) {
+        // no MCJIT for this target, fall back to the global engine
+        delete cache;
+        add_llvm_module(llvm_module);
+        return;
+    }
+
+    if (cache != NULL)
+        engine->setObjectCache(cache);
+
+    // loads the object code from the cache or generates (and stores) it
+    engine->finalizeObject();
+
+    mi::base::Lock::Block block(&m_standalone_engines_lock);
+
+    Standalone_engine &entry = m_standalone_engines[llvm_module];
+    entry.engine = engine;
+    entry.cache  = cache;
+}
+
+// Add this LLVM module to its own lazily compiling execution engine.
+void Jitted_code::add_lazy_llvm_module(llvm::Module *llvm_module)
+{
+    MISTD::string error;
+    llvm::ExecutionEngine *engine = llvm::EngineBuilder(llvm_module)
+        .setEngineKind(llvm::EngineKind::JIT)
+        .setOptLevel(llvm::CodeGenOpt::Aggressive)
+        .setTargetOptions(m_target_options)
+        .setErrorStr(&error)
+        .create();
+
+    if (engine == NULL) {
+        // fall back to the global engine, the module is compiled eagerly there
+        add_llvm_module(llvm_module);
+        return;
+    }
+
+    // only this engine is switched into lazy mode, the global one still compiles eagerly
+    engine->DisableLazyCompilation(false);
+
+    mi::base::Lock::Block block(&m_standalone_engines_lock);
+
+    Standalone_engine &entry = m_standalone_engines[llvm_module];
+    entry.engine = engine;
+    entry.cache  = NULL;
+}
+
+// Get the execution engine of a module added by add_standalone_llvm_module() or
+// add_lazy_llvm_module().
+llvm::ExecutionEngine *Jitted_code::get_standalone_engine(llvm::Module const *llvm_module)
+{
+    mi::base::Lock::Block block(&m_standalone_engines_lock);
+
+    Standalone_engine_map::const_iterator it(m_standalone_engines.find(llvm_module));
+    return it != m_standalone_engines.end() ? it->second.engine : NULL;
+}
+
 // Helper: remove this module from the execution engine and delete it.
 void Jitted_code::delete_llvm_module(llvm::Module *llvm_module)
 {
+    Standalone_engine entry = { NULL, NULL };
+    {
+        mi::base::Lock::Block block(&m_standalone_engines_lock);
+
+        Standalone_engine_map::iterator it(m_standalone_engines.find(llvm_module));
+        if (it != m_standalone_engines.end()) {
+            entry = it->second;
+            m_standalone_engines.erase(it);
+        }
+    }
+    if (entry.engine != NULL) {
+        // the engine owns the module, deleting it frees the object code, too
+        delete entry.engine;
+        delete entry.cache;
+        return;
+    }
+
     m_execution_engine->removeModule(llvm_module);
 
     llvm::MutexGuard guard(m_execution_engine->lock);
@@ -346,9 +671,24 @@ void Jitted_code::delete_llvm_module(llvm::Module *llvm_module)
 // JIT compile the given LLVM function.
 void *Jitted_code::jit_compile(llvm::Function *func)
 {
+    if (llvm::ExecutionEngine *engine = get_standalone_engine(func->getParent()))
+        return engine->getPointerToFunction(func);
     return m_execution_engine->getPointerToFunction(func);
 }
 
+// Get a callable address for the given LLVM function without compiling it.
+void *Jitted_code::jit_compile_lazy(llvm::Function *func)
+{
+    llvm::ExecutionEngine *engine = get_standalone_engine(func->getParent());
+    if (engine == NULL || !engine->isCompilingLazily()) {
+        // the module was not added by add_lazy_llvm_module(), compile it eagerly
+        return jit_compile(func);
+    }
+
+    llvm::MutexGuard guard(engine->lock);
+    return engine->getPointerToFunctionOrStub(func);
+}
+
 // ----------------------------- Internal_function class -----------------------------
 
 // Constructor for an internal function.
@@ -837,11 +1177,22 @@ LLVM_code_generator::LLVM_code_generator(
 , m_jitted_code(mi::base::make_handle_dup(jitted_code))
 , m_compiler(mi::base::make_handle_dup(compiler))
 , m_messages(messages)
+, m_statistics(NULL)
 , m_module(NULL)
 , m_user_state_module(options.get_binary_option(MDL_JIT_BINOPTION_LLVM_STATE_MODULE))
 , m_func_pass_manager(NULL)
 , m_fast_math(options.get_bool_option(MDL_JIT_OPTION_FAST_MATH))
 , m_enable_ro_segment(options.get_bool_option(MDL_JIT_OPTION_ENABLE_RO_SEGMENT))
+, m_lazy_jit(!ptx_mode && options.get_bool_option(MDL_JIT_OPTION_LAZY_COMPILATION))
+, m_object_cache_dir(
+    ptx_mode ? "" : options.get_string_option(MDL_JIT_OPTION_OBJECT_CACHE_DIR),
+    jitted_code->get_allocator())
+, m_target_cpu(
+    ptx_mode ? "" : options.get_string_option(MDL_JIT_OPTION_TARGET_CPU),
+    jitted_code->get_allocator())
+, m_target_features(
+    ptx_mode ? "" : options.get_string_option(MDL_JIT_OPTION_TARGET_FEATURES),
+    jitted_code->get_allocator())
 , m_finite_math(false)
 , m_reciprocal_math(false)
 , m_runtime(create_mdl_runtime(
@@ -963,6 +1314,12 @@ LLVM_code_generator::LLVM_code_generator(
             m_opt_level = 2;
     }
 
+    if (!m_jitted_code->is_known_target_cpu(m_target_cpu.c_str())) {
+        // LLVM would silently ignore the CPU, report it and fall back to generic code
+        warning(UNKNOWN_TARGET_CPU, m_target_cpu.c_str());
+        m_target_cpu.clear();
+    }
+
     prepare_internal_functions();
 }
 
@@ -1049,6 +1406,8 @@ static void AddDeleteUnusedLibDeviceExtension(
 // Optimize LLVM code.
 bool LLVM_code_generator::optimize(llvm::Module *module)
 {
+    Phase_timer timer(m_statistics, CP_LLVM_OPTIMIZATION);
+
     if (m_ptx_mode) {
         llvm::PassManager    mpm;
         llvm::StringMap<int> values;
@@ -1099,10 +1458,34 @@ bool LLVM_code_generator::optimize(llvm::Module *module)
             AddDeleteUnusedLibDeviceExtension);
     }
 
+    // with a known target CPU, the vectorizers can use its cost model
+    llvm::OwningPtr<llvm::TargetMachine> target_machine;
+    if (!m_ptx_mode && !m_target_cpu.empty()) {
+        target_machine.reset(m_jitted_code->create_target_machine(
+            module, m_target_cpu.c_str(), m_target_features.c_str(), m_fast_math));
+        if (target_machine && m_opt_level > 1) {
+            builder.LoopVectorize = true;
+            builder.SLPVectorize  = true;
+        }
+    }
+
     llvm::PassManager mpm;
     mpm.add(new llvm::DataLayout(*get_target_layout_data()));
+    if (target_machine)
+        target_machine->addAnalysisPasses(mpm);
     builder.populateModulePassManager(mpm);
-    return mpm.run(*module);
+    bool res = mpm.run(*module);
+
+    if (m_statistics != NULL) {
+        // count the remaining instructions
+        size_t n_insts = 0;
+        for (llvm::Module::iterator FI = module->begin(), FE = module->end(); FI != FE; ++FI) {
+            for (llvm::Function::iterator BI = FI->begin(), BE = FI->end(); BI != BE; ++BI)
+                n_insts += BI->size();
+        }
+        timer.set_node_count(n_insts);
+    }
+    return res;
 }
 
 // Get an LLVM type for an MDL type.
@@ -7173,6 +7556,8 @@ llvm::Module *LLVM_code_generator::finalize_module()
 // JIT compile all functions of the given module.
 void LLVM_code_generator::jit_compile(llvm::Module *module)
 {
+    Phase_timer timer(m_statistics, CP_CODE_EMISSION);
+
     llvm::Module::FunctionListType &funcs = module->getFunctionList();
 
     // check that all functions exists
@@ -7183,6 +7568,24 @@ void LLVM_code_generator::jit_compile(llvm::Module *module)
         }
     }
 
+    if (!m_lazy_jit && (!m_object_cache_dir.empty() || !m_target_cpu.empty())) {
+        // the whole module is compiled at once for the selected target or loaded from the
+        // object code cache
+        m_jitted_code->add_standalone_llvm_module(
+            module,
+            m_target_cpu.c_str(),
+            m_target_features.c_str(),
+            m_fast_math,
+            m_object_cache_dir.c_str());
+        return;
+    }
+
+    // in lazy mode, functions are compiled through stubs on their first call
+    if (m_lazy_jit) {
+        m_jitted_code->add_lazy_llvm_module(module);
+        return;
+    }
+
     // the jitted code must take ownership of this module
     m_jitted_code->add_llvm_module(module);
 
@@ -7200,11 +7603,17 @@ void LLVM_code_generator::jit_compile(llvm::Module *module)
 namespace {
 
 /// Wrapper to "stream" an LLVM object into a string.
+///
+/// The output is collected in a large buffer and appended to the string in big chunks.
+/// The string is reserved from a size estimate up front and grows geometrically, so
+/// multi-megabyte output is not copied over and over again.
 class raw_string_ostream : public llvm::raw_ostream
 {
     /// write_impl - See raw_ostream::write_impl.
     void write_impl(char const *Ptr, size_t Size) LLVM_FINAL {
-        // FIXME: slow implementation
+        size_t needed = m_string.size() + Size;
+        if (needed > m_string.capacity())
+            m_string.reserve(MISTD::max(needed, 2 * m_string.capacity()));
         m_string.append(Ptr, Size);
     }
 
@@ -7212,8 +7621,21 @@ class raw_string_ostream : public llvm::raw_ostream
     /// counting the bytes currently in the buffer.
     uint64_t current_pos() const LLVM_FINAL { return m_string.size(); }
 
+    /// preferred_buffer_size - Return an efficient buffer size for the underlying
+    /// output mechanism.
+    size_t preferred_buffer_size() const LLVM_FINAL { return 64 * 1024; }
+
 public:
-    explicit raw_string_ostream(string &str) : m_string(str) {}
+    /// Constructor.
+    ///
+    /// \param str            the string to append to
+    /// \param expected_size  the expected number of bytes written, used to reserve the string
+    explicit raw_string_ostream(string &str, size_t expected_size = 0)
+    : m_string(str)
+    {
+        if (expected_size > 0)
+            m_string.reserve(m_string.size() + expected_size);
+    }
 
     ~raw_string_ostream() { flush(); }
 
@@ -7228,6 +7650,20 @@ private:
     string &m_string;
 };
 
+/// Estimate the size of the textual output for an LLVM module.
+///
+/// \param module           the LLVM module
+/// \param bytes_per_inst   the average number of output bytes per LLVM instruction
+size_t estimate_output_size(llvm::Module const *module, size_t bytes_per_inst)
+{
+    size_t n_insts = 0;
+    for (llvm::Module::const_iterator FI = module->begin(), FE = module->end(); FI != FE; ++FI) {
+        for (llvm::Function::const_iterator BI = FI->begin(), BE = FI->end(); BI != BE; ++BI)
+            n_insts += BI->size();
+    }
+    return n_insts * bytes_per_inst;
+}
+
 }  // anonymous
 
 // Compile the given module into PTX code.
@@ -7235,6 +7671,8 @@ void LLVM_code_generator::ptx_compile(
     llvm::Module *module,
     string       &code)
 {
+    Phase_timer timer(m_statistics, CP_CODE_EMISSION);
+
     char mcpu[16];
     char features[16];
     {
@@ -7243,7 +7681,8 @@ void LLVM_code_generator::ptx_compile(
         llvm::InterleaveSrcInPtx = true;
     }
 
-    llvm::raw_ostream *SOut = new raw_string_ostream(code);
+    // typically a few PTX instructions per LLVM instruction after inlining
+    llvm::raw_ostream *SOut = new raw_string_ostream(code, estimate_output_size(module, 40));
 
     llvm::OwningPtr<llvm::formatted_raw_ostream> Out(new llvm::formatted_raw_ostream(
         *SOut, llvm::formatted_raw_ostream::DELETE_STREAM));
@@ -7315,46 +7754,20 @@ void LLVM_code_generator::ptx_compile(
 // Compile the given module into LLVM-IR code.
 void LLVM_code_generator::llvm_ir_compile(llvm::Module *module, string &code)
 {
-    raw_string_ostream SOut(code);
+    Phase_timer timer(m_statistics, CP_CODE_EMISSION);
+
+    raw_string_ostream SOut(code, estimate_output_size(module, 48));
 
     // just print it
     module->print(SOut, NULL);
 }
 
-namespace {
-
-/// A raw_ostream that writes to an mi::mdl::string.  This is a
-/// simple adapter class. This class does not encounter output errors.
-class raw_mdl_string_ostream : public llvm::raw_ostream {
-    string &OS;
-
-    /// write_impl - See raw_ostream::write_impl.
-    void write_impl(const char *Ptr, size_t Size) MDL_OVERRIDE {
-        OS.append(Ptr, Size);
-    }
-
-    /// current_pos - Return the current position within the stream, not
-    /// counting the bytes currently in the buffer.
-    uint64_t current_pos() const MDL_OVERRIDE { return OS.size(); }
-
-public:
-    explicit raw_mdl_string_ostream(string &O) : OS(O) {}
-    ~raw_mdl_string_ostream() { flush(); }
-
-    /// str - Flushes the stream contents to the target string and returns
-    ///  the string's reference.
-    string& str() {
-        flush();
-        return OS;
-    }
-};
-
-}  // anonymous
-
 // Compile the given module into LLVM-BC code.
 void LLVM_code_generator::llvm_bc_compile(llvm::Module *module, string &code)
 {
-    raw_mdl_string_ostream Out(code);
+    Phase_timer timer(m_statistics, CP_CODE_EMISSION);
+
+    raw_string_ostream Out(code);
     llvm::WriteBitcodeToFile(module, Out);
 }
 
@@ -7509,6 +7922,8 @@ void LLVM_code_generator::disable_function_instancing()
 // Get the address of a JIT compiled LLVM function.
 void *LLVM_code_generator::get_entry_point(llvm::Function *func)
 {
+    if (m_lazy_jit)
+        return m_jitted_code->jit_compile_lazy(func);
     return m_jitted_code->jit_compile(func);
 }
 
@@ -7531,6 +7946,14 @@ void LLVM_code_generator::error(int code, char const *str_param)
     error(code, Error_params(get_allocator()).add(str_param));
 }
 
+/// Add a compiler warning message to the messages.
+void LLVM_code_generator::warning(int code, char const *str_param)
+{
+    string msg(m_messages.format_msg(
+        code, MESSAGE_CLASS, Error_params(get_allocator()).add(str_param)));
+    m_messages.add_warning_message(code, MESSAGE_CLASS, 0, NULL, msg.c_str());
+}
+
 // Find the definition of a signature of a standard library function.
 mi::mdl::IDefinition const *LLVM_code_generator::find_stdlib_signature(
     char const *module_name,
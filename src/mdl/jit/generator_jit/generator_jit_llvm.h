@@ -41,12 +41,14 @@
 #include <llvm/IR/GlobalVariable.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/Support/Compiler.h>
+#include <llvm/Target/TargetOptions.h>
 #include <llvm/DebugInfo.h>
 
 #include <mi/mdl/mdl_types.h>
 #include <mi/mdl/mdl_declarations.h>
 #include <mi/mdl/mdl_generated_dag.h>
 #include <mdl/compiler/compilercore/compilercore_memory_arena.h>
+#include <mdl/compiler/compilercore/compilercore_statistics.h>
 #include <mdl/compiler/compilercore/compilercore_function_instance.h>
 
 #include "generator_jit_type_map.h"
@@ -59,6 +61,7 @@ namespace llvm {
     class ExecutionEngine;
     class Function;
     class Module;
+    class TargetMachine;
 }  // llvm
 
 namespace mi {
@@ -81,6 +84,7 @@ class Lambda_function;
 class Distribution_function;
 class MDL;
 class MDL_runtime_creator;
+class Object_code_cache;
 
 /// The Jitted code interface holds jitted code.
 class IJitted_code : public
@@ -104,6 +108,48 @@ public:
     /// \param llvm_module  the LLVM module, takes ownership
     void add_llvm_module(llvm::Module *llvm_module);
 
+    /// Add this LLVM module to its own execution engine, generating code for the given target
+    /// CPU and optionally reusing object code from a persistent cache directory.
+    ///
+    /// If the cache contains object code for this module, LLVM code generation is skipped,
+    /// otherwise the generated object code is stored into the cache.
+    ///
+    /// \param llvm_module  the LLVM module, takes ownership
+    /// \param cpu          the target CPU name, empty or "host" for the host CPU
+    /// \param features     comma separated target features (e.g. "+avx2,-fma"), may be empty
+    /// \param fp_fusion    if true, floating point operations may be fused (FMA)
+    /// \param cache_dir    the directory of the object code cache, empty if disabled
+    void add_standalone_llvm_module(
+        llvm::Module *llvm_module,
+        char const   *cpu,
+        char const   *features,
+        bool         fp_fusion,
+        char const   *cache_dir);
+
+    /// Add this LLVM module to its own execution engine that compiles functions lazily.
+    ///
+    /// \param llvm_module  the LLVM module, the engine takes ownership of it
+    void add_lazy_llvm_module(llvm::Module *llvm_module);
+
+    /// Check if the given CPU name is known to the native target.
+    ///
+    /// \param cpu  the target CPU name, empty or "host" for the host CPU
+    bool is_known_target_cpu(char const *cpu);
+
+    /// Create a target machine for native code of the given target CPU.
+    ///
+    /// \param llvm_module  the LLVM module code will be generated for
+    /// \param cpu          the target CPU name, empty or "host" for the host CPU
+    /// \param features     comma separated target features (e.g. "+avx2,-fma"), may be empty
+    /// \param fp_fusion    if true, floating point operations may be fused (FMA)
+    ///
+    /// \return the new target machine owned by the caller or NULL if the target is unknown
+    llvm::TargetMachine *create_target_machine(
+        llvm::Module *llvm_module,
+        char const   *cpu,
+        char const   *features,
+        bool         fp_fusion);
+
     /// Remove this module from the execution engine and delete it.
     ///
     /// \param llvm_module  the LLVM module
@@ -118,6 +164,17 @@ public:
     /// \note: the module of this function must be added in advance
     void *jit_compile(llvm::Function *func);
 
+    /// Get a callable address for the given LLVM function without compiling it.
+    ///
+    /// \param func  the LLVM function
+    ///
+    /// \return The address of a stub that compiles the function on its first call.
+    ///
+    /// \note: the module of this function must be added in advance by
+    ///        add_lazy_llvm_module(), functions of other modules are compiled eagerly.
+    ///        First calls of stubs are serialized by the lock of the module's engine.
+    void *jit_compile_lazy(llvm::Function *func);
+
     /// Get the only instance.
     ///
     /// \param alloc    the allocator
@@ -146,6 +203,14 @@ private:
     /// One time LLVM initialization.
     static void init_llvm();
 
+    /// Get the execution engine of a module added by add_standalone_llvm_module() or
+    /// add_lazy_llvm_module().
+    ///
+    /// \param llvm_module  the LLVM module
+    ///
+    /// \return the engine or NULL, if the module belongs to the global engine
+    llvm::ExecutionEngine *get_standalone_engine(llvm::Module const *llvm_module);
+
 private:
     // NOT implemented
     Jitted_code(Jitted_code const &) LLVM_DELETED_FUNCTION;
@@ -166,6 +231,24 @@ private:
 
     /// The global ExecutionEngine.
     llvm::ExecutionEngine *m_execution_engine;
+
+    /// The target options of all execution engines.
+    llvm::TargetOptions m_target_options;
+
+    /// An execution engine owning exactly one module and its optional object code cache.
+    struct Standalone_engine {
+        llvm::ExecutionEngine *engine;
+        Object_code_cache     *cache;
+    };
+
+    typedef ptr_hash_map<llvm::Module const, Standalone_engine>::Type Standalone_engine_map;
+
+    /// The execution engines of modules added by add_standalone_llvm_module() or
+    /// add_lazy_llvm_module().
+    Standalone_engine_map m_standalone_engines;
+
+    /// The lock protecting m_standalone_engines.
+    mi::base::Lock m_standalone_engines_lock;
 };
 
 ///
@@ -1120,6 +1203,13 @@ public:
     /// Retrieve the div-by-zero reporting routine.
     llvm::Function *get_div_by_zero() const;
 
+    /// Retrieve the runtime function implementing a measured BSDF accessor of libbsdf.
+    ///
+    /// \param name  the name of the accessor, for example "bsdf_measurement_evaluate"
+    ///
+    /// \returns NULL if no resource handler is available
+    llvm::Function *get_libbsdf_bsdf_measurement_func(llvm::StringRef name) const;
+
     /// Compile the given module into PTX code.
     ///
     /// \param module       the LLVM module to JIT compile
@@ -1138,6 +1228,12 @@ public:
     /// \param code         will be filled with the LLVM-BC code
     void llvm_bc_compile(llvm::Module *module, string &code);
 
+    /// Set the statistics into which the LLVM optimization and code emission phases
+    /// are recorded.
+    ///
+    /// \param stats  the statistics, may be NULL
+    void set_statistics(Compile_statistics *stats) { m_statistics = stats; }
+
     /// Set a call transformer for DAG calls.
     ///
     /// \param transformer  the call transformer
@@ -2134,10 +2230,16 @@ private:
 
     /// JIT compile all functions of the given module.
     ///
+    /// If lazy compilation is enabled, the module is only added to the JIT and its functions
+    /// are compiled on their first call.
+    ///
     /// \param module  the LLVM module to JIT compile
     void jit_compile(llvm::Module *module);
 
     /// Get the address of a JIT compiled LLVM function.
+    ///
+    /// If lazy compilation is enabled, this returns a stub that compiles the function
+    /// on its first call.
     void *get_entry_point(llvm::Function *func);
 
     /// Get the number of error messages.
@@ -2183,6 +2285,12 @@ private:
         error(code, str_param.c_str());
     }
 
+    /// Add a JIT backend warning message to the messages.
+    ///
+    /// \param code    the code of the warning message
+    /// \param param   a string parameter for the warning message
+    void warning(int code, char const *str_param);
+
     /// Create a runtime.
     ///
     /// \param arena_builder        an arena builder
@@ -2346,6 +2454,21 @@ private:
         llvm::BasicBlock::iterator &ii,
         Function_context &ctx);
 
+    /// Translate a call to a measured BSDF accessor in a libbsdf function to a call to the
+    /// according runtime function, converting the arguments as necessary.
+    ///
+    /// \param call      the call instruction to translate
+    /// \param ii        the instruction iterator, which will be updated
+    /// \param ctx       the context for the translation
+    /// \param name      the name of the accessor without namespace and signature
+    ///
+    /// \returns false if there was any error
+    bool translate_libbsdf_bsdf_measurement_call(
+        llvm::CallInst *call,
+        llvm::BasicBlock::iterator &ii,
+        Function_context &ctx,
+        llvm::StringRef name);
+
     /// Transitively walk over the uses of the given argument and mark any calls as BSDF calls,
     /// storing the provided parameter index as "libbsdf.bsdf_param" metadata.
     ///
@@ -2432,6 +2555,9 @@ private:
     /// The messages object.
     Messages_impl &m_messages;
 
+    /// If non-NULL, the statistics to record into.
+    Compile_statistics *m_statistics;
+
     /// The current module.
     llvm::Module *m_module;
 
@@ -2447,6 +2573,18 @@ private:
     /// If true, the read-only segment generation is enabled.
     bool m_enable_ro_segment;
 
+    /// If true, native code is compiled lazily on the first call of a function.
+    bool m_lazy_jit;
+
+    /// If non-empty, the directory of the persistent object code cache.
+    string m_object_cache_dir;
+
+    /// If non-empty, the CPU native code is tuned for ("host" for the host CPU).
+    string m_target_cpu;
+
+    /// Comma separated target features added to the ones of m_target_cpu.
+    string m_target_features;
+
     /// If true, finite-math-only transformations are enabled.
     bool m_finite_math;
 
@@ -1005,7 +1005,8 @@ llvm::Function *LLVM_code_generator::get_libbsdf_function(IDefinition::Semantics
         SEMA_CASE(DS_INTRINSIC_DF_BACKSCATTERING_GLOSSY_REFLECTION_BSDF,
                   "backscattering_glossy_reflection_bsdf")
 
-        // Unsupported: DS_INTRINSIC_DF_MEASURED_BSDF
+        SEMA_CASE(DS_INTRINSIC_DF_MEASURED_BSDF,
+                  "measured_bsdf")
         // Unsupported: DS_INTRINSIC_DF_DIFFUSE_EDF
         // Unsupported: DS_INTRINSIC_DF_MEASURED_EDF
         // Unsupported: DS_INTRINSIC_DF_SPOT_EDF
@@ -1135,6 +1136,13 @@ bool LLVM_code_generator::translate_libbsdf_runtime_call(
     if (!mangler.demangle(func_name.data(), func_name.size()))
         demangled_name.assign(func_name.data(), func_name.size());
 
+    // measured BSDF data is only accessible via the resource handler
+    if (demangled_name.compare(0, 21, "df::bsdf_measurement_") == 0) {
+        llvm::StringRef accessor(demangled_name.c_str() + 4);  // skip "df::"
+        accessor = accessor.substr(0, accessor.find('('));
+        return translate_libbsdf_bsdf_measurement_call(call, ii, ctx, accessor);
+    }
+
     llvm::Function *func;
     LLVM_context_data *p_data;
     unsigned ret_array_size = 0;
@@ -1315,6 +1323,98 @@ bool LLVM_code_generator::translate_libbsdf_runtime_call(
     return true;
 }
 
+// Translates a call to a measured BSDF accessor in a libbsdf function to a call to the
+// according runtime function, converting the arguments as necessary.
+bool LLVM_code_generator::translate_libbsdf_bsdf_measurement_call(
+    llvm::CallInst *call,
+    llvm::BasicBlock::iterator &ii,
+    Function_context &ctx,
+    llvm::StringRef name)
+{
+    llvm::Type *orig_res_type = call->getType();
+    bool res_via_first_param = orig_res_type == m_type_mapper.get_void_type();
+
+    // insert new code before the old call
+    ctx->SetInsertPoint(call);
+
+    llvm::Function *func = get_libbsdf_bsdf_measurement_func(name);
+    if (func == NULL) {
+        // without a resource handler, the measurement is invalid and all results are zero
+        if (res_via_first_param) {
+            llvm::Value *orig_res_ptr = call->getArgOperand(0);
+            ctx->CreateStore(
+                llvm::Constant::getNullValue(orig_res_ptr->getType()->getPointerElementType()),
+                orig_res_ptr);
+        } else
+            call->replaceAllUsesWith(llvm::Constant::getNullValue(orig_res_type));
+
+        // Remove old call and let iterator point to instruction before old call
+        ii = ii->getParent()->getInstList().erase(call)->getPrevNode();
+        return true;
+    }
+
+    llvm::FunctionType *func_type = func->getFunctionType();
+    llvm::SmallVector<llvm::Value *, 8> llvm_args;
+
+    // The runtime functions return results via an array pointer as first parameter,
+    // while the libbsdf accessors use a reference to a vector struct.
+    llvm::Value *orig_res_ptr = NULL;
+    llvm::Value *runtime_res_ptr = NULL;
+    if (res_via_first_param) {
+        orig_res_ptr = call->getArgOperand(0);
+        runtime_res_ptr = ctx.create_local(
+            func_type->getParamType(0)->getPointerElementType(), "runtime_call_result");
+        llvm_args.push_back(runtime_res_ptr);
+    }
+
+    // pass resource_data parameter
+    MDL_ASSERT(ctx.get_resource_data_parameter() != NULL);
+    llvm_args.push_back(ctx.get_resource_data_parameter());
+
+    // handle all remaining arguments
+    unsigned n_args = call->getNumArgOperands();
+    for (unsigned i = res_via_first_param ? 1 : 0; i < n_args; ++i) {
+        llvm::Value *arg = call->getArgOperand(i);
+        llvm::Type *arg_type = arg->getType();
+        llvm::Type *param_type = func_type->getParamType(llvm_args.size());
+
+        // are argument and parameter types identical?
+        if (arg_type == param_type)
+            llvm_args.push_back(arg);
+        else if (llvm::isa<llvm::PointerType>(arg_type) &&
+            llvm::isa<llvm::PointerType>(param_type))
+        {
+            // convert from the vector struct to the array representation
+            llvm::Type *param_elem_type = param_type->getPointerElementType();
+            llvm::Value *val = ctx.load_and_convert(param_elem_type, arg);
+
+            llvm::Value *convert_tmp_ptr = ctx.create_local(param_elem_type, "convert_tmp");
+            ctx->CreateStore(val, convert_tmp_ptr);
+
+            llvm_args.push_back(convert_tmp_ptr);
+        } else {
+            MDL_ASSERT(!"Unsupported parameter conversion");
+            return false;
+        }
+    }
+
+    llvm::Value *res = ctx->CreateCall(func, llvm_args);
+
+    if (orig_res_ptr != NULL) {
+        // Case: f(&res,a,b) with f_r(&res_array,a,b)
+        llvm::Type *orig_res_elem_type = orig_res_ptr->getType()->getPointerElementType();
+        ctx->CreateStore(ctx.load_and_convert(orig_res_elem_type, runtime_res_ptr), orig_res_ptr);
+    } else {
+        // Case: res = f(a,b)
+        MDL_ASSERT(res->getType() == orig_res_type);
+        call->replaceAllUsesWith(res);
+    }
+
+    // Remove old call and let iterator point to instruction before old call
+    ii = ii->getParent()->getInstList().erase(call)->getPrevNode();
+    return true;
+}
+
 // Transitively walk over the uses of the given argument and mark any calls as BSDF calls,
 // storing the provided parameter index as "libbsdf.bsdf_param" metadata.
 void LLVM_code_generator::mark_bsdf_calls(llvm::Argument *arg, int bsdf_param_idx)
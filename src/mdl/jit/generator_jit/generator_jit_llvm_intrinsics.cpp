@@ -928,6 +928,83 @@ bool df_bsdf_measurement_isvalid(
     }
 }
 
+/// Glue function for evaluating a measured BSDF
+void df_bsdf_measurement_evaluate(
+    float               result[3],
+    Res_data_pair const *data,
+    unsigned            texture,
+    float const         theta_phi_in[2],
+    float const         theta_phi_out[2],
+    unsigned            part)
+{
+    Res_data const          *res_data = data->get_shared_data();
+    IResource_handler const *handler  = res_data->get_resource_handler();
+    if (handler != NULL && texture != 0) {
+        handler->bm_evaluate(
+            result, res_data->get_resource_store(texture - 1), data->get_thread_data(),
+            theta_phi_in, theta_phi_out, part);
+    } else {
+        result[0] = result[1] = result[2] = 0.0f;
+    }
+}
+
+/// Glue function for importance sampling a measured BSDF
+void df_bsdf_measurement_sample(
+    float               result[3],
+    Res_data_pair const *data,
+    unsigned            texture,
+    float const         theta_phi_in[2],
+    float const         xi[3],
+    unsigned            part)
+{
+    Res_data const          *res_data = data->get_shared_data();
+    IResource_handler const *handler  = res_data->get_resource_handler();
+    if (handler != NULL && texture != 0) {
+        handler->bm_sample(
+            result, res_data->get_resource_store(texture - 1), data->get_thread_data(),
+            theta_phi_in, xi, part);
+    } else {
+        result[0] = result[1] = result[2] = 0.0f;
+    }
+}
+
+/// Glue function for the pdf of a measured BSDF sample
+float df_bsdf_measurement_pdf(
+    Res_data_pair const *data,
+    unsigned            texture,
+    float const         theta_phi_in[2],
+    float const         theta_phi_out[2],
+    unsigned            part)
+{
+    Res_data const          *res_data = data->get_shared_data();
+    IResource_handler const *handler  = res_data->get_resource_handler();
+    if (handler != NULL && texture != 0) {
+        return handler->bm_pdf(
+            res_data->get_resource_store(texture - 1), data->get_thread_data(),
+            theta_phi_in, theta_phi_out, part);
+    } else {
+        return 0.0f;
+    }
+}
+
+/// Glue function for the directional albedos of a measured BSDF
+void df_bsdf_measurement_albedos(
+    float               result[4],
+    Res_data_pair const *data,
+    unsigned            texture,
+    float const         theta_phi_in[2])
+{
+    Res_data const          *res_data = data->get_shared_data();
+    IResource_handler const *handler  = res_data->get_resource_handler();
+    if (handler != NULL && texture != 0) {
+        handler->bm_albedos(
+            result, res_data->get_resource_store(texture - 1), data->get_thread_data(),
+            theta_phi_in);
+    } else {
+        result[0] = result[1] = result[2] = result[3] = 0.0f;
+    }
+}
+
 } // anonymous
 
 const int VPRINTF_BUFFER_ALIGNMENT = 8;  // In Bytes.
@@ -1929,6 +2006,37 @@ llvm::Function *MDL_runtime_creator::create_runtime_func(
         func->setDoesNotCapture(1); // resource_data
         MARK_NATIVE(func);  // df_bsdf_measurement_isvalid
         return func;
+    case RT_MDL_DF_BSDF_MEASUREMENT_EVALUATE:
+        func->setDoesNotThrow();
+        func->setDoesNotCapture(1); // result
+        func->setDoesNotCapture(2); // resource_data
+        func->setDoesNotCapture(4); // theta_phi_in
+        func->setDoesNotCapture(5); // theta_phi_out
+        MARK_NATIVE(func);  // df_bsdf_measurement_evaluate
+        return func;
+    case RT_MDL_DF_BSDF_MEASUREMENT_SAMPLE:
+        func->setDoesNotThrow();
+        func->setDoesNotCapture(1); // result
+        func->setDoesNotCapture(2); // resource_data
+        func->setDoesNotCapture(4); // theta_phi_in
+        func->setDoesNotCapture(5); // xi
+        MARK_NATIVE(func);  // df_bsdf_measurement_sample
+        return func;
+    case RT_MDL_DF_BSDF_MEASUREMENT_PDF:
+        func->setDoesNotThrow();
+        func->setOnlyReadsMemory();
+        func->setDoesNotCapture(1); // resource_data
+        func->setDoesNotCapture(3); // theta_phi_in
+        func->setDoesNotCapture(4); // theta_phi_out
+        MARK_NATIVE(func);  // df_bsdf_measurement_pdf
+        return func;
+    case RT_MDL_DF_BSDF_MEASUREMENT_ALBEDOS:
+        func->setDoesNotThrow();
+        func->setDoesNotCapture(1); // result
+        func->setDoesNotCapture(2); // resource_data
+        func->setDoesNotCapture(4); // theta_phi_in
+        MARK_NATIVE(func);  // df_bsdf_measurement_albedos
+        return func;
 
     case RT_MDL_BLACKBODY:
         func->setDoesNotThrow();
@@ -2496,6 +2604,10 @@ void LLVM_code_generator::register_native_runtime_functions(Jitted_code *jitted_
     REG_FUNC(df_light_profile_maximum);
     REG_FUNC2("mdl_df_light_profile_valid", df_light_profile_isvalid);
     REG_FUNC2("mdl_df_bsdf_measurement_valid", df_bsdf_measurement_isvalid);
+    REG_FUNC(df_bsdf_measurement_evaluate);
+    REG_FUNC(df_bsdf_measurement_sample);
+    REG_FUNC(df_bsdf_measurement_pdf);
+    REG_FUNC(df_bsdf_measurement_albedos);
 
     REG_FUNC2("mdl_blackbody", check_sig<FA3_FF>(mi::mdl::spectral::mdl_blackbody));
 
@@ -2963,6 +3075,31 @@ llvm::Function *LLVM_code_generator::get_div_by_zero() const
     return m_runtime->get_runtime_func(MDL_runtime_creator::RT_MDL_DIV_BY_ZERO);
 }
 
+// Retrieve the runtime function implementing a measured BSDF accessor of libbsdf.
+llvm::Function *LLVM_code_generator::get_libbsdf_bsdf_measurement_func(
+    llvm::StringRef name) const
+{
+    if (!m_runtime->has_res_handler())
+        return NULL;
+
+    MDL_runtime_creator::Runtime_function code;
+    if (name == "bsdf_measurement_isvalid")
+        code = MDL_runtime_creator::RT_MDL_DF_BSDF_MEASUREMENT_VALID;
+    else if (name == "bsdf_measurement_evaluate")
+        code = MDL_runtime_creator::RT_MDL_DF_BSDF_MEASUREMENT_EVALUATE;
+    else if (name == "bsdf_measurement_sample")
+        code = MDL_runtime_creator::RT_MDL_DF_BSDF_MEASUREMENT_SAMPLE;
+    else if (name == "bsdf_measurement_pdf")
+        code = MDL_runtime_creator::RT_MDL_DF_BSDF_MEASUREMENT_PDF;
+    else if (name == "bsdf_measurement_albedos")
+        code = MDL_runtime_creator::RT_MDL_DF_BSDF_MEASUREMENT_ALBEDOS;
+    else {
+        MDL_ASSERT(!"Unsupported measured BSDF accessor");
+        return NULL;
+    }
+    return m_runtime->get_runtime_func(code);
+}
+
 // Handle out of bounds.
 void LLVM_code_generator::mdl_out_of_bounds(
     Exc_state  &exc_state,
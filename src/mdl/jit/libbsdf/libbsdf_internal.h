@@ -221,6 +221,30 @@ namespace state
     float3 texture_tangent_v(int index);
 }
 
+// accessors of measured BSDF data, the part is 0 for reflection and 1 for transmission
+namespace df
+{
+    bool bsdf_measurement_isvalid(int measurement);
+    void bsdf_measurement_evaluate(
+        float3 &result,
+        int measurement,
+        float2 const &theta_phi_in,
+        float2 const &theta_phi_out,
+        int part);
+    void bsdf_measurement_sample(
+        float3 &result,
+        int measurement,
+        float2 const &theta_phi_in,
+        float3 const &xi,
+        int part);
+    float bsdf_measurement_pdf(
+        int measurement,
+        float2 const &theta_phi_in,
+        float2 const &theta_phi_out,
+        int part);
+    void bsdf_measurement_albedos(float4 &result, int measurement, float2 const &theta_phi_in);
+}
+
 #include "libbsdf_runtime.h"
 #include "libbsdf.h"
 
@@ -16,6 +16,7 @@
 
 #include "llvm/MC/MCInstrItineraries.h"
 #include "llvm/MC/SubtargetFeature.h"
+#include <algorithm>
 #include <string>
 
 namespace llvm {
@@ -83,6 +84,14 @@ public:
   /// bits. This version will also change all implied bits.
   uint64_t ToggleFeature(StringRef FS);
 
+  /// isCPUStringValid - Check whether the CPU string is a known processor of
+  /// this target.
+  bool isCPUStringValid(StringRef CPU) const {
+    const SubtargetFeatureKV *Found =
+      MISTD::lower_bound(ProcDesc, ProcDesc + NumProcs, CPU);
+    return Found != ProcDesc + NumProcs && StringRef(Found->Key) == CPU;
+  }
+
   /// getSchedModelForCPU - Get the machine model of a CPU.
   ///
   const MCSchedModel *getSchedModelForCPU(StringRef CPU) const;
@@ -31,9 +31,11 @@
 #if defined(LINUX)
 #include <dirent.h>
 #include <unistd.h>
+#include <sys/resource.h>
 #elif defined(WIN_NT)
 #include <mi/base/miwindows.h>
 #include <io.h>
+#include <psapi.h>
 #define access(a, b) _access(a, b)
 #else
 #include <sys/dir.h>
@@ -48,6 +50,9 @@
 #include <cstdio>
 #include <cstdlib>
 #include <vector>
+#include <map>
+#include <chrono>
+#include <thread>
 
 #include <mi/base/handle.h>
 #include <mi/mdl/mdl_generated_dag.h>
@@ -59,6 +64,9 @@
 #include <base/system/version/i_version.h>
 
 #include <mdl/compiler/compilercore/compilercore_mdl.h>
+#include <mdl/compiler/compilercore/compilercore_module_cache.h>
+#include <mdl/compiler/compilercore/compilercore_modules.h>
+#include <mdl/compiler/compilercore/compilercore_tools.h>
 
 #include "search_path.h"
 #include "getopt.h"
@@ -74,6 +82,8 @@ using mi::mdl::ISymbol;
 using mi::mdl::ISimple_name;
 using mi::mdl::IQualified_name;
 using mi::mdl::IModule;
+using mi::mdl::IModule_cache;
+using mi::mdl::Shared_module_cache;
 using mi::mdl::Messages;
 using mi::mdl::IMessage;
 using mi::mdl::IPrinter;
@@ -105,12 +115,41 @@ static void print_messages(Messages const &msgs, IPrinter *printer)
 }
 
 
+typedef MISTD::chrono::steady_clock Clock;
+
+/// Get the seconds elapsed since a time point.
+static double seconds_since(Clock::time_point start)
+{
+    return MISTD::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/// Get the peak resident set size of the process in bytes, or 0 if unknown.
+static size_t get_peak_rss()
+{
+#if defined(LINUX)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        return size_t(usage.ru_maxrss) * 1024u;
+#elif defined(WIN_NT)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return size_t(counters.PeakWorkingSetSize);
+#elif defined(MACOSX)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        return size_t(usage.ru_maxrss);
+#endif
+    return 0;
+}
+
 Mdlc::Mdlc(char const *program_name)
 : m_program(program_name)
 , m_dump_dag(false)
 , m_verbose(false)
 , m_syntax_coloring(false)
 , m_show_positions(false)
+, m_jobs(0)
+, m_print_lock()
 , m_imdl()
 , m_check_root()
 , m_internal_space("coordinate_object")
@@ -186,6 +225,10 @@ void Mdlc::usage()
         "\t\tworld\n"
         "  --show-positions\n"
         "\tShow source code position in target output.\n"
+        "  --jobs <N>\n"
+        "  -j <N>\n"
+        "\tCompile the input modules concurrently on N threads and print\n"
+        "\ta per-module timing and memory report.\n"
         "  --help\n"
         "  -?"
         "\tThis help.\n",
@@ -210,7 +253,8 @@ int Mdlc::run(int argc, char *argv[])
         /*12*/ { "internal-space",  mi::getopt::REQUIRED_ARGUMENT, NULL, 0 },
         /*13*/ { "show-positions",  mi::getopt::NO_ARGUMENT,       NULL, 0 },
         /*14*/ { "help",            mi::getopt::NO_ARGUMENT,       NULL, '?' },
-        /*15*/ { NULL,              0,                             NULL, 0 }
+        /*15*/ { "jobs",            mi::getopt::REQUIRED_ARGUMENT, NULL, 'j' },
+        /*16*/ { NULL,              0,                             NULL, 0 }
     };
 
     bool opt_error = false;
@@ -225,7 +269,8 @@ int Mdlc::run(int argc, char *argv[])
     mi::mdl::Options &comp_options = m_imdl->access_options();
 
     while (
-        (c = mi::getopt::getopt_long(argc, argv, "O:W:Vvp:Ct:d:B:?", long_options, &longidx)) != -1
+        (c = mi::getopt::getopt_long(
+            argc, argv, "O:W:Vvp:Ct:d:B:j:?", long_options, &longidx)) != -1
     ) {
         switch (c) {
         case 'O':
@@ -324,6 +369,24 @@ int Mdlc::run(int argc, char *argv[])
         case 'B':
             m_backend_options.push_back(mi::getopt::optarg);
             break;
+        case 'j':
+            {
+                char const *s = mi::getopt::optarg;
+                char *end = NULL;
+                long jobs = strtol(s, &end, 10);
+
+                if (end == s || *end != '\0' || jobs < 1) {
+                    fprintf(
+                        stderr,
+                        "%s error: invalid number of jobs (%s)\n",
+                        argv[0],
+                        s);
+                    opt_error = true;
+                } else {
+                    m_jobs = unsigned(jobs);
+                }
+            }
+            break;
         case '?':
             usage();
             return EXIT_SUCCESS;
@@ -413,28 +476,52 @@ int Mdlc::run(int argc, char *argv[])
         m_input_modules.push_back(argv[i]);
     }
 
-    for (String_list::const_iterator it(m_input_modules.begin()), end(m_input_modules.end());
-         it != end;
-         ++it)
-    {
-        MISTD::string const &input_module = *it;
+    if (m_jobs > 0) {
+        Clock::time_point start(Clock::now());
 
-        unsigned errors = 0;
-        mi::base::Handle<IModule const> module;
+        Result_vector results;
+        compile_parallel(results);
 
-        if (is_binary(input_module.c_str())) {
-            module = mi::base::make_handle(load_binary(input_module.c_str(), errors));
-        } else {
-            module = mi::base::make_handle(compile(input_module.c_str(), errors));
+        double total_time = seconds_since(start);
+        print_report(results, total_time);
+
+        // the backends print to stdout, run them in input order
+        for (size_t i = 0, n = results.size(); i < n; ++i) {
+            Compile_result const &r = results[i];
+
+            if (!r.module.is_valid_interface())
+                return EXIT_FAILURE;
+            err_count += r.errors;
+
+            if (m_check_root.empty()) {
+                if (!backend(r.module.get()))
+                    return EXIT_FAILURE;
+            }
         }
-        if (!module.is_valid_interface())
-            return EXIT_FAILURE;
-        err_count += errors;
+    } else {
+        for (String_list::const_iterator it(m_input_modules.begin()), end(m_input_modules.end());
+             it != end;
+             ++it)
+        {
+            MISTD::string const &input_module = *it;
+
+            unsigned errors = 0;
+            mi::base::Handle<IModule const> module;
 
-        if (m_check_root.empty()) {
-            // compile
-            if (!backend(module.get()))
+            if (is_binary(input_module.c_str())) {
+                module = mi::base::make_handle(load_binary(input_module.c_str(), errors));
+            } else {
+                module = mi::base::make_handle(compile(input_module.c_str(), errors));
+            }
+            if (!module.is_valid_interface())
                 return EXIT_FAILURE;
+            err_count += errors;
+
+            if (m_check_root.empty()) {
+                // compile
+                if (!backend(module.get()))
+                    return EXIT_FAILURE;
+            }
         }
     }
 
@@ -458,10 +545,16 @@ int Mdlc::run(int argc, char *argv[])
 }
 
 // Compile one module.
-IModule const *Mdlc::compile(char const *module_name, unsigned &errors)
+IModule const *Mdlc::compile(
+    char const    *module_name,
+    unsigned      &errors,
+    IModule_cache *cache)
 {
     mi::base::Handle<IThread_context> ctx(m_imdl->create_thread_context());
-    IModule const *module = m_imdl->load_module(ctx.get(), module_name, /*cache=*/NULL);
+    IModule const *module = m_imdl->load_module(ctx.get(), module_name, cache);
+
+    // do not interleave the messages of concurrently compiled modules
+    mi::base::Lock::Block block(&m_print_lock);
 
     mi::base::Handle<IOutput_stream> os_stderr(m_imdl->create_std_stream(IMDL::OS_STDERR));
     mi::base::Handle<IPrinter> printer(m_imdl->create_printer(os_stderr.get()));
@@ -482,6 +575,103 @@ IModule const *Mdlc::compile(char const *module_name, unsigned &errors)
     return module;
 }
 
+// Compile all input modules on a pool of m_jobs threads.
+void Mdlc::compile_parallel(Result_vector &results)
+{
+    MISTD::vector<MISTD::string> names(m_input_modules.begin(), m_input_modules.end());
+    results.clear();
+    results.resize(names.size());
+
+    mi::base::Handle<mi::base::IAllocator> alloc(m_imdl->get_mdl_allocator());
+
+    Shared_module_cache cache(alloc.get());
+    mi::base::Lock      queue_lock;
+    size_t              next = 0;
+
+    struct Worker {
+        static void run(
+            Mdlc                               *self,
+            MISTD::vector<MISTD::string> const *names,
+            Result_vector                      *results,
+            Shared_module_cache                *cache,
+            mi::base::Lock                     *queue_lock,
+            size_t                             *next)
+        {
+            for (;;) {
+                size_t idx;
+                {
+                    mi::base::Lock::Block block(queue_lock);
+                    if (*next >= names->size())
+                        return;
+                    idx = (*next)++;
+                }
+
+                char const     *name = (*names)[idx].c_str();
+                Compile_result &r    = (*results)[idx];
+
+                Clock::time_point start(Clock::now());
+
+                if (self->is_binary(name)) {
+                    r.module = mi::base::make_handle(self->load_binary(name, r.errors));
+                } else {
+                    r.module = mi::base::make_handle(self->compile(name, r.errors, cache));
+                }
+                cache->enter(r.module.get());
+
+                r.wall_time = seconds_since(start);
+            }
+        }
+    };
+
+    size_t n_threads = MISTD::min(size_t(m_jobs), names.size());
+
+    MISTD::vector<MISTD::thread> threads;
+    threads.reserve(n_threads);
+    for (size_t i = 0; i < n_threads; ++i) {
+        threads.push_back(MISTD::thread(
+            &Worker::run, this, &names, &results, &cache, &queue_lock, &next));
+    }
+    for (size_t i = 0; i < n_threads; ++i) {
+        threads[i].join();
+    }
+}
+
+// Print the timing and memory report of a parallel compilation.
+//
+// Per module, "arena" is the size of the memory arena chunks allocated by the module and
+// "module" its total memory footprint including the arena. The peak resident set size can
+// only be measured for the whole process and is reported once at the end.
+void Mdlc::print_report(Result_vector const &results, double total_time)
+{
+    String_list::const_iterator name(m_input_modules.begin());
+
+    fprintf(stderr, "%s: compiled %u modules on %u threads in %.3f s\n",
+        m_program, unsigned(results.size()), m_jobs, total_time);
+    fprintf(stderr, "%10s %11s %12s %6s  %s\n",
+        "time [ms]", "arena [KiB]", "module [KiB]", "errors", "module");
+
+    for (size_t i = 0, n = results.size(); i < n; ++i, ++name) {
+        Compile_result const &r = results[i];
+
+        size_t arena_size  = 0;
+        size_t module_size = 0;
+        if (r.module.is_valid_interface()) {
+            mi::mdl::Module const *mod = mi::mdl::impl_cast<mi::mdl::Module>(r.module.get());
+            arena_size  = mod->get_arena().get_chunks_size();
+            module_size = mod->get_memory_size();
+        }
+
+        fprintf(stderr, "%10.3f %11u %12u %6u  %s\n",
+            r.wall_time * 1000.0,
+            unsigned(arena_size / 1024),
+            unsigned(module_size / 1024),
+            r.errors,
+            name->c_str());
+    }
+    fprintf(stderr, "%s: process peak RSS %u KiB\n",
+        m_program, unsigned(get_peak_rss() / 1024));
+}
+
 // Apply backend options.
 void Mdlc::apply_backend_options(mi::mdl::Options &opts)
 {
@@ -546,6 +736,15 @@ bool Mdlc::backend(IModule const *module)
             /// ... we need entries for those in the DB, hence generate them
             dag_opts.set_option( MDL_CG_DAG_OPTION_INCLUDE_LOCAL_ENTITIES, "true");
 
+            // Compile the materials of a module concurrently, unless the modules themselves
+            // are compiled in parallel (-j).
+            if (m_jobs == 0) {
+                unsigned n_threads = MISTD::thread::hardware_concurrency();
+                if (n_threads > 1)
+                    dag_opts.set_option(
+                        MDL_CG_DAG_OPTION_COMPILE_THREADS, MISTD::to_string(n_threads).c_str());
+            }
+
             apply_backend_options(dag_opts);
 
             mi::base::Handle<IGenerated_code_dag> dag(generator->compile(module));
@@ -614,6 +813,7 @@ IModule const *Mdlc::load_binary(char const *filename, unsigned &errors)
 
     IModule const *module = m_imdl->deserialize_module(&stream_deserializer);
     if (module == NULL) {
+        mi::base::Lock::Block block(&m_print_lock);
         fprintf(
             stderr, "%s: failed to open binary '%s' for reading\n", m_program, filename);
         return NULL;
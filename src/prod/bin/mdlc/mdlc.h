@@ -30,14 +30,17 @@
 #define _MDLC_ 1
 
 #include <mi/base/handle.h>
+#include <mi/base/lock.h>
 
 #include <string>
 #include <list>
+#include <vector>
 
 namespace mi {
     namespace mdl {
         class IMDL;
         class IModule;
+        class IModule_cache;
         class IGenerated_code;
         class ISyntax_coloring;
         class Options;
@@ -87,7 +90,42 @@ private:
     /// \param      errors          The number of errors detected during compilation.
     /// \returns                    NULL: Some serious error occurred and no modules was created.
     ///                             The created module.
-    mi::mdl::IModule const *compile(char const *module_name, unsigned &errors);
+    /// \param      cache           If non-NULL, a module cache shared between compilations.
+    mi::mdl::IModule const *compile(
+        char const             *module_name,
+        unsigned               &errors,
+        mi::mdl::IModule_cache *cache = NULL);
+
+    /// The result of one module compiled in parallel mode.
+    struct Compile_result {
+        /// Constructor.
+        Compile_result()
+        : module()
+        , errors(0)
+        , wall_time(0.0)
+        {
+        }
+
+        mi::base::Handle<mi::mdl::IModule const> module;  ///< The compiled module.
+        unsigned errors;                                  ///< The number of errors.
+        double   wall_time;                               ///< Compile time in seconds.
+    };
+
+    typedef MISTD::vector<Compile_result> Result_vector;
+
+    /// Compile all input modules on a pool of m_jobs threads.
+    ///
+    /// All threads share the IMDL instance and a module cache, so every dependency is
+    /// loaded only once.
+    ///
+    /// \param results  will be filled with one result per input module, in input order
+    void compile_parallel(Result_vector &results);
+
+    /// Print the timing and memory report of a parallel compilation.
+    ///
+    /// \param results     the results of compile_parallel()
+    /// \param total_time  the wall clock time of the whole compilation in seconds
+    void print_report(Result_vector const &results, double total_time);
 
     // Apply backend options.
     void apply_backend_options(mi::mdl::Options &opts);
@@ -136,6 +174,12 @@ private:
     /// True if position should be printed.
     bool m_show_positions;
 
+    /// Number of compiler threads, 0 for sequential compilation without a report.
+    unsigned m_jobs;
+
+    /// Serializes message output of concurrently compiled modules.
+    mi::base::Lock m_print_lock;
+
     /// The MDL interface.
     mi::base::Handle<mi::mdl::IMDL> m_imdl;
 
@@ -50,6 +50,7 @@
 #include <mdl/codegenerators/generator_dag/generator_dag_lambda_function.h>
 #include <mdl/codegenerators/generator_dag/generator_dag_tools.h>
 #include <mdl/codegenerators/generator_dag/generator_dag_dumper.h>
+#include <mdl/compiler/compilercore/compilercore_statistics.h>
 #include <mdl/compiler/compilercore/compilercore_streams.h>
 
 #include "backends_link_unit.h"
@@ -595,17 +596,23 @@ public:
     , m_mdl_wavelength_max(mdl_wavelength_max)
     , m_error(0)
     , m_compile_consts(compile_consts)
+    , m_statistics()
     {
     }
 
     /// Get the error code of the last operation.
     Sint32 get_error_code() const { return m_error; }
 
+    /// Get the statistics of the conversions done by this builder.
+    mi::mdl::Compile_statistics const &get_statistics() const { return m_statistics; }
+
     /// Build a lambda function from a call.
     mi::mdl::ILambda_function *env_from_call(
         MDL::Mdl_function_call const *function_call,
         char const                   *fname)
     {
+        mi::mdl::Phase_timer timer(&m_statistics, mi::mdl::CP_LAMBDA_CONVERSION);
+
         if (function_call == NULL) {
             m_error = -1;
             return NULL;
@@ -754,6 +761,8 @@ public:
         char const                       *path,
         char const                       *fname)
     {
+        mi::mdl::Phase_timer timer(&m_statistics, mi::mdl::CP_LAMBDA_CONVERSION);
+
         mi::mdl::ILambda_function::Lambda_execution_context lec
             = mi::mdl::ILambda_function::LEC_CORE;
 
@@ -826,6 +835,8 @@ public:
         const char* fname,
         bool include_geometry_normal)
     {
+        mi::mdl::Phase_timer timer(&m_statistics, mi::mdl::CP_LAMBDA_CONVERSION);
+
         mi::base::Handle<MDL::IExpression_factory> ef(MDL::get_expression_factory());
 
         // get the field corresponding to path
@@ -929,6 +940,8 @@ public:
         MDL::Mdl_compiled_material const *compiled_material,
         char const                       *path)
     {
+        mi::mdl::Phase_timer timer(&m_statistics, mi::mdl::CP_LAMBDA_CONVERSION);
+
         mi::mdl::Lambda_function *lambda = mi::mdl::impl_cast<mi::mdl::Lambda_function>(ilambda);
         mi::mdl::ILambda_function::Lambda_execution_context lec =
             mi::mdl::ILambda_function::LEC_CORE;
@@ -1073,6 +1086,9 @@ private:
 
     /// True, if constants should be compiled (else return error -4 instead)
     bool m_compile_consts;
+
+    /// The statistics of the lambda conversion.
+    mi::mdl::Compile_statistics m_statistics;
 };
 
 } // anonymous
@@ -1624,6 +1640,16 @@ Link_unit::~Link_unit()
     delete m_tc_reg;
 }
 
+// Add the compile statistics of a compiled material to the target code, once per material
+// for the instance and once per module for the module.
+void Link_unit::add_material_statistics(MDL::Mdl_compiled_material const *compiled_material)
+{
+    if (m_statistics_materials.insert(compiled_material->get_hash()).second)
+        m_target_code->add_statistics(compiled_material->get_statistics());
+    if (m_statistics_modules.insert(compiled_material->get_module_name()).second)
+        m_target_code->add_statistics(compiled_material->get_module_statistics());
+}
+
 // Add an MDL environment function call as a function to this link unit.
 Sint32 Link_unit::add_environment(
     MDL::Mdl_function_call const *function_call,
@@ -1650,6 +1676,7 @@ Sint32 Link_unit::add_environment(
         builder.env_from_call(function_call, fname));
     if (!lambda.is_valid_interface())
         return builder.get_error_code();
+    m_target_code->add_statistics(builder.get_statistics());
 
     // enumerate resources ...
     Function_enumerator enumerator(
@@ -1692,6 +1719,8 @@ Sint32 Link_unit::add_material_expression(
         builder.from_sub_expr(compiled_material, path, fname));
     if (!lambda.is_valid_interface())
         return builder.get_error_code();
+    m_target_code->add_statistics(builder.get_statistics());
+    add_material_statistics(compiled_material);
 
     // Enumerate resources ...
     Function_enumerator enumerator(
@@ -1762,6 +1791,8 @@ Sint32 Link_unit::add_material_df(
     if (!dist_func.is_valid_interface()) {
         return lambda_builder.get_error_code();
     }
+    m_target_code->add_statistics(lambda_builder.get_statistics());
+    add_material_statistics(compiled_material);
 
     mi::base::Handle<mi::mdl::ILambda_function> main_df(
         dist_func->get_main_df());
@@ -2115,8 +2146,33 @@ Sint32 Mdl_llvm_backend::set_option(
         }
         break;
 
-    case mi::neuraylib::IMdl_compiler::MB_GLSL:
     case mi::neuraylib::IMdl_compiler::MB_NATIVE:
+        if (strcmp(name, "lazy_compilation") == 0) {
+            if (strcmp(value, "off") == 0) {
+                value = "false";
+            } else if (strcmp(value, "on") == 0) {
+                value = "true";
+            } else {
+                return -2;
+            }
+            m_jit->access_options().set_option(MDL_JIT_OPTION_LAZY_COMPILATION, value);
+            return 0;
+        }
+        if (strcmp(name, "object_cache_dir") == 0) {
+            m_jit->access_options().set_option(MDL_JIT_OPTION_OBJECT_CACHE_DIR, value);
+            return 0;
+        }
+        if (strcmp(name, "target_cpu") == 0) {
+            m_jit->access_options().set_option(MDL_JIT_OPTION_TARGET_CPU, value);
+            return 0;
+        }
+        if (strcmp(name, "target_features") == 0) {
+            m_jit->access_options().set_option(MDL_JIT_OPTION_TARGET_FEATURES, value);
+            return 0;
+        }
+        break;
+
+    case mi::neuraylib::IMdl_compiler::MB_GLSL:
     case mi::neuraylib::IMdl_compiler::MB_FORCE_32_BIT:
         break;
     }
@@ -2223,6 +2279,7 @@ mi::neuraylib::ITarget_code const *Mdl_llvm_backend::translate_environment(
     }
 
     Target_code *tc = new Target_code(code.get(), transaction, m_strings_mapped_to_ids);
+    tc->add_statistics(builder.get_statistics());
 
     // Enter the resource-table here
     fill_resource_tables(tc_reg, tc);
@@ -2336,6 +2393,9 @@ mi::neuraylib::ITarget_code const *Mdl_llvm_backend::translate_material_expressi
     }
 
     Target_code *tc = new Target_code(code.get(), transaction, m_strings_mapped_to_ids);
+    tc->add_statistics(builder.get_statistics());
+    tc->add_statistics(compiled_material->get_statistics());
+    tc->add_statistics(compiled_material->get_module_statistics());
 
     // Enter the resource-table here
     fill_resource_tables(tc_reg, tc);
@@ -2479,6 +2539,9 @@ mi::neuraylib::ITarget_code const *Mdl_llvm_backend::translate_material_expressi
     }
 
     Target_code *tc = new Target_code(code.get(), transaction, m_strings_mapped_to_ids);
+    tc->add_statistics(builder.get_statistics());
+    tc->add_statistics(compiled_material->get_statistics());
+    tc->add_statistics(compiled_material->get_module_statistics());
 
     // Enter the resource-table here
     fill_resource_tables(tc_reg, tc);
@@ -2638,6 +2701,9 @@ mi::neuraylib::ITarget_code const *Mdl_llvm_backend::translate_material_expressi
     }
 
     Target_code *tc = new Target_code(code.get(), transaction, m_strings_mapped_to_ids);
+    tc->add_statistics(builder.get_statistics());
+    tc->add_statistics(compiled_material->get_statistics());
+    tc->add_statistics(compiled_material->get_module_statistics());
 
     // Enter the resource-table here
     fill_resource_tables(tc_reg, tc);
@@ -2769,6 +2835,9 @@ const mi::neuraylib::ITarget_code* Mdl_llvm_backend::translate_material_df(
     }
 
     Target_code *tc = new Target_code(code.get(), transaction, m_strings_mapped_to_ids);
+    tc->add_statistics(lambda_builder.get_statistics());
+    tc->add_statistics(compiled_material->get_statistics());
+    tc->add_statistics(compiled_material->get_module_statistics());
 
     // Enter the resource-table here
     fill_resource_tables(tc_reg, tc);
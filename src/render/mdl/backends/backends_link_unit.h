@@ -32,6 +32,7 @@
 #define RENDER_MDL_BACKENDS_BACKENDS_LINK_UNIT_H
 
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -191,6 +192,11 @@ public:
     ~Link_unit();
 
 private:
+    /// Add the compile statistics of \p compiled_material to the target code, unless they were
+    /// already added for an earlier function of the same compiled material. The statistics of
+    /// its module are added unless they were added for an earlier material of the same module.
+    void add_material_statistics(MDL::Mdl_compiled_material const *compiled_material);
+
     /// The MDL compiler.
     mi::base::Handle<mi::mdl::IMDL> m_compiler;
 
@@ -229,6 +235,12 @@ private:
     /// The arguments of the compiled materials for which target argument blocks should be
     /// created.
     MISTD::vector<mi::base::Handle<MDL::IValue_list const> > m_arg_block_comp_material_args;
+
+    /// The hashes of the compiled materials whose statistics were added to the target code.
+    MISTD::set<mi::base::Uuid> m_statistics_materials;
+
+    /// The names of the modules whose statistics were added to the target code.
+    MISTD::set<MISTD::string> m_statistics_modules;
 };
 
 } // namespace BACKENDS
@@ -108,7 +108,9 @@ Target_code::Target_code(
     MI::DB::Transaction* transaction,
     bool string_ids)
   : m_native_code(),
-    m_code(),
+    m_source_code(),
+    m_code(""),
+    m_code_size(0),
     m_code_segments(),
     m_code_segment_descriptions(),
     m_callable_function_map(),
@@ -123,7 +125,8 @@ Target_code::Target_code(
     m_cap_arg_blocks(),
     m_rh( NULL),
     m_render_state_usage(~0u),
-    m_string_args_mapped_to_ids(string_ids)
+    m_string_args_mapped_to_ids(string_ids),
+    m_statistics()
 {
     finalize(code, transaction);
 
@@ -144,7 +147,9 @@ Target_code::Target_code(
 Target_code::Target_code(
     bool string_ids)
   : m_native_code(),
-    m_code(),
+    m_source_code(),
+    m_code(""),
+    m_code_size(0),
     m_code_segments(),
     m_code_segment_descriptions(),
     m_callable_function_map(),
@@ -159,7 +164,8 @@ Target_code::Target_code(
     m_cap_arg_blocks(),
     m_rh( NULL),
     m_render_state_usage( ~0u),
-    m_string_args_mapped_to_ids(string_ids)
+    m_string_args_mapped_to_ids(string_ids),
+    m_statistics()
 {
 }
 
@@ -185,6 +191,9 @@ void Target_code::finalize(
     m_native_code = mi::base::make_handle(
         code->get_interface<mi::mdl::IGenerated_code_lambda_function>());
     m_render_state_usage = code->get_state_usage();
+    // the LLVM optimization and code emission phases; the phases up to the lambda conversion
+    // are added by the backend via add_statistics()
+    m_statistics.merge(code->access_statistics());
 
     if (m_native_code.is_valid_interface()) {
 
@@ -192,23 +201,26 @@ void Target_code::finalize(
 
         m_native_code->init(transaction, NULL, m_rh);
     } else {
-        // only source code itself
+        // only source code itself, which can be tens of megabytes: keep the generated code
+        // alive instead of copying it
         size_t size = 0;
         char const *src = code->get_source_code(size);
 
-        m_code = MISTD::string(src, size);
+        m_source_code = mi::base::make_handle_dup(code);
+        m_code        = src != NULL ? src : "";
+        m_code_size   = src != NULL ? size : 0;
     }
 }
 
 
 const char* Target_code::get_code() const
 {
-    return m_code.c_str();
+    return m_code;
 }
 
 mi::Size Target_code::get_code_size() const
 {
-    return m_code.size();
+    return m_code_size;
 }
 
 mi::Size Target_code::get_callable_function_count() const
@@ -517,6 +529,39 @@ mi::Sint32 Target_code::execute_bsdf_pdf(
     return -2;
 }
 
+mi::Size Target_code::get_compile_phase_count() const
+{
+    return mi::mdl::CP_LAST + 1;
+}
+
+const char* Target_code::get_compile_phase_name( mi::Size index) const
+{
+    if ( index > mi::Size( mi::mdl::CP_LAST))
+        return NULL;
+    return mi::mdl::Compile_statistics::get_phase_name( mi::mdl::Compile_phase( index));
+}
+
+mi::Float64 Target_code::get_compile_phase_time( mi::Size index) const
+{
+    if ( index > mi::Size( mi::mdl::CP_LAST))
+        return 0.0;
+    return m_statistics.get( mi::mdl::Compile_phase( index)).wall_time;
+}
+
+mi::Size Target_code::get_compile_phase_allocated_bytes( mi::Size index) const
+{
+    if ( index > mi::Size( mi::mdl::CP_LAST))
+        return 0;
+    return m_statistics.get( mi::mdl::Compile_phase( index)).allocated_bytes;
+}
+
+mi::Size Target_code::get_compile_phase_node_count( mi::Size index) const
+{
+    if ( index > mi::Size( mi::mdl::CP_LAST))
+        return 0;
+    return m_statistics.get( mi::mdl::Compile_phase( index)).node_count;
+}
+
 Target_code::State_usage Target_code::get_render_state_usage() const
 {
     return m_render_state_usage;
@@ -40,6 +40,7 @@
 #include <mi/base/handle.h>
 #include <mi/base/interface_implement.h>
 #include <mi/neuraylib/imdl_compiler.h>
+#include <mi/mdl/mdl_statistics.h>
 
 #include <io/scene/mdl_elements/i_mdl_elements_compiled_material.h>
 
@@ -418,6 +419,21 @@ public:
         const Shading_state_material& state,
         const mi::neuraylib::ITarget_argument_block *cap_args) const NEURAY_OVERRIDE;
 
+    /// Returns the number of compilation phases for which statistics were recorded.
+    Size get_compile_phase_count() const NEURAY_OVERRIDE;
+
+    /// Returns the name of a compilation phase.
+    const char* get_compile_phase_name(Size index) const NEURAY_OVERRIDE;
+
+    /// Returns the accumulated wall clock time spent in a compilation phase.
+    Float64 get_compile_phase_time(Size index) const NEURAY_OVERRIDE;
+
+    /// Returns the amount of memory allocated by the compiler in a compilation phase.
+    Size get_compile_phase_allocated_bytes(Size index) const NEURAY_OVERRIDE;
+
+    /// Returns the number of nodes produced in a compilation phase.
+    Size get_compile_phase_node_count(Size index) const NEURAY_OVERRIDE;
+
     // non-API methods.
 
     /// Adds a new callable function to this target code.
@@ -503,6 +519,11 @@ public:
     /// if the string is not known.
     mi::Uint32 get_string_index(char const *string) const;
 
+    /// Add compile statistics recorded outside of the MDL code generator, for instance
+    /// during the lambda conversion or, via the compiled material, in the front-end, the DAG
+    /// generation and the material instance initialization.
+    void add_statistics(mi::mdl::Compile_statistics const &stats) { m_statistics.merge(stats); }
+
 private:
     /// Destructor.
     ~Target_code();
@@ -511,8 +532,14 @@ private:
     /// If native code was generated, its interface.
     mutable mi::base::Handle<mi::mdl::IGenerated_code_lambda_function> m_native_code;
 
-    /// The code.
-    MISTD::string m_code;
+    /// If source code was generated, the generated code owning it.
+    mi::base::Handle<mi::mdl::IGenerated_code_executable> m_source_code;
+
+    /// The code, owned by m_source_code if that is valid.
+    char const *m_code;
+
+    /// The size of the code.
+    mi::Size m_code_size;
 
     /// The code segments if any.
     MISTD::vector<MISTD::string> m_code_segments;
@@ -618,6 +645,9 @@ private:
 
     /// True, if string arguments in the target block are mapped to identifiers.
     bool m_string_args_mapped_to_ids;
+
+    /// The accumulated compile statistics.
+    mi::mdl::Compile_statistics m_statistics;
 };
 
 } // namespace BACKENDS
@@ -32,8 +32,12 @@
 #ifndef RENDER_MDL_RUNTIME_I_MDLRT_BSDF_MEASUREMENT_H
 #define RENDER_MDL_RUNTIME_I_MDLRT_BSDF_MEASUREMENT_H
 
+#include <mi/base/handle.h>
+#include <mi/neuraylib/ibsdf_isotropic_data.h>
 #include <mi/neuraylib/typedefs.h>
 
+#include <vector>
+
 #include <base/data/db/i_db_tag.h>
 #include <base/data/db/i_db_access.h>
 #include <io/scene/bsdf_measurement/i_bsdf_measurement.h>
@@ -49,14 +53,99 @@ class Bsdf_measurement
 public:
     typedef DB::Typed_tag<BSDFM::Bsdf_measurement> Tag_type;
 
+    /// The parts of a measured BSDF.
+    enum Part {
+        PART_REFLECTION   = 0,
+        PART_TRANSMISSION = 1,
+        PART_LAST         = PART_TRANSMISSION
+    };
+
     Bsdf_measurement();
 
     Bsdf_measurement(Tag_type const &tag, DB::Transaction *trans);
 
     bool is_valid() const { return m_bsdf_measurement->is_valid(); }
 
+    /// Evaluate one part of the measured BSDF.
+    ///
+    /// \param result         the RGB value, scalar data is replicated
+    /// \param theta_phi_in   the incoming direction, theta in [0, pi/2] relative to the normal
+    ///                       of the hemisphere of the part
+    /// \param theta_phi_out  the outgoing direction, theta in [0, pi/2] likewise
+    /// \param part           the part to evaluate
+    ///
+    /// Uses trilinear interpolation of the grid with clamping at the borders, the code does
+    /// not branch on the input and can be vectorized.
+    void evaluate(
+        float       result[3],
+        float const theta_phi_in[2],
+        float const theta_phi_out[2],
+        Part        part) const;
+
+    /// Importance sample an outgoing direction of one part proportional to the BSDF
+    /// times the cosine of the outgoing direction.
+    ///
+    /// \param result        the sampled theta and phi of the outgoing direction and the pdf
+    ///                      with respect to solid angle; the pdf is 0 if nothing can be sampled
+    /// \param theta_phi_in  the incoming direction
+    /// \param xi            three uniformly distributed random numbers in [0, 1)
+    /// \param part          the part to sample
+    void sample(
+        float       result[3],
+        float const theta_phi_in[2],
+        float const xi[3],
+        Part        part) const;
+
+    /// Get the pdf with respect to solid angle of sample() for the given directions.
+    float pdf(
+        float const theta_phi_in[2],
+        float const theta_phi_out[2],
+        Part        part) const;
+
+    /// Get the directional albedos for an incoming direction.
+    ///
+    /// \param result        the albedo of the reflection part for theta_phi_in, its maximum
+    ///                      over all incoming directions, and the same two values for the
+    ///                      transmission part
+    /// \param theta_phi_in  the incoming direction
+    void get_albedos(
+        float       result[4],
+        float const theta_phi_in[2]) const;
+
+private:
+    /// The precomputed tables of one part.
+    struct Part_table {
+        Part_table();
+
+        unsigned           res_theta;        // number of theta_in and theta_out samples
+        unsigned           res_phi;          // number of phi samples
+        unsigned           n_channels;       // 1 for scalar and 3 for RGB data
+        float              delta_theta;      // extent of a theta cell, pi/2 / res_theta
+        float              delta_phi;        // extent of a phi cell, pi / res_phi
+        float              inv_delta_theta;  // 1 / delta_theta
+        float              inv_delta_phi;    // 1 / delta_phi
+        float              max_albedo;       // maximum of albedo
+        mi::base::Handle<mi::neuraylib::IBsdf_buffer const>
+                           buffer;           // the buffer of the measured values
+        float const        *eval;            // the measured values, owned by buffer
+        std::vector<float> sin2_theta;       // sin^2 at the theta cell borders
+        std::vector<float> cdf_theta;        // per theta_in the marginal CDF over theta_out
+        std::vector<float> cdf_phi;          // per theta_in and theta_out the CDF over phi
+        std::vector<float> albedo;           // per theta_in the directional albedo
+    };
+
+    /// Build the tables of one part, called once per bsdf measurement.
+    static void init_part_table(
+        Part_table                                 &table,
+        mi::neuraylib::IBsdf_isotropic_data const *data);
+
+    /// Get the theta_in row of a part table.
+    static unsigned get_theta_in_index(Part_table const &table, float theta_in);
+
 protected:
     DB::Access<BSDFM::Bsdf_measurement>  m_bsdf_measurement;   // the underlying bsdf measurement
+
+    Part_table                           m_parts[PART_LAST + 1];  // tables of the parts
 };
 
 }  // MDLRT
@@ -59,6 +59,31 @@ public:
 
     bool is_valid() const { return m_light_profile->is_valid(); }
 
+    /// Evaluate the light profile in candela for the given direction.
+    ///
+    /// \param theta_phi  the polar angle theta and the azimuthal angle phi in radians
+    float evaluate(float const theta_phi[2]) const {
+        return m_light_profile->evaluate(theta_phi[1], theta_phi[0]);
+    }
+
+    /// Importance sample a direction proportional to the light profile.
+    ///
+    /// The sampling tables are owned by the light profile and built once per profile.
+    ///
+    /// \param result  the sampled polar angle theta, azimuthal angle phi and the pdf
+    ///                with respect to solid angle; the pdf is 0 if the profile is empty
+    /// \param xi      two uniformly distributed random numbers in [0, 1)
+    void sample(float result[3], float const xi[2]) const {
+        result[2] = m_light_profile->sample_direction(xi[0], xi[1], &result[1], &result[0]);
+    }
+
+    /// Get the pdf with respect to solid angle of sample() for the given direction.
+    ///
+    /// \param theta_phi  the polar angle theta and the azimuthal angle phi in radians
+    float pdf(float const theta_phi[2]) const {
+        return m_light_profile->get_pdf(theta_phi[1], theta_phi[0]);
+    }
+
 protected:
     DB::Access<LIGHTPROFILE::Lightprofile>  m_light_profile;   // the underlying light profile
 };
@@ -402,6 +402,40 @@ public:
     bool lp_isvalid(
         void const *lp_data) const NEURAY_OVERRIDE;
 
+    /// Evaluate the light profile for a given direction.
+    ///
+    /// \param lp_data      the read-only shared light profile data pointer
+    /// \param thread_data  extra per-thread data that was passed to the lambda function
+    /// \param theta_phi    the polar angle theta and the azimuthal angle phi in radians
+    ///
+    /// \returns the intensity in candela, 0 outside of the tabulated domain
+    float lp_evaluate(
+        void const  *lp_data,
+        void        *thread_data,
+        float const theta_phi[2]) const;
+
+    /// Importance sample a direction proportional to the light profile.
+    ///
+    /// \param result       the sampled theta, phi and the pdf with respect to solid angle
+    /// \param lp_data      the read-only shared light profile data pointer
+    /// \param thread_data  extra per-thread data that was passed to the lambda function
+    /// \param xi           two uniformly distributed random numbers in [0, 1)
+    void lp_sample(
+        float       result[3],
+        void const  *lp_data,
+        void        *thread_data,
+        float const xi[2]) const;
+
+    /// Get the pdf with respect to solid angle of lp_sample() for a given direction.
+    ///
+    /// \param lp_data      the read-only shared light profile data pointer
+    /// \param thread_data  extra per-thread data that was passed to the lambda function
+    /// \param theta_phi    the polar angle theta and the azimuthal angle phi in radians
+    float lp_pdf(
+        void const  *lp_data,
+        void        *thread_data,
+        float const theta_phi[2]) const;
+
     /// Initializes a bsdf measurement data helper object from a given bsdf measurement tag.
     ///
     /// \param data    an 16byte aligned pointer to allocated data of at least
@@ -432,6 +466,65 @@ public:
     bool bm_isvalid(
         void const *bm_data) const NEURAY_OVERRIDE;
 
+    /// Evaluate a measured BSDF.
+    ///
+    /// \param result         the RGB value of the BSDF
+    /// \param bm_data        the read-only shared bsdf measurement data pointer
+    /// \param thread_data    extra per-thread data that was passed to the lambda function
+    /// \param theta_phi_in   the incoming direction, theta in [0, pi/2]
+    /// \param theta_phi_out  the outgoing direction, theta in [0, pi/2]
+    /// \param part           0 for the reflection and 1 for the transmission part
+    void bm_evaluate(
+        float       result[3],
+        void const  *bm_data,
+        void        *thread_data,
+        float const theta_phi_in[2],
+        float const theta_phi_out[2],
+        unsigned    part) const NEURAY_OVERRIDE;
+
+    /// Importance sample an outgoing direction of a measured BSDF.
+    ///
+    /// \param result        the sampled theta and phi and the pdf with respect to solid angle
+    /// \param bm_data       the read-only shared bsdf measurement data pointer
+    /// \param thread_data   extra per-thread data that was passed to the lambda function
+    /// \param theta_phi_in  the incoming direction, theta in [0, pi/2]
+    /// \param xi            three uniformly distributed random numbers in [0, 1)
+    /// \param part          0 for the reflection and 1 for the transmission part
+    void bm_sample(
+        float       result[3],
+        void const  *bm_data,
+        void        *thread_data,
+        float const theta_phi_in[2],
+        float const xi[3],
+        unsigned    part) const NEURAY_OVERRIDE;
+
+    /// Get the pdf with respect to solid angle of bm_sample() for the given directions.
+    ///
+    /// \param bm_data        the read-only shared bsdf measurement data pointer
+    /// \param thread_data    extra per-thread data that was passed to the lambda function
+    /// \param theta_phi_in   the incoming direction, theta in [0, pi/2]
+    /// \param theta_phi_out  the outgoing direction, theta in [0, pi/2]
+    /// \param part           0 for the reflection and 1 for the transmission part
+    float bm_pdf(
+        void const  *bm_data,
+        void        *thread_data,
+        float const theta_phi_in[2],
+        float const theta_phi_out[2],
+        unsigned    part) const NEURAY_OVERRIDE;
+
+    /// Get the directional albedos of a measured BSDF.
+    ///
+    /// \param result        the reflection albedo for theta_phi_in and its maximum, followed
+    ///                      by the same values of the transmission part
+    /// \param bm_data       the read-only shared bsdf measurement data pointer
+    /// \param thread_data   extra per-thread data that was passed to the lambda function
+    /// \param theta_phi_in  the incoming direction, theta in [0, pi/2]
+    void bm_albedos(
+        float       result[4],
+        void const  *bm_data,
+        void        *thread_data,
+        float const theta_phi_in[2]) const NEURAY_OVERRIDE;
+
     /// Destructor.
     virtual ~Resource_handler();
 };
@@ -0,0 +1,67 @@
+/******************************************************************************
+ * Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+/** \file
+ ** \brief Helpers shared by the sampling tables of the native runtime resources.
+ **/
+
+#ifndef RENDER_MDL_RUNTIME_I_MDLRT_SAMPLING_H
+#define RENDER_MDL_RUNTIME_I_MDLRT_SAMPLING_H
+
+#include <algorithm>
+
+namespace MI {
+namespace MDLRT {
+
+/// Find the interval i with cdf[i-1] <= x < cdf[i] of a non-decreasing table of n > 0 entries.
+///
+/// Uses a fixed number of iterations without data dependent branches.
+inline unsigned find_interval(float const *cdf, unsigned n, float x)
+{
+    unsigned first = 0;
+    unsigned len   = n;
+    while (len > 0) {
+        unsigned half   = len >> 1;
+        bool     larger = cdf[first + half] <= x;
+        first = larger ? first + half + 1 : first;
+        len   = larger ? len - half - 1   : half;
+    }
+    return std::min(first, n - 1);
+}
+
+/// Remap a random number that selected the interval i of a CDF back to [0, 1].
+inline float remap_in_interval(float const *cdf, unsigned i, float x)
+{
+    float const prev = i > 0 ? cdf[i - 1] : 0.0f;
+    float const w    = cdf[i] - prev;
+    return w > 0.0f ? std::min((x - prev) / w, 1.0f) : 0.5f;
+}
+
+}  // MDLRT
+}  // MI
+
+#endif // RENDER_MDL_RUNTIME_I_MDLRT_SAMPLING_H
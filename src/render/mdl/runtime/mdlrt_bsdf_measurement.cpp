@@ -33,10 +33,62 @@
 
 #include <base/data/db/i_db_access.h>
 #include "i_mdlrt_bsdf_measurement.h"
+#include "i_mdlrt_sampling.h"
+
+#include <mi/base/handle.h>
+#include <mi/neuraylib/ibsdf_isotropic_data.h>
+
+#include <algorithm>
+#include <cmath>
 
 namespace MI {
 namespace MDLRT {
 
+namespace {
+
+float const PI      = 3.14159265358979323846f;
+float const TWO_PI  = 6.28318530717958647692f;
+float const HALF_PI = 1.57079632679489661923f;
+
+// Reduce the difference of two azimuthal angles to [0, pi], the data is symmetric in phi.
+inline float get_phi_delta(float phi_in, float phi_out)
+{
+    float d = std::fabs(phi_out - phi_in);
+    d -= d >= TWO_PI ? TWO_PI : 0.0f;
+    return d > PI ? TWO_PI - d : d;
+}
+
+// Map an angle to the cell centered grid coordinate clamped to [0, res - 1].
+inline float get_grid_coord(float angle, float inv_delta, unsigned res)
+{
+    float const c = angle * inv_delta - 0.5f;
+    return std::min(std::max(c, 0.0f), float(res - 1));
+}
+
+// Get the average of the channels of a grid value, used as sampling weight.
+inline float get_weight(float const *v, unsigned n_channels)
+{
+    float sum = v[0];
+    for (unsigned c = 1; c < n_channels; ++c)
+        sum += v[c];
+    return std::max(sum / float(n_channels), 0.0f);
+}
+
+}  // anonymous
+
+Bsdf_measurement::Part_table::Part_table()
+: res_theta(0)
+, res_phi(0)
+, n_channels(0)
+, delta_theta(0.0f)
+, delta_phi(0.0f)
+, inv_delta_theta(0.0f)
+, inv_delta_phi(0.0f)
+, max_albedo(0.0f)
+, eval(NULL)
+{
+}
+
 Bsdf_measurement::Bsdf_measurement()
 {
 }
@@ -46,6 +98,251 @@ Bsdf_measurement::Bsdf_measurement(
     DB::Transaction *trans)
 : m_bsdf_measurement(bm_t, trans)
 {
+    if (!m_bsdf_measurement->is_valid())
+        return;
+
+    mi::base::Handle<mi::neuraylib::IBsdf_isotropic_data const> reflection(
+        m_bsdf_measurement->get_reflection<mi::neuraylib::IBsdf_isotropic_data>());
+    init_part_table(m_parts[PART_REFLECTION], reflection.get());
+
+    mi::base::Handle<mi::neuraylib::IBsdf_isotropic_data const> transmission(
+        m_bsdf_measurement->get_transmission<mi::neuraylib::IBsdf_isotropic_data>());
+    init_part_table(m_parts[PART_TRANSMISSION], transmission.get());
+}
+
+// Build the tables of one part, called once per bsdf measurement.
+void Bsdf_measurement::init_part_table(
+    Part_table                                 &table,
+    mi::neuraylib::IBsdf_isotropic_data const *data)
+{
+    if (data == NULL)
+        return;
+
+    mi::base::Handle<mi::neuraylib::IBsdf_buffer const> buffer(data->get_bsdf_buffer());
+    float const *values = buffer.is_valid_interface() ? buffer->get_data() : NULL;
+
+    unsigned const res_theta  = data->get_resolution_theta();
+    unsigned const res_phi    = data->get_resolution_phi();
+    unsigned const n_channels = data->get_type() == mi::neuraylib::BSDF_SCALAR ? 1 : 3;
+    if (values == NULL || res_theta == 0 || res_phi == 0)
+        return;
+
+    table.res_theta       = res_theta;
+    table.res_phi         = res_phi;
+    table.n_channels      = n_channels;
+    table.delta_theta     = HALF_PI / float(res_theta);
+    table.delta_phi       = PI / float(res_phi);
+    table.inv_delta_theta = 1.0f / table.delta_theta;
+    table.inv_delta_phi   = 1.0f / table.delta_phi;
+
+    size_t const n_cells = size_t(res_theta) * res_theta * res_phi;
+    // the measured values are referenced, not copied; the buffer handle keeps them alive
+    table.buffer = buffer;
+    table.eval   = values;
+
+    table.sin2_theta.resize(res_theta + 1);
+    for (unsigned j = 0; j <= res_theta; ++j) {
+        float const s = std::sin(float(j) * table.delta_theta);
+        table.sin2_theta[j] = s * s;
+    }
+
+    // The grid values are constant over their cells for sampling. Covering both signs of
+    // phi_out - phi_in, the integral of cos(theta_out) over a cell is
+    // delta_phi * (sin^2(theta_1) - sin^2(theta_0)).
+    table.cdf_theta.resize(size_t(res_theta) * res_theta);
+    table.cdf_phi.resize(n_cells);
+    table.albedo.resize(res_theta);
+
+    for (unsigned i = 0; i < res_theta; ++i) {
+        float  *cdf_theta = &table.cdf_theta[size_t(i) * res_theta];
+        double row_sum    = 0.0;
+        for (unsigned j = 0; j < res_theta; ++j) {
+            size_t const cell = (size_t(i) * res_theta + j) * res_phi;
+            float  *cdf_phi   = &table.cdf_phi[cell];
+            float  const area =
+                table.delta_phi * (table.sin2_theta[j + 1] - table.sin2_theta[j]);
+
+            double phi_sum = 0.0;
+            for (unsigned k = 0; k < res_phi; ++k) {
+                phi_sum += get_weight(table.eval + (cell + k) * n_channels, n_channels);
+                cdf_phi[k] = float(phi_sum);
+            }
+            for (unsigned k = 0; k < res_phi; ++k)
+                cdf_phi[k] = phi_sum > 0.0 ?
+                    float(cdf_phi[k] / phi_sum) : float(k + 1) / float(res_phi);
+            cdf_phi[res_phi - 1] = 1.0f;
+
+            row_sum += phi_sum * area;
+            cdf_theta[j] = float(row_sum);
+        }
+        for (unsigned j = 0; j < res_theta; ++j)
+            cdf_theta[j] = row_sum > 0.0 ?
+                float(cdf_theta[j] / row_sum) : float(j + 1) / float(res_theta);
+        cdf_theta[res_theta - 1] = 1.0f;
+
+        table.albedo[i]  = float(row_sum);
+        table.max_albedo = std::max(table.max_albedo, table.albedo[i]);
+    }
+}
+
+// Get the theta_in row of a part table.
+unsigned Bsdf_measurement::get_theta_in_index(Part_table const &table, float theta_in)
+{
+    float const t = std::max(theta_in, 0.0f) * table.inv_delta_theta;
+    return std::min(unsigned(t), table.res_theta - 1);
+}
+
+// Evaluate one part of the measured BSDF.
+void Bsdf_measurement::evaluate(
+    float       result[3],
+    float const theta_phi_in[2],
+    float const theta_phi_out[2],
+    Part        part) const
+{
+    Part_table const &table = m_parts[part];
+    if (table.eval == NULL) {
+        result[0] = result[1] = result[2] = 0.0f;
+        return;
+    }
+
+    unsigned const res_theta = table.res_theta;
+    unsigned const res_phi   = table.res_phi;
+
+    float const ti = get_grid_coord(theta_phi_in[0],  table.inv_delta_theta, res_theta);
+    float const to = get_grid_coord(theta_phi_out[0], table.inv_delta_theta, res_theta);
+    float const tp = get_grid_coord(
+        get_phi_delta(theta_phi_in[1], theta_phi_out[1]), table.inv_delta_phi, res_phi);
+
+    unsigned const i0 = unsigned(ti), i1 = std::min(i0 + 1, res_theta - 1);
+    unsigned const j0 = unsigned(to), j1 = std::min(j0 + 1, res_theta - 1);
+    unsigned const k0 = unsigned(tp), k1 = std::min(k0 + 1, res_phi - 1);
+    float const fi = ti - float(i0);
+    float const fj = to - float(j0);
+    float const fk = tp - float(k0);
+
+    float const w[8] = {
+        (1.0f - fi) * (1.0f - fj) * (1.0f - fk),
+        (1.0f - fi) * (1.0f - fj) *         fk,
+        (1.0f - fi) *         fj  * (1.0f - fk),
+        (1.0f - fi) *         fj  *         fk,
+                fi  * (1.0f - fj) * (1.0f - fk),
+                fi  * (1.0f - fj) *         fk,
+                fi  *         fj  * (1.0f - fk),
+                fi  *         fj  *         fk
+    };
+    size_t const row_i0 = size_t(i0) * res_theta, row_i1 = size_t(i1) * res_theta;
+    size_t const n = table.n_channels;
+    size_t const idx[8] = {
+        ((row_i0 + j0) * res_phi + k0) * n,
+        ((row_i0 + j0) * res_phi + k1) * n,
+        ((row_i0 + j1) * res_phi + k0) * n,
+        ((row_i0 + j1) * res_phi + k1) * n,
+        ((row_i1 + j0) * res_phi + k0) * n,
+        ((row_i1 + j0) * res_phi + k1) * n,
+        ((row_i1 + j1) * res_phi + k0) * n,
+        ((row_i1 + j1) * res_phi + k1) * n
+    };
+
+    // outside of the hemispheres the BSDF of this part is zero
+    bool const inside =
+        theta_phi_in[0]  >= 0.0f && theta_phi_in[0]  <= HALF_PI &&
+        theta_phi_out[0] >= 0.0f && theta_phi_out[0] <= HALF_PI;
+
+    float const *eval = table.eval;
+    for (size_t c = 0; c < 3; ++c) {
+        size_t const ch = std::min(c, n - 1);
+        float v = 0.0f;
+        for (size_t s = 0; s < 8; ++s)
+            v += w[s] * eval[idx[s] + ch];
+        result[c] = inside ? v : 0.0f;
+    }
+}
+
+// Importance sample an outgoing direction of one part.
+void Bsdf_measurement::sample(
+    float       result[3],
+    float const theta_phi_in[2],
+    float const xi[3],
+    Part        part) const
+{
+    Part_table const &table = m_parts[part];
+    unsigned const i = table.eval == NULL ? 0 : get_theta_in_index(table, theta_phi_in[0]);
+    if (table.eval == NULL || !(table.albedo[i] > 0.0f)) {
+        result[0] = result[1] = result[2] = 0.0f;
+        return;
+    }
+
+    unsigned const res_theta = table.res_theta;
+    unsigned const res_phi   = table.res_phi;
+
+    // select theta_out from the marginal CDF of the theta_in row
+    float const *cdf_theta = &table.cdf_theta[size_t(i) * res_theta];
+    unsigned const j = find_interval(cdf_theta, res_theta, xi[0]);
+    float const s_theta = remap_in_interval(cdf_theta, j, xi[0]);
+
+    // select phi_out - phi_in from the conditional CDF
+    size_t const cell = (size_t(i) * res_theta + j) * res_phi;
+    float const *cdf_phi = &table.cdf_phi[cell];
+    unsigned const k = find_interval(cdf_phi, res_phi, xi[1]);
+    float const s_phi = remap_in_interval(cdf_phi, k, xi[1]);
+
+    // inside the cell, sample proportional to cos(theta_out), i.e. uniform in sin^2(theta_out)
+    float const sin2 = table.sin2_theta[j] +
+        s_theta * (table.sin2_theta[j + 1] - table.sin2_theta[j]);
+    float const sin_theta = std::sqrt(std::min(std::max(sin2, 0.0f), 1.0f));
+    float const cos_theta = std::sqrt(std::max(1.0f - sin2, 0.0f));
+    float const phi_delta = (float(k) + s_phi) * table.delta_phi;
+
+    float const lum = get_weight(table.eval + (cell + k) * table.n_channels, table.n_channels);
+
+    result[0] = std::asin(sin_theta);
+    result[1] = theta_phi_in[1] + (xi[2] < 0.5f ? phi_delta : -phi_delta);
+    result[2] = cos_theta * lum / table.albedo[i];
+}
+
+// Get the pdf with respect to solid angle of sample() for the given directions.
+float Bsdf_measurement::pdf(
+    float const theta_phi_in[2],
+    float const theta_phi_out[2],
+    Part        part) const
+{
+    Part_table const &table = m_parts[part];
+    if (table.eval == NULL)
+        return 0.0f;
+
+    unsigned const res_theta = table.res_theta;
+    unsigned const res_phi   = table.res_phi;
+
+    unsigned const i = get_theta_in_index(table, theta_phi_in[0]);
+    unsigned const j = get_theta_in_index(table, theta_phi_out[0]);
+    float const    p = std::max(get_phi_delta(theta_phi_in[1], theta_phi_out[1]), 0.0f);
+    unsigned const k = std::min(unsigned(p * table.inv_delta_phi), res_phi - 1);
+
+    size_t const   cell = (size_t(i) * res_theta + j) * res_phi + k;
+    float const    lum  = get_weight(table.eval + cell * table.n_channels, table.n_channels);
+
+    float const albedo = table.albedo[i];
+    bool const inside =
+        albedo > 0.0f && theta_phi_out[0] >= 0.0f && theta_phi_out[0] <= HALF_PI;
+    float const pdf = std::cos(theta_phi_out[0]) * lum / (albedo > 0.0f ? albedo : 1.0f);
+    return inside ? pdf : 0.0f;
+}
+
+// Get the directional albedos for an incoming direction.
+void Bsdf_measurement::get_albedos(
+    float       result[4],
+    float const theta_phi_in[2]) const
+{
+    for (unsigned part = 0; part <= PART_LAST; ++part) {
+        Part_table const &table = m_parts[part];
+        if (table.albedo.empty()) {
+            result[2 * part]     = 0.0f;
+            result[2 * part + 1] = 0.0f;
+            continue;
+        }
+        result[2 * part]     = table.albedo[get_theta_in_index(table, theta_phi_in[0])];
+        result[2 * part + 1] = table.max_albedo;
+    }
 }
 
 }  // MDLRT
@@ -713,6 +713,40 @@ bool Resource_handler::lp_isvalid(
     return o->is_valid();
 }
 
+// Evaluate the light profile for a given direction.
+float Resource_handler::lp_evaluate(
+    void const  *lp_data,
+    void        *thread_data,
+    float const theta_phi[2]) const
+{
+    MI::MDLRT::Light_profile const *o =
+        reinterpret_cast<MI::MDLRT::Light_profile const *>(lp_data);
+    return o->evaluate(theta_phi);
+}
+
+// Importance sample a direction proportional to the light profile.
+void Resource_handler::lp_sample(
+    float       result[3],
+    void const  *lp_data,
+    void        *thread_data,
+    float const xi[2]) const
+{
+    MI::MDLRT::Light_profile const *o =
+        reinterpret_cast<MI::MDLRT::Light_profile const *>(lp_data);
+    o->sample(result, xi);
+}
+
+// Get the pdf with respect to solid angle of lp_sample() for a given direction.
+float Resource_handler::lp_pdf(
+    void const  *lp_data,
+    void        *thread_data,
+    float const theta_phi[2]) const
+{
+    MI::MDLRT::Light_profile const *o =
+        reinterpret_cast<MI::MDLRT::Light_profile const *>(lp_data);
+    return o->pdf(theta_phi);
+}
+
 // Initializes a bsdf measurement data helper object from a given bsdf measurement tag.
 void Resource_handler::bm_init(
     void     *data,
@@ -742,6 +776,60 @@ bool Resource_handler::bm_isvalid(
     return o->is_valid();
 }
 
+// Evaluate a measured BSDF.
+void Resource_handler::bm_evaluate(
+    float       result[3],
+    void const  *bm_data,
+    void        *thread_data,
+    float const theta_phi_in[2],
+    float const theta_phi_out[2],
+    unsigned    part) const
+{
+    MI::MDLRT::Bsdf_measurement const *o =
+        reinterpret_cast<MI::MDLRT::Bsdf_measurement const *>(bm_data);
+    o->evaluate(
+        result, theta_phi_in, theta_phi_out, MI::MDLRT::Bsdf_measurement::Part(part));
+}
+
+// Importance sample an outgoing direction of a measured BSDF.
+void Resource_handler::bm_sample(
+    float       result[3],
+    void const  *bm_data,
+    void        *thread_data,
+    float const theta_phi_in[2],
+    float const xi[3],
+    unsigned    part) const
+{
+    MI::MDLRT::Bsdf_measurement const *o =
+        reinterpret_cast<MI::MDLRT::Bsdf_measurement const *>(bm_data);
+    o->sample(result, theta_phi_in, xi, MI::MDLRT::Bsdf_measurement::Part(part));
+}
+
+// Get the pdf with respect to solid angle of bm_sample() for the given directions.
+float Resource_handler::bm_pdf(
+    void const  *bm_data,
+    void        *thread_data,
+    float const theta_phi_in[2],
+    float const theta_phi_out[2],
+    unsigned    part) const
+{
+    MI::MDLRT::Bsdf_measurement const *o =
+        reinterpret_cast<MI::MDLRT::Bsdf_measurement const *>(bm_data);
+    return o->pdf(theta_phi_in, theta_phi_out, MI::MDLRT::Bsdf_measurement::Part(part));
+}
+
+// Get the directional albedos of a measured BSDF.
+void Resource_handler::bm_albedos(
+    float       result[4],
+    void const  *bm_data,
+    void        *thread_data,
+    float const theta_phi_in[2]) const
+{
+    MI::MDLRT::Bsdf_measurement const *o =
+        reinterpret_cast<MI::MDLRT::Bsdf_measurement const *>(bm_data);
+    o->get_albedos(result, theta_phi_in);
+}
+
 // Destructor.
 Resource_handler::~Resource_handler()
 {